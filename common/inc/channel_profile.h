@@ -0,0 +1,82 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+#ifndef _CHANNEL_PROFILE_H_
+#define _CHANNEL_PROFILE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CHANNEL_PROFILE_COUNT                8     // profiles are numbered 0 to CHANNEL_PROFILE_COUNT - 1
+#define CHANNEL_PROFILE_MAX_SIZE             128   // bytes of batched commands per profile
+#define CHANNEL_PROFILE_NONE                 ((uint8_t)0xFF)
+
+/**
+ * Find the stored profiles.
+ *
+ * Call from thread context.
+ *
+ * Profiles are kept in a log over two flash pages. Every change appends a
+ * record to the active page. Once it is full, the latest records are copied
+ * to the other page, which then becomes the active one.
+ */
+void channel_profile_init(void);
+
+/**
+ * Store the content of a profile, replacing or extending the stored one.
+ *
+ * Call from thread context, waits for the flash operations to complete.
+ *
+ * The content is a sequence of commands in the MESG_COMMAND_BATCH_ID format.
+ *
+ * @return RESPONSE_NO_ERROR, or the response code of the failure.
+ */
+uint8_t channel_profile_store(uint8_t ucProfile, const uint8_t *pucData, uint8_t ucSize, bool bAppend);
+
+/**
+ * Erase a stored profile.
+ *
+ * Call from thread context, waits for the flash operations to complete.
+ *
+ * @return RESPONSE_NO_ERROR, or the response code of the failure.
+ */
+uint8_t channel_profile_erase(uint8_t ucProfile);
+
+/**
+ * Retrieve the content of a stored profile.
+ *
+ * @return the content in flash, NULL if the profile is not stored.
+ */
+const uint8_t *channel_profile_get(uint8_t ucProfile, uint8_t *pucSize);
+
+/**
+ * Select the profile applied at startup, CHANNEL_PROFILE_NONE for none.
+ *
+ * Call from thread context, waits for the flash operations to complete.
+ *
+ * @return RESPONSE_NO_ERROR, or the response code of the failure.
+ */
+uint8_t channel_profile_boot_set(uint8_t ucProfile);
+
+/**
+ * Retrieve the profile applied at startup, CHANNEL_PROFILE_NONE if none.
+ */
+uint8_t channel_profile_boot_get(void);
+
+/**
+ * Retrieve a bit mask of the stored profiles.
+ */
+uint8_t channel_profile_stored_get(void);
+
+/**
+ * Retrieve the number of bytes left for records before the log is compacted.
+ */
+uint16_t channel_profile_free_get(void);
+
+#endif //_CHANNEL_PROFILE_H_
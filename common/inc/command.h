@@ -29,10 +29,21 @@ typedef struct
 extern uint16_t usEventFilterMask;
 
 /**
- * @brief ANT serial burst command message handler
+ * @brief ANT serial command handler initialization
+ */
+void Command_Init(void);
+
+/**
+ * @brief ANT serial burst command message handler. Returns true if the burst staging queue is full,
+ * the receive buffer is then kept and the message must be processed again once Main_SetQueuedBurst is called.
  */
 bool Command_BurstMessageProcess(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage);
 
+/**
+ * @brief ANT burst transfer event handler, feeds the burst handler from the burst staging queue
+ */
+void Command_BurstTransferEvent(uint8_t ucEvent, uint8_t ucChannel);
+
 /**
  * @brief ANT serial command message handler
  */
@@ -43,6 +54,11 @@ void Command_SerialMessageProcess(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxM
  */
 void Command_ResponseMessage(COMMAND_RESPONSE stCmdResponse, ANT_MESSAGE *pstTxMessage);
 
+/**
+ * @brief Apply the channel profile selected for startup. The message size is left at 0 if none is selected.
+ */
+void Command_ProfileBootApply(ANT_MESSAGE *pstTxMessage);
+
 #if defined (USE_INTERFACE_LOCK)
 /**
  * @brief ANT serial command interface lock
@@ -0,0 +1,87 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+#ifndef _CYCLE_PROFILE_H_
+#define _CYCLE_PROFILE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ant_parameters.h"
+#include "appconfig.h"
+#include "nrf.h"
+
+// Temporary message IDs until they are added to the nrf-softdevice repos
+#ifndef MESG_CYCLE_PROFILE_ID
+   #define MESG_CYCLE_PROFILE_ID                   ((uint16_t)0xE418) ///< ANT application - cycle count statistics of the hot paths
+#endif
+#define MESG_CYCLE_PROFILE_SIZE                    ((uint8_t)19) // sub ID, region, number of regions, count, min, max, average
+
+typedef enum
+{
+   CYCLE_PROFILE_SD_EVT_IRQ,                       // SD_EVT_IRQHandler
+   CYCLE_PROFILE_UART0_IRQ,                        // Serial_UART0_IRQHandler
+   CYCLE_PROFILE_COMMAND,                          // Command_SerialMessageProcess from the main loop
+   CYCLE_PROFILE_SERIAL_TX,                        // Serial_TxMessage framing a message, calls that frame nothing are not counted
+   CYCLE_PROFILE_REGIONS
+} cycle_profile_region_t;
+
+#if defined (CYCLE_PROFILING)
+
+/*
+ * Wrap a region with CYCLE_PROFILE_START and CYCLE_PROFILE_STOP in the same
+ * block, the cycles between them are counted with the DWT cycle counter. A
+ * region is recorded from a single context level, its count includes the
+ * interrupts that preempt it. Without CYCLE_PROFILING both expand to nothing.
+ */
+#define CYCLE_PROFILE_START(name)                  uint32_t name = DWT->CYCCNT
+#define CYCLE_PROFILE_STOP(region, name)           cycle_profile_record((region), DWT->CYCCNT - (name))
+
+/**
+ * Start the cycle counter and clear the statistics.
+ *
+ * Call from thread context.
+ */
+void cycle_profile_init(void);
+
+/**
+ * Add a cycle count to the statistics of a region.
+ *
+ * Call from the context level the region runs at.
+ */
+void cycle_profile_record(cycle_profile_region_t eRegion, uint32_t ulCycles);
+
+/**
+ * Clear the statistics of all regions.
+ *
+ * Call from thread context.
+ */
+void cycle_profile_clear(void);
+
+/**
+ * Construct the cycle profile message of a region.
+ *
+ * Call from thread context.
+ *
+ * Payload: region, number of regions, then the count, minimum, maximum and
+ * average cycles of the region as 4 byte little endian fields. Minimum and
+ * average are 0 if the region has not run.
+ *
+ * @return false if there is no such region.
+ */
+bool cycle_profile_mesg_get(uint8_t ucRegion, ANT_MESSAGE *pstTxMessage);
+
+#else
+
+#define CYCLE_PROFILE_START(name)
+#define CYCLE_PROFILE_STOP(region, name)
+
+#endif // CYCLE_PROFILING
+
+#endif // _CYCLE_PROFILE_H_
@@ -24,6 +24,11 @@ uint16_t DSI_GetUShort(uint8_t *pucData);
  */
 void DSI_PutUShort(uint16_t val, uint8_t *pucData);
 
+/**
+ * @brief Write unsigned 32-bit from buffer (little endian)
+ */
+void DSI_PutULong(uint32_t ulVal, uint8_t *pucData);
+
 /**
  * @brief Read unsigned 32-bit from buffer (little endian)
  */
@@ -44,5 +49,10 @@ void DSI_memset(uint8_t *pucDest, uint8_t ucValue, uint8_t ucSize);
  */
 bool DSI_memcmp(uint8_t *pucSrc1, uint8_t *pucSrc2, uint8_t ucSize);
 
+/**
+ * @brief Buffer XOR checksum utility, starting from ucCheckSum
+ */
+uint8_t DSI_CheckSum(uint8_t *pucData, uint8_t ucSize, uint8_t ucCheckSum);
+
 
 #endif // DSI_UTILITY_H
@@ -15,25 +15,65 @@ All rights reserved.
 
 #include "ant_interface.h"
 #include "ant_parameters.h"
+#include "multi_ctx_fifo.h"
 
 #define DEFAULT_EVENT_BUFFERING_CONFIG             0
 #define DEFAULT_EVENT_BUFFERING_SIZE_THRESHOLD     0
 #define DEFAULT_EVENT_BUFFERING_TIME_THRESHOLD     0
+#define DEFAULT_EVENT_BUFFERING_DRAIN_WEIGHT       4
+
+// Temporary message IDs until they are added to the nrf-softdevice repos
+#ifndef MESG_BURST_AGGREGATION_CONFIG_ID
+   #define MESG_BURST_AGGREGATION_CONFIG_ID        ((uint16_t)0xE410) ///< ANT application - burst receive aggregation enable
+#endif
+#ifndef MESG_BURST_AGGREGATE_DATA_ID
+   #define MESG_BURST_AGGREGATE_DATA_ID            ((uint16_t)0xE411) ///< ANT application - aggregated burst receive data
+#endif
+#ifndef MESG_EVENT_BUFFERING_DRAIN_CONFIG_ID
+   #define MESG_EVENT_BUFFERING_DRAIN_CONFIG_ID    ((uint16_t)0xE412) ///< ANT application - event buffering drain weight
+#endif
+#ifndef MESG_EVENT_TIMESTAMP_CONFIG_ID
+   #define MESG_EVENT_TIMESTAMP_CONFIG_ID          ((uint16_t)0xE416) ///< ANT application - event timestamp extended data enable
+#endif
+#define MESG_BURST_AGGREGATION_CONFIG_SIZE         ((uint8_t)2)
+#define MESG_EVENT_BUFFERING_DRAIN_CONFIG_SIZE     ((uint8_t)2)
+#define MESG_EVENT_TIMESTAMP_CONFIG_SIZE           ((uint8_t)2)
+
+// Extended data flag of the event timestamp field, which follows the standard
+// extended data fields. Not assigned by the ANT stack.
+#ifndef ANT_EXT_MESG_BITFIELD_NP_TIMESTAMP
+   #define ANT_EXT_MESG_BITFIELD_NP_TIMESTAMP      ((uint8_t)0x10)
+#endif
+#define ANT_EXT_MESG_NP_TIMESTAMP_FIELD_SIZE       ((uint8_t)4)
 
 typedef struct
 {
    uint8_t ucChannel;
    uint8_t ucEvent;
+   // System_GetTime_32K when the event was read from the ANT stack, little
+   // endian. Byte array so the header needs no alignment within the record.
+   // Only valid while the system timer is requested, which the timestamp
+   // extended data and the event trace do while enabled.
+   uint8_t aucTimestamp[4];
 } ant_event_hdr_t;
 
 typedef struct
 {
    // Needed because ANT_MESSAGE is aligned to 4 bytes, but fifo needs continuous memory.
-   uint8_t __padding[2];
+   uint8_t __padding;
    ant_event_hdr_t stHeader;
+   // Events are buffered as complete serial frames so they can be sent in place.
+   uint8_t ucSyncByte;
    ANT_MESSAGE stMessage;
 } ant_event_t;
 
+// Lane an event was claimed from, passed back to event_buffering_release.
+typedef enum
+{
+   EVENT_LANE_HIGH,
+   EVENT_LANE_LOW
+} event_lane_t;
+
 /**
  * Init event buffer.
  *
@@ -41,31 +81,69 @@ typedef struct
  */
 void event_buffering_init(void);
 
+/**
+ * Drop all events and size the buffer again from the RAM arena.
+ *
+ * Call from thread context, with no event claimed and no event put in
+ * progress, after ram_arena_reset. The configuration is kept.
+ */
+void event_buffering_reset(void);
+
+/**
+ * Retrieve the size in bytes of the high and low priority lanes.
+ */
+void event_buffering_queue_size_get(uint16_t *pusHighSize, uint16_t *pusLowSize);
+
+/**
+ * Retrieve the number of bytes in use in the high and low priority lanes,
+ * including events claimed and not released yet.
+ *
+ * Can be called from any context level.
+ */
+void event_buffering_queue_level_get(uint16_t *pusHighLevel, uint16_t *pusLowLevel);
+
 /**
  * Put an event in the buffer.
  *
  * Call from thread or interrupt context.
  *
+ * The event is stored as a complete serial frame: sync byte, message and
+ * checksum. Events that are bufferable under the current configuration go to
+ * the low priority lane and wait for a flush, all others (including command
+ * responses) go to the high priority lane and are sent right away. Without a
+ * size or time threshold nothing is bufferable, events keep their order.
+ *
  * @return true if the message was placed in the buffer. false otherwise.
  *          It is up to the caller to hold onto the message and retry at a later
  *          time.
  */
-bool event_buffering_put(const ant_event_t *pstEvent);
+bool event_buffering_put(ant_event_t *pstEvent);
 
 /**
- * Attempt to retrieve an event from the buffer.
+ * Attempt to claim the next event in the buffer without copying it out.
  *
  * Call from thread context.
  *
- * This doesn't mirror the event_buffering_put call exactly. It is a result of
- * how main currently deals with the TxMessage variable (it's actually a pointer
- * into a serial buffer).
+ * The serial frame of the event is returned in place and stays allocated
+ * until event_buffering_release is called with the returned lane and record
+ * size. Events must be released in the order they were claimed.
  *
- * @return true if there was an event to retrieve. false if there was no event
- *          to retrieve. This is used instead of NO_EVENT because NO_EVENT
+ * High priority events are claimed first. While the low priority lane is
+ * flushing, the drain weight bounds how many high priority events are claimed
+ * in a row ahead of it.
+ *
+ * @return true if there was an event to claim. false if there was no event
+ *          to claim. This is used instead of NO_EVENT because NO_EVENT
  *          indicates command responses.
  */
-bool event_buffering_get(ant_event_hdr_t *pstEvent, ANT_MESSAGE *pstMessage);
+bool event_buffering_claim(ant_event_hdr_t *pstEvent, mc_fifo_span_t *pstFrame, event_lane_t *peLane, uint16_t *pusRecordSize);
+
+/**
+ * Release the space of the oldest claimed event(s).
+ *
+ * Call from a single context, e.g. once the frame has been transmitted.
+ */
+void event_buffering_release(event_lane_t eLane, uint16_t usRecordSize);
 
 /**
  * Set the event buffering configuration.
@@ -79,6 +157,68 @@ void event_buffering_config_set(uint8_t ucConfig, uint16_t usSizeThreshold, uint
  */
 void event_buffering_config_get(uint8_t *pucConfig, uint16_t *pusSizeThreshold, uint16_t *pusTimeThreshold);
 
+/**
+ * Set the drain weight of the low priority lane.
+ *
+ * Call from thread context.
+ *
+ * While the low priority lane is flushing, one of its events is sent after
+ * every ucWeight high priority events. A weight of 0 is taken as 1, the low
+ * priority lane is never starved.
+ */
+void event_buffering_drain_weight_set(uint8_t ucWeight);
+
+/**
+ * Retrieve the drain weight of the low priority lane.
+ */
+uint8_t event_buffering_drain_weight_get(void);
+
+/**
+ * Flush the event buffer once the time threshold has expired.
+ *
+ * Call from thread context, at least once every time through the main loop.
+ * The flush timer is armed when an event is buffered and wakes the core up
+ * on expiry, so buffered events never wait for the next event to arrive.
+ *
+ * @return true if the buffer was flushed.
+ */
+bool event_buffering_tick(void);
+
+/**
+ * Enable or disable aggregation of received burst packets.
+ *
+ * Call from thread context.
+ *
+ * When enabled, consecutive standard burst packets received on a channel are
+ * combined into MESG_BURST_AGGREGATE_DATA_ID frames. Payload: channel number
+ * with the sequence number of the first packet (the last message flag is set
+ * if the frame ends the burst), packet count, then the packet data.
+ */
+void event_buffering_burst_aggregation_set(bool bEnable);
+
+/**
+ * Retrieve whether received burst packets are aggregated.
+ */
+bool event_buffering_burst_aggregation_get(void);
+
+/**
+ * Enable or disable the timestamp extended data field.
+ *
+ * Call from thread context.
+ *
+ * When enabled, the timestamp of the event header is appended to received
+ * broadcast, acknowledged and burst data messages as a 4 byte little endian
+ * field flagged with ANT_EXT_MESG_BITFIELD_NP_TIMESTAMP, in 32768 Hz ticks of
+ * the 24 bit RTC. The system timer is kept running while enabled. Aggregated
+ * burst frames carry no timestamp.
+ */
+void event_buffering_timestamp_set(bool bEnable);
+
+/**
+ * Retrieve whether the timestamp extended data field is appended.
+ */
+bool event_buffering_timestamp_get(void);
+
 /**
  * Trigger an explicit flush of the event buffer.
  *
@@ -0,0 +1,115 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+#ifndef _EVENT_TRACE_H_
+#define _EVENT_TRACE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ant_parameters.h"
+#include "appconfig.h"
+#include "event_buffering.h"
+
+// Temporary message IDs until they are added to the nrf-softdevice repos
+#ifndef MESG_EVENT_TRACE_ID
+   #define MESG_EVENT_TRACE_ID                     ((uint16_t)0xE417) ///< ANT application - event trace configuration and records
+#endif
+#define MESG_EVENT_TRACE_CONFIG_SIZE               ((uint8_t)2)
+#define MESG_EVENT_TRACE_HEADER_SIZE               ((uint8_t)7) // sub ID, configuration, next sequence, first sequence, record count
+
+#define EVENT_TRACE_CONFIG_ENABLE                  ((uint8_t)0x01)
+// Stop recording once half of the ring has been written after stack events
+// stalled, keeping what led to the stall and what followed it.
+#define EVENT_TRACE_CONFIG_STOP_ON_STALL           ((uint8_t)0x02)
+#define EVENT_TRACE_CONFIG_MASK                    ((uint8_t)0x03)
+#define DEFAULT_EVENT_TRACE_CONFIG                 EVENT_TRACE_CONFIG_ENABLE
+
+// Flags in the size field of a record.
+#define EVENT_TRACE_FLAG_STALL                     ((uint8_t)0x80) // event could not be buffered, stack events stall
+#define EVENT_TRACE_FLAG_RESUME                    ((uint8_t)0x40) // held event buffered, stack events resume
+#define EVENT_TRACE_SIZE_MASK                      ((uint8_t)0x3F)
+
+#define EVENT_TRACE_RECORD_SIZE                    ((uint8_t)8)
+#define EVENT_TRACE_RECORDS_PER_MESG               ((uint8_t)((MESG_MAX_SIZE_VALUE - MESG_EVENT_TRACE_HEADER_SIZE) / EVENT_TRACE_RECORD_SIZE))
+
+/*
+ * Trace record, also the format of traces saved on the host: records back to
+ * back, oldest first. A record is written for every event read from the ANT
+ * stack, and a resume record when the event held by a stall is buffered.
+ */
+typedef struct
+{
+   uint8_t aucTimestamp[4];                        // System_GetTime_32K, little endian
+   uint8_t ucChannel;                              // channel field of the message, with the burst sequence number
+   uint8_t ucEvent;
+   uint8_t ucMesgID;
+   uint8_t ucSize;                                 // message size and EVENT_TRACE_FLAG_*
+} event_trace_record_t;
+
+/**
+ * Clear the trace and restore the default configuration.
+ *
+ * Call from thread context, once, after System_Init.
+ */
+void event_trace_init(void);
+
+/**
+ * Record an event read from the ANT stack, before it is buffered.
+ *
+ * Call from the stack event interrupt.
+ */
+void event_trace_record(const ant_event_t *pstEvent);
+
+/**
+ * Mark the last recorded event as the one that could not be buffered and
+ * stalled the stack events.
+ *
+ * Call from the stack event interrupt, right after recording the event.
+ */
+void event_trace_stall(void);
+
+/**
+ * Record that the event held by a stall was buffered and stack events
+ * resume, at the current time.
+ *
+ * Call from thread context.
+ */
+void event_trace_resume(const ant_event_t *pstEvent);
+
+/**
+ * Set the trace configuration, EVENT_TRACE_CONFIG_*. Clears the trace.
+ *
+ * Call from thread context.
+ *
+ * The system timer is kept running from enabling the trace until a
+ * configuration disables it, so that the records are timed.
+ */
+void event_trace_config_set(uint8_t ucConfig);
+
+/**
+ * Retrieve the trace configuration.
+ */
+uint8_t event_trace_config_get(void);
+
+/**
+ * Construct an event trace message holding the records from a sequence number.
+ *
+ * Call from thread context.
+ *
+ * Records are numbered from 0 since the trace was cleared, wrapping at 16
+ * bits. Records that were already overwritten are skipped: the message gives
+ * the sequence of the first record it holds and the sequence of the next
+ * record to be written, so the host can tell what it missed. Payload:
+ * configuration, next sequence, first sequence, record count, then the
+ * records.
+ */
+void event_trace_mesg_get(uint16_t usSequence, ANT_MESSAGE *pstTxMessage);
+
+#endif // _EVENT_TRACE_H_
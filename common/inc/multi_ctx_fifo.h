@@ -22,26 +22,67 @@ All rights reserved.
 // Can change this depending on how large of a fifo is required.
 typedef uint16_t fifo_offset_t;
 
+// Power of two fifo sizes let the offsets run freely and be masked into the
+// buffer, which removes the wraparound branches from every operation. Fifos
+// must then be sized to a power of two, no larger than half the offset range.
+#if !defined (MC_FIFO_POW2_SIZE_DISABLE)
+   #define MC_FIFO_POW2_SIZE
+#endif
+
 typedef struct
 {
    uint8_t *pucBuff;
    fifo_offset_t uiSize;
+   // With MC_FIFO_POW2_SIZE the offsets below run freely, otherwise they
+   // wrap around at uiSize.
    fifo_offset_t uiHead;
    fifo_offset_t uiTail;
+   // Read position of the pop context. Data between the tail and this
+   // has been claimed in place and its space is not released yet.
+   fifo_offset_t uiRead;
    // Used to handle simultaneous push ops at multiple contexts.
    // It is advanced at the start of every push. The real head is
    // updated once all push ops are confirmed complete.
    fifo_offset_t uiPushHead;
 } multi_ctx_fifo_t;
 
+// Data claimed in place. The second span is only used when the data wraps
+// around the end of the fifo buffer.
+typedef struct
+{
+   uint8_t *pucData[2];
+   fifo_offset_t uiLen[2];
+} mc_fifo_span_t;
+
+#if defined (MC_FIFO_POW2_SIZE)
+   // Fails to compile if the fifo size is not a power of two within range.
+   #define MC_FIFO_SIZE_CHECK(uiLen) \
+      (void)sizeof(char[((((uiLen) & ((uiLen) - 1)) == 0) && ((uiLen) <= ((fifo_offset_t)~0u >> 1) + 1u)) ? 1 : -1])
+#else
+   #define MC_FIFO_SIZE_CHECK(uiLen) \
+      (void)sizeof(char[((uiLen) <= (fifo_offset_t)~0u) ? 1 : -1])
+#endif
+
 #define mc_fifo_init(pstFifo, uiLen) do {    \
-   multi_ctx_fifo_t *_pstFifo = (pstFifo);   \
-   memset(_pstFifo, 0, sizeof(*_pstFifo));   \
+   MC_FIFO_SIZE_CHECK(uiLen);                \
    static uint8_t _aucFifoBuff [uiLen];     \
-   _pstFifo->pucBuff = _aucFifoBuff;         \
-   _pstFifo->uiSize = sizeof(_aucFifoBuff);  \
+   mc_fifo_init_buffer((pstFifo), _aucFifoBuff, sizeof(_aucFifoBuff)); \
    } while (0)
 
+/**
+ * Init a fifo on a buffer provided at runtime.
+ *
+ * Call before the fifo is used from any context, the fifo starts out empty.
+ *
+ * With MC_FIFO_POW2_SIZE the size must be a power of two, no larger than half
+ * the offset range. Unlike mc_fifo_init this is not checked.
+ *
+ * @param[in] pstFifo The fifo to init.
+ * @param[in] pucBuff Buffer holding the fifo data, used until re-init.
+ * @param[in] uiLen Size of the buffer in bytes.
+ */
+void mc_fifo_init_buffer(multi_ctx_fifo_t *pstFifo, uint8_t *pucBuff, fifo_offset_t uiLen);
+
 /**
  * Insert new data into the fifo.
  *
@@ -60,6 +101,36 @@ typedef struct
  */
 bool mc_fifo_push(multi_ctx_fifo_t *pstFifo, const void *pvSrc, fifo_offset_t uiLen);
 
+/**
+ * Insert new data into the fifo and return where it was placed.
+ *
+ * Same as mc_fifo_push.
+ *
+ * @param[out] puiOffset Offset of the data, for use with mc_fifo_write.
+ */
+bool mc_fifo_push_at(multi_ctx_fifo_t *pstFifo, const void *pvSrc, fifo_offset_t uiLen, fifo_offset_t *puiOffset);
+
+/**
+ * Overwrite data in place.
+ *
+ * The caller must ensure the data at uiOffset was pushed with
+ * mc_fifo_push_at and has not been popped or claimed yet, and that the write
+ * is atomic w.r.t. the pop context.
+ *
+ * @param[in] pstFifo The fifo to write to.
+ * @param[in] uiOffset Offset returned by mc_fifo_push_at.
+ * @param[in] pvSrc The new data.
+ * @param[in] uiLen Length of data (in bytes) to write, at most the pushed length.
+ */
+void mc_fifo_write(multi_ctx_fifo_t *pstFifo, fifo_offset_t uiOffset, const void *pvSrc, fifo_offset_t uiLen);
+
+/**
+ * Query the offset of the next data to be claimed or popped.
+ *
+ * Call from the pop context.
+ */
+fifo_offset_t mc_fifo_get_read_offset(multi_ctx_fifo_t *pstFifo);
+
 /**
  * Retrieve data from the head of the fifo.
  *
@@ -79,6 +150,50 @@ bool mc_fifo_push(multi_ctx_fifo_t *pstFifo, const void *pvSrc, fifo_offset_t ui
  */
 bool mc_fifo_pop(multi_ctx_fifo_t *pstFifo, void *pvDst, fifo_offset_t uiLen);
 
+/**
+ * Copy data from the head of the fifo without removing it.
+ *
+ * Same context rules as mc_fifo_pop.
+ *
+ * @param[in] pstFifo The fifo to read from.
+ * @param[out] pvDst The destination buffer for the data.
+ * @param[in] uiLen The length of data to copy out of the fifo.
+ *
+ * @return true if the data was copied out of the fifo, false if there was not
+ *          enough data to satisfy the request.
+ */
+bool mc_fifo_peek(multi_ctx_fifo_t *pstFifo, void *pvDst, fifo_offset_t uiLen);
+
+/**
+ * Claim data from the head of the fifo in place, without copying it.
+ *
+ * Same context rules as mc_fifo_pop. The claimed data is no longer returned
+ * by peek/pop/claim, but its space stays allocated until it is handed back
+ * with mc_fifo_release. Claimed data may be modified in place.
+ *
+ * Pops must not be mixed with claims that have not been released yet.
+ *
+ * @param[in] pstFifo The fifo to claim data from.
+ * @param[out] pstSpan Location of the claimed data.
+ * @param[in] uiLen The length of data to claim.
+ *
+ * @return true if the data was claimed, false if there was not enough data
+ *          to satisfy the request.
+ */
+bool mc_fifo_claim(multi_ctx_fifo_t *pstFifo, mc_fifo_span_t *pstSpan, fifo_offset_t uiLen);
+
+/**
+ * Release the oldest claimed data back to the fifo.
+ *
+ * Releases are done in claim order, but may be called from a different
+ * context level than the claims (e.g. a transfer complete interrupt).
+ * All releases must be done from the same context level.
+ *
+ * @param[in] pstFifo The fifo to release data to.
+ * @param[in] uiLen The length of data to release.
+ */
+void mc_fifo_release(multi_ctx_fifo_t *pstFifo, fifo_offset_t uiLen);
+
 /**
  * Query the amount of valid data currently in the fifo.
  *
@@ -88,7 +203,8 @@ bool mc_fifo_pop(multi_ctx_fifo_t *pstFifo, void *pvDst, fifo_offset_t uiLen);
  *
  * @param[in] pstFifo The fifo to query the status of.
  *
- * @return the amount of data in the fifo.
+ * @return the amount of data in the fifo, including claimed data that has not
+ *          been released yet.
  */
 fifo_offset_t mc_fifo_get_data_len(multi_ctx_fifo_t *pstFifo);
 
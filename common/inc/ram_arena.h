@@ -0,0 +1,73 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+#ifndef _RAM_ARENA_H_
+#define _RAM_ARENA_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "multi_ctx_fifo.h"
+
+/**
+ * Init the arena on the part of a memory block that its owner left unused.
+ *
+ * Call from thread context, once the owner has taken its share of the block
+ * (i.e. after sd_ant_enable) and before any allocation.
+ *
+ * The arena hands out two kinds of memory. Fixed allocations are taken from
+ * the end of the block and are never given back. Fifo buffers are taken from
+ * the start of the free space and are all given back by ram_arena_reset.
+ */
+void ram_arena_init(uint8_t *pucBlock, uint16_t usBlockSize, uint16_t usUsedSize);
+
+/**
+ * Give back all fifo buffers and change the share of the block owner.
+ *
+ * Call from thread context, once none of the fifos grown into the arena are
+ * in use anymore. They must be initialized again before they are used.
+ *
+ * The owner share is limited to ram_arena_get_owner_limit.
+ */
+void ram_arena_reset(uint16_t usUsedSize);
+
+/**
+ * Allocate fixed, word aligned memory from the arena.
+ *
+ * Call from thread context.
+ *
+ * @return the allocated memory, NULL if the arena does not have room for it.
+ */
+void *ram_arena_alloc(uint16_t usSize);
+
+/**
+ * Move a fifo onto the largest buffer the arena can give, up to uiMaxLen.
+ *
+ * Call from thread context, before the fifo is used.
+ *
+ * With MC_FIFO_POW2_SIZE the buffer size is rounded down to a power of two.
+ * The fifo is left on its current buffer if the arena cannot give a larger
+ * one.
+ *
+ * @return true if the fifo was moved onto arena memory.
+ */
+bool ram_arena_fifo_grow(multi_ctx_fifo_t *pstFifo, fifo_offset_t uiMaxLen);
+
+/**
+ * Retrieve the number of bytes still available in the arena.
+ */
+uint16_t ram_arena_get_free(void);
+
+/**
+ * Retrieve the largest share of the block its owner can take, i.e. the block
+ * size less the fixed allocations.
+ */
+uint16_t ram_arena_get_owner_limit(void);
+
+#endif //_RAM_ARENA_H_
@@ -15,10 +15,16 @@ All rights reserved.
 #include "ant_parameters.h"
 #include "appconfig.h"
 #include "boardconfig.h"
+#include "event_buffering.h"
+#include "multi_ctx_fifo.h"
 
 #define SERIAL_SLEEP_POLLING_MODE // enable serial sleeping mechanism
 
 #define SERIAL_RX_BUFFER_SIZE        (MESG_MAX_DATA_SIZE + MESG_ID_SIZE)
+#define SERIAL_RX_QUEUE_SIZE         ((uint8_t)4) // number of input messages buffered before flow control kicks in, power of 2
+#define SERIAL_RX_QUEUE_SIZE_MAX     ((uint8_t)16) // number of input messages the rx queue grows to when there is room in the RAM arena, power of 2
+#define SERIAL_TX_RING_SIZE          ((uint16_t)256) // async tx staging ring size in bytes, power of 2
+#define SERIAL_TX_FRAME_QUEUE_SIZE   ((uint8_t)8) // number of event frames queued for in place transmission, power of 2
 
 //////////////////////////////////////////////
 /* Supported Async Baudrate Bitfield
@@ -169,7 +175,7 @@ uint8_t Serial_SetByteSyncSerialBitRate(uint8_t ucConfig);
 uint8_t Serial_SetByteSyncSerialSRDYSleep(uint8_t ucDelay);
 
 /**
- * @brief Get input message buffer
+ * @brief Get input message buffer, the oldest received message not yet released
  */
 ANT_MESSAGE *Serial_GetRxMesgPtr(void);
 
@@ -178,6 +184,11 @@ ANT_MESSAGE *Serial_GetRxMesgPtr(void);
  */
 ANT_MESSAGE *Serial_GetTxMesgPtr(void);
 
+/**
+ * @brief Check if serial transmission is in progress
+ */
+bool Serial_TxBusy(void);
+
 /**
  * @brief Set baudrate
  */
@@ -194,15 +205,26 @@ void Serial_ActivateAsyncBaudrate(void);
 void Serial_HoldRx(void);
 
 /**
- * @brief Allow incoming serial communication
+ * @brief Release the input message buffer and allow incoming serial communication
  */
 void Serial_ReleaseRx(void);
 
 /**
- * @brief Send serial message
+ * @brief Send serial message. Async messages are queued and sent from interrupt context, this does not wait for completion.
  */
 void Serial_TxMessage(void);
 
+/**
+ * @brief Send a serial frame claimed from the event buffer in place, NULL if the event is not to be sent.
+ * The event buffer space is released once the frame is out. Returns false if the frame queue is full.
+ */
+bool Serial_TxEventFrame(mc_fifo_span_t *pstFrame, event_lane_t eLane, uint16_t usRecordSize);
+
+/**
+ * @brief Check if the event frame queue is full
+ */
+bool Serial_TxEventFrameQueueFull(void);
+
 /**
  * @brief Receive serial message
  */
@@ -213,6 +235,11 @@ bool Serial_RxMessage(void);
  */
 void Serial_Sleep(void);
 
+/**
+ * @brief Request the high frequency clock again after the softdevice was restarted, if serial held it
+ */
+void Serial_ClockRestore(void);
+
 /**
  * @brief Interrupt handler for synchronous serial SMSGRDY and SRDY interrupt. Uses GPIOTE 0 and 1
  */
@@ -226,8 +253,13 @@ void Serial_GPIOTE_IRQHandler(void);
 void Serial_UART0_IRQHandler(void);
 
 /**
- * @brief ANT event handler used by serial interface
+ * @brief Interrupt handler for asynchronous serial receive line idle timer (TIMER3, UARTE only)
+ */
+void Serial_TIMER3_IRQHandler(void);
+
+/**
+ * @brief ANT event handler used by serial interface. Returns false if the event is not to be sent out.
  */
-void Serial_ANTEventHandler(uint8_t ucEventType, ANT_MESSAGE *pstANTMessage);
+bool Serial_ANTEventHandler(uint8_t ucEventType, uint8_t ucChannel);
 
 #endif /* SERIAL_H_ */
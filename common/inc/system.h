@@ -36,6 +36,13 @@ All rights reserved.
 #define SYSTEM_ID_MFG_ESN                    0
 #define SYSTEM_ID_ANT_ID                     1
 
+// Temporary message IDs until they are added to the nrf-softdevice repos
+#ifndef MESG_ANT_MEMORY_CONFIG_ID
+   #define MESG_ANT_MEMORY_CONFIG_ID         ((uint16_t)0xE413) ///< ANT application - ANT stack channel memory configuration
+#endif
+#define MESG_ANT_MEMORY_CONFIG_SET_SIZE      ((uint8_t)5)   // sub ID, channels, encrypted channels, burst queue size, events
+#define MESG_ANT_MEMORY_CONFIG_SIZE          ((uint8_t)13)  // set fields, then ANT stack, message queue, buffered message queue and free arena bytes
+
 /*
  * RSSI Calibration Settings
  */
@@ -119,11 +126,36 @@ void System_GetRSSICalDataMesg(ANT_MESSAGE *pstTxMessage);
  */
 void System_GetRSSICalData(uint8_t *pucRSSICal);
 
+/**
+ * @brief Sets the DC/DC converter mode, DC_TO_DC_OFF or DC_TO_DC_ON
+ */
+uint8_t System_SetDCToDC(uint8_t ucMode);
+
+/**
+ * @brief Applies the SoC settings made through the softdevice again after it was restarted
+ */
+void System_SoftDeviceRestore(void);
+
+/**
+ * @brief Restarts the ANT stack with the channel memory configuration given by the host
+ */
+uint8_t System_SetANTMemoryConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage);
+
+/**
+ * @brief Constructs the ANT stack channel memory configuration message
+ */
+void System_GetANTMemoryConfigMesg(ANT_MESSAGE *pstTxMessage);
+
 /**
  * @brief Initiates a flash write operation with given parameters
  */
 uint32_t System_FlashWrite(uint32_t* ulAddress, uint32_t * pulData, uint8_t ucLength);
 
+/**
+ * @brief Initiates a flash page erase operation
+ */
+uint32_t System_FlashPageErase(uint32_t ulPageNumber);
+
 /**
  * @brief Process for updating a flag when a flash write is complete
  */
@@ -134,6 +166,11 @@ void System_FlashEventProcess(uint32_t ulEvent);
  */
 bool System_FlashBusy(void);
 
+/**
+ * @brief Returns flag indicating whether the last flash operation failed, valid once it is no longer busy
+ */
+bool System_FlashFailed(void);
+
 /**
  * @brief Read the given address to empty the system bus write buffer
  */
@@ -154,6 +191,14 @@ void System_TimerRequest(void);
  */
 void System_TimerRelease(void);
 
+/**
+ * Check whether the system timer is requested, i.e. System_GetTime_32K
+ * advances.
+ *
+ * Context: Any
+ */
+bool System_TimerRequested(void);
+
 /**
  * Gets a system time value that increments at 32KHz. Wraps at 0xFFFF_FFFF.
  *
@@ -163,4 +208,31 @@ void System_TimerRelease(void);
  */
 uint32_t System_GetTime_32K(void);
 
+/**
+ * Arm the system timer alarm for the given System_GetTime_32K time. The alarm
+ * wakes the core up but does not run an interrupt handler, poll it with
+ * System_TimerAlarmExpired. The system timer must be requested.
+ *
+ * @return false if the time is too close or too far away to be set, in that
+ *          case the alarm is not armed.
+ *
+ * Context: Any
+ */
+bool System_TimerAlarmSet(uint32_t ulTime);
+
+/**
+ * Disarm the system timer alarm and clear any expiry.
+ *
+ * Context: Any
+ */
+void System_TimerAlarmClear(void);
+
+/**
+ * Check whether the armed system timer alarm has expired. It stays expired
+ * until cleared.
+ *
+ * Context: Any
+ */
+bool System_TimerAlarmExpired(void);
+
 #endif // SYSTEM_H
@@ -0,0 +1,316 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "nrf.h"
+#include "nrf_error.h"
+#include "ant_parameters.h"
+#include "boardconfig.h"
+#include "channel_profile.h"
+#include "system.h"
+
+#ifndef NVM_FULL_ERROR
+   #define NVM_FULL_ERROR                    ((uint8_t)0x40)
+#endif
+#ifndef NVM_WRITE_ERROR
+   #define NVM_WRITE_ERROR                   ((uint8_t)0x41)
+#endif
+
+#define PROFILE_FLASH_ERASED                 0xFFFFFFFFUL
+
+// Page header: marker and sequence number, the page with the newest sequence is the active one.
+// It is written last when a page is filled from the other one.
+#define PROFILE_PAGE_MARKER                  0xA55A0000UL
+#define PROFILE_PAGE_MARKER_MASK             0xFFFF0000UL
+
+// Record header: marker, profile, data size and its complement, followed by the data words.
+// The data is written ahead of the header, an erased header ends the log.
+#define PROFILE_RECORD_MARKER                0x5AUL
+#define PROFILE_RECORD_HEADER(id, size)      ((PROFILE_RECORD_MARKER << 24) | ((uint32_t)(id) << 16) | ((uint32_t)(size) << 8) | (uint8_t)~(size))
+#define PROFILE_RECORD_VALID(hdr)            ((((hdr) >> 24) == PROFILE_RECORD_MARKER) && ((uint8_t)((hdr) >> 8) == (uint8_t)~(hdr)))
+#define PROFILE_RECORD_ID(hdr)               ((uint8_t)((hdr) >> 16))
+#define PROFILE_RECORD_SIZE(hdr)             ((uint8_t)((hdr) >> 8))
+#define PROFILE_RECORD_WORDS(size)           (1u + (((size) + 3u) >> 2))
+
+#define PROFILE_BOOT_ID                      ((uint8_t)0xFE) // record holding the startup profile
+
+static uint32_t ulPageSize;                  // bytes
+static uint32_t *apulPage[2];
+static uint32_t *pulActivePage;              // NULL until the first record is written
+static uint32_t *pulLogEnd;                  // where the next record goes
+static bool bLogDirty;                       // log ends on an incomplete record, it can not be appended to
+
+static const uint32_t *apulRecord[CHANNEL_PROFILE_COUNT]; // latest record of each profile, NULL if not stored
+static uint8_t ucBootProfile;
+
+static bool profile_page_valid(const uint32_t *pulPage)
+{
+   return (pulPage[0] & PROFILE_PAGE_MARKER_MASK) == PROFILE_PAGE_MARKER;
+}
+
+static uint32_t *profile_page_end(const uint32_t *pulPage)
+{
+   return (uint32_t *)pulPage + (ulPageSize / sizeof(uint32_t));
+}
+
+static void profile_scan(void)
+{
+   const uint32_t *pulRecord;
+
+   memset(apulRecord, 0, sizeof(apulRecord));
+   ucBootProfile = CHANNEL_PROFILE_NONE;
+   bLogDirty = false;
+   pulLogEnd = NULL;
+
+   if (pulActivePage == NULL)
+      return;
+
+   pulRecord = pulActivePage + 1;
+   while ((pulRecord < profile_page_end(pulActivePage)) && (*pulRecord != PROFILE_FLASH_ERASED))
+   {
+      uint32_t ulHeader = *pulRecord;
+      uint8_t ucID = PROFILE_RECORD_ID(ulHeader);
+      uint8_t ucSize = PROFILE_RECORD_SIZE(ulHeader);
+
+      if (!PROFILE_RECORD_VALID(ulHeader) || ((pulRecord + PROFILE_RECORD_WORDS(ucSize)) > profile_page_end(pulActivePage)))
+      {
+         bLogDirty = true;
+         break;
+      }
+
+      if (ucID < CHANNEL_PROFILE_COUNT)
+         apulRecord[ucID] = ucSize ? pulRecord : NULL; // empty record erases the profile
+      else if ((ucID == PROFILE_BOOT_ID) && (ucSize == 1))
+         ucBootProfile = *(const uint8_t *)(pulRecord + 1);
+
+      pulRecord += PROFILE_RECORD_WORDS(ucSize);
+   }
+
+   pulLogEnd = (uint32_t *)pulRecord;
+}
+
+static bool profile_flash_wait(uint32_t ulErrCode)
+{
+   if (ulErrCode != NRF_SUCCESS)
+      return false;
+
+   while (System_FlashBusy());
+
+   return !System_FlashFailed();
+}
+
+static bool profile_blank(const uint32_t *pulData, uint16_t usWords)
+{
+   while (usWords--)
+   {
+      if (*pulData++ != PROFILE_FLASH_ERASED)
+         return false;
+   }
+
+   return true;
+}
+
+// Write a record at the given location, data first, header last.
+static bool profile_record_write(uint32_t *pulDest, uint8_t ucID, const uint8_t *pucData, uint8_t ucSize)
+{
+   uint32_t aulRecord[PROFILE_RECORD_WORDS(CHANNEL_PROFILE_MAX_SIZE)];
+   uint8_t ucWords = PROFILE_RECORD_WORDS(ucSize);
+
+   aulRecord[0] = PROFILE_RECORD_HEADER(ucID, ucSize);
+   memset(&aulRecord[1], 0xFF, (ucWords - 1) * sizeof(uint32_t));
+   memcpy(&aulRecord[1], pucData, ucSize);
+
+   if ((ucWords > 1) && !profile_flash_wait(System_FlashWrite(pulDest + 1, &aulRecord[1], ucWords - 1)))
+      return false;
+
+   return profile_flash_wait(System_FlashWrite(pulDest, &aulRecord[0], 1));
+}
+
+// Copy the latest records to the other page, leaving room for a record of usWords,
+// and make it the active page. ucSkipID is about to be replaced and is not copied.
+static uint8_t profile_compact(uint16_t usWords, uint8_t ucSkipID)
+{
+   uint32_t *pulPage = (pulActivePage == apulPage[0]) ? apulPage[1] : apulPage[0];
+   uint32_t *pulDest = pulPage + 1;
+   uint32_t ulHeader = PROFILE_PAGE_MARKER;
+   uint16_t usLive = usWords + PROFILE_RECORD_WORDS(1);
+
+   for (uint8_t i = 0; i < CHANNEL_PROFILE_COUNT; i++)
+   {
+      if ((apulRecord[i] != NULL) && (i != ucSkipID))
+         usLive += PROFILE_RECORD_WORDS(PROFILE_RECORD_SIZE(*apulRecord[i]));
+   }
+
+   if ((pulPage + 1 + usLive) > profile_page_end(pulPage))
+      return NVM_FULL_ERROR;
+
+   if (!profile_blank(pulPage, ulPageSize / sizeof(uint32_t)) &&
+       !profile_flash_wait(System_FlashPageErase((uint32_t)((uintptr_t)pulPage / ulPageSize))))
+      return NVM_WRITE_ERROR;
+
+   for (uint8_t i = 0; i < CHANNEL_PROFILE_COUNT; i++)
+   {
+      if ((apulRecord[i] != NULL) && (i != ucSkipID))
+      {
+         uint8_t ucSize = PROFILE_RECORD_SIZE(*apulRecord[i]);
+
+         if (!profile_record_write(pulDest, i, (const uint8_t *)(apulRecord[i] + 1), ucSize))
+            return NVM_WRITE_ERROR;
+         pulDest += PROFILE_RECORD_WORDS(ucSize);
+      }
+   }
+
+   if ((ucBootProfile != CHANNEL_PROFILE_NONE) && (ucSkipID != PROFILE_BOOT_ID))
+   {
+      if (!profile_record_write(pulDest, PROFILE_BOOT_ID, &ucBootProfile, 1))
+         return NVM_WRITE_ERROR;
+   }
+
+   if (pulActivePage != NULL)
+      ulHeader |= (uint16_t)(pulActivePage[0] + 1);
+
+   if (!profile_flash_wait(System_FlashWrite(pulPage, &ulHeader, 1)))
+      return NVM_WRITE_ERROR;
+
+   pulActivePage = pulPage;
+   profile_scan();
+
+   return RESPONSE_NO_ERROR;
+}
+
+static uint8_t profile_append(uint8_t ucID, const uint8_t *pucData, uint8_t ucSize)
+{
+   uint16_t usWords = PROFILE_RECORD_WORDS(ucSize);
+
+   if ((pulActivePage == NULL) || bLogDirty ||
+       ((pulLogEnd + usWords) > profile_page_end(pulActivePage)) ||
+       !profile_blank(pulLogEnd, usWords))
+   {
+      uint8_t ucResponse = profile_compact(usWords, ucID);
+
+      if (ucResponse != RESPONSE_NO_ERROR)
+         return ucResponse;
+   }
+
+   if (!profile_record_write(pulLogEnd, ucID, pucData, ucSize))
+   {
+      profile_scan();
+      return NVM_WRITE_ERROR;
+   }
+
+   profile_scan();
+   return RESPONSE_NO_ERROR;
+}
+
+void channel_profile_init(void)
+{
+   ulPageSize = NRF_FICR->CODEPAGESIZE;
+
+#if defined (CHANNEL_PROFILE_FLASH_START)
+   apulPage[0] = (uint32_t *)CHANNEL_PROFILE_FLASH_START;
+#else
+   apulPage[0] = (uint32_t *)((NRF_FICR->CODESIZE - 2) * ulPageSize);
+#endif
+   apulPage[1] = (uint32_t *)((uint8_t *)apulPage[0] + ulPageSize);
+
+   if (profile_page_valid(apulPage[0]) && profile_page_valid(apulPage[1]))
+      pulActivePage = ((int16_t)(apulPage[1][0] - apulPage[0][0]) > 0) ? apulPage[1] : apulPage[0];
+   else if (profile_page_valid(apulPage[0]))
+      pulActivePage = apulPage[0];
+   else if (profile_page_valid(apulPage[1]))
+      pulActivePage = apulPage[1];
+   else
+      pulActivePage = NULL;
+
+   profile_scan();
+}
+
+uint8_t channel_profile_store(uint8_t ucProfile, const uint8_t *pucData, uint8_t ucSize, bool bAppend)
+{
+   uint8_t aucContent[CHANNEL_PROFILE_MAX_SIZE];
+   uint8_t ucStored = 0;
+
+   if (ucProfile >= CHANNEL_PROFILE_COUNT)
+      return INVALID_PARAMETER_PROVIDED;
+
+   if (bAppend && (apulRecord[ucProfile] != NULL))
+      ucStored = PROFILE_RECORD_SIZE(*apulRecord[ucProfile]);
+
+   if ((ucSize == 0) || (ucSize > (CHANNEL_PROFILE_MAX_SIZE - ucStored)))
+      return INVALID_PARAMETER_PROVIDED;
+
+   memcpy(aucContent, apulRecord[ucProfile] + 1, ucStored); // the record may move when the log is compacted
+   memcpy(&aucContent[ucStored], pucData, ucSize);
+
+   return profile_append(ucProfile, aucContent, ucStored + ucSize);
+}
+
+uint8_t channel_profile_erase(uint8_t ucProfile)
+{
+   if (ucProfile >= CHANNEL_PROFILE_COUNT)
+      return INVALID_PARAMETER_PROVIDED;
+
+   if (apulRecord[ucProfile] == NULL)
+      return RESPONSE_NO_ERROR;
+
+   return profile_append(ucProfile, NULL, 0);
+}
+
+const uint8_t *channel_profile_get(uint8_t ucProfile, uint8_t *pucSize)
+{
+   if ((ucProfile >= CHANNEL_PROFILE_COUNT) || (apulRecord[ucProfile] == NULL))
+      return NULL;
+
+   *pucSize = PROFILE_RECORD_SIZE(*apulRecord[ucProfile]);
+   return (const uint8_t *)(apulRecord[ucProfile] + 1);
+}
+
+uint8_t channel_profile_boot_set(uint8_t ucProfile)
+{
+   if ((ucProfile >= CHANNEL_PROFILE_COUNT) && (ucProfile != CHANNEL_PROFILE_NONE))
+      return INVALID_PARAMETER_PROVIDED;
+
+   if (ucProfile == ucBootProfile)
+      return RESPONSE_NO_ERROR;
+
+   return profile_append(PROFILE_BOOT_ID, &ucProfile, 1);
+}
+
+uint8_t channel_profile_boot_get(void)
+{
+   return ucBootProfile;
+}
+
+uint8_t channel_profile_stored_get(void)
+{
+   uint8_t ucMask = 0;
+
+   for (uint8_t i = 0; i < CHANNEL_PROFILE_COUNT; i++)
+   {
+      if (apulRecord[i] != NULL)
+         ucMask |= (uint8_t)(1 << i);
+   }
+
+   return ucMask;
+}
+
+uint16_t channel_profile_free_get(void)
+{
+   if (pulActivePage == NULL)
+      return (uint16_t)(ulPageSize - sizeof(uint32_t));
+
+   if (bLogDirty)
+      return 0;
+
+   return (uint16_t)((profile_page_end(pulActivePage) - pulLogEnd) * sizeof(uint32_t));
+}
@@ -19,10 +19,15 @@ All rights reserved.
 #include "ant_error.h"
 #include "appconfig.h"
 #include "boardconfig.h"
+#include "channel_profile.h"
+#include "cycle_profile.h"
 #include "dsi_utility.h"
 #include "event_buffering.h"
+#include "event_trace.h"
 #include "global.h"
 #include "main.h"
+#include "multi_ctx_fifo.h"
+#include "ram_arena.h"
 #include "serial.h"
 #include "system.h"
 #include "nrf_error.h"
@@ -57,6 +62,32 @@ All rights reserved.
 #else
    //#error "MESG_SET_SERIAL_NUM_ID: already defined, check ant_parameters.h"
 #endif
+#ifndef MESG_COMMAND_BATCH_ID
+   #define MESG_COMMAND_BATCH_ID          ((uint16_t)0xE414) ///< ANT application - sequence of commands processed back to back
+#endif
+
+#define COMMAND_BATCH_SUB_ID_SIZE         ((uint8_t)1) // sub ID of the batch message
+#define COMMAND_BATCH_HEADER_SIZE         ((uint8_t)2) // size and message ID of each batched command
+#define COMMAND_BATCH_COUNT_OFFSET        ((uint8_t)0) // offset to the number of processed commands in the batch response
+#define COMMAND_BATCH_RESPONSE_OFFSET     ((uint8_t)1) // offset to the response codes in the batch response
+
+#ifndef MESG_CHANNEL_PROFILE_ID
+   #define MESG_CHANNEL_PROFILE_ID        ((uint16_t)0xE415) ///< ANT application - channel profiles stored in flash
+#endif
+
+#define CHANNEL_PROFILE_OP_OFFSET         ((uint8_t)0) // offset to the operation
+#define CHANNEL_PROFILE_NUMBER_OFFSET     ((uint8_t)1) // offset to the profile number
+#define CHANNEL_PROFILE_DATA_OFFSET       ((uint8_t)2) // offset to the batched commands to store
+#define CHANNEL_PROFILE_COUNT_OFFSET      ((uint8_t)2) // offset to the number of commands applied in the apply response
+#define CHANNEL_PROFILE_RESPONSE_OFFSET   ((uint8_t)3) // offset to the response code of the last applied command
+#define CHANNEL_PROFILE_APPLY_SIZE        ((uint8_t)5)
+#define CHANNEL_PROFILE_REQ_SIZE          ((uint8_t)5)
+
+#define CHANNEL_PROFILE_OP_STORE          ((uint8_t)0) // replace the profile with the batched commands
+#define CHANNEL_PROFILE_OP_APPEND         ((uint8_t)1) // add the batched commands to the profile
+#define CHANNEL_PROFILE_OP_ERASE          ((uint8_t)2)
+#define CHANNEL_PROFILE_OP_APPLY          ((uint8_t)3)
+#define CHANNEL_PROFILE_OP_BOOT           ((uint8_t)4) // apply the profile at startup, CHANNEL_PROFILE_NONE for none
 
 #if  defined(D52Q_PREMIUM_MODULE)|| defined(D52M_PREMIUM_MODULE)
    #define EXT_DEV_ID_TRANS_T_LOC         4           // Extended device ID uses bits 4-7 of trans type
@@ -77,16 +108,148 @@ All rights reserved.
 #define EVENT_FILTER_PROHIBITED_EVENTS    (FILTER_EVENT_TRANSFER_TX_COMPLETED | FILTER_EVENT_TRANSFER_TX_FAILED)
 uint16_t usEventFilterMask = 0;           // Mask to use for internal event filtering
 
+/*
+ * Burst staging queue. Host burst packets are staged here and handed to the burst handler one at a time,
+ * paced by the transfer events, so the host does not have to wait for the radio before sending the next one.
+ */
+typedef struct
+{
+   uint8_t ucChannel;
+   uint8_t ucSegment;
+   uint8_t ucMesgID;
+   uint8_t ucSize;
+   uint8_t aucData[MESG_MAX_DATA_SIZE];
+} BURST_RECORD;
+
+#define BURST_RECORD_HEADER_SIZE          ((uint8_t)4) // staged size of a record without data
+
+static multi_ctx_fifo_t stBurstFifo;
+static uint8_t ucBurstFeedChannel;        // channel waiting for the burst handler to ask for more data, 0xFF if none
+static uint8_t ucBurstDiscardChannel;     // channel whose failed burst is discarded up to its last packet, 0xFF if none
+
+static void Command_BurstFeed(void);
+static void Command_BurstFeedError(BURST_RECORD *pstRecord, uint8_t ucResponse);
+
+/*
+ * Channel ID last set on each master channel, so extended data messages only set the ID when it changes.
+ * Slave channels are not shadowed as the ANT stack replaces their wildcards once paired.
+ */
+typedef struct
+{
+   uint16_t usDeviceNumber;
+   uint8_t ucDeviceType;
+   uint8_t ucTransType;
+   bool bMaster;                          // channel is assigned as a master
+   bool bValid;                           // the ID fields match the channel ID set in the ANT stack
+} CHANNEL_ID_SHADOW;
+
+static CHANNEL_ID_SHADOW astChannelIDShadow[ANT_STACK_TOTAL_CHANNELS_ALLOCATED_MAX];
+
+static void Command_ChannelIDShadowSet(uint8_t ucChannel, uint8_t *pucID, uint8_t ucResponse);
+static uint8_t Command_ChannelIDUpdate(uint8_t ucChannel, uint8_t *pucID);
+
+static bool bBatchProcess;                // processing the commands of a batch, their responses are collected instead of sent
+static uint8_t ucBatchResponse;           // response of the last batched command
+
+static uint8_t Command_BatchRun(const uint8_t *pucBatch, uint8_t ucBatchSize, uint8_t *pucResponses, uint8_t ucMaxResponses);
+static void Command_BatchProcess(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage);
+static uint8_t Command_ProfileProcess(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage);
+static void Command_ProfileApply(uint8_t ucProfile, ANT_MESSAGE *pstTxMessage);
+
+/*
+ * Command dispatch. Messages are looked up by message ID, extended messages by page and sub ID, and
+ * requests by the requested message ID in the same entries, so a message costs one table read whatever its ID.
+ */
+typedef void (*COMMAND_HANDLER)(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp);
+
+typedef struct
+{
+   COMMAND_HANDLER pfCommand;             // handles the message, NULL if not supported
+   COMMAND_HANDLER pfRequest;             // answers a request for the message, NULL if not supported
+   uint8_t ucMinSize;                     // smallest message size holding all the fields read unconditionally
+   uint8_t ucFlags;
+} COMMAND_ENTRY;
+
+typedef struct
+{
+   const COMMAND_ENTRY *pastEntry;        // indexed by sub ID
+   uint8_t ucCount;
+} COMMAND_EXT_PAGE;
+
+#define COMMAND_FLAG_CHANNEL              ((uint8_t)0x01) // channel number must be below the number of channels
+#define COMMAND_FLAG_NETWORK              ((uint8_t)0x02) // channel number is a network number
+#define COMMAND_FLAG_BURST                ((uint8_t)0x04) // answered by the burst handler once queued
+
+#define COMMAND_MIN_SIZE(size)            ((uint8_t)(MESG_CHANNEL_NUM_SIZE + (size))) // channel number or sub ID, then data
+
+static const COMMAND_ENTRY astCommandTable[256];
+static const COMMAND_ENTRY *Command_ExtEntry(uint16_t usExtID);
+
+/**
+ * @brief ANT serial command handler initialization
+ */
+void Command_Init(void)
+{
+   mc_fifo_init(&stBurstFifo, COMMAND_BURST_STAGING_QUEUE_SIZE);
+   (void)ram_arena_fifo_grow(&stBurstFifo, COMMAND_BURST_STAGING_QUEUE_SIZE_MAX);
+   ucBurstFeedChannel = 0xFF;
+   ucBurstDiscardChannel = 0xFF;
+   memset(astChannelIDShadow, 0, sizeof(astChannelIDShadow)); // channels are unassigned after the ANT stack is enabled
+}
+
+/**
+ * @brief Record the result of setting the channel ID of a channel, pucID as device number, device type and transmission type
+ */
+static void Command_ChannelIDShadowSet(uint8_t ucChannel, uint8_t *pucID, uint8_t ucResponse)
+{
+   CHANNEL_ID_SHADOW *pstShadow;
+
+   if (ucChannel >= ANT_STACK_TOTAL_CHANNELS_ALLOCATED_MAX)
+      return;
+
+   pstShadow = &astChannelIDShadow[ucChannel];
+   pstShadow->usDeviceNumber = DSI_GetUShort(pucID);
+   pstShadow->ucDeviceType = pucID[2];
+   pstShadow->ucTransType = pucID[3];
+   pstShadow->bValid = pstShadow->bMaster && (ucResponse == RESPONSE_NO_ERROR);
+}
+
+/**
+ * @brief Set the channel ID of a channel unless it is known to be set already, pucID as in Command_ChannelIDShadowSet
+ */
+static uint8_t Command_ChannelIDUpdate(uint8_t ucChannel, uint8_t *pucID)
+{
+   uint8_t ucResponse;
+
+   if ((ucChannel < ANT_STACK_TOTAL_CHANNELS_ALLOCATED_MAX) &&
+       astChannelIDShadow[ucChannel].bValid &&
+       (astChannelIDShadow[ucChannel].usDeviceNumber == DSI_GetUShort(pucID)) &&
+       (astChannelIDShadow[ucChannel].ucDeviceType == pucID[2]) &&
+       (astChannelIDShadow[ucChannel].ucTransType == pucID[3]))
+   {
+      return RESPONSE_NO_ERROR;
+   }
+
+   ucResponse = (uint8_t)sd_ant_channel_id_set(ucChannel, DSI_GetUShort(pucID), pucID[2], pucID[3]);
+   Command_ChannelIDShadowSet(ucChannel, pucID, ucResponse);
+
+   return ucResponse;
+}
+
 /**
  * @brief ANT serial burst command message handler
  */
 bool Command_BurstMessageProcess(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage)
 {
    COMMAND_RESPONSE stCmdResp;
-   uint8_t ucBurstSegment = 0;
+   BURST_RECORD stRecord;
+   uint8_t ucNextSequence = ucBurstSequence;
    uint8_t ucSequence = pstRxMessage->ANT_MESSAGE_ucChannel & SEQUENCE_NUMBER_MASK;
 
-   pstRxMessage->ANT_MESSAGE_ucChannel &= ~SEQUENCE_NUMBER_MASK;
+   // The message is left untouched as it is processed again if the staging queue is full.
+   stRecord.ucChannel = pstRxMessage->ANT_MESSAGE_ucChannel & ~SEQUENCE_NUMBER_MASK;
+   stRecord.ucSegment = 0;
+   stRecord.ucMesgID = pstRxMessage->ANT_MESSAGE_ucMesgID;
 
    if ((uint8_t)(ucBurstSequence << 1) != (uint8_t)(ucSequence << 1))
    {
@@ -96,875 +259,1364 @@ bool Command_BurstMessageProcess(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMe
    else // sequence match
    {
       if ((uint8_t)(ucSequence << 1) == (uint8_t)(SEQUENCE_NUMBER_ROLLOVER << 1))
-         ucBurstSequence = SEQUENCE_NUMBER_INC;
+         ucNextSequence = SEQUENCE_NUMBER_INC;
       else
-         ucBurstSequence += SEQUENCE_NUMBER_INC;
+         ucNextSequence += SEQUENCE_NUMBER_INC;
 
       if ((uint8_t)(ucSequence << 1) == (uint8_t)(SEQUENCE_FIRST_MESSAGE << 1))
       {
-         ucBurstSegment |= BURST_SEGMENT_START;
+         stRecord.ucSegment |= BURST_SEGMENT_START;
       }
 
       if (ucSequence & SEQUENCE_LAST_MESSAGE)
       {
-         ucBurstSequence = 0;
-         ucBurstSegment |= BURST_SEGMENT_END;
+         ucNextSequence = 0;
+         stRecord.ucSegment |= BURST_SEGMENT_END;
       }
 
       if (pstRxMessage->ANT_MESSAGE_ucMesgID == MESG_EXT_BURST_DATA_ID)
       {
-         stCmdResp.ucResponse = (uint8_t)sd_ant_burst_handler_request(pstRxMessage->ANT_MESSAGE_ucChannel, pstRxMessage->ANT_MESSAGE_ucSize-(ANT_ID_SIZE + MESG_CHANNEL_NUM_SIZE), pstRxMessage->ANT_MESSAGE_aucPayload + ANT_ID_SIZE, ucBurstSegment);
-         if (!stCmdResp.ucResponse)
-            stCmdResp.ucResponse = NO_RESPONSE_MESSAGE;
-      }
-      else if (pstRxMessage->ANT_MESSAGE_ucMesgID == MESG_ADV_BURST_DATA_ID)
-      {
-         stCmdResp.ucResponse = (uint8_t)sd_ant_burst_handler_request(pstRxMessage->ANT_MESSAGE_ucChannel, (pstRxMessage->ANT_MESSAGE_ucSize-MESG_CHANNEL_NUM_SIZE), pstRxMessage->ANT_MESSAGE_aucPayload, ucBurstSegment);
-         if (!stCmdResp.ucResponse)
-            stCmdResp.ucResponse = NO_RESPONSE_MESSAGE;
+         stRecord.ucSize = pstRxMessage->ANT_MESSAGE_ucSize-(ANT_ID_SIZE + MESG_CHANNEL_NUM_SIZE);
+         memcpy(stRecord.aucData, pstRxMessage->ANT_MESSAGE_aucPayload + ANT_ID_SIZE, stRecord.ucSize);
       }
-      else
+      else // MESG_BURST_DATA_ID and MESG_ADV_BURST_DATA_ID
       {
-         stCmdResp.ucResponse = (uint8_t)sd_ant_burst_handler_request(pstRxMessage->ANT_MESSAGE_ucChannel, (pstRxMessage->ANT_MESSAGE_ucSize-MESG_CHANNEL_NUM_SIZE), pstRxMessage->ANT_MESSAGE_aucPayload, ucBurstSegment);
-         if (!stCmdResp.ucResponse)
-            stCmdResp.ucResponse = NO_RESPONSE_MESSAGE;
+         stRecord.ucSize = pstRxMessage->ANT_MESSAGE_ucSize-MESG_CHANNEL_NUM_SIZE;
+         memcpy(stRecord.aucData, pstRxMessage->ANT_MESSAGE_aucPayload, stRecord.ucSize);
       }
 
-      if (stCmdResp.ucResponse == NO_RESPONSE_MESSAGE) // input data successfully queued for processing, do not release receive buffer
+      if (!mc_fifo_push(&stBurstFifo, &stRecord, BURST_RECORD_HEADER_SIZE + stRecord.ucSize))
       {
-          return true;
+         return true; // staging queue is full, do not release receive buffer
       }
-      else
-         ucBurstSequence = 0; // reset sequence check, if failed
+
+      ucBurstSequence = ucNextSequence;
+      stCmdResp.ucResponse = NO_RESPONSE_MESSAGE; // input data successfully staged, the receive buffer can take the next packet
+      Command_BurstFeed();
    }
 
-   stCmdResp.ucChannel    = pstRxMessage->ANT_MESSAGE_ucChannel & CHANNEL_NUMBER_MASK;
+   stCmdResp.ucChannel    = stRecord.ucChannel & CHANNEL_NUMBER_MASK;
    stCmdResp.ucResponseID = pstRxMessage->ANT_MESSAGE_ucMesgID;
    stCmdResp.bExtIDResponse = false;
 
    Command_ResponseMessage(stCmdResp, pstTxMessage); // send a response message if there is one and release the receive buffer
    return false;
 }
+
 /**
- * @brief ANT serial command message handler
+ * @brief ANT burst transfer event handler, feeds the burst handler from the burst staging queue
  */
-void Command_SerialMessageProcess(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage)
+void Command_BurstTransferEvent(uint8_t ucEvent, uint8_t ucChannel)
 {
-   COMMAND_RESPONSE stCmdResp;
-   uint16_t usExtID;
-   uint16_t usTemp;
-
-   // initialize a response message
-   stCmdResp.ucChannel    = pstRxMessage->ANT_MESSAGE_ucChannel & CHANNEL_NUMBER_MASK; // save the channel number for the response
-   stCmdResp.ucResponseID = pstRxMessage->ANT_MESSAGE_ucMesgID; // save the message ID
-   stCmdResp.ucResponse   = RESPONSE_NO_ERROR; // initialize the response field to no error
-   stCmdResp.bExtIDResponse = false; // by default, non-extended ID response
-
-   if (pstTxMessage != NULL)
-      pstTxMessage->ANT_MESSAGE_ucSize = 0;   // init the transmit message size to 0
-
-   #if defined (USE_INTERFACE_LOCK)
-      if (bInterfaceLock) // handles interface lockout condition
-      {
-         if (pstRxMessage->ANT_MESSAGE_ucMesgID == MESG_UNLOCK_INTERFACE_ID)
-            bInterfaceLock = false;
-         else
-            stCmdResp.ucResponse = RETURN_TO_MFG; // standard response when interface locked out
-
-         if (pstTxMessage != NULL)
-            Command_ResponseMessage(stCmdResp, pstTxMessage);
-
-         return;
-      }
-   #endif // USE_INTERFACE_LOCK
+   if (ucBurstFeedChannel == 0xFF) // no staged packet was handed to the burst handler
+      return;
 
-   if ((stCmdResp.ucChannel < stANTChannelEnable.ucTotalNumberOfChannels) ||
-       (MAX_NETWORKS > stANTChannelEnable.ucTotalNumberOfChannels && pstRxMessage->ANT_MESSAGE_ucMesgID == MESG_NETWORK_KEY_ID) ||
-       ((pstRxMessage->ANT_MESSAGE_ucMesgID & MSG_EXT_ID_MASK) == MSG_EXT_ID_MASK))
+   if ((ucBurstFeedChannel == (ucChannel & CHANNEL_NUMBER_MASK)) || // event and fed channel number matches
+       (ucEvent == EVENT_QUE_OVERFLOW)) // queue overflow (channel events might be lost)
    {
-      switch (stCmdResp.ucResponseID)
-      {
-         ///////////////////////////////////////////////////////////////////////
-         // Data Messages
-         ///////////////////////////////////////////////////////////////////////
-         case MESG_EXT_BURST_DATA_ID:
-            if ((pstRxMessage->ANT_MESSAGE_ucChannel & SEQUENCE_NUMBER_ROLLOVER) == SEQUENCE_FIRST_MESSAGE)
-            {
-               stCmdResp.ucResponse = (uint8_t)sd_ant_channel_id_set(stCmdResp.ucChannel,
-                                                         ((uint16_t)pstRxMessage->ANT_MESSAGE_aucPayload[1] << 8) |  ((uint16_t)pstRxMessage->ANT_MESSAGE_aucPayload[0]), // only try to set the ID if this is the initial burst packet
-                                                         pstRxMessage->ANT_MESSAGE_aucPayload[2],
-                                                         pstRxMessage->ANT_MESSAGE_aucPayload[3]);
-
-               if (stCmdResp.ucResponse != RESPONSE_NO_ERROR)
-                  break; // break and respond with error if the ID was not set correctly
-            }
-            //fall thru
-         case MESG_BURST_DATA_ID:
-         case MESG_ADV_BURST_DATA_ID:
-            Main_SetQueuedBurst();
-            stCmdResp.ucResponse = NO_RESPONSE_MESSAGE;
-            return;
-         case MESG_EXT_ACKNOWLEDGED_DATA_ID:
-            sd_ant_channel_id_set(stCmdResp.ucChannel,
-                              ((uint16_t)pstRxMessage->ANT_MESSAGE_aucPayload[1] << 8) |  ((uint16_t)pstRxMessage->ANT_MESSAGE_aucPayload[0]),
-                                 pstRxMessage->ANT_MESSAGE_aucPayload[2],
-                                 pstRxMessage->ANT_MESSAGE_aucPayload[3]);
-            stCmdResp.ucResponse = (uint8_t)sd_ant_acknowledge_message_tx(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_ucSize-(ANT_ID_SIZE+MESG_CHANNEL_NUM_SIZE), pstRxMessage->ANT_MESSAGE_aucPayload + ANT_ID_SIZE);
-            if (!stCmdResp.ucResponse)
-               stCmdResp.ucResponse = NO_RESPONSE_MESSAGE;
-            break;
-         case MESG_ACKNOWLEDGED_DATA_ID:
-            stCmdResp.ucResponse = (uint8_t)sd_ant_acknowledge_message_tx(stCmdResp.ucChannel, (pstRxMessage->ANT_MESSAGE_ucSize-MESG_CHANNEL_NUM_SIZE), pstRxMessage->ANT_MESSAGE_aucPayload);
-            if (!stCmdResp.ucResponse)
-               stCmdResp.ucResponse = NO_RESPONSE_MESSAGE;
-            break;
-         case MESG_EXT_BROADCAST_DATA_ID:
-            sd_ant_channel_id_set(stCmdResp.ucChannel,
-                              ((uint16_t)pstRxMessage->ANT_MESSAGE_aucPayload[1] << 8) |  ((uint16_t)pstRxMessage->ANT_MESSAGE_aucPayload[0]),
-                              pstRxMessage->ANT_MESSAGE_aucPayload[2],
-                              pstRxMessage->ANT_MESSAGE_aucPayload[3]);
-            stCmdResp.ucResponse = (uint8_t)sd_ant_broadcast_message_tx(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_ucSize-(ANT_ID_SIZE+MESG_CHANNEL_NUM_SIZE), pstRxMessage->ANT_MESSAGE_aucPayload + ANT_ID_SIZE);
-            if (!stCmdResp.ucResponse)
-               stCmdResp.ucResponse = NO_RESPONSE_MESSAGE;
-            break;
-         case MESG_BROADCAST_DATA_ID:
-            stCmdResp.ucResponse = (uint8_t)sd_ant_broadcast_message_tx(stCmdResp.ucChannel, (pstRxMessage->ANT_MESSAGE_ucSize-MESG_CHANNEL_NUM_SIZE), pstRxMessage->ANT_MESSAGE_aucPayload);
-            if (!stCmdResp.ucResponse)
-               stCmdResp.ucResponse = NO_RESPONSE_MESSAGE;
-            break;
-
-         ///////////////////////////////////////////////////////////////////////
-         // Request Messages
-         ///////////////////////////////////////////////////////////////////////
-         case MESG_REQUEST_ID:
-            if (pstTxMessage == NULL) // don't allow request messages if no transmit buffer provided
-               break;
-
-            pstTxMessage->ANT_MESSAGE_ucChannel = stCmdResp.ucChannel;
-
-            switch (pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1])
-            {
-               case MESG_CHANNEL_STATUS_ID:
-                  stCmdResp.ucResponse = sd_ant_channel_status_get(stCmdResp.ucChannel, &pstTxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
-                  if (!stCmdResp.ucResponse)
-                  {
-                     pstTxMessage->ANT_MESSAGE_ucSize   = MESG_CHANNEL_STATUS_SIZE;
-                     pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_CHANNEL_STATUS_ID;
-                     // the channel number field has already been filled in
-                  }
-                  break;
-
-               case MESG_CHANNEL_ID_ID:
-                  stCmdResp.ucResponse = sd_ant_channel_id_get(stCmdResp.ucChannel,
-                                                              (uint16_t*)&usTemp,
-                                                              (uint8_t*)&pstTxMessage->ANT_MESSAGE_aucPayload[2],
-                                                              (uint8_t*)&pstTxMessage->ANT_MESSAGE_aucPayload[3]);
-                  if (!stCmdResp.ucResponse)
-                  {
-                     pstTxMessage->ANT_MESSAGE_ucSize   = MESG_CHANNEL_ID_SIZE;
-                     pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_CHANNEL_ID_ID;
-                     // the channel number field has already been filled in
-
-                     pstTxMessage->ANT_MESSAGE_aucPayload[0] = (uint8_t)usTemp;
-                     pstTxMessage->ANT_MESSAGE_aucPayload[1] = (uint8_t)(usTemp >> 8);
-                  }
-                  break;
-
-               case MESG_CAPABILITIES_ID:
-                  stCmdResp.ucResponse = sd_ant_capabilities_get(pstTxMessage->ANT_MESSAGE_aucMesgData);
-                  if (!stCmdResp.ucResponse)
-                  {
-                     pstTxMessage->ANT_MESSAGE_ucSize = MESG_CAPABILITIES_SIZE;
-                     pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_CAPABILITIES_ID;
-                     //serial number support is provided by the application level, insert if application supports it
-                     pstTxMessage->ANT_MESSAGE_aucMesgData[3] |= CAPABILITIES_SERIAL_NUMBER_ENABLED;
-                     //event buffering is also provided at application level.
-                     pstTxMessage->ANT_MESSAGE_aucMesgData[6] |= CAPABILITIES_EVENT_BUFFERING_ENABLED;
-                  }
-                  break;
-
-               case MESG_VERSION_ID:
-                  /*Returns Application version number*/
-                  if (pstTxMessage->ANT_MESSAGE_ucChannel == 0)
-               #if !defined (TEST_SD_OUTPUT_FW_VERSION)
-                  {
-                     pstTxMessage->ANT_MESSAGE_ucSize = 11;
-                     pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_VERSION_ID;
-                     memcpy(pstTxMessage->ANT_MESSAGE_aucMesgData, acAppVersion, APP_VERSION_SIZE);
-                  }
-                  /*Returns Softdevice version number*/
-                  else if (pstTxMessage->ANT_MESSAGE_ucChannel == 1)
-               #endif //TEST_SD_OUTPUT_FW_VERSION
-                  {
-                     stCmdResp.ucResponse = sd_ant_version_get(pstTxMessage->ANT_MESSAGE_aucMesgData);
-                     if (!stCmdResp.ucResponse)
-                     {
-                        pstTxMessage->ANT_MESSAGE_ucSize = MESG_VERSION_SIZE;
-                        pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_VERSION_ID;
-                     }
-                  }
-                  /*Chan Number must only be 0=App or 1=Softdevice*/
-                  else
-                  {
-                     stCmdResp.ucResponse = INVALID_MESSAGE;
-                  }
-                  break;
-
-
-            #if !defined (SERIAL_NUMBER_NOT_AVAILABLE)
-               case MESG_GET_SERIAL_NUM_ID:
-                  /* Returns serial number identifying the device */
-                  System_GetSerialNumberMesg(pstTxMessage);
-                  break;
-            #endif // !SERIAL_NUMBER_NOT_AVAILABLE
-
-               case MESG_CONFIG_ADV_BURST_ID:
-                  stCmdResp.ucResponse = sd_ant_adv_burst_config_get(stCmdResp.ucChannel, pstTxMessage->ANT_MESSAGE_aucMesgData);
-                  if (!stCmdResp.ucResponse)
-                  {
-                     if (stCmdResp.ucChannel)
-                        pstTxMessage->ANT_MESSAGE_ucSize = MESG_CONFIG_ADV_BURST_REQ_CONFIG_SIZE;
-                     else
-                        pstTxMessage->ANT_MESSAGE_ucSize = MESG_CONFIG_ADV_BURST_REQ_CAPABILITIES_SIZE;
-
-                     pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_CONFIG_ADV_BURST_ID;
-                  }
-                  break;
-
-               case MESG_COEX_PRIORITY_CONFIG_ID:
-               {
-                  ANT_BUFFER_PTR stBuf;
-                  stBuf.pucBuffer = pstTxMessage->ANT_MESSAGE_aucPayload;
-                  stBuf.ucBufferSize = MESG_MAX_DATA_SIZE;
-                  stCmdResp.ucResponse = sd_ant_coex_config_get(stCmdResp.ucChannel, &stBuf, NULL);
-                  if (!stCmdResp.ucResponse)
-                  {
-                     pstTxMessage->ANT_MESSAGE_ucSize = stBuf.ucBufferSize + MESG_CHANNEL_NUM_SIZE;
-                     pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_COEX_PRIORITY_CONFIG_ID;
-                  }
-               }
-               break;
-
-               case MESG_COEX_ADV_PRIORITY_CONFIG_ID:
-               {
-                  ANT_BUFFER_PTR stBuf;
-                  stBuf.pucBuffer = pstTxMessage->ANT_MESSAGE_aucPayload;
-                  stBuf.ucBufferSize = MESG_MAX_DATA_SIZE;
-                  stCmdResp.ucResponse = sd_ant_coex_config_get(stCmdResp.ucChannel, NULL, &stBuf);
-                  if (!stCmdResp.ucResponse)
-                  {
-                     pstTxMessage->ANT_MESSAGE_ucSize = stBuf.ucBufferSize + MESG_CHANNEL_NUM_SIZE;
-                     pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_COEX_ADV_PRIORITY_CONFIG_ID;
-                  }
-               }
-               break;
-
-               case MESG_HIGH_DUTY_SEARCH_MODE_ID:
-               {
-                  ANT_HIGH_DUTY_SEARCH_CONFIG stConfig;
-                  stCmdResp.ucResponse = sd_ant_high_duty_search_config_get(&stConfig);
-                  if (!stCmdResp.ucResponse)
-                  {
-                     pstTxMessage->ANT_MESSAGE_ucSize = MESG_HIGH_DUTY_SEARCH_MODE_REQ_SIZE;
-                     pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_HIGH_DUTY_SEARCH_MODE_ID;
-                     pstTxMessage->ANT_MESSAGE_aucPayload[0] = stConfig.bEnable;
-                     pstTxMessage->ANT_MESSAGE_aucPayload[1] = stConfig.ucSearchSuppressionWindows;
-                     pstTxMessage->ANT_MESSAGE_aucPayload[2] = (uint8_t)stConfig.usRestartInterval;
-                     pstTxMessage->ANT_MESSAGE_aucPayload[3] = (uint8_t)(stConfig.usRestartInterval >> 8);
-                  }
-               }
-               break;
-
-               case MESG_ACTIVE_SEARCH_SHARING_ID:
-                  stCmdResp.ucResponse = sd_ant_active_search_sharing_cycles_get(stCmdResp.ucChannel, &pstTxMessage->ANT_MESSAGE_aucPayload[0]);
-                  if (!stCmdResp.ucResponse)
-                  {
-                     pstTxMessage->ANT_MESSAGE_ucSize = MESG_ACTIVE_SEARCH_SHARING_REQ_SIZE;
-                     pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_ACTIVE_SEARCH_SHARING_ID;
-                  }
-                  break;
-
-
-               case MESG_EVENT_BUFFERING_CONFIG_ID:
-               {
-                  uint8_t ucConfig;
-                  uint16_t usSizeThreshold;
-                  uint16_t usTimeThreshold;
-                  event_buffering_config_get(&ucConfig, &usSizeThreshold, &usTimeThreshold);
-
-                  pstTxMessage->ANT_MESSAGE_ucSize = MESG_EVENT_BUFFERING_CONFIG_REQ_SIZE;
-                  pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_EVENT_BUFFERING_CONFIG_ID;
-
-                  pstTxMessage->ANT_MESSAGE_aucPayload[0] = ucConfig;
-                  DSI_PutUShort(usSizeThreshold, &pstTxMessage->ANT_MESSAGE_aucPayload[1]);
-                  DSI_PutUShort(usTimeThreshold, &pstTxMessage->ANT_MESSAGE_aucPayload[3]);
-               }
-               break;
-
-               case MESG_EVENT_FILTER_CONFIG_ID:
-                  stCmdResp.ucResponse = sd_ant_event_filtering_get((uint16_t*)&usTemp);
-                  // Add in events that are being filtered by the NP
-                  usTemp |= usEventFilterMask;
-                  if (!stCmdResp.ucResponse)
-                  {
-                     pstTxMessage->ANT_MESSAGE_ucSize = MESG_EVENT_FILTER_CONFIG_REQ_SIZE;
-                     pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_EVENT_FILTER_CONFIG_ID;
-
-                     pstTxMessage->ANT_MESSAGE_aucPayload[0] = (uint8_t)usTemp;
-                     pstTxMessage->ANT_MESSAGE_aucPayload[1] = (uint8_t)(usTemp >> 8);
-                  }
-                  break;
-
-               case MESG_SDU_SET_MASK_ID:
-                  stCmdResp.ucResponse = sd_ant_sdu_mask_get(stCmdResp.ucChannel, pstTxMessage->ANT_MESSAGE_aucPayload);
-                  if (!stCmdResp.ucResponse)
-                  {
-                     pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_SDU_SET_MASK_ID;
-                     pstTxMessage->ANT_MESSAGE_ucSize = MESG_ANT_MAX_PAYLOAD_SIZE + MESG_CHANNEL_NUM_SIZE;
-                  }
-                  break;
-
-               case MESG_ENCRYPT_ENABLE_ID:
-                  stCmdResp.ucResponse = sd_ant_crypto_info_get(stCmdResp.ucChannel, pstTxMessage->ANT_MESSAGE_aucPayload);
-                  if (!stCmdResp.ucResponse)
-                  {
-                     switch (stCmdResp.ucChannel)
-                     {
-                        case ENCRYPTION_INFO_GET_SUPPORTED_MODE:
-                           pstTxMessage->ANT_MESSAGE_ucSize = MESG_CONFIG_ENCRYPT_REQ_CAPABILITIES_SIZE;
-                           break;
-                        case ENCRYPTION_INFO_GET_CRYPTO_ID:
-                           pstTxMessage->ANT_MESSAGE_ucSize = MESG_CONFIG_ENCRYPT_REQ_CONFIG_ID_SIZE;
-                           break;
-                        case ENCRYPTION_INFO_GET_CUSTOM_USER_DATA:
-                           pstTxMessage->ANT_MESSAGE_ucSize = MESG_CONFIG_ENCRYPT_REQ_CONFIG_USER_DATA_SIZE;
-                           break;
-                     }
-
-                     pstTxMessage->ANT_MESSAGE_ucChannel = stCmdResp.ucChannel;
-                     pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_ENCRYPT_ENABLE_ID;
-                  }
-                  break;
-
-               case MESG_RFACTIVE_NOTIFICATION_ID:
-                  stCmdResp.ucResponse = sd_ant_rfactive_notification_config_get((uint8_t*)&pstTxMessage->ANT_MESSAGE_aucPayload[0], (uint16_t*)&usTemp);
-                  if (!stCmdResp.ucResponse)
-                  {
-                     pstTxMessage->ANT_MESSAGE_ucSize = MESG_RFACTIVE_NOTIFICATION_SIZE;
-                     pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_RFACTIVE_NOTIFICATION_ID;
-
-                     pstTxMessage->ANT_MESSAGE_aucPayload[1] = (uint8_t)usTemp;
-                     pstTxMessage->ANT_MESSAGE_aucPayload[2] = (uint8_t)(usTemp >> 8);
-                  }
-                  break;
-
-
-               case MESG_PA_LNA_CONFIG_ID:
-                  {
-                     ANT_PA_LNA_CONFIG stConfig;
-                     sd_ant_config_pa_lna_get(&stConfig);
-
-                     pstTxMessage->ANT_MESSAGE_ucSize = MESG_PA_LNA_CONFIG_SIZE;
-                     pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_PA_LNA_CONFIG_ID;
-                     pstTxMessage->ANT_MESSAGE_aucPayload[0] = ((stConfig.PA_CONFIG.bEnabled << 4) | stConfig.PA_CONFIG.bActiveState);
-                     pstTxMessage->ANT_MESSAGE_aucPayload[1] = stConfig.PA_CONFIG.ucGPIO;
-                     pstTxMessage->ANT_MESSAGE_aucPayload[2] = ((stConfig.LNA_CONFIG.bEnabled << 4) | stConfig.LNA_CONFIG.bActiveState);
-                     pstTxMessage->ANT_MESSAGE_aucPayload[3] = stConfig.LNA_CONFIG.ucGPIO;
-                  }
-                  break;
-
-               case MESG_CHANNEL_CRC_MODE_ID:
-                  {
-                     pstTxMessage->ANT_MESSAGE_ucSize = MESG_CHANNEL_CRC_MODE_SIZE;
-                     pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_CHANNEL_CRC_MODE_ID;
-                     // Channel has already been filled in.
-                     sd_ant_channel_radio_crc_mode_get(pstTxMessage->ANT_MESSAGE_ucChannel,
-                        &pstTxMessage->ANT_MESSAGE_aucPayload[0]);
-                  }
-                  break;
-
-               default:
-                  stCmdResp.ucResponse = INVALID_MESSAGE;
-                  break;
-            }
-            break;
-
-         ///////////////////////////////////////////////////////////////////////
-         // Command Messages
-         ///////////////////////////////////////////////////////////////////////
-         case MESG_ASSIGN_CHANNEL_ID:
-            if (pstRxMessage->ANT_MESSAGE_ucSize > MESG_ASSIGN_CHANNEL_SIZE )
-            {
-               stCmdResp.ucResponse = (uint8_t)sd_ant_channel_assign(stCmdResp.ucChannel,
-                                             pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1],
-                                             pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2],
-                                             pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_3]);
-            }
-            else
-            {
-               stCmdResp.ucResponse = (uint8_t)sd_ant_channel_assign(stCmdResp.ucChannel,
-                                             pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1],
-                                             pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2],
-                                             0);
-            }
-
-            break;
-
-         case MESG_UNASSIGN_CHANNEL_ID:
-            stCmdResp.ucResponse = (uint8_t)sd_ant_channel_unassign(stCmdResp.ucChannel);
-            break;
-
-         case MESG_OPEN_CHANNEL_ID:
-            if (pstRxMessage->ANT_MESSAGE_ucSize >= MESG_OPEN_CHANNEL_WITH_OFFSET_SIZE)
-                stCmdResp.ucResponse = (uint8_t)sd_ant_channel_open_with_offset(stCmdResp.ucChannel, DSI_GetUShort(pstRxMessage->ANT_MESSAGE_aucPayload));
-            else
-                stCmdResp.ucResponse = (uint8_t)sd_ant_channel_open(stCmdResp.ucChannel);
-            break;
-
-         case MESG_CLOSE_CHANNEL_ID:
-            stCmdResp.ucResponse = (uint8_t)sd_ant_channel_close(stCmdResp.ucChannel);
-            break;
-
-         case MESG_CHANNEL_ID_ID:
-            stCmdResp.ucResponse = (uint8_t)sd_ant_channel_id_set(stCmdResp.ucChannel,
-                        DSI_GetUShort(pstRxMessage->ANT_MESSAGE_aucPayload),
-                                 pstRxMessage->ANT_MESSAGE_aucPayload[2],
-                                 pstRxMessage->ANT_MESSAGE_aucPayload[3]);
-            break;
-
-         case MESG_CHANNEL_MESG_PERIOD_ID:
-            stCmdResp.ucResponse = (uint8_t)sd_ant_channel_period_set(stCmdResp.ucChannel, DSI_GetUShort(pstRxMessage->ANT_MESSAGE_aucPayload));
-            break;
-
-         case MESG_PROX_SEARCH_CONFIG_ID:
-            if (pstRxMessage->ANT_MESSAGE_ucSize > MESG_PROX_SEARCH_CONFIG_SIZE )
-               sd_ant_prox_search_set(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2]);
-            else
-               sd_ant_prox_search_set(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], 0);
-            break;
+      if (ucEvent == EVENT_TRANSFER_TX_FAILED)
+         ucBurstDiscardChannel = ucBurstFeedChannel; // drop what is left of the failed burst
 
-         case MESG_CHANNEL_RADIO_FREQ_ID:
-            stCmdResp.ucResponse = sd_ant_channel_radio_freq_set(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
-            break;
-
-         case MESG_RADIO_TX_POWER_ID:
-            {
-               uint8_t i;
-
-               if (pstRxMessage->ANT_MESSAGE_ucSize > MESG_RADIO_TX_POWER_SIZE )
-               {
-                  for (i=0; i<stANTChannelEnable.ucTotalNumberOfChannels; i++)
-                     sd_ant_channel_radio_tx_power_set(i, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2]);
-               }
-               else
-               {
-                  for (i=0; i<stANTChannelEnable.ucTotalNumberOfChannels; i++)
-                     sd_ant_channel_radio_tx_power_set(i, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], 0);
-               }
-            }
-            break;
+      ucBurstFeedChannel = 0xFF;
+      Command_BurstFeed();
+   }
+}
 
-         case MESG_CHANNEL_RADIO_TX_POWER_ID:
-            if (pstRxMessage->ANT_MESSAGE_ucSize > MESG_CHANNEL_RADIO_TX_POWER_SIZE )
-               sd_ant_channel_radio_tx_power_set(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2]);
-            else
-               sd_ant_channel_radio_tx_power_set(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], 0);
-            break;
+/**
+ * @brief Hand the next staged burst packet to the burst handler, unless it is still busy with the previous one
+ */
+static void Command_BurstFeed(void)
+{
+   BURST_RECORD stRecord;
+   uint8_t ucResponse;
+   bool bFreed = false;
 
-         case MESG_CHANNEL_SEARCH_TIMEOUT_ID:
-            sd_ant_channel_rx_search_timeout_set(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
-            break;
+   while ((ucBurstFeedChannel == 0xFF) && mc_fifo_peek(&stBurstFifo, &stRecord, BURST_RECORD_HEADER_SIZE))
+   {
+      mc_fifo_pop(&stBurstFifo, &stRecord, BURST_RECORD_HEADER_SIZE + stRecord.ucSize);
+      bFreed = true;
 
-         case MESG_SEARCH_WAVEFORM_ID:
-            sd_ant_search_waveform_set(stCmdResp.ucChannel, DSI_GetUShort(pstRxMessage->ANT_MESSAGE_aucPayload));
-            break;
+      if (ucBurstDiscardChannel == stRecord.ucChannel)
+      {
+         if (!(stRecord.ucSegment & BURST_SEGMENT_START)) // still part of the failed burst
+         {
+            if (stRecord.ucSegment & BURST_SEGMENT_END)
+               ucBurstDiscardChannel = 0xFF;
 
-         case MESG_NETWORK_KEY_ID:
-            if (stCmdResp.ucChannel < MAX_NETWORKS)
-               sd_ant_network_address_set(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload);
-            else
-               stCmdResp.ucResponse = INVALID_MESSAGE;
-            break;
+            continue;
+         }
 
-         case MESG_ANTLIB_CONFIG_ID:
-            sd_ant_lib_config_clear(ANT_LIB_CONFIG_MASK_ALL);
-            stCmdResp.ucResponse = (uint8_t)sd_ant_lib_config_set(ANT_LIB_CONFIG_RADIO_CONFIG_ALWAYS|pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
-            break;
+         ucBurstDiscardChannel = 0xFF; // a new burst is starting
+      }
 
-         case MESG_RX_EXT_MESGS_ENABLE_ID:
-            if (pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1])
-               stCmdResp.ucResponse = (uint8_t)sd_ant_lib_config_set(ANT_LIB_CONFIG_MESG_OUT_INC_DEVICE_ID);
-            else
-               sd_ant_lib_config_clear(ANT_LIB_CONFIG_MESG_OUT_INC_DEVICE_ID);
-            break;
+      ucResponse = (uint8_t)sd_ant_burst_handler_request(stRecord.ucChannel, stRecord.ucSize, stRecord.aucData, stRecord.ucSegment);
+      if (!ucResponse)
+      {
+         ucBurstFeedChannel = stRecord.ucChannel; // wait for the burst handler to ask for more
+      }
+      else
+      {
+         ucBurstSequence = 0; // reset sequence check, if failed
+         if (!(stRecord.ucSegment & BURST_SEGMENT_END))
+            ucBurstDiscardChannel = stRecord.ucChannel;
 
-         case MESG_RADIO_CW_INIT_ID:
-            sd_ant_cw_test_mode_init();
-            break;
+         Command_BurstFeedError(&stRecord, ucResponse);
+      }
+   }
 
-         case MESG_RADIO_CW_MODE_ID:
-            // apply potential workaround for cw mode issue where starting ANT CW mode does not properly wait for HFCLK to be ready before starting test mode
-            sd_clock_hfclk_request();
-            nrf_delay_us(5000);
+   if (bFreed && (ucQueuedTxBurstChannel != 0xFF)) // a burst message is waiting for staging space
+   {
+      ucQueuedTxBurstChannel = 0xFF;
+      Main_SetQueuedBurst();
+   }
+}
 
-            if (pstRxMessage->ANT_MESSAGE_ucSize > (MESG_RADIO_CW_MODE_SIZE + 1))
-               sd_ant_cw_test_mode(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_3], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_4]);
-            else if (pstRxMessage->ANT_MESSAGE_ucSize > MESG_RADIO_CW_MODE_SIZE)
-               sd_ant_cw_test_mode(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_3], 0);
-            else
-               sd_ant_cw_test_mode(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], 0, 0);
+/**
+ * @brief Report a staged burst packet rejected by the burst handler
+ */
+static void Command_BurstFeedError(BURST_RECORD *pstRecord, uint8_t ucResponse)
+{
+   ant_event_t stEvent;
+
+   // The command was already released, the response goes out through the event buffer.
+   stEvent.stHeader.ucChannel = pstRecord->ucChannel & CHANNEL_NUMBER_MASK;
+   stEvent.stHeader.ucEvent = NO_EVENT;
+   DSI_PutULong(System_GetTime_32K(), stEvent.stHeader.aucTimestamp);
+   stEvent.stMessage.ANT_MESSAGE_ucSize = MESG_RESPONSE_EVENT_SIZE;
+   stEvent.stMessage.ANT_MESSAGE_ucMesgID = MESG_RESPONSE_EVENT_ID;
+   stEvent.stMessage.ANT_MESSAGE_ucChannel = pstRecord->ucChannel & CHANNEL_NUMBER_MASK;
+   stEvent.stMessage.ANT_MESSAGE_aucPayload[SERIAL_RESPONSE_ID_OFFSET] = pstRecord->ucMesgID;
+   stEvent.stMessage.ANT_MESSAGE_aucPayload[SERIAL_RESPONSE_OFFSET] = ucResponse;
+
+   if (event_buffering_put(&stEvent)) // responses are never buffered, this flushes
+      bEventANTProcess = true;
+}
+/**
+ * @brief Process a sequence of commands, each as size, message ID and data
+ *
+ * Commands are processed back to back until one fails, their response codes are stored in pucResponses
+ * up to ucMaxResponses and the number of commands processed is returned. The response code of the last one
+ * is left in ucBatchResponse. Commands without a response code (requests, burst data and extended messages)
+ * are rejected, as well as a reset which would drop the batch response and loop a profile applied at startup.
+ */
+static uint8_t Command_BatchRun(const uint8_t *pucBatch, uint8_t ucBatchSize, uint8_t *pucResponses, uint8_t ucMaxResponses)
+{
+   ANT_MESSAGE stCommand;
+   ANT_MESSAGE stResponse; // scratch, batched commands do not send their own messages
+   uint8_t ucOffset = 0;
+   uint8_t ucCount = 0;
 
-            break;
+   ucBatchResponse = RESPONSE_NO_ERROR;
 
-         case MESG_SYSTEM_RESET_ID:
-            stCmdResp.ucResponse = System_Reset(RESET_CMD);
-            break;
+   while (ucOffset < ucBatchSize)
+   {
+      uint8_t ucSize = pucBatch[ucOffset];
+      uint8_t ucMesgID = pucBatch[ucOffset + 1];
+
+      if (((ucBatchSize - ucOffset) < COMMAND_BATCH_HEADER_SIZE) ||
+          (ucSize > (ucBatchSize - ucOffset - COMMAND_BATCH_HEADER_SIZE)) ||
+          (ucSize > MESG_MAX_SIZE_VALUE) ||
+          (ucMesgID == MESG_REQUEST_ID) || (ucMesgID == MESG_SYSTEM_RESET_ID) ||
+          (ucMesgID == MESG_BURST_DATA_ID) || (ucMesgID == MESG_EXT_BURST_DATA_ID) || (ucMesgID == MESG_ADV_BURST_DATA_ID) ||
+          ((ucMesgID & MSG_EXT_ID_MASK) == MSG_EXT_ID_MASK))
+      {
+         ucBatchResponse = INVALID_MESSAGE;
+      }
+      else
+      {
+         stCommand.ANT_MESSAGE_ucSize = ucSize;
+         stCommand.ANT_MESSAGE_ucMesgID = ucMesgID;
+         memcpy(stCommand.ANT_MESSAGE_aucMesgData, &pucBatch[ucOffset + COMMAND_BATCH_HEADER_SIZE], ucSize);
 
-         case MESG_SLEEP_ID:
-            stCmdResp.ucResponse = System_SetDeepSleep(pstRxMessage);
+         ucBatchResponse = NO_RESPONSE_MESSAGE;
+         bBatchProcess = true;
+         Command_SerialMessageProcess(&stCommand, &stResponse);
+         bBatchProcess = false;
 
-            break;
+         if (ucBatchResponse == NO_RESPONSE_MESSAGE) // accepted, the command has no response of its own
+            ucBatchResponse = RESPONSE_NO_ERROR;
+      }
 
-         case MESG_ID_LIST_ADD_ID:
-            stCmdResp.ucResponse = (uint8_t)sd_ant_id_list_add(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload, *(pstRxMessage->ANT_MESSAGE_aucPayload + 4));
-            break;
+      if (ucCount < ucMaxResponses)
+         pucResponses[ucCount] = ucBatchResponse;
+      ucCount++;
 
-         case MESG_ID_LIST_CONFIG_ID:
-            stCmdResp.ucResponse =(uint8_t) sd_ant_id_list_config(stCmdResp.ucChannel, *pstRxMessage->ANT_MESSAGE_aucPayload, *(pstRxMessage->ANT_MESSAGE_aucPayload + 1));
-            break;
+      if (ucBatchResponse != RESPONSE_NO_ERROR)
+         break; // later commands most likely depend on this one
 
-         case MESG_OPEN_RX_SCAN_ID:
-            if (pstRxMessage->ANT_MESSAGE_ucSize != MESG_OPEN_RX_SCAN_SIZE)
-               stCmdResp.ucResponse = (uint8_t)sd_ant_rx_scan_mode_start(0);
-            else
-               stCmdResp.ucResponse = (uint8_t)sd_ant_rx_scan_mode_start(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
-            break;
+      ucOffset += COMMAND_BATCH_HEADER_SIZE + ucSize;
+   }
 
+   return ucCount;
+}
 
-         case MESG_SET_LP_SEARCH_TIMEOUT_ID:
-            sd_ant_channel_low_priority_rx_search_timeout_set(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
-            break;
+/**
+ * @brief ANT serial command batch handler
+ *
+ * Payload is a sequence of commands processed by Command_BatchRun, answered with a single message:
+ * the number of commands processed, then the response code of each.
+ */
+static void Command_BatchProcess(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage)
+{
+   uint8_t ucCount;
+   uint8_t ucBatchSize = pstRxMessage->ANT_MESSAGE_ucSize - COMMAND_BATCH_SUB_ID_SIZE; // without the sub ID
 
-      #if !defined (SERIAL_NUMBER_NOT_AVAILABLE)
-         case MESG_SERIAL_NUM_SET_CHANNEL_ID_ID:
-            stCmdResp.ucResponse = SetChannelToSerialID(pstRxMessage);
-            break;
-      #endif // !SERIAL_NUMBER_NOT_AVAILABLE
+   ucCount = Command_BatchRun(pstRxMessage->ANT_MESSAGE_aucPayload, ucBatchSize,
+                              &pstTxMessage->ANT_MESSAGE_aucPayload[COMMAND_BATCH_RESPONSE_OFFSET], ucBatchSize);
 
-         case MESG_SET_SEARCH_CH_PRIORITY_ID:
-            sd_ant_search_channel_priority_set(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
-            break;
+   pstTxMessage->ANT_MESSAGE_ucSize = COMMAND_BATCH_SUB_ID_SIZE + COMMAND_BATCH_RESPONSE_OFFSET + ucCount;
+   pstTxMessage->ANT_MESSAGE_ucMesgID = (uint8_t)(MESG_COMMAND_BATCH_ID >> 8);
+   pstTxMessage->ANT_MESSAGE_ucSubID = (uint8_t)(MESG_COMMAND_BATCH_ID);
+   pstTxMessage->ANT_MESSAGE_aucPayload[COMMAND_BATCH_COUNT_OFFSET] = ucCount;
+}
 
+/**
+ * @brief Apply a stored channel profile
+ *
+ * The batched commands of the profile are processed and answered with the operation, the profile,
+ * the number of commands processed and the response code of the last one.
+ */
+static void Command_ProfileApply(uint8_t ucProfile, ANT_MESSAGE *pstTxMessage)
+{
+   const uint8_t *pucProfile;
+   uint8_t ucSize;
+   uint8_t ucCount = 0;
 
-         case MESG_AUTO_FREQ_CONFIG_ID:
-            sd_ant_auto_freq_hop_table_set(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2],
-                                     pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_3]);
+   pucProfile = channel_profile_get(ucProfile, &ucSize);
+   if (pucProfile == NULL)
+      ucBatchResponse = INVALID_PARAMETER_PROVIDED;
+   else
+      ucCount = Command_BatchRun(pucProfile, ucSize, NULL, 0);
+
+   pstTxMessage->ANT_MESSAGE_ucSize = CHANNEL_PROFILE_APPLY_SIZE;
+   pstTxMessage->ANT_MESSAGE_ucMesgID = (uint8_t)(MESG_CHANNEL_PROFILE_ID >> 8);
+   pstTxMessage->ANT_MESSAGE_ucSubID = (uint8_t)(MESG_CHANNEL_PROFILE_ID);
+   pstTxMessage->ANT_MESSAGE_aucPayload[CHANNEL_PROFILE_OP_OFFSET] = CHANNEL_PROFILE_OP_APPLY;
+   pstTxMessage->ANT_MESSAGE_aucPayload[CHANNEL_PROFILE_NUMBER_OFFSET] = ucProfile;
+   pstTxMessage->ANT_MESSAGE_aucPayload[CHANNEL_PROFILE_COUNT_OFFSET] = ucCount;
+   pstTxMessage->ANT_MESSAGE_aucPayload[CHANNEL_PROFILE_RESPONSE_OFFSET] = ucBatchResponse;
+}
 
-            break;
+/**
+ * @brief ANT serial channel profile handler
+ *
+ * Payload is the operation and the profile number, followed by the batched commands to store.
+ * Applying a profile is answered with its own message, other operations with their response code.
+ */
+static uint8_t Command_ProfileProcess(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage)
+{
+   uint8_t ucProfile = pstRxMessage->ANT_MESSAGE_aucPayload[CHANNEL_PROFILE_NUMBER_OFFSET];
+   uint8_t ucResponse = RESPONSE_NO_ERROR;
 
-         case MESG_CONFIG_ADV_BURST_ID:
-            stCmdResp.ucResponse = (uint8_t)sd_ant_adv_burst_config_set(pstRxMessage->ANT_MESSAGE_aucPayload, pstRxMessage->ANT_MESSAGE_ucSize - 1);
-            break;
+   if (pstRxMessage->ANT_MESSAGE_ucSize <= CHANNEL_PROFILE_NUMBER_OFFSET + 1) // sub ID, operation and profile
+      return INVALID_MESSAGE;
 
-         case MESG_COEX_PRIORITY_CONFIG_ID:
-         {
-            ANT_BUFFER_PTR stBuf;
-            stBuf.pucBuffer = pstRxMessage->ANT_MESSAGE_aucPayload;
-            stBuf.ucBufferSize = pstRxMessage->ANT_MESSAGE_ucSize - MESG_CHANNEL_NUM_SIZE;
-            sd_ant_coex_config_set(stCmdResp.ucChannel, &stBuf, NULL);
-         }
+   switch (pstRxMessage->ANT_MESSAGE_aucPayload[CHANNEL_PROFILE_OP_OFFSET])
+   {
+      case CHANNEL_PROFILE_OP_STORE:
+      case CHANNEL_PROFILE_OP_APPEND:
+         ucResponse = channel_profile_store(ucProfile, &pstRxMessage->ANT_MESSAGE_aucPayload[CHANNEL_PROFILE_DATA_OFFSET],
+                                            pstRxMessage->ANT_MESSAGE_ucSize - (CHANNEL_PROFILE_DATA_OFFSET + 1),
+                                            pstRxMessage->ANT_MESSAGE_aucPayload[CHANNEL_PROFILE_OP_OFFSET] == CHANNEL_PROFILE_OP_APPEND);
          break;
 
-         case MESG_COEX_ADV_PRIORITY_CONFIG_ID:
-         {
-            ANT_BUFFER_PTR stBuf;
-            stBuf.pucBuffer = pstRxMessage->ANT_MESSAGE_aucPayload;
-            stBuf.ucBufferSize = pstRxMessage->ANT_MESSAGE_ucSize - MESG_CHANNEL_NUM_SIZE;
-            sd_ant_coex_config_set(stCmdResp.ucChannel, NULL, &stBuf);
-         }
+      case CHANNEL_PROFILE_OP_ERASE:
+         ucResponse = channel_profile_erase(ucProfile);
          break;
 
-         case MESG_EVENT_BUFFERING_CONFIG_ID:
-         {
-            uint8_t ucConfig = pstRxMessage->ANT_MESSAGE_aucPayload[0];
-            uint16_t usSizeThreshold = DSI_GetUShort(&pstRxMessage->ANT_MESSAGE_aucPayload[1]);
-            uint16_t usTimeThreshold = DSI_GetUShort(&pstRxMessage->ANT_MESSAGE_aucPayload[3]);
-            event_buffering_config_set(ucConfig, usSizeThreshold, usTimeThreshold);
-         }
+      case CHANNEL_PROFILE_OP_APPLY:
+         Command_ProfileApply(ucProfile, pstTxMessage);
          break;
 
-         case MESG_HIGH_DUTY_SEARCH_MODE_ID:
-         {
-            ANT_HIGH_DUTY_SEARCH_CONFIG stConfig;
-            sd_ant_high_duty_search_config_get(&stConfig);
-
-            if (pstRxMessage->ANT_MESSAGE_ucSize < MESG_HIGH_DUTY_SEARCH_MODE_EN_SIZE)
-            {
-               stCmdResp.ucResponse = INVALID_MESSAGE;
-               break;
-            }
-
-            stConfig.bEnable = pstRxMessage->ANT_MESSAGE_aucPayload[0];
-            if (pstRxMessage->ANT_MESSAGE_ucSize >= MESG_HIGH_DUTY_SEARCH_MODE_EN_SIZE + 1)
-            {
-               stConfig.ucSearchSuppressionWindows = pstRxMessage->ANT_MESSAGE_aucPayload[1];
-            }
-
-            if (pstRxMessage->ANT_MESSAGE_ucSize >= MESG_HIGH_DUTY_SEARCH_MODE_EN_SIZE + 3)
-            {
-               stConfig.usRestartInterval = DSI_GetUShort(&(pstRxMessage->ANT_MESSAGE_aucPayload[2]));
-            }
-
-            stCmdResp.ucResponse = sd_ant_high_duty_search_config_set(&stConfig);
-         }
+      case CHANNEL_PROFILE_OP_BOOT:
+         ucResponse = channel_profile_boot_set(ucProfile);
          break;
 
-         case MESG_EVENT_FILTER_CONFIG_ID:
-         {
-            // Check if user wants to filter out burst-related events
-            usEventFilterMask = DSI_GetUShort(&(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]));
-            // Set SD filtering while clearing some bits
-            sd_ant_event_filtering_set(usEventFilterMask & ~EVENT_FILTER_PROHIBITED_EVENTS);
-            // Set field for NP-based filtering later
-            usEventFilterMask &= EVENT_FILTER_PROHIBITED_EVENTS;
-         }
+      default:
+         ucResponse = INVALID_PARAMETER_PROVIDED;
          break;
+   }
 
-         case MESG_ACTIVE_SEARCH_SHARING_ID:
-            sd_ant_active_search_sharing_cycles_set(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
-            break;
-
-         case MESG_SDU_CONFIG_ID:
-            stCmdResp.ucResponse = sd_ant_sdu_mask_config(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
-            break;
+   return ucResponse;
+}
 
-         case MESG_SDU_SET_MASK_ID:
-            stCmdResp.ucResponse = sd_ant_sdu_mask_set(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload);
-            break;
+/**
+ * @brief Apply the channel profile selected for startup
+ */
+void Command_ProfileBootApply(ANT_MESSAGE *pstTxMessage)
+{
+   uint8_t ucProfile = channel_profile_boot_get();
 
-         case MESG_ENCRYPT_ENABLE_ID:
-            stCmdResp.ucResponse = sd_ant_crypto_channel_enable(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_3]);
-            break;
+   pstTxMessage->ANT_MESSAGE_ucSize = 0;
 
-         case MESG_SET_ENCRYPT_KEY_ID:
-            stCmdResp.ucResponse = sd_ant_crypto_key_set(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload);
-            break;
+   if (ucProfile != CHANNEL_PROFILE_NONE)
+      Command_ProfileApply(ucProfile, pstTxMessage);
+}
 
-         case MESG_SET_ENCRYPT_INFO_ID:
-            stCmdResp.ucResponse = sd_ant_crypto_info_set(stCmdResp.ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload);
-            break;
+///////////////////////////////////////////////////////////////////////
+// Data Messages
+///////////////////////////////////////////////////////////////////////
+static void Command_BroadcastData(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = (uint8_t)sd_ant_broadcast_message_tx(pstCmdResp->ucChannel, (pstRxMessage->ANT_MESSAGE_ucSize-MESG_CHANNEL_NUM_SIZE), pstRxMessage->ANT_MESSAGE_aucPayload);
+   if (!pstCmdResp->ucResponse)
+      pstCmdResp->ucResponse = NO_RESPONSE_MESSAGE;
+}
 
+static void Command_AcknowledgedData(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = (uint8_t)sd_ant_acknowledge_message_tx(pstCmdResp->ucChannel, (pstRxMessage->ANT_MESSAGE_ucSize-MESG_CHANNEL_NUM_SIZE), pstRxMessage->ANT_MESSAGE_aucPayload);
+   if (!pstCmdResp->ucResponse)
+      pstCmdResp->ucResponse = NO_RESPONSE_MESSAGE;
+}
 
-         case MESG_RFACTIVE_NOTIFICATION_ID:
-            stCmdResp.ucResponse = sd_ant_rfactive_notification_config_set(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], DSI_GetUShort(&(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2])));
-            break;
+static void Command_ExtBroadcastData(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   Command_ChannelIDUpdate(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload);
+   pstCmdResp->ucResponse = (uint8_t)sd_ant_broadcast_message_tx(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_ucSize-(ANT_ID_SIZE+MESG_CHANNEL_NUM_SIZE), pstRxMessage->ANT_MESSAGE_aucPayload + ANT_ID_SIZE);
+   if (!pstCmdResp->ucResponse)
+      pstCmdResp->ucResponse = NO_RESPONSE_MESSAGE;
+}
 
+static void Command_ExtAcknowledgedData(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   Command_ChannelIDUpdate(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload);
+   pstCmdResp->ucResponse = (uint8_t)sd_ant_acknowledge_message_tx(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_ucSize-(ANT_ID_SIZE+MESG_CHANNEL_NUM_SIZE), pstRxMessage->ANT_MESSAGE_aucPayload + ANT_ID_SIZE);
+   if (!pstCmdResp->ucResponse)
+      pstCmdResp->ucResponse = NO_RESPONSE_MESSAGE;
+}
 
+static void Command_BurstData(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   if ((pstRxMessage->ANT_MESSAGE_ucMesgID == MESG_EXT_BURST_DATA_ID) &&
+       ((pstRxMessage->ANT_MESSAGE_ucChannel & SEQUENCE_NUMBER_ROLLOVER) == SEQUENCE_FIRST_MESSAGE))
+   {
+      pstCmdResp->ucResponse = Command_ChannelIDUpdate(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload); // only try to set the ID if this is the initial burst packet
 
+      if (pstCmdResp->ucResponse != RESPONSE_NO_ERROR)
+         return; // respond with error if the ID was not set correctly
+   }
 
-         case MESG_PA_LNA_CONFIG_ID:
-         {
-            ANT_PA_LNA_CONFIG stConfig;
-            sd_ant_config_pa_lna_get(&stConfig);
-
-            if (pstRxMessage->ANT_MESSAGE_ucSize < MESG_PA_LNA_CONFIG_SIZE)
-            {
-               stCmdResp.ucResponse = INVALID_MESSAGE;
-               break;
-            }
-
-            // Message structure:
-            // Byte 0: Upper nybble = PA Enabled bit, Lower nybble = PA Active State
-            // Byte 1: PA GPIO
-            // Byte 2: Upper nybble = LNA Enabled bit, Lower nybble = LNA Active State
-            // Byte 3: LNA GPIO
-
-            stConfig.PA_CONFIG.bEnabled =       (bool)(pstRxMessage->ANT_MESSAGE_aucPayload[0] >> 4);
-            stConfig.PA_CONFIG.bActiveState =   (bool)(pstRxMessage->ANT_MESSAGE_aucPayload[0] & 0xF);
-            stConfig.PA_CONFIG.ucGPIO =         pstRxMessage->ANT_MESSAGE_aucPayload[1];
-
-            stConfig.LNA_CONFIG.bEnabled =      (bool)(pstRxMessage->ANT_MESSAGE_aucPayload[2] >> 4);
-            stConfig.LNA_CONFIG.bActiveState =  (bool)(pstRxMessage->ANT_MESSAGE_aucPayload[2] & 0xF);
-            stConfig.LNA_CONFIG.ucGPIO =        pstRxMessage->ANT_MESSAGE_aucPayload[3];
-
-            stConfig.ucGPIOTECh =               PA_LNA_GPIOTE_CH;
-            stConfig.ucPPIChEnable =            PA_LNA_PPI_CH_ENABLE;
-            stConfig.ucPPIChDisable =           PA_LNA_PPI_CH_DISABLE;
-
-            stCmdResp.ucResponse = sd_ant_config_pa_lna_set(&stConfig);
-         }
-         break;
+   Main_SetQueuedBurst();
+   pstCmdResp->ucResponse = NO_RESPONSE_MESSAGE;
+}
 
-         case MESG_CHANNEL_CRC_MODE_ID:
-         {
-            if (pstRxMessage->ANT_MESSAGE_ucSize < MESG_CHANNEL_CRC_MODE_SIZE)
-            {
-               stCmdResp.ucResponse = INVALID_MESSAGE;
-               break;
-            }
-
-            stCmdResp.ucResponse = sd_ant_channel_radio_crc_mode_set(
-               pstRxMessage->ANT_MESSAGE_ucChannel,
-               pstRxMessage->ANT_MESSAGE_aucPayload[0]);
-         }
-         break;
+///////////////////////////////////////////////////////////////////////
+// Request Messages
+///////////////////////////////////////////////////////////////////////
+static void Command_Request(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   const COMMAND_ENTRY *pstEntry = &astCommandTable[pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]];
 
-         ///////////////////////////////////////////////////////////////////////
-         // Extended ID Messages
-         ///////////////////////////////////////////////////////////////////////
-         case MESG_EXT_ID_0:
-         case MESG_EXT_ID_1:
-         case MESG_EXT_ID_2:
-         case MESG_EXT_ID_3:
-         case MESG_EXT_ID_4:
-         {
-            bool bInvalidMessage = false;
-
-            usExtID = (((uint16_t)(pstRxMessage->ANT_MESSAGE_ucMesgID)) << 8) | (pstRxMessage->ANT_MESSAGE_ucSubID);
-
-            stCmdResp.ucResponseID = pstRxMessage->ANT_MESSAGE_ucMesgID;
-            stCmdResp.ucResponseSubID = pstRxMessage->ANT_MESSAGE_ucSubID;
-            stCmdResp.ucChannel = 0;
-
-            switch (usExtID)
-            {
-               /////////////////////////
-               case MESG_EXT_REQUEST_ID:
-               {
-
-                  usExtID =(((uint16_t)(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1])) << 8) | (pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2]);
-                  pstTxMessage->ANT_MESSAGE_ucMesgID = (uint8_t) (usExtID >> 8);
-                  pstTxMessage->ANT_MESSAGE_ucSubID = (uint8_t) usExtID;
-
-                  switch(usExtID)
-                  {
-                     case MESG_SET_SYNC_SERIAL_BIT_RATE:
-                        // Reserving ability to use SERIAL_DATA_OFFSET_3 as a selector for other requests (current active baudrate? other?)
-                        if (!pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_3])
-                        {
-                           pstTxMessage->ANT_MESSAGE_ucSize = MESG_SET_BIT_RATE_REQ_SIZE;
-                           pstTxMessage->ANT_MESSAGE_ucMesgID =      (uint8_t)(MESG_SET_SYNC_SERIAL_BIT_RATE >> 8);
-                           pstTxMessage->ANT_MESSAGE_ucSubID  =      (uint8_t)(MESG_SET_SYNC_SERIAL_BIT_RATE);
-                           pstTxMessage->ANT_MESSAGE_aucPayload[0] = 0;
-                           pstTxMessage->ANT_MESSAGE_aucPayload[1] = (uint8_t)(BIT_RATE_SUPPORTED_BITFIELD);
-                        }
-                        else
-                        {
-                           stCmdResp.ucResponse = INVALID_PARAMETER_PROVIDED;
-                        }
-                        break;
-
-                     case MESG_SET_ASYNC_BAUDRATE:
-                        // Reserving ability to use SERIAL_DATA_OFFSET_3 as a selector for other requests (current active baudrate? other?)
-                        if (!pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_3])
-                        {
-                           pstTxMessage->ANT_MESSAGE_ucSize = MESG_SET_BAUDRATE_REQ_SIZE;
-                           pstTxMessage->ANT_MESSAGE_ucMesgID =      (uint8_t)(MESG_SET_ASYNC_BAUDRATE >> 8);
-                           pstTxMessage->ANT_MESSAGE_ucSubID  =      (uint8_t)(MESG_SET_ASYNC_BAUDRATE);
-                           pstTxMessage->ANT_MESSAGE_aucPayload[0] = 0;
-                           pstTxMessage->ANT_MESSAGE_aucPayload[1] = (uint8_t)(BAUD_SUPPORTED_BITFIELD);
-                           pstTxMessage->ANT_MESSAGE_aucPayload[2] = (uint8_t)(BAUD_SUPPORTED_BITFIELD >> 8);
-                        }
-                        else
-                        {
-                           stCmdResp.ucResponse = INVALID_PARAMETER_PROVIDED;
-                        }
-                        break;
-
-                     case MESG_RSSI_CAL_ID:
-                        /* Returns RSSI calibration values */
-                        System_GetRSSICalDataMesg(pstTxMessage);
-                        break;
-
-                     default:
-                        bInvalidMessage = true;
-                        break;
-                  }
-
-                  if (stCmdResp.ucResponse)
-                  {
-                     stCmdResp.ucResponseID = pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1];
-                     stCmdResp.ucResponseSubID = pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2];
-                     stCmdResp.bExtIDResponse = true;
-                  }
-                  //
-
-                  break;
-               } // case MESG_EXT_REQUEST_ID
-
-               case MESG_SET_SYNC_SERIAL_BIT_RATE:
-                  stCmdResp.ucResponse = Serial_SetByteSyncSerialBitRate(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
-                  break;
-
-               case MESG_SET_SYNC_SERIAL_SRDY_SLEEP:
-                  stCmdResp.ucResponse = Serial_SetByteSyncSerialSRDYSleep(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
-                  break;
-
-               case MESG_SET_ASYNC_BAUDRATE:
-                  stCmdResp.ucResponse = Serial_SetAsyncBaudrate((BAUDRATE_TYPE)pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
-                  break;
-
-               case MESG_SET_DC_TO_DC:
-                  if(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1] == DC_TO_DC_OFF)
-                     sd_power_dcdc_mode_set(NRF_POWER_DCDC_DISABLE);
-                  else if(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1] == DC_TO_DC_ON)
-                     sd_power_dcdc_mode_set(NRF_POWER_DCDC_ENABLE);
-                  else
-                     stCmdResp.ucResponse = INVALID_PARAMETER_PROVIDED;
-                  break;
-
-               case MESG_RSSI_CAL_ID:
-                  /* Writes RSSI calibration */
-                  stCmdResp.ucResponse = System_SetRSSICal(pstRxMessage);
-                  break;
-
-            #if !defined(SERIAL_NUMBER_NOT_AVAILABLE)
-               case MESG_SET_SERIAL_NUM_ID:
-                  /* Sets the specified ID with the value passed in */
-                  stCmdResp.ucResponse = System_SetSerialNum(pstRxMessage);
-                  break;
-            #endif // !SERIAL_NUMBER_NOT_AVAILABLE
-
-               default:
-                  bInvalidMessage = true;
-                  break;
-
-            }
-
-            if (bInvalidMessage)
-               stCmdResp.ucResponse = INVALID_MESSAGE;
-            else
-               stCmdResp.bExtIDResponse = true;
-            //
-            //
+   if (pstTxMessage == NULL) // don't allow request messages if no transmit buffer provided
+      return;
 
-            break;
-         }
+   pstTxMessage->ANT_MESSAGE_ucChannel = pstCmdResp->ucChannel;
 
-         default:
-            stCmdResp.ucResponse = INVALID_MESSAGE;
-            break;
-      }
-   }
+   if (pstEntry->pfRequest == NULL)
+      pstCmdResp->ucResponse = INVALID_MESSAGE;
    else
+      pstEntry->pfRequest(pstRxMessage, pstTxMessage, pstCmdResp);
+}
+
+static void Command_RequestChannelStatus(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = sd_ant_channel_status_get(pstCmdResp->ucChannel, &pstTxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
+   if (!pstCmdResp->ucResponse)
    {
-      stCmdResp.ucResponse = INVALID_MESSAGE;
+      pstTxMessage->ANT_MESSAGE_ucSize   = MESG_CHANNEL_STATUS_SIZE;
+      pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_CHANNEL_STATUS_ID;
+      // the channel number field has already been filled in
    }
+}
 
-   if (stCmdResp.ucResponse == NRF_ERROR_NOT_SUPPORTED)
-      stCmdResp.ucResponse = INVALID_MESSAGE;
+static void Command_RequestChannelID(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   uint16_t usTemp;
 
-   if (pstTxMessage == NULL) // don't send a response if no buffer provided and don't release RTS
-      return;
+   pstCmdResp->ucResponse = sd_ant_channel_id_get(pstCmdResp->ucChannel,
+                                                  (uint16_t*)&usTemp,
+                                                  (uint8_t*)&pstTxMessage->ANT_MESSAGE_aucPayload[2],
+                                                  (uint8_t*)&pstTxMessage->ANT_MESSAGE_aucPayload[3]);
+   if (!pstCmdResp->ucResponse)
+   {
+      pstTxMessage->ANT_MESSAGE_ucSize   = MESG_CHANNEL_ID_SIZE;
+      pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_CHANNEL_ID_ID;
+      // the channel number field has already been filled in
 
-   Command_ResponseMessage(stCmdResp, pstTxMessage);
+      pstTxMessage->ANT_MESSAGE_aucPayload[0] = (uint8_t)usTemp;
+      pstTxMessage->ANT_MESSAGE_aucPayload[1] = (uint8_t)(usTemp >> 8);
+   }
 }
 
-/**
- * @brief ANT serial command response handler
- */
-void Command_ResponseMessage(COMMAND_RESPONSE stCmdResp, ANT_MESSAGE *pstTxMessage)
+static void Command_RequestCapabilities(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
 {
+   pstCmdResp->ucResponse = sd_ant_capabilities_get(pstTxMessage->ANT_MESSAGE_aucMesgData);
+   if (!pstCmdResp->ucResponse)
+   {
+      pstTxMessage->ANT_MESSAGE_ucSize = MESG_CAPABILITIES_SIZE;
+      pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_CAPABILITIES_ID;
+      //serial number support is provided by the application level, insert if application supports it
+      pstTxMessage->ANT_MESSAGE_aucMesgData[3] |= CAPABILITIES_SERIAL_NUMBER_ENABLED;
+      //event buffering is also provided at application level.
+      pstTxMessage->ANT_MESSAGE_aucMesgData[6] |= CAPABILITIES_EVENT_BUFFERING_ENABLED;
+   }
+}
+
+static void Command_RequestVersion(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   /*Returns Application version number*/
+   if (pstTxMessage->ANT_MESSAGE_ucChannel == 0)
+#if !defined (TEST_SD_OUTPUT_FW_VERSION)
+   {
+      pstTxMessage->ANT_MESSAGE_ucSize = 11;
+      pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_VERSION_ID;
+      memcpy(pstTxMessage->ANT_MESSAGE_aucMesgData, acAppVersion, APP_VERSION_SIZE);
+   }
+   /*Returns Softdevice version number*/
+   else if (pstTxMessage->ANT_MESSAGE_ucChannel == 1)
+#endif //TEST_SD_OUTPUT_FW_VERSION
+   {
+      pstCmdResp->ucResponse = sd_ant_version_get(pstTxMessage->ANT_MESSAGE_aucMesgData);
+      if (!pstCmdResp->ucResponse)
+      {
+         pstTxMessage->ANT_MESSAGE_ucSize = MESG_VERSION_SIZE;
+         pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_VERSION_ID;
+      }
+   }
+   /*Chan Number must only be 0=App or 1=Softdevice*/
+   else
+   {
+      pstCmdResp->ucResponse = INVALID_MESSAGE;
+   }
+}
+
+#if !defined (SERIAL_NUMBER_NOT_AVAILABLE)
+static void Command_RequestSerialNumber(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   /* Returns serial number identifying the device */
+   System_GetSerialNumberMesg(pstTxMessage);
+}
+#endif // !SERIAL_NUMBER_NOT_AVAILABLE
+
+static void Command_RequestAdvBurstConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = sd_ant_adv_burst_config_get(pstCmdResp->ucChannel, pstTxMessage->ANT_MESSAGE_aucMesgData);
+   if (!pstCmdResp->ucResponse)
+   {
+      if (pstCmdResp->ucChannel)
+         pstTxMessage->ANT_MESSAGE_ucSize = MESG_CONFIG_ADV_BURST_REQ_CONFIG_SIZE;
+      else
+         pstTxMessage->ANT_MESSAGE_ucSize = MESG_CONFIG_ADV_BURST_REQ_CAPABILITIES_SIZE;
+
+      pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_CONFIG_ADV_BURST_ID;
+   }
+}
+
+static void Command_RequestCoexPriorityConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   ANT_BUFFER_PTR stBuf;
+   stBuf.pucBuffer = pstTxMessage->ANT_MESSAGE_aucPayload;
+   stBuf.ucBufferSize = MESG_MAX_DATA_SIZE;
+   pstCmdResp->ucResponse = sd_ant_coex_config_get(pstCmdResp->ucChannel, &stBuf, NULL);
+   if (!pstCmdResp->ucResponse)
+   {
+      pstTxMessage->ANT_MESSAGE_ucSize = stBuf.ucBufferSize + MESG_CHANNEL_NUM_SIZE;
+      pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_COEX_PRIORITY_CONFIG_ID;
+   }
+}
+
+static void Command_RequestCoexAdvPriorityConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   ANT_BUFFER_PTR stBuf;
+   stBuf.pucBuffer = pstTxMessage->ANT_MESSAGE_aucPayload;
+   stBuf.ucBufferSize = MESG_MAX_DATA_SIZE;
+   pstCmdResp->ucResponse = sd_ant_coex_config_get(pstCmdResp->ucChannel, NULL, &stBuf);
+   if (!pstCmdResp->ucResponse)
+   {
+      pstTxMessage->ANT_MESSAGE_ucSize = stBuf.ucBufferSize + MESG_CHANNEL_NUM_SIZE;
+      pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_COEX_ADV_PRIORITY_CONFIG_ID;
+   }
+}
+
+static void Command_RequestHighDutySearchMode(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   ANT_HIGH_DUTY_SEARCH_CONFIG stConfig;
+   pstCmdResp->ucResponse = sd_ant_high_duty_search_config_get(&stConfig);
+   if (!pstCmdResp->ucResponse)
+   {
+      pstTxMessage->ANT_MESSAGE_ucSize = MESG_HIGH_DUTY_SEARCH_MODE_REQ_SIZE;
+      pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_HIGH_DUTY_SEARCH_MODE_ID;
+      pstTxMessage->ANT_MESSAGE_aucPayload[0] = stConfig.bEnable;
+      pstTxMessage->ANT_MESSAGE_aucPayload[1] = stConfig.ucSearchSuppressionWindows;
+      pstTxMessage->ANT_MESSAGE_aucPayload[2] = (uint8_t)stConfig.usRestartInterval;
+      pstTxMessage->ANT_MESSAGE_aucPayload[3] = (uint8_t)(stConfig.usRestartInterval >> 8);
+   }
+}
+
+static void Command_RequestActiveSearchSharing(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = sd_ant_active_search_sharing_cycles_get(pstCmdResp->ucChannel, &pstTxMessage->ANT_MESSAGE_aucPayload[0]);
+   if (!pstCmdResp->ucResponse)
+   {
+      pstTxMessage->ANT_MESSAGE_ucSize = MESG_ACTIVE_SEARCH_SHARING_REQ_SIZE;
+      pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_ACTIVE_SEARCH_SHARING_ID;
+   }
+}
+
+static void Command_RequestEventBufferingConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   uint8_t ucConfig;
+   uint16_t usSizeThreshold;
+   uint16_t usTimeThreshold;
+   event_buffering_config_get(&ucConfig, &usSizeThreshold, &usTimeThreshold);
+
+   pstTxMessage->ANT_MESSAGE_ucSize = MESG_EVENT_BUFFERING_CONFIG_REQ_SIZE;
+   pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_EVENT_BUFFERING_CONFIG_ID;
+
+   pstTxMessage->ANT_MESSAGE_aucPayload[0] = ucConfig;
+   DSI_PutUShort(usSizeThreshold, &pstTxMessage->ANT_MESSAGE_aucPayload[1]);
+   DSI_PutUShort(usTimeThreshold, &pstTxMessage->ANT_MESSAGE_aucPayload[3]);
+}
+
+static void Command_RequestEventFilterConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   uint16_t usTemp;
+
+   pstCmdResp->ucResponse = sd_ant_event_filtering_get((uint16_t*)&usTemp);
+   // Add in events that are being filtered by the NP
+   usTemp |= usEventFilterMask;
+   if (!pstCmdResp->ucResponse)
+   {
+      pstTxMessage->ANT_MESSAGE_ucSize = MESG_EVENT_FILTER_CONFIG_REQ_SIZE;
+      pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_EVENT_FILTER_CONFIG_ID;
+
+      pstTxMessage->ANT_MESSAGE_aucPayload[0] = (uint8_t)usTemp;
+      pstTxMessage->ANT_MESSAGE_aucPayload[1] = (uint8_t)(usTemp >> 8);
+   }
+}
+
+static void Command_RequestSduMask(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = sd_ant_sdu_mask_get(pstCmdResp->ucChannel, pstTxMessage->ANT_MESSAGE_aucPayload);
+   if (!pstCmdResp->ucResponse)
+   {
+      pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_SDU_SET_MASK_ID;
+      pstTxMessage->ANT_MESSAGE_ucSize = MESG_ANT_MAX_PAYLOAD_SIZE + MESG_CHANNEL_NUM_SIZE;
+   }
+}
+
+static void Command_RequestEncryptInfo(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = sd_ant_crypto_info_get(pstCmdResp->ucChannel, pstTxMessage->ANT_MESSAGE_aucPayload);
+   if (!pstCmdResp->ucResponse)
+   {
+      switch (pstCmdResp->ucChannel)
+      {
+         case ENCRYPTION_INFO_GET_SUPPORTED_MODE:
+            pstTxMessage->ANT_MESSAGE_ucSize = MESG_CONFIG_ENCRYPT_REQ_CAPABILITIES_SIZE;
+            break;
+         case ENCRYPTION_INFO_GET_CRYPTO_ID:
+            pstTxMessage->ANT_MESSAGE_ucSize = MESG_CONFIG_ENCRYPT_REQ_CONFIG_ID_SIZE;
+            break;
+         case ENCRYPTION_INFO_GET_CUSTOM_USER_DATA:
+            pstTxMessage->ANT_MESSAGE_ucSize = MESG_CONFIG_ENCRYPT_REQ_CONFIG_USER_DATA_SIZE;
+            break;
+      }
+
+      pstTxMessage->ANT_MESSAGE_ucChannel = pstCmdResp->ucChannel;
+      pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_ENCRYPT_ENABLE_ID;
+   }
+}
+
+static void Command_RequestRFActiveNotification(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   uint16_t usTemp;
+
+   pstCmdResp->ucResponse = sd_ant_rfactive_notification_config_get((uint8_t*)&pstTxMessage->ANT_MESSAGE_aucPayload[0], (uint16_t*)&usTemp);
+   if (!pstCmdResp->ucResponse)
+   {
+      pstTxMessage->ANT_MESSAGE_ucSize = MESG_RFACTIVE_NOTIFICATION_SIZE;
+      pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_RFACTIVE_NOTIFICATION_ID;
+
+      pstTxMessage->ANT_MESSAGE_aucPayload[1] = (uint8_t)usTemp;
+      pstTxMessage->ANT_MESSAGE_aucPayload[2] = (uint8_t)(usTemp >> 8);
+   }
+}
+
+static void Command_RequestPALNAConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   ANT_PA_LNA_CONFIG stConfig;
+   sd_ant_config_pa_lna_get(&stConfig);
+
+   pstTxMessage->ANT_MESSAGE_ucSize = MESG_PA_LNA_CONFIG_SIZE;
+   pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_PA_LNA_CONFIG_ID;
+   pstTxMessage->ANT_MESSAGE_aucPayload[0] = ((stConfig.PA_CONFIG.bEnabled << 4) | stConfig.PA_CONFIG.bActiveState);
+   pstTxMessage->ANT_MESSAGE_aucPayload[1] = stConfig.PA_CONFIG.ucGPIO;
+   pstTxMessage->ANT_MESSAGE_aucPayload[2] = ((stConfig.LNA_CONFIG.bEnabled << 4) | stConfig.LNA_CONFIG.bActiveState);
+   pstTxMessage->ANT_MESSAGE_aucPayload[3] = stConfig.LNA_CONFIG.ucGPIO;
+}
+
+static void Command_RequestChannelCRCMode(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstTxMessage->ANT_MESSAGE_ucSize = MESG_CHANNEL_CRC_MODE_SIZE;
+   pstTxMessage->ANT_MESSAGE_ucMesgID = MESG_CHANNEL_CRC_MODE_ID;
+   // Channel has already been filled in.
+   sd_ant_channel_radio_crc_mode_get(pstTxMessage->ANT_MESSAGE_ucChannel,
+      &pstTxMessage->ANT_MESSAGE_aucPayload[0]);
+}
+
+///////////////////////////////////////////////////////////////////////
+// Command Messages
+///////////////////////////////////////////////////////////////////////
+static void Command_AssignChannel(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   if (pstRxMessage->ANT_MESSAGE_ucSize > MESG_ASSIGN_CHANNEL_SIZE )
+   {
+      pstCmdResp->ucResponse = (uint8_t)sd_ant_channel_assign(pstCmdResp->ucChannel,
+                                    pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1],
+                                    pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2],
+                                    pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_3]);
+   }
+   else
+   {
+      pstCmdResp->ucResponse = (uint8_t)sd_ant_channel_assign(pstCmdResp->ucChannel,
+                                    pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1],
+                                    pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2],
+                                    0);
+   }
+
+   if ((pstCmdResp->ucResponse == RESPONSE_NO_ERROR) && (pstCmdResp->ucChannel < ANT_STACK_TOTAL_CHANNELS_ALLOCATED_MAX))
+   {
+      astChannelIDShadow[pstCmdResp->ucChannel].bMaster = (pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1] & CHANNEL_TYPE_MASTER) != 0;
+      astChannelIDShadow[pstCmdResp->ucChannel].bValid = false;
+   }
+}
+
+static void Command_UnassignChannel(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = (uint8_t)sd_ant_channel_unassign(pstCmdResp->ucChannel);
+
+   if ((pstCmdResp->ucResponse == RESPONSE_NO_ERROR) && (pstCmdResp->ucChannel < ANT_STACK_TOTAL_CHANNELS_ALLOCATED_MAX))
+   {
+      astChannelIDShadow[pstCmdResp->ucChannel].bMaster = false;
+      astChannelIDShadow[pstCmdResp->ucChannel].bValid = false;
+   }
+}
+
+static void Command_OpenChannel(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   if (pstRxMessage->ANT_MESSAGE_ucSize >= MESG_OPEN_CHANNEL_WITH_OFFSET_SIZE)
+       pstCmdResp->ucResponse = (uint8_t)sd_ant_channel_open_with_offset(pstCmdResp->ucChannel, DSI_GetUShort(pstRxMessage->ANT_MESSAGE_aucPayload));
+   else
+       pstCmdResp->ucResponse = (uint8_t)sd_ant_channel_open(pstCmdResp->ucChannel);
+}
+
+static void Command_CloseChannel(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = (uint8_t)sd_ant_channel_close(pstCmdResp->ucChannel);
+}
+
+static void Command_ChannelID(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = (uint8_t)sd_ant_channel_id_set(pstCmdResp->ucChannel,
+               DSI_GetUShort(pstRxMessage->ANT_MESSAGE_aucPayload),
+                        pstRxMessage->ANT_MESSAGE_aucPayload[2],
+                        pstRxMessage->ANT_MESSAGE_aucPayload[3]);
+   Command_ChannelIDShadowSet(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload, pstCmdResp->ucResponse);
+}
+
+static void Command_ChannelPeriod(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = (uint8_t)sd_ant_channel_period_set(pstCmdResp->ucChannel, DSI_GetUShort(pstRxMessage->ANT_MESSAGE_aucPayload));
+}
+
+static void Command_ProxSearchConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   if (pstRxMessage->ANT_MESSAGE_ucSize > MESG_PROX_SEARCH_CONFIG_SIZE )
+      sd_ant_prox_search_set(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2]);
+   else
+      sd_ant_prox_search_set(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], 0);
+}
+
+static void Command_ChannelRadioFreq(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = sd_ant_channel_radio_freq_set(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
+}
+
+static void Command_RadioTxPower(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   uint8_t i;
+
+   if (pstRxMessage->ANT_MESSAGE_ucSize > MESG_RADIO_TX_POWER_SIZE )
+   {
+      for (i=0; i<stANTChannelEnable.ucTotalNumberOfChannels; i++)
+         sd_ant_channel_radio_tx_power_set(i, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2]);
+   }
+   else
+   {
+      for (i=0; i<stANTChannelEnable.ucTotalNumberOfChannels; i++)
+         sd_ant_channel_radio_tx_power_set(i, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], 0);
+   }
+}
+
+static void Command_ChannelRadioTxPower(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   if (pstRxMessage->ANT_MESSAGE_ucSize > MESG_CHANNEL_RADIO_TX_POWER_SIZE )
+      sd_ant_channel_radio_tx_power_set(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2]);
+   else
+      sd_ant_channel_radio_tx_power_set(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], 0);
+}
+
+static void Command_ChannelSearchTimeout(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   sd_ant_channel_rx_search_timeout_set(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
+}
+
+static void Command_SearchWaveform(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   sd_ant_search_waveform_set(pstCmdResp->ucChannel, DSI_GetUShort(pstRxMessage->ANT_MESSAGE_aucPayload));
+}
+
+static void Command_NetworkKey(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   sd_ant_network_address_set(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload);
+}
+
+static void Command_ANTLibConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   sd_ant_lib_config_clear(ANT_LIB_CONFIG_MASK_ALL);
+   pstCmdResp->ucResponse = (uint8_t)sd_ant_lib_config_set(ANT_LIB_CONFIG_RADIO_CONFIG_ALWAYS|pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
+}
+
+static void Command_RxExtMesgsEnable(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   if (pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1])
+      pstCmdResp->ucResponse = (uint8_t)sd_ant_lib_config_set(ANT_LIB_CONFIG_MESG_OUT_INC_DEVICE_ID);
+   else
+      sd_ant_lib_config_clear(ANT_LIB_CONFIG_MESG_OUT_INC_DEVICE_ID);
+}
+
+static void Command_RadioCWInit(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   sd_ant_cw_test_mode_init();
+}
+
+static void Command_RadioCWMode(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   // apply potential workaround for cw mode issue where starting ANT CW mode does not properly wait for HFCLK to be ready before starting test mode
+   sd_clock_hfclk_request();
+   nrf_delay_us(5000);
+
+   if (pstRxMessage->ANT_MESSAGE_ucSize > (MESG_RADIO_CW_MODE_SIZE + 1))
+      sd_ant_cw_test_mode(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_3], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_4]);
+   else if (pstRxMessage->ANT_MESSAGE_ucSize > MESG_RADIO_CW_MODE_SIZE)
+      sd_ant_cw_test_mode(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_3], 0);
+   else
+      sd_ant_cw_test_mode(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], 0, 0);
+}
+
+static void Command_SystemReset(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = System_Reset(RESET_CMD);
+}
+
+static void Command_Sleep(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = System_SetDeepSleep(pstRxMessage);
+}
+
+static void Command_IDListAdd(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = (uint8_t)sd_ant_id_list_add(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload, *(pstRxMessage->ANT_MESSAGE_aucPayload + 4));
+}
+
+static void Command_IDListConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse =(uint8_t) sd_ant_id_list_config(pstCmdResp->ucChannel, *pstRxMessage->ANT_MESSAGE_aucPayload, *(pstRxMessage->ANT_MESSAGE_aucPayload + 1));
+}
+
+static void Command_OpenRxScan(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   if (pstRxMessage->ANT_MESSAGE_ucSize != MESG_OPEN_RX_SCAN_SIZE)
+      pstCmdResp->ucResponse = (uint8_t)sd_ant_rx_scan_mode_start(0);
+   else
+      pstCmdResp->ucResponse = (uint8_t)sd_ant_rx_scan_mode_start(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
+}
+
+static void Command_LPSearchTimeout(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   sd_ant_channel_low_priority_rx_search_timeout_set(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
+}
+
+#if !defined (SERIAL_NUMBER_NOT_AVAILABLE)
+static void Command_SerialNumSetChannelID(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = SetChannelToSerialID(pstRxMessage);
+
+   if (pstCmdResp->ucChannel < ANT_STACK_TOTAL_CHANNELS_ALLOCATED_MAX)
+      astChannelIDShadow[pstCmdResp->ucChannel].bValid = false; // ID is derived from the serial number, set again on the next extended message
+}
+#endif // !SERIAL_NUMBER_NOT_AVAILABLE
+
+static void Command_SearchChannelPriority(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   sd_ant_search_channel_priority_set(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
+}
+
+static void Command_AutoFreqConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   sd_ant_auto_freq_hop_table_set(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2],
+                            pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_3]);
+}
+
+static void Command_AdvBurstConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = (uint8_t)sd_ant_adv_burst_config_set(pstRxMessage->ANT_MESSAGE_aucPayload, pstRxMessage->ANT_MESSAGE_ucSize - 1);
+}
+
+static void Command_CoexPriorityConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   ANT_BUFFER_PTR stBuf;
+   stBuf.pucBuffer = pstRxMessage->ANT_MESSAGE_aucPayload;
+   stBuf.ucBufferSize = pstRxMessage->ANT_MESSAGE_ucSize - MESG_CHANNEL_NUM_SIZE;
+   sd_ant_coex_config_set(pstCmdResp->ucChannel, &stBuf, NULL);
+}
+
+static void Command_CoexAdvPriorityConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   ANT_BUFFER_PTR stBuf;
+   stBuf.pucBuffer = pstRxMessage->ANT_MESSAGE_aucPayload;
+   stBuf.ucBufferSize = pstRxMessage->ANT_MESSAGE_ucSize - MESG_CHANNEL_NUM_SIZE;
+   sd_ant_coex_config_set(pstCmdResp->ucChannel, NULL, &stBuf);
+}
+
+static void Command_EventBufferingConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   uint8_t ucConfig = pstRxMessage->ANT_MESSAGE_aucPayload[0];
+   uint16_t usSizeThreshold = DSI_GetUShort(&pstRxMessage->ANT_MESSAGE_aucPayload[1]);
+   uint16_t usTimeThreshold = DSI_GetUShort(&pstRxMessage->ANT_MESSAGE_aucPayload[3]);
+   event_buffering_config_set(ucConfig, usSizeThreshold, usTimeThreshold);
+}
+
+static void Command_HighDutySearchMode(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   ANT_HIGH_DUTY_SEARCH_CONFIG stConfig;
+   sd_ant_high_duty_search_config_get(&stConfig);
+
+   stConfig.bEnable = pstRxMessage->ANT_MESSAGE_aucPayload[0];
+   if (pstRxMessage->ANT_MESSAGE_ucSize >= MESG_HIGH_DUTY_SEARCH_MODE_EN_SIZE + 1)
+   {
+      stConfig.ucSearchSuppressionWindows = pstRxMessage->ANT_MESSAGE_aucPayload[1];
+   }
+
+   if (pstRxMessage->ANT_MESSAGE_ucSize >= MESG_HIGH_DUTY_SEARCH_MODE_EN_SIZE + 3)
+   {
+      stConfig.usRestartInterval = DSI_GetUShort(&(pstRxMessage->ANT_MESSAGE_aucPayload[2]));
+   }
+
+   pstCmdResp->ucResponse = sd_ant_high_duty_search_config_set(&stConfig);
+}
+
+static void Command_EventFilterConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   // Check if user wants to filter out burst-related events
+   usEventFilterMask = DSI_GetUShort(&(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]));
+   // Set SD filtering while clearing some bits
+   sd_ant_event_filtering_set(usEventFilterMask & ~EVENT_FILTER_PROHIBITED_EVENTS);
+   // Set field for NP-based filtering later
+   usEventFilterMask &= EVENT_FILTER_PROHIBITED_EVENTS;
+}
+
+static void Command_ActiveSearchSharing(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   sd_ant_active_search_sharing_cycles_set(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
+}
+
+static void Command_SduConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = sd_ant_sdu_mask_config(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
+}
+
+static void Command_SduSetMask(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = sd_ant_sdu_mask_set(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload);
+}
+
+static void Command_EncryptEnable(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = sd_ant_crypto_channel_enable(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2], pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_3]);
+}
+
+static void Command_SetEncryptKey(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = sd_ant_crypto_key_set(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload);
+}
+
+static void Command_SetEncryptInfo(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = sd_ant_crypto_info_set(pstCmdResp->ucChannel, pstRxMessage->ANT_MESSAGE_aucPayload);
+}
+
+static void Command_RFActiveNotification(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = sd_ant_rfactive_notification_config_set(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1], DSI_GetUShort(&(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2])));
+}
+
+static void Command_PALNAConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   ANT_PA_LNA_CONFIG stConfig;
+   sd_ant_config_pa_lna_get(&stConfig);
+
+   // Message structure:
+   // Byte 0: Upper nybble = PA Enabled bit, Lower nybble = PA Active State
+   // Byte 1: PA GPIO
+   // Byte 2: Upper nybble = LNA Enabled bit, Lower nybble = LNA Active State
+   // Byte 3: LNA GPIO
+
+   stConfig.PA_CONFIG.bEnabled =       (bool)(pstRxMessage->ANT_MESSAGE_aucPayload[0] >> 4);
+   stConfig.PA_CONFIG.bActiveState =   (bool)(pstRxMessage->ANT_MESSAGE_aucPayload[0] & 0xF);
+   stConfig.PA_CONFIG.ucGPIO =         pstRxMessage->ANT_MESSAGE_aucPayload[1];
+
+   stConfig.LNA_CONFIG.bEnabled =      (bool)(pstRxMessage->ANT_MESSAGE_aucPayload[2] >> 4);
+   stConfig.LNA_CONFIG.bActiveState =  (bool)(pstRxMessage->ANT_MESSAGE_aucPayload[2] & 0xF);
+   stConfig.LNA_CONFIG.ucGPIO =        pstRxMessage->ANT_MESSAGE_aucPayload[3];
+
+   stConfig.ucGPIOTECh =               PA_LNA_GPIOTE_CH;
+   stConfig.ucPPIChEnable =            PA_LNA_PPI_CH_ENABLE;
+   stConfig.ucPPIChDisable =           PA_LNA_PPI_CH_DISABLE;
+
+   pstCmdResp->ucResponse = sd_ant_config_pa_lna_set(&stConfig);
+}
+
+static void Command_ChannelCRCMode(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = sd_ant_channel_radio_crc_mode_set(
+      pstRxMessage->ANT_MESSAGE_ucChannel,
+      pstRxMessage->ANT_MESSAGE_aucPayload[0]);
+}
+
+///////////////////////////////////////////////////////////////////////
+// Extended ID Messages
+///////////////////////////////////////////////////////////////////////
+static void Command_ExtMessage(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   uint16_t usExtID = (((uint16_t)(pstRxMessage->ANT_MESSAGE_ucMesgID)) << 8) | (pstRxMessage->ANT_MESSAGE_ucSubID);
+   const COMMAND_ENTRY *pstEntry = Command_ExtEntry(usExtID);
+
+   pstCmdResp->ucResponseID = pstRxMessage->ANT_MESSAGE_ucMesgID;
+   pstCmdResp->ucResponseSubID = pstRxMessage->ANT_MESSAGE_ucSubID;
+   pstCmdResp->ucChannel = 0;
+
+   if ((pstEntry == NULL) || (pstEntry->pfCommand == NULL) || (pstRxMessage->ANT_MESSAGE_ucSize < pstEntry->ucMinSize))
+   {
+      pstCmdResp->ucResponse = INVALID_MESSAGE;
+      return;
+   }
+
+   pstCmdResp->bExtIDResponse = true;
+   pstEntry->pfCommand(pstRxMessage, pstTxMessage, pstCmdResp);
+}
+
+static void Command_ExtRequest(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   uint16_t usExtID = (((uint16_t)(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1])) << 8) | (pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2]);
+   const COMMAND_ENTRY *pstEntry = Command_ExtEntry(usExtID);
+
+   if ((pstTxMessage == NULL) || (pstEntry == NULL) || (pstEntry->pfRequest == NULL))
+   {
+      pstCmdResp->ucResponse = INVALID_MESSAGE;
+      pstCmdResp->bExtIDResponse = false;
+      return;
+   }
+
+   pstTxMessage->ANT_MESSAGE_ucMesgID = (uint8_t) (usExtID >> 8);
+   pstTxMessage->ANT_MESSAGE_ucSubID = (uint8_t) usExtID;
+
+   pstEntry->pfRequest(pstRxMessage, pstTxMessage, pstCmdResp);
+
+   if (pstCmdResp->ucResponse)
+   {
+      pstCmdResp->ucResponseID = pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1];
+      pstCmdResp->ucResponseSubID = pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_2];
+   }
+}
+
+static void Command_ExtRequestSyncSerialBitRate(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   // Reserving ability to use SERIAL_DATA_OFFSET_3 as a selector for other requests (current active baudrate? other?)
+   if (!pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_3])
+   {
+      pstTxMessage->ANT_MESSAGE_ucSize = MESG_SET_BIT_RATE_REQ_SIZE;
+      pstTxMessage->ANT_MESSAGE_ucMesgID =      (uint8_t)(MESG_SET_SYNC_SERIAL_BIT_RATE >> 8);
+      pstTxMessage->ANT_MESSAGE_ucSubID  =      (uint8_t)(MESG_SET_SYNC_SERIAL_BIT_RATE);
+      pstTxMessage->ANT_MESSAGE_aucPayload[0] = 0;
+      pstTxMessage->ANT_MESSAGE_aucPayload[1] = (uint8_t)(BIT_RATE_SUPPORTED_BITFIELD);
+   }
+   else
+   {
+      pstCmdResp->ucResponse = INVALID_PARAMETER_PROVIDED;
+   }
+}
+
+static void Command_ExtRequestAsyncBaudrate(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   // Reserving ability to use SERIAL_DATA_OFFSET_3 as a selector for other requests (current active baudrate? other?)
+   if (!pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_3])
+   {
+      pstTxMessage->ANT_MESSAGE_ucSize = MESG_SET_BAUDRATE_REQ_SIZE;
+      pstTxMessage->ANT_MESSAGE_ucMesgID =      (uint8_t)(MESG_SET_ASYNC_BAUDRATE >> 8);
+      pstTxMessage->ANT_MESSAGE_ucSubID  =      (uint8_t)(MESG_SET_ASYNC_BAUDRATE);
+      pstTxMessage->ANT_MESSAGE_aucPayload[0] = 0;
+      pstTxMessage->ANT_MESSAGE_aucPayload[1] = (uint8_t)(BAUD_SUPPORTED_BITFIELD);
+      pstTxMessage->ANT_MESSAGE_aucPayload[2] = (uint8_t)(BAUD_SUPPORTED_BITFIELD >> 8);
+   }
+   else
+   {
+      pstCmdResp->ucResponse = INVALID_PARAMETER_PROVIDED;
+   }
+}
+
+static void Command_ExtRequestRSSICal(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   /* Returns RSSI calibration values */
+   System_GetRSSICalDataMesg(pstTxMessage);
+}
+
+static void Command_ExtRequestBurstAggregationConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstTxMessage->ANT_MESSAGE_ucSize = MESG_BURST_AGGREGATION_CONFIG_SIZE;
+   pstTxMessage->ANT_MESSAGE_aucPayload[0] = event_buffering_burst_aggregation_get();
+}
+
+static void Command_ExtRequestANTMemoryConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   System_GetANTMemoryConfigMesg(pstTxMessage);
+}
+
+static void Command_ExtRequestEventBufferingDrainConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstTxMessage->ANT_MESSAGE_ucSize = MESG_EVENT_BUFFERING_DRAIN_CONFIG_SIZE;
+   pstTxMessage->ANT_MESSAGE_aucPayload[0] = event_buffering_drain_weight_get();
+}
+
+static void Command_ExtRequestEventTimestampConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstTxMessage->ANT_MESSAGE_ucSize = MESG_EVENT_TIMESTAMP_CONFIG_SIZE;
+   pstTxMessage->ANT_MESSAGE_aucPayload[0] = event_buffering_timestamp_get();
+}
+
+static void Command_ExtRequestChannelProfile(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstTxMessage->ANT_MESSAGE_ucSize = CHANNEL_PROFILE_REQ_SIZE;
+   pstTxMessage->ANT_MESSAGE_aucPayload[0] = channel_profile_stored_get();
+   pstTxMessage->ANT_MESSAGE_aucPayload[1] = channel_profile_boot_get();
+   DSI_PutUShort(channel_profile_free_get(), &pstTxMessage->ANT_MESSAGE_aucPayload[2]);
+}
+
+#if !defined (EVENT_TRACE_DISABLE)
+static void Command_ExtRequestEventTrace(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   uint16_t usSequence = 0; // oldest record held if no sequence is given
+
+   if (pstRxMessage->ANT_MESSAGE_ucSize >= COMMAND_MIN_SIZE(SERIAL_DATA_OFFSET_4 + 1))
+      usSequence = DSI_GetUShort(&pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_3]);
+
+   event_trace_mesg_get(usSequence, pstTxMessage);
+}
+#endif // !EVENT_TRACE_DISABLE
+
+#if defined (CYCLE_PROFILING)
+static void Command_ExtRequestCycleProfile(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   uint8_t ucRegion = 0; // first region if no region is given
+
+   if (pstRxMessage->ANT_MESSAGE_ucSize >= COMMAND_MIN_SIZE(SERIAL_DATA_OFFSET_3 + 1))
+      ucRegion = pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_3];
+
+   if (!cycle_profile_mesg_get(ucRegion, pstTxMessage))
+      pstCmdResp->ucResponse = INVALID_PARAMETER_PROVIDED;
+}
+#endif // CYCLE_PROFILING
+
+static void Command_ExtSyncSerialBitRate(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = Serial_SetByteSyncSerialBitRate(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
+}
+
+static void Command_ExtSyncSerialSRDYSleep(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = Serial_SetByteSyncSerialSRDYSleep(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
+}
+
+static void Command_ExtAsyncBaudrate(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = Serial_SetAsyncBaudrate((BAUDRATE_TYPE)pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
+}
+
+static void Command_ExtDCToDC(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = System_SetDCToDC(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
+}
+
+static void Command_ExtRSSICal(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   /* Writes RSSI calibration */
+   pstCmdResp->ucResponse = System_SetRSSICal(pstRxMessage);
+}
+
+static void Command_ExtBurstAggregationConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   if (pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1] > 1)
+      pstCmdResp->ucResponse = INVALID_PARAMETER_PROVIDED;
+   else
+      event_buffering_burst_aggregation_set(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
+}
+
+static void Command_ExtANTMemoryConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = System_SetANTMemoryConfig(pstRxMessage, pstTxMessage);
+}
+
+static void Command_ExtCommandBatch(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   Command_BatchProcess(pstRxMessage, pstTxMessage);
+}
+
+static void Command_ExtChannelProfile(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   pstCmdResp->ucResponse = Command_ProfileProcess(pstRxMessage, pstTxMessage);
+}
+
+static void Command_ExtEventTimestampConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   if (pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1] > 1)
+      pstCmdResp->ucResponse = INVALID_PARAMETER_PROVIDED;
+   else
+      event_buffering_timestamp_set(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
+}
+
+#if !defined (EVENT_TRACE_DISABLE)
+static void Command_ExtEventTrace(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   if (pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1] & ~EVENT_TRACE_CONFIG_MASK)
+      pstCmdResp->ucResponse = INVALID_PARAMETER_PROVIDED;
+   else
+      event_trace_config_set(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]); // clears the trace
+}
+#endif // !EVENT_TRACE_DISABLE
+
+#if defined (CYCLE_PROFILING)
+static void Command_ExtCycleProfile(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   cycle_profile_clear();
+}
+#endif // CYCLE_PROFILING
+
+static void Command_ExtEventBufferingDrainConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   if (pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1] == 0) // the low priority lane would starve
+      pstCmdResp->ucResponse = INVALID_PARAMETER_PROVIDED;
+   else
+      event_buffering_drain_weight_set(pstRxMessage->ANT_MESSAGE_aucPayload[SERIAL_DATA_OFFSET_1]);
+}
+
+#if !defined(SERIAL_NUMBER_NOT_AVAILABLE)
+static void Command_ExtSetSerialNum(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage, COMMAND_RESPONSE *pstCmdResp)
+{
+   /* Sets the specified ID with the value passed in */
+   pstCmdResp->ucResponse = System_SetSerialNum(pstRxMessage);
+}
+#endif // !SERIAL_NUMBER_NOT_AVAILABLE
+
+static const COMMAND_ENTRY astCommandTable[256] =
+{
+   // Data Messages
+   [MESG_BROADCAST_DATA_ID]               = { Command_BroadcastData,          NULL,                                  COMMAND_MIN_SIZE(0),                 COMMAND_FLAG_CHANNEL },
+   [MESG_ACKNOWLEDGED_DATA_ID]            = { Command_AcknowledgedData,       NULL,                                  COMMAND_MIN_SIZE(0),                 COMMAND_FLAG_CHANNEL },
+   [MESG_EXT_BROADCAST_DATA_ID]           = { Command_ExtBroadcastData,       NULL,                                  COMMAND_MIN_SIZE(ANT_ID_SIZE),       COMMAND_FLAG_CHANNEL },
+   [MESG_EXT_ACKNOWLEDGED_DATA_ID]        = { Command_ExtAcknowledgedData,    NULL,                                  COMMAND_MIN_SIZE(ANT_ID_SIZE),       COMMAND_FLAG_CHANNEL },
+   [MESG_BURST_DATA_ID]                   = { Command_BurstData,              NULL,                                  COMMAND_MIN_SIZE(0),                 COMMAND_FLAG_CHANNEL | COMMAND_FLAG_BURST },
+   [MESG_EXT_BURST_DATA_ID]               = { Command_BurstData,              NULL,                                  COMMAND_MIN_SIZE(ANT_ID_SIZE),       COMMAND_FLAG_CHANNEL | COMMAND_FLAG_BURST },
+   [MESG_ADV_BURST_DATA_ID]               = { Command_BurstData,              NULL,                                  COMMAND_MIN_SIZE(0),                 COMMAND_FLAG_CHANNEL | COMMAND_FLAG_BURST },
+
+   // Request Messages
+   [MESG_REQUEST_ID]                      = { Command_Request,                NULL,                                  COMMAND_MIN_SIZE(1),                 COMMAND_FLAG_CHANNEL },
+   [MESG_CHANNEL_STATUS_ID]               = { NULL,                           Command_RequestChannelStatus,          0,                                   0 },
+   [MESG_CAPABILITIES_ID]                 = { NULL,                           Command_RequestCapabilities,           0,                                   0 },
+   [MESG_VERSION_ID]                      = { NULL,                           Command_RequestVersion,                0,                                   0 },
+#if !defined (SERIAL_NUMBER_NOT_AVAILABLE)
+   [MESG_GET_SERIAL_NUM_ID]               = { NULL,                           Command_RequestSerialNumber,           0,                                   0 },
+#endif // !SERIAL_NUMBER_NOT_AVAILABLE
+
+   // Command Messages
+   [MESG_ASSIGN_CHANNEL_ID]               = { Command_AssignChannel,          NULL,                                  COMMAND_MIN_SIZE(2),                 COMMAND_FLAG_CHANNEL },
+   [MESG_UNASSIGN_CHANNEL_ID]             = { Command_UnassignChannel,        NULL,                                  COMMAND_MIN_SIZE(0),                 COMMAND_FLAG_CHANNEL },
+   [MESG_OPEN_CHANNEL_ID]                 = { Command_OpenChannel,            NULL,                                  COMMAND_MIN_SIZE(0),                 COMMAND_FLAG_CHANNEL },
+   [MESG_CLOSE_CHANNEL_ID]                = { Command_CloseChannel,           NULL,                                  COMMAND_MIN_SIZE(0),                 COMMAND_FLAG_CHANNEL },
+   [MESG_CHANNEL_ID_ID]                   = { Command_ChannelID,              Command_RequestChannelID,              COMMAND_MIN_SIZE(ANT_ID_SIZE),       COMMAND_FLAG_CHANNEL },
+   [MESG_CHANNEL_MESG_PERIOD_ID]          = { Command_ChannelPeriod,          NULL,                                  COMMAND_MIN_SIZE(2),                 COMMAND_FLAG_CHANNEL },
+   [MESG_PROX_SEARCH_CONFIG_ID]           = { Command_ProxSearchConfig,       NULL,                                  COMMAND_MIN_SIZE(1),                 COMMAND_FLAG_CHANNEL },
+   [MESG_CHANNEL_RADIO_FREQ_ID]           = { Command_ChannelRadioFreq,       NULL,                                  COMMAND_MIN_SIZE(1),                 COMMAND_FLAG_CHANNEL },
+   [MESG_RADIO_TX_POWER_ID]               = { Command_RadioTxPower,           NULL,                                  COMMAND_MIN_SIZE(1),                 COMMAND_FLAG_CHANNEL },
+   [MESG_CHANNEL_RADIO_TX_POWER_ID]       = { Command_ChannelRadioTxPower,    NULL,                                  COMMAND_MIN_SIZE(1),                 COMMAND_FLAG_CHANNEL },
+   [MESG_CHANNEL_SEARCH_TIMEOUT_ID]       = { Command_ChannelSearchTimeout,   NULL,                                  COMMAND_MIN_SIZE(1),                 COMMAND_FLAG_CHANNEL },
+   [MESG_SEARCH_WAVEFORM_ID]              = { Command_SearchWaveform,         NULL,                                  COMMAND_MIN_SIZE(2),                 COMMAND_FLAG_CHANNEL },
+   [MESG_NETWORK_KEY_ID]                  = { Command_NetworkKey,             NULL,                                  COMMAND_MIN_SIZE(8),                 COMMAND_FLAG_NETWORK },
+   [MESG_ANTLIB_CONFIG_ID]                = { Command_ANTLibConfig,           NULL,                                  COMMAND_MIN_SIZE(1),                 COMMAND_FLAG_CHANNEL },
+   [MESG_RX_EXT_MESGS_ENABLE_ID]          = { Command_RxExtMesgsEnable,       NULL,                                  COMMAND_MIN_SIZE(1),                 COMMAND_FLAG_CHANNEL },
+   [MESG_RADIO_CW_INIT_ID]                = { Command_RadioCWInit,            NULL,                                  COMMAND_MIN_SIZE(0),                 COMMAND_FLAG_CHANNEL },
+   [MESG_RADIO_CW_MODE_ID]                = { Command_RadioCWMode,            NULL,                                  COMMAND_MIN_SIZE(2),                 COMMAND_FLAG_CHANNEL },
+   [MESG_SYSTEM_RESET_ID]                 = { Command_SystemReset,            NULL,                                  COMMAND_MIN_SIZE(0),                 COMMAND_FLAG_CHANNEL },
+   [MESG_SLEEP_ID]                        = { Command_Sleep,                  NULL,                                  COMMAND_MIN_SIZE(0),                 COMMAND_FLAG_CHANNEL },
+   [MESG_ID_LIST_ADD_ID]                  = { Command_IDListAdd,              NULL,                                  COMMAND_MIN_SIZE(ANT_ID_SIZE + 1),   COMMAND_FLAG_CHANNEL },
+   [MESG_ID_LIST_CONFIG_ID]               = { Command_IDListConfig,           NULL,                                  COMMAND_MIN_SIZE(2),                 COMMAND_FLAG_CHANNEL },
+   [MESG_OPEN_RX_SCAN_ID]                 = { Command_OpenRxScan,             NULL,                                  COMMAND_MIN_SIZE(0),                 COMMAND_FLAG_CHANNEL },
+   [MESG_SET_LP_SEARCH_TIMEOUT_ID]        = { Command_LPSearchTimeout,        NULL,                                  COMMAND_MIN_SIZE(1),                 COMMAND_FLAG_CHANNEL },
+#if !defined (SERIAL_NUMBER_NOT_AVAILABLE)
+   [MESG_SERIAL_NUM_SET_CHANNEL_ID_ID]    = { Command_SerialNumSetChannelID,  NULL,                                  COMMAND_MIN_SIZE(2),                 COMMAND_FLAG_CHANNEL },
+#endif // !SERIAL_NUMBER_NOT_AVAILABLE
+   [MESG_SET_SEARCH_CH_PRIORITY_ID]       = { Command_SearchChannelPriority,  NULL,                                  COMMAND_MIN_SIZE(1),                 COMMAND_FLAG_CHANNEL },
+   [MESG_AUTO_FREQ_CONFIG_ID]             = { Command_AutoFreqConfig,         NULL,                                  COMMAND_MIN_SIZE(3),                 COMMAND_FLAG_CHANNEL },
+   [MESG_CONFIG_ADV_BURST_ID]             = { Command_AdvBurstConfig,         Command_RequestAdvBurstConfig,         COMMAND_MIN_SIZE(0),                 COMMAND_FLAG_CHANNEL },
+   [MESG_COEX_PRIORITY_CONFIG_ID]         = { Command_CoexPriorityConfig,     Command_RequestCoexPriorityConfig,     COMMAND_MIN_SIZE(0),                 COMMAND_FLAG_CHANNEL },
+   [MESG_COEX_ADV_PRIORITY_CONFIG_ID]     = { Command_CoexAdvPriorityConfig,  Command_RequestCoexAdvPriorityConfig,  COMMAND_MIN_SIZE(0),                 COMMAND_FLAG_CHANNEL },
+   [MESG_EVENT_BUFFERING_CONFIG_ID]       = { Command_EventBufferingConfig,   Command_RequestEventBufferingConfig,   COMMAND_MIN_SIZE(5),                 COMMAND_FLAG_CHANNEL },
+   [MESG_HIGH_DUTY_SEARCH_MODE_ID]        = { Command_HighDutySearchMode,     Command_RequestHighDutySearchMode,     MESG_HIGH_DUTY_SEARCH_MODE_EN_SIZE,  COMMAND_FLAG_CHANNEL },
+   [MESG_EVENT_FILTER_CONFIG_ID]          = { Command_EventFilterConfig,      Command_RequestEventFilterConfig,      COMMAND_MIN_SIZE(2),                 COMMAND_FLAG_CHANNEL },
+   [MESG_ACTIVE_SEARCH_SHARING_ID]        = { Command_ActiveSearchSharing,    Command_RequestActiveSearchSharing,    COMMAND_MIN_SIZE(1),                 COMMAND_FLAG_CHANNEL },
+   [MESG_SDU_CONFIG_ID]                   = { Command_SduConfig,              NULL,                                  COMMAND_MIN_SIZE(1),                 COMMAND_FLAG_CHANNEL },
+   [MESG_SDU_SET_MASK_ID]                 = { Command_SduSetMask,             Command_RequestSduMask,                COMMAND_MIN_SIZE(MESG_ANT_MAX_PAYLOAD_SIZE), COMMAND_FLAG_CHANNEL },
+   [MESG_ENCRYPT_ENABLE_ID]               = { Command_EncryptEnable,          Command_RequestEncryptInfo,            COMMAND_MIN_SIZE(3),                 COMMAND_FLAG_CHANNEL },
+   [MESG_SET_ENCRYPT_KEY_ID]              = { Command_SetEncryptKey,          NULL,                                  COMMAND_MIN_SIZE(0),                 COMMAND_FLAG_CHANNEL },
+   [MESG_SET_ENCRYPT_INFO_ID]             = { Command_SetEncryptInfo,         NULL,                                  COMMAND_MIN_SIZE(0),                 COMMAND_FLAG_CHANNEL },
+   [MESG_RFACTIVE_NOTIFICATION_ID]        = { Command_RFActiveNotification,   Command_RequestRFActiveNotification,   COMMAND_MIN_SIZE(3),                 COMMAND_FLAG_CHANNEL },
+   [MESG_PA_LNA_CONFIG_ID]                = { Command_PALNAConfig,            Command_RequestPALNAConfig,            MESG_PA_LNA_CONFIG_SIZE,             COMMAND_FLAG_CHANNEL },
+   [MESG_CHANNEL_CRC_MODE_ID]             = { Command_ChannelCRCMode,         Command_RequestChannelCRCMode,         MESG_CHANNEL_CRC_MODE_SIZE,          COMMAND_FLAG_CHANNEL },
+
+   // Extended ID Messages
+   [MESG_EXT_ID_0]                        = { Command_ExtMessage,             NULL,                                  COMMAND_MIN_SIZE(0),                 0 },
+   [MESG_EXT_ID_1]                        = { Command_ExtMessage,             NULL,                                  COMMAND_MIN_SIZE(0),                 0 },
+   [MESG_EXT_ID_2]                        = { Command_ExtMessage,             NULL,                                  COMMAND_MIN_SIZE(0),                 0 },
+   [MESG_EXT_ID_3]                        = { Command_ExtMessage,             NULL,                                  COMMAND_MIN_SIZE(0),                 0 },
+   [MESG_EXT_ID_4]                        = { Command_ExtMessage,             NULL,                                  COMMAND_MIN_SIZE(0),                 0 },
+};
+
+static const COMMAND_ENTRY astExtCommandTable1[] =
+{
+   [(uint8_t)MESG_EXT_REQUEST_ID]                  = { Command_ExtRequest,                 NULL,                                          COMMAND_MIN_SIZE(2), 0 },
+   [(uint8_t)MESG_SET_SYNC_SERIAL_BIT_RATE]        = { Command_ExtSyncSerialBitRate,       Command_ExtRequestSyncSerialBitRate,           COMMAND_MIN_SIZE(1), 0 },
+   [(uint8_t)MESG_SET_SYNC_SERIAL_SRDY_SLEEP]      = { Command_ExtSyncSerialSRDYSleep,     NULL,                                          COMMAND_MIN_SIZE(1), 0 },
+   [(uint8_t)MESG_SET_ASYNC_BAUDRATE]              = { Command_ExtAsyncBaudrate,           Command_ExtRequestAsyncBaudrate,               COMMAND_MIN_SIZE(1), 0 },
+   [(uint8_t)MESG_SET_DC_TO_DC]                    = { Command_ExtDCToDC,                  NULL,                                          COMMAND_MIN_SIZE(1), 0 },
+};
+
+static const COMMAND_ENTRY astExtCommandTable4[] =
+{
+   [(uint8_t)MESG_RSSI_CAL_ID]                     = { Command_ExtRSSICal,                 Command_ExtRequestRSSICal,                     COMMAND_MIN_SIZE(0), 0 },
+#if !defined(SERIAL_NUMBER_NOT_AVAILABLE)
+   [(uint8_t)MESG_SET_SERIAL_NUM_ID]               = { Command_ExtSetSerialNum,            NULL,                                          COMMAND_MIN_SIZE(0), 0 },
+#endif // !SERIAL_NUMBER_NOT_AVAILABLE
+   [(uint8_t)MESG_BURST_AGGREGATION_CONFIG_ID]     = { Command_ExtBurstAggregationConfig,  Command_ExtRequestBurstAggregationConfig,      COMMAND_MIN_SIZE(1), 0 },
+   [(uint8_t)MESG_EVENT_BUFFERING_DRAIN_CONFIG_ID] = { Command_ExtEventBufferingDrainConfig, Command_ExtRequestEventBufferingDrainConfig, COMMAND_MIN_SIZE(1), 0 },
+   [(uint8_t)MESG_ANT_MEMORY_CONFIG_ID]            = { Command_ExtANTMemoryConfig,         Command_ExtRequestANTMemoryConfig,             COMMAND_MIN_SIZE(0), 0 },
+   [(uint8_t)MESG_COMMAND_BATCH_ID]                = { Command_ExtCommandBatch,            NULL,                                          COMMAND_MIN_SIZE(0), 0 },
+   [(uint8_t)MESG_CHANNEL_PROFILE_ID]              = { Command_ExtChannelProfile,          Command_ExtRequestChannelProfile,              COMMAND_MIN_SIZE(0), 0 },
+   [(uint8_t)MESG_EVENT_TIMESTAMP_CONFIG_ID]       = { Command_ExtEventTimestampConfig,    Command_ExtRequestEventTimestampConfig,        COMMAND_MIN_SIZE(1), 0 },
+#if !defined (EVENT_TRACE_DISABLE)
+   [(uint8_t)MESG_EVENT_TRACE_ID]                  = { Command_ExtEventTrace,              Command_ExtRequestEventTrace,                  COMMAND_MIN_SIZE(1), 0 },
+#endif // !EVENT_TRACE_DISABLE
+#if defined (CYCLE_PROFILING)
+   [(uint8_t)MESG_CYCLE_PROFILE_ID]                = { Command_ExtCycleProfile,            Command_ExtRequestCycleProfile,                COMMAND_MIN_SIZE(0), 0 },
+#endif // CYCLE_PROFILING
+};
+
+static const COMMAND_EXT_PAGE astExtCommandPage[] =
+{
+   [MESG_EXT_ID_1 - MESG_EXT_ID_0]        = { astExtCommandTable1, sizeof(astExtCommandTable1) / sizeof(COMMAND_ENTRY) },
+   [MESG_EXT_ID_4 - MESG_EXT_ID_0]        = { astExtCommandTable4, sizeof(astExtCommandTable4) / sizeof(COMMAND_ENTRY) },
+};
+
+/**
+ * @brief Look up the dispatch entry of an extended ID, NULL if it has none
+ */
+static const COMMAND_ENTRY *Command_ExtEntry(uint16_t usExtID)
+{
+   uint8_t ucPage = (uint8_t)(usExtID >> 8) - MESG_EXT_ID_0;
+   uint8_t ucSubID = (uint8_t)usExtID;
+
+   if ((ucPage >= (sizeof(astExtCommandPage) / sizeof(COMMAND_EXT_PAGE))) || (ucSubID >= astExtCommandPage[ucPage].ucCount))
+      return NULL;
+
+   return &astExtCommandPage[ucPage].pastEntry[ucSubID];
+}
+
+/**
+ * @brief ANT serial command message handler
+ */
+void Command_SerialMessageProcess(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage)
+{
+   COMMAND_RESPONSE stCmdResp;
+   const COMMAND_ENTRY *pstEntry = &astCommandTable[pstRxMessage->ANT_MESSAGE_ucMesgID];
+
+   // initialize a response message
+   stCmdResp.ucChannel    = pstRxMessage->ANT_MESSAGE_ucChannel & CHANNEL_NUMBER_MASK; // save the channel number for the response
+   stCmdResp.ucResponseID = pstRxMessage->ANT_MESSAGE_ucMesgID; // save the message ID
+   stCmdResp.ucResponse   = RESPONSE_NO_ERROR; // initialize the response field to no error
+   stCmdResp.bExtIDResponse = false; // by default, non-extended ID response
+
+   if (pstTxMessage != NULL)
+      pstTxMessage->ANT_MESSAGE_ucSize = 0;   // init the transmit message size to 0
+
+   #if defined (USE_INTERFACE_LOCK)
+      if (bInterfaceLock) // handles interface lockout condition
+      {
+         if (pstRxMessage->ANT_MESSAGE_ucMesgID == MESG_UNLOCK_INTERFACE_ID)
+            bInterfaceLock = false;
+         else
+            stCmdResp.ucResponse = RETURN_TO_MFG; // standard response when interface locked out
+
+         if (pstTxMessage != NULL)
+            Command_ResponseMessage(stCmdResp, pstTxMessage);
+
+         return;
+      }
+   #endif // USE_INTERFACE_LOCK
+
+   if ((pstEntry->pfCommand == NULL) ||
+       (pstRxMessage->ANT_MESSAGE_ucSize < pstEntry->ucMinSize) ||
+       ((pstEntry->ucFlags & COMMAND_FLAG_CHANNEL) && (stCmdResp.ucChannel >= stANTChannelEnable.ucTotalNumberOfChannels)) ||
+       ((pstEntry->ucFlags & COMMAND_FLAG_NETWORK) && (stCmdResp.ucChannel >= MAX_NETWORKS)))
+   {
+      stCmdResp.ucResponse = INVALID_MESSAGE;
+   }
+   else
+   {
+      pstEntry->pfCommand(pstRxMessage, pstTxMessage, &stCmdResp);
+
+      if ((pstEntry->ucFlags & COMMAND_FLAG_BURST) && (stCmdResp.ucResponse == NO_RESPONSE_MESSAGE))
+         return; // queued for the burst handler, which answers and releases the receive buffer
+   }
+
+   if (stCmdResp.ucResponse == NRF_ERROR_NOT_SUPPORTED)
+      stCmdResp.ucResponse = INVALID_MESSAGE;
+
+   if (pstTxMessage == NULL) // don't send a response if no buffer provided and don't release RTS
+      return;
+
+   Command_ResponseMessage(stCmdResp, pstTxMessage);
+}
+
+/**
+ * @brief ANT serial command response handler
+ */
+void Command_ResponseMessage(COMMAND_RESPONSE stCmdResp, ANT_MESSAGE *pstTxMessage)
+{
+   if (bBatchProcess) // the batch is answered once for all of its commands
+   {
+      ucBatchResponse = stCmdResp.ucResponse;
+      return;
+   }
 
    if (!pstTxMessage->ANT_MESSAGE_ucSize)
    {
@@ -0,0 +1,107 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+#include <string.h>
+
+#include "nrf.h"
+#include "nrf_nvic.h"
+#include "appconfig.h"
+#include "ant_parameters.h"
+#include "cycle_profile.h"
+#include "dsi_utility.h"
+
+#if defined (CYCLE_PROFILING)
+
+#define CYCLE_PROFILE_REGION_OFFSET       0
+#define CYCLE_PROFILE_REGIONS_OFFSET      1
+#define CYCLE_PROFILE_COUNT_OFFSET        2
+#define CYCLE_PROFILE_MIN_OFFSET          6
+#define CYCLE_PROFILE_MAX_OFFSET          10
+#define CYCLE_PROFILE_AVG_OFFSET          14
+
+typedef struct
+{
+   uint32_t ulCount;
+   uint32_t ulMin;
+   uint32_t ulMax;
+   uint64_t ullTotal;
+} cycle_profile_stats_t;
+
+static cycle_profile_stats_t astStats[CYCLE_PROFILE_REGIONS];
+
+void cycle_profile_init(void)
+{
+   CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+   DWT->CYCCNT = 0;
+   DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+   cycle_profile_clear();
+}
+
+// A region is only recorded from one context level, nothing preempts the
+// update but the thread context reader and clear, which hold a critical region.
+void cycle_profile_record(cycle_profile_region_t eRegion, uint32_t ulCycles)
+{
+   cycle_profile_stats_t *pstStats = &astStats[eRegion];
+
+   if (pstStats->ulCount == UINT32_MAX)
+   {
+      return; // keep the average consistent once the count saturates
+   }
+
+   if (!pstStats->ulCount || (ulCycles < pstStats->ulMin))
+   {
+      pstStats->ulMin = ulCycles;
+   }
+   if (ulCycles > pstStats->ulMax)
+   {
+      pstStats->ulMax = ulCycles;
+   }
+   pstStats->ullTotal += ulCycles;
+   pstStats->ulCount++;
+}
+
+void cycle_profile_clear(void)
+{
+   uint8_t bNested;
+
+   sd_nvic_critical_region_enter(&bNested);
+   memset(astStats, 0, sizeof(astStats));
+   sd_nvic_critical_region_exit(bNested);
+}
+
+bool cycle_profile_mesg_get(uint8_t ucRegion, ANT_MESSAGE *pstTxMessage)
+{
+   uint8_t bNested;
+   cycle_profile_stats_t stStats;
+
+   if (ucRegion >= CYCLE_PROFILE_REGIONS)
+   {
+      return false;
+   }
+
+   sd_nvic_critical_region_enter(&bNested);
+   stStats = astStats[ucRegion];
+   sd_nvic_critical_region_exit(bNested);
+
+   pstTxMessage->ANT_MESSAGE_ucSize = MESG_CYCLE_PROFILE_SIZE;
+   pstTxMessage->ANT_MESSAGE_ucMesgID = (uint8_t)(MESG_CYCLE_PROFILE_ID >> 8);
+   pstTxMessage->ANT_MESSAGE_ucSubID = (uint8_t)(MESG_CYCLE_PROFILE_ID);
+   pstTxMessage->ANT_MESSAGE_aucPayload[CYCLE_PROFILE_REGION_OFFSET] = ucRegion;
+   pstTxMessage->ANT_MESSAGE_aucPayload[CYCLE_PROFILE_REGIONS_OFFSET] = CYCLE_PROFILE_REGIONS;
+   DSI_PutULong(stStats.ulCount, &pstTxMessage->ANT_MESSAGE_aucPayload[CYCLE_PROFILE_COUNT_OFFSET]);
+   DSI_PutULong(stStats.ulMin, &pstTxMessage->ANT_MESSAGE_aucPayload[CYCLE_PROFILE_MIN_OFFSET]);
+   DSI_PutULong(stStats.ulMax, &pstTxMessage->ANT_MESSAGE_aucPayload[CYCLE_PROFILE_MAX_OFFSET]);
+   DSI_PutULong(stStats.ulCount ? (uint32_t)(stStats.ullTotal / stStats.ulCount) : 0,
+      &pstTxMessage->ANT_MESSAGE_aucPayload[CYCLE_PROFILE_AVG_OFFSET]);
+
+   return true;
+}
+
+#endif // CYCLE_PROFILING
@@ -12,6 +12,7 @@ All rights reserved.
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "appconfig.h"
 
@@ -68,6 +69,20 @@ void DSI_PutUShort(uint16_t usVal, uint8_t *pucData)
    *pucData = stData.stBytes.ucHigh;
 }
 
+/**
+ * @brief Write unsigned 32-bit from buffer (little endian)
+ */
+void DSI_PutULong(uint32_t ulVal, uint8_t *pucData)
+{
+   uint32_t_UNION stData;
+
+   stData.ulData = ulVal;
+   *pucData++ = stData.stBytes.ucByte0;
+   *pucData++ = stData.stBytes.ucByte1;
+   *pucData++ = stData.stBytes.ucByte2;
+   *pucData = stData.stBytes.ucByte3;
+}
+
 /**
  * @brief Read unsigned 32-bit from buffer (little endian)
  */
@@ -115,3 +130,36 @@ bool DSI_memcmp(uint8_t *pucSrc1, uint8_t *pucSrc2, uint8_t ucSize)
    return 0; // match, replicate memcmp return behaviour
 }
 
+/**
+ * @brief Buffer XOR checksum utility, starting from ucCheckSum
+ */
+uint8_t DSI_CheckSum(uint8_t *pucData, uint8_t ucSize, uint8_t ucCheckSum)
+{
+   uint32_t_UNION stWord;
+   uint32_t ulData;
+
+   while (ucSize && ((uintptr_t)pucData & 0x03)) // bytes up to the first word boundary
+   {
+      ucCheckSum ^= *(pucData++);
+      ucSize--;
+   }
+
+   // XOR is bytewise, so whole words can be folded and reduced to a byte at the end.
+   // Words are loaded with memcpy to keep within the aliasing rules, an aligned
+   // word copy compiles to a single load.
+   stWord.ulData = 0;
+   while (ucSize >= sizeof(uint32_t))
+   {
+      memcpy(&ulData, pucData, sizeof(ulData));
+      stWord.ulData ^= ulData;
+      pucData += sizeof(uint32_t);
+      ucSize -= sizeof(uint32_t);
+   }
+   ucCheckSum ^= stWord.stBytes.ucByte0 ^ stWord.stBytes.ucByte1 ^ stWord.stBytes.ucByte2 ^ stWord.stBytes.ucByte3;
+
+   while (ucSize--) // remaining bytes
+      ucCheckSum ^= *(pucData++);
+
+   return ucCheckSum;
+}
+
@@ -7,6 +7,8 @@ Copyright (c) Garmin Canada Inc. 2019
 All rights reserved.
 */
 
+#include <string.h>
+
 #include "nrf_nvic.h"
 #include "appconfig.h"
 #include "ant_interface.h"
@@ -14,26 +16,84 @@ All rights reserved.
 #include "dsi_utility.h"
 #include "event_buffering.h"
 #include "multi_ctx_fifo.h"
+#include "ram_arena.h"
 #include "system.h"
 
 #define TIMEBASE_CONVERSION_TO_10MS       ((uint16_t) 328) //convert # in 10ms time frame to # of ticks (32768 time base)
+#define SYS_TIME_ALARM_MAX_TICKS          ((uint32_t) 0x400000) //keep flush timer alarms well within the 24 bit RTC range
 
 // TODO: These should probably go in ant_parameters.h
 #define EVENT_BUFFER_CONFIG_LOW_PRIO      0x00
 #define EVENT_BUFFER_CONFIG_ALL           0x01
+#define EVENT_BUFFER_CONFIG_MODE_MASK     0x7F
+// Flag: a broadcast rx event replaces the unsent one of the same channel (and device in scan mode).
+#define EVENT_BUFFER_CONFIG_COALESCE_RX   0x80
+
+// Number of channel/device pairs tracked for coalescing, beyond that events are queued.
+#define EVENT_COALESCE_TABLE_SIZE         16
+
+#define BURST_AGGREGATE_HEADER_SIZE       ((uint8_t)3) // sub ID, channel and sequence, packet count
+#define BURST_AGGREGATE_CHANNEL_OFFSET    0
+#define BURST_AGGREGATE_COUNT_OFFSET      1
+#define BURST_AGGREGATE_DATA_OFFSET       2
+#define BURST_AGGREGATE_MAX_PACKETS       ((MESG_MAX_SIZE_VALUE - BURST_AGGREGATE_HEADER_SIZE) / ANT_STANDARD_DATA_PAYLOAD_SIZE)
 
 static volatile bool bFlushing;
+static volatile bool bFlushTimerArmed;
 
 static uint8_t ucConfig;
 static uint16_t usSizeThreshold;
 static uint32_t ulTimeThreshold;
 static uint32_t ulFlushTime;
 
-static multi_ctx_fifo_t stEventFifo;
+// Events that are not bufferable are sent as soon as possible from the high
+// priority lane. Bufferable events wait in the low priority lane for a flush.
+static multi_ctx_fifo_t stHighFifo;
+static multi_ctx_fifo_t stLowFifo;
+
+// Number of high priority events sent in a row while low priority events are
+// flushing before one low priority event is let through, at least 1.
+static uint8_t ucDrainWeight;
+static uint8_t ucHighRun;
+
+typedef struct
+{
+   bool bValid;
+   uint8_t ucChannel;
+   uint8_t ucSize;
+   uint32_t ulDeviceID;       // device ID from the extended data, 0 if not present
+   multi_ctx_fifo_t *pstFifo; // lane holding the unsent event
+   fifo_offset_t uiOffset;    // record of the unsent event in the fifo
+} coalesce_entry_t;
+
+// Latest unsent broadcast event of each channel/device. An entry is valid
+// only while its record has not been claimed.
+static coalesce_entry_t astCoalesce[EVENT_COALESCE_TABLE_SIZE];
+
+static bool bBurstAggregation;
+// Aggregated burst frame being assembled, message size is 0 if there is none.
+static ant_event_t stBurstAggregate;
+// Sequence number of the last packet added to the aggregated burst frame.
+static uint8_t ucBurstAggregateSequence;
+
+static bool bTimestampAppend;
 
 static bool is_event_bufferable(uint8_t event)
 {
-   switch (ucConfig)
+   // Command responses put by the application are never held back.
+   if (event == NO_EVENT)
+   {
+      return false;
+   }
+
+   // Without a threshold every event is flushed right away, keep them all in
+   // one lane so they are sent in the order they were received.
+   if ((usSizeThreshold == 0) && (ulTimeThreshold == 0))
+   {
+      return false;
+   }
+
+   switch (ucConfig & EVENT_BUFFER_CONFIG_MODE_MASK)
    {
       case EVENT_BUFFER_CONFIG_LOW_PRIO:
          switch (event)
@@ -58,73 +118,502 @@ static bool has_flush_timeout_expired(void)
       ((System_GetTime_32K() - ulFlushTime) >= ulTimeThreshold);
 }
 
-void event_buffering_init(void)
+// Arm the flush timer for the time threshold, measured from the last flush.
+// The alarm only spans part of the RTC range, longer thresholds are re-armed on expiry.
+static void flush_timer_arm(void)
 {
-   bFlushing = false;
-   ucConfig = DEFAULT_EVENT_BUFFERING_CONFIG;
-   usSizeThreshold = DEFAULT_EVENT_BUFFERING_SIZE_THRESHOLD;
-   ulTimeThreshold = DEFAULT_EVENT_BUFFERING_TIME_THRESHOLD;
-   ulFlushTime = System_GetTime_32K();
+   uint32_t ulTimeLeft = ulTimeThreshold - (System_GetTime_32K() - ulFlushTime);
+
+   if (ulTimeLeft > SYS_TIME_ALARM_MAX_TICKS)
+   {
+      ulTimeLeft = SYS_TIME_ALARM_MAX_TICKS;
+   }
+
+   bFlushTimerArmed = true;
+   if (!System_TimerAlarmSet(System_GetTime_32K() + ulTimeLeft))
+   {
+      event_buffering_flush(); // threshold is about to expire
+   }
+}
+
+static bool is_burst_packet(const ant_event_t *pstEvent)
+{
+   // Only standard packets without extended data are aggregated.
+   return (pstEvent->stHeader.ucEvent == EVENT_RX) &&
+      (pstEvent->stMessage.ANT_MESSAGE_ucMesgID == MESG_BURST_DATA_ID) &&
+      (pstEvent->stMessage.ANT_MESSAGE_ucSize == (MESG_CHANNEL_NUM_SIZE + ANT_STANDARD_DATA_PAYLOAD_SIZE));
+}
+
+// Append the event timestamp to received data messages as extended data.
+// A message that already carries it is left as is, failed puts are retried
+// with the same event.
+static void event_timestamp_append(ant_event_t *pstEvent)
+{
+   ANT_MESSAGE *pstMessage = &pstEvent->stMessage;
+   uint8_t *pucFlags = &pstMessage->ANT_MESSAGE_aucPayload[ANT_STANDARD_DATA_PAYLOAD_SIZE];
+   uint8_t ucSize = pstMessage->ANT_MESSAGE_ucSize;
 
-   mc_fifo_init(&stEventFifo, ANT_STACK_MESSAGE_QUEUE_SIZE);
+   if ((pstEvent->stHeader.ucEvent != EVENT_RX) ||
+      (ucSize < (MESG_CHANNEL_NUM_SIZE + ANT_STANDARD_DATA_PAYLOAD_SIZE)))
+   {
+      return;
+   }
+
+   switch (pstMessage->ANT_MESSAGE_ucMesgID)
+   {
+      case MESG_BROADCAST_DATA_ID:
+      case MESG_ACKNOWLEDGED_DATA_ID:
+      case MESG_BURST_DATA_ID:
+         break;
+
+      default:
+         return;
+   }
+
+   if (ucSize == (MESG_CHANNEL_NUM_SIZE + ANT_STANDARD_DATA_PAYLOAD_SIZE))
+   {
+      if ((ucSize + MESG_EXT_MESG_BF_SIZE + ANT_EXT_MESG_NP_TIMESTAMP_FIELD_SIZE) > MESG_MAX_SIZE_VALUE)
+      {
+         return;
+      }
+
+      *pucFlags = 0;
+      ucSize += MESG_EXT_MESG_BF_SIZE;
+   }
+   else if ((*pucFlags & ANT_EXT_MESG_BITFIELD_NP_TIMESTAMP) ||
+      ((ucSize + ANT_EXT_MESG_NP_TIMESTAMP_FIELD_SIZE) > MESG_MAX_SIZE_VALUE))
+   {
+      return;
+   }
+
+   *pucFlags |= ANT_EXT_MESG_BITFIELD_NP_TIMESTAMP;
+   memcpy(&pstMessage->ANT_MESSAGE_aucMesgData[ucSize], pstEvent->stHeader.aucTimestamp, ANT_EXT_MESG_NP_TIMESTAMP_FIELD_SIZE);
+   pstMessage->ANT_MESSAGE_ucSize = ucSize + ANT_EXT_MESG_NP_TIMESTAMP_FIELD_SIZE;
+}
+
+static uint8_t burst_sequence_next(uint8_t ucSequence)
+{
+   if (ucSequence == SEQUENCE_NUMBER_ROLLOVER)
+   {
+      return SEQUENCE_NUMBER_INC;
+   }
+
+   return ucSequence + SEQUENCE_NUMBER_INC;
+}
+
+static uint32_t event_device_id(const ant_event_t *pstEvent)
+{
+   const ANT_MESSAGE *pstMessage = &pstEvent->stMessage;
+
+   if ((pstMessage->ANT_MESSAGE_ucSize >= (MESG_CHANNEL_NUM_SIZE + ANT_STANDARD_DATA_PAYLOAD_SIZE + MESG_EXT_MESG_BF_SIZE + ANT_EXT_MESG_DEVICE_ID_FIELD_SIZE)) &&
+      (pstMessage->ANT_MESSAGE_aucPayload[ANT_STANDARD_DATA_PAYLOAD_SIZE] & ANT_EXT_MESG_BITFIELD_DEVICE_ID))
+   {
+      return DSI_GetULong((uint8_t *)&pstMessage->ANT_MESSAGE_aucPayload[ANT_STANDARD_DATA_PAYLOAD_SIZE + MESG_EXT_MESG_BF_SIZE]);
+   }
+
+   return 0;
+}
+
+static void coalesce_reset(void)
+{
+   for (uint8_t i = 0; i < EVENT_COALESCE_TABLE_SIZE; i++)
+   {
+      astCoalesce[i].bValid = false;
+   }
 }
 
-bool event_buffering_put(const ant_event_t *pstEvent)
+static bool event_push(ant_event_t *pstEvent, multi_ctx_fifo_t **ppstFifo, fifo_offset_t *puiOffset)
 {
+   bool bBufferable = is_event_bufferable(pstEvent->stHeader.ucEvent);
+   multi_ctx_fifo_t *pstFifo = bBufferable ? &stLowFifo : &stHighFifo;
    fifo_offset_t uiTotalSize =
       pstEvent->stMessage.ANT_MESSAGE_ucSize +
       sizeof(pstEvent->stHeader) +
-      MESG_SIZE_SIZE + MESG_ID_SIZE;
+      MESG_SYNC_SIZE + MESG_SIZE_SIZE + MESG_ID_SIZE + MESG_CHECKSUM_SIZE;
 
-   bool was_pushed = mc_fifo_push(&stEventFifo, &pstEvent->stHeader, uiTotalSize);
+   // Frame the event here so that it is ready to send once it reaches the head.
+   pstEvent->ucSyncByte = MESG_TX_SYNC;
+   pstEvent->stMessage.ANT_MESSAGE_aucMesgData[pstEvent->stMessage.ANT_MESSAGE_ucSize] =
+      DSI_CheckSum(pstEvent->stMessage.aucMessage,
+         pstEvent->stMessage.ANT_MESSAGE_ucSize + MESG_SIZE_SIZE + MESG_ID_SIZE,
+         MESG_TX_SYNC);
 
    // Use header pointer to skip the padding.
+   bool was_pushed = mc_fifo_push_at(pstFifo, &pstEvent->stHeader, uiTotalSize, puiOffset);
+   *ppstFifo = pstFifo;
+
+   if (!bBufferable)
+   {
+      // The high priority lane is always sent, there is nothing to flush.
+      return was_pushed;
+   }
+
    if (!was_pushed ||
-      !is_event_bufferable(pstEvent->stHeader.ucEvent) ||
-      mc_fifo_get_data_len(&stEventFifo) > usSizeThreshold ||
+      mc_fifo_get_data_len(&stLowFifo) > usSizeThreshold ||
       has_flush_timeout_expired())
    {
       event_buffering_flush();
    }
+   else if (ulTimeThreshold != 0 && !bFlushTimerArmed)
+   {
+      // First event buffered since the last flush, bound its latency.
+      flush_timer_arm();
+   }
 
    return was_pushed;
 }
 
-bool event_buffering_get(ant_event_hdr_t *pstEvent, ANT_MESSAGE *pstMessage)
+// Replace the unsent broadcast event of the same channel and device, or push
+// a new one and track it.
+static bool event_coalesce(ant_event_t *pstEvent)
 {
-   bool bGotMsg = false;
+   coalesce_entry_t *pstEntry = NULL;
+   coalesce_entry_t *pstFree = NULL;
+   uint32_t ulDeviceID = event_device_id(pstEvent);
+   multi_ctx_fifo_t *pstFifo;
+   fifo_offset_t uiOffset;
+
+   for (uint8_t i = 0; i < EVENT_COALESCE_TABLE_SIZE; i++)
+   {
+      if (!astCoalesce[i].bValid)
+      {
+         if (pstFree == NULL)
+         {
+            pstFree = &astCoalesce[i];
+         }
+      }
+      else if ((astCoalesce[i].ucChannel == pstEvent->stHeader.ucChannel) && (astCoalesce[i].ulDeviceID == ulDeviceID))
+      {
+         pstEntry = &astCoalesce[i];
+         break;
+      }
+   }
+
+   if ((pstEntry != NULL) && (pstEntry->ucSize == pstEvent->stMessage.ANT_MESSAGE_ucSize))
+   {
+      pstEvent->ucSyncByte = MESG_TX_SYNC;
+      pstEvent->stMessage.ANT_MESSAGE_aucMesgData[pstEvent->stMessage.ANT_MESSAGE_ucSize] =
+         DSI_CheckSum(pstEvent->stMessage.aucMessage,
+            pstEvent->stMessage.ANT_MESSAGE_ucSize + MESG_SIZE_SIZE + MESG_ID_SIZE,
+            MESG_TX_SYNC);
+
+      mc_fifo_write(pstEntry->pstFifo, pstEntry->uiOffset, &pstEvent->stHeader,
+         sizeof(pstEvent->stHeader) + MESG_SYNC_SIZE + MESG_SIZE_SIZE + MESG_ID_SIZE + pstEvent->stMessage.ANT_MESSAGE_ucSize + MESG_CHECKSUM_SIZE);
+      return true;
+   }
+
+   if (!event_push(pstEvent, &pstFifo, &uiOffset))
+   {
+      return false;
+   }
+
+   if (pstEntry == NULL)
+   {
+      pstEntry = pstFree; // untracked if the table is full
+   }
+
+   if (pstEntry != NULL)
+   {
+      pstEntry->ucChannel = pstEvent->stHeader.ucChannel;
+      pstEntry->ulDeviceID = ulDeviceID;
+      pstEntry->ucSize = pstEvent->stMessage.ANT_MESSAGE_ucSize;
+      pstEntry->pstFifo = pstFifo;
+      pstEntry->uiOffset = uiOffset;
+      pstEntry->bValid = true;
+   }
+
+   return true;
+}
+
+// Push the aggregated burst frame, if any.
+static bool burst_aggregate_commit(void)
+{
+   if (stBurstAggregate.stMessage.ANT_MESSAGE_ucSize == 0)
+   {
+      return true;
+   }
+
+   multi_ctx_fifo_t *pstFifo;
+   fifo_offset_t uiOffset;
+
+   if (!event_push(&stBurstAggregate, &pstFifo, &uiOffset))
+   {
+      return false;
+   }
+
+   stBurstAggregate.stMessage.ANT_MESSAGE_ucSize = 0;
+   return true;
+}
+
+static bool burst_aggregate(const ant_event_t *pstEvent)
+{
+   ANT_MESSAGE *pstAggregate = &stBurstAggregate.stMessage;
+   uint8_t ucSequence = pstEvent->stMessage.ANT_MESSAGE_ucChannel & SEQUENCE_NUMBER_MASK;
+   uint8_t ucPreviousSequence;
+
+   // Packets are only combined while they continue the burst of the same channel.
+   if (pstAggregate->ANT_MESSAGE_ucSize &&
+      ((stBurstAggregate.stHeader.ucChannel != pstEvent->stHeader.ucChannel) ||
+      (burst_sequence_next(ucBurstAggregateSequence) != (ucSequence & SEQUENCE_NUMBER_ROLLOVER))))
+   {
+      if (!burst_aggregate_commit())
+      {
+         return false;
+      }
+   }
+
+   if (pstAggregate->ANT_MESSAGE_ucSize == 0)
+   {
+      stBurstAggregate.stHeader = pstEvent->stHeader;
+      pstAggregate->ANT_MESSAGE_ucSize = BURST_AGGREGATE_HEADER_SIZE;
+      pstAggregate->ANT_MESSAGE_ucMesgID = (uint8_t)(MESG_BURST_AGGREGATE_DATA_ID >> 8);
+      pstAggregate->ANT_MESSAGE_ucSubID = (uint8_t)(MESG_BURST_AGGREGATE_DATA_ID);
+      pstAggregate->ANT_MESSAGE_aucPayload[BURST_AGGREGATE_CHANNEL_OFFSET] =
+         (pstEvent->stMessage.ANT_MESSAGE_ucChannel & CHANNEL_NUMBER_MASK) | (ucSequence & SEQUENCE_NUMBER_ROLLOVER);
+      pstAggregate->ANT_MESSAGE_aucPayload[BURST_AGGREGATE_COUNT_OFFSET] = 0;
+   }
+
+   ucPreviousSequence = ucBurstAggregateSequence;
+   memcpy(&pstAggregate->ANT_MESSAGE_aucPayload[BURST_AGGREGATE_DATA_OFFSET +
+      (pstAggregate->ANT_MESSAGE_aucPayload[BURST_AGGREGATE_COUNT_OFFSET] * ANT_STANDARD_DATA_PAYLOAD_SIZE)],
+      pstEvent->stMessage.ANT_MESSAGE_aucPayload, ANT_STANDARD_DATA_PAYLOAD_SIZE);
+   pstAggregate->ANT_MESSAGE_ucSize += ANT_STANDARD_DATA_PAYLOAD_SIZE;
+   pstAggregate->ANT_MESSAGE_aucPayload[BURST_AGGREGATE_COUNT_OFFSET]++;
+   ucBurstAggregateSequence = ucSequence & SEQUENCE_NUMBER_ROLLOVER;
+
+   if ((ucSequence & SEQUENCE_LAST_MESSAGE) ||
+      (pstAggregate->ANT_MESSAGE_aucPayload[BURST_AGGREGATE_COUNT_OFFSET] == BURST_AGGREGATE_MAX_PACKETS))
+   {
+      pstAggregate->ANT_MESSAGE_aucPayload[BURST_AGGREGATE_CHANNEL_OFFSET] |= (ucSequence & SEQUENCE_LAST_MESSAGE);
+
+      if (!burst_aggregate_commit())
+      {
+         // Take the packet back out, it is put again when the caller retries.
+         pstAggregate->ANT_MESSAGE_aucPayload[BURST_AGGREGATE_CHANNEL_OFFSET] &= ~SEQUENCE_LAST_MESSAGE;
+         pstAggregate->ANT_MESSAGE_aucPayload[BURST_AGGREGATE_COUNT_OFFSET]--;
+         pstAggregate->ANT_MESSAGE_ucSize -= ANT_STANDARD_DATA_PAYLOAD_SIZE;
+         ucBurstAggregateSequence = ucPreviousSequence;
+         if (pstAggregate->ANT_MESSAGE_aucPayload[BURST_AGGREGATE_COUNT_OFFSET] == 0)
+         {
+            pstAggregate->ANT_MESSAGE_ucSize = 0;
+         }
+         return false;
+      }
+   }
+
+   return true;
+}
+
+// Empty both lanes and size them from the RAM arena.
+static void event_lanes_init(void)
+{
+   bFlushing = false;
+   stBurstAggregate.stMessage.ANT_MESSAGE_ucSize = 0;
+   coalesce_reset();
+   ucHighRun = 0;
+
+   mc_fifo_init(&stHighFifo, ANT_STACK_MESSAGE_QUEUE_SIZE);
+   mc_fifo_init(&stLowFifo, ANT_STACK_LOW_PRIORITY_MESSAGE_QUEUE_SIZE);
+   // Buffering benefits the most from a larger queue, it gets the arena first.
+   (void)ram_arena_fifo_grow(&stLowFifo, ANT_STACK_LOW_PRIORITY_MESSAGE_QUEUE_SIZE_MAX);
+   (void)ram_arena_fifo_grow(&stHighFifo, ANT_STACK_MESSAGE_QUEUE_SIZE_MAX);
+}
+
+void event_buffering_init(void)
+{
+   ucConfig = DEFAULT_EVENT_BUFFERING_CONFIG;
+   usSizeThreshold = DEFAULT_EVENT_BUFFERING_SIZE_THRESHOLD;
+   ulTimeThreshold = DEFAULT_EVENT_BUFFERING_TIME_THRESHOLD;
+   ulFlushTime = System_GetTime_32K();
+   bFlushTimerArmed = false;
+   bBurstAggregation = false;
+   bTimestampAppend = false;
+   ucDrainWeight = DEFAULT_EVENT_BUFFERING_DRAIN_WEIGHT;
+
+   event_lanes_init();
+}
+
+void event_buffering_reset(void)
+{
+   event_lanes_init();
+
+   if (usSizeThreshold > stLowFifo.uiSize)
+   {
+      usSizeThreshold = stLowFifo.uiSize;
+   }
+}
+
+void event_buffering_queue_size_get(uint16_t *pusHighSize, uint16_t *pusLowSize)
+{
+   *pusHighSize = stHighFifo.uiSize;
+   *pusLowSize = stLowFifo.uiSize;
+}
+
+void event_buffering_queue_level_get(uint16_t *pusHighLevel, uint16_t *pusLowLevel)
+{
+   *pusHighLevel = mc_fifo_get_data_len(&stHighFifo);
+   *pusLowLevel = mc_fifo_get_data_len(&stLowFifo);
+}
+
+bool event_buffering_put(ant_event_t *pstEvent)
+{
+   bool was_pushed;
+   uint8_t bNested;
+   multi_ctx_fifo_t *pstFifo;
+   fifo_offset_t uiOffset;
+
+   // Packets to aggregate are matched on their standard size.
+   if (bTimestampAppend && !(bBurstAggregation && is_burst_packet(pstEvent)))
+   {
+      event_timestamp_append(pstEvent);
+   }
+
+   if (!bBurstAggregation && (stBurstAggregate.stMessage.ANT_MESSAGE_ucSize == 0) && !(ucConfig & EVENT_BUFFER_CONFIG_COALESCE_RX))
+   {
+      return event_push(pstEvent, &pstFifo, &uiOffset);
+   }
+
+   // The aggregated frame and coalesced events are shared by all put contexts.
+   sd_nvic_critical_region_enter(&bNested);
+
+   if (bBurstAggregation && is_burst_packet(pstEvent))
+   {
+      was_pushed = burst_aggregate(pstEvent);
+   }
+   else if (!burst_aggregate_commit()) // anything else ends the aggregated frame to keep the event order
+   {
+      was_pushed = false;
+   }
+   else if ((ucConfig & EVENT_BUFFER_CONFIG_COALESCE_RX) &&
+      (pstEvent->stHeader.ucEvent == EVENT_RX) &&
+      (pstEvent->stMessage.ANT_MESSAGE_ucMesgID == MESG_BROADCAST_DATA_ID))
+   {
+      was_pushed = event_coalesce(pstEvent);
+   }
+   else
+   {
+      was_pushed = event_push(pstEvent, &pstFifo, &uiOffset);
+   }
+
+   sd_nvic_critical_region_exit(bNested);
+
+   return was_pushed;
+}
+
+bool event_buffering_tick(void)
+{
+   if (!bFlushTimerArmed || !System_TimerAlarmExpired())
+   {
+      return false;
+   }
+
+   if (has_flush_timeout_expired())
+   {
+      event_buffering_flush();
+      return true;
+   }
+
+   // Threshold is longer than a single alarm.
+   flush_timer_arm();
+   return false;
+}
+
+// Claim the record at the head of a lane.
+static bool event_claim(multi_ctx_fifo_t *pstFifo, ant_event_hdr_t *pstEvent, mc_fifo_span_t *pstFrame, uint16_t *pusRecordSize)
+{
+   fifo_offset_t uiOffset = mc_fifo_get_read_offset(pstFifo);
+   struct
+   {
+      ant_event_hdr_t stHeader;
+      uint8_t ucSyncByte;
+      uint8_t ucSize;
+   } stRecord;
+
+   if (!mc_fifo_peek(pstFifo, &stRecord, sizeof(stRecord)))
+   {
+      return false;
+   }
+
+   fifo_offset_t uiFrameSize =
+      stRecord.ucSize +
+      MESG_SYNC_SIZE + MESG_SIZE_SIZE + MESG_ID_SIZE + MESG_CHECKSUM_SIZE;
+
+   *pstEvent = stRecord.stHeader;
+   *pusRecordSize = sizeof(stRecord.stHeader) + uiFrameSize;
+
+   // Skip over the header, the frame follows it.
+   mc_fifo_claim(pstFifo, pstFrame, sizeof(stRecord.stHeader));
+   mc_fifo_claim(pstFifo, pstFrame, uiFrameSize);
+
+   // A claimed event is about to be sent, it can no longer be replaced.
+   // Replacing it before this point is harmless, the frame is not in use yet.
+   for (uint8_t i = 0; i < EVENT_COALESCE_TABLE_SIZE; i++)
+   {
+      if (astCoalesce[i].bValid && (astCoalesce[i].pstFifo == pstFifo) && (astCoalesce[i].uiOffset == uiOffset))
+      {
+         astCoalesce[i].bValid = false;
+      }
+   }
+
+   return true;
+}
+
+// Claim the head of the high priority lane.
+static bool event_claim_high(ant_event_hdr_t *pstEvent, mc_fifo_span_t *pstFrame, event_lane_t *peLane, uint16_t *pusRecordSize, bool bLowPending)
+{
+   if (!event_claim(&stHighFifo, pstEvent, pstFrame, pusRecordSize))
+   {
+      return false;
+   }
+
+   if (bLowPending)
+   {
+      ucHighRun++;
+   }
+
+   *peLane = EVENT_LANE_HIGH;
+   return true;
+}
+
+bool event_buffering_claim(ant_event_hdr_t *pstEvent, mc_fifo_span_t *pstFrame, event_lane_t *peLane, uint16_t *pusRecordSize)
+{
+   bool bLowPending = bFlushing && (mc_fifo_get_data_len(&stLowFifo) != 0);
+   // Let a low priority event through once the high priority lane has had its turns.
+   bool bHighFirst = !bLowPending || (ucHighRun < ucDrainWeight);
+
+   if (bHighFirst && event_claim_high(pstEvent, pstFrame, peLane, pusRecordSize, bLowPending))
+   {
+      return true;
+   }
 
    if (bFlushing)
    {
       // Cleared here in case more data is pushed while we check for a message.
       bFlushing = false;
 
-      bGotMsg = mc_fifo_pop(&stEventFifo, pstEvent, sizeof(*pstEvent));
-
-      if (bGotMsg)
+      if (event_claim(&stLowFifo, pstEvent, pstFrame, pusRecordSize))
       {
          // Continue flushing
          bFlushing = true;
-
-         mc_fifo_pop(
-            &stEventFifo,
-            &pstMessage->ANT_MESSAGE_ucSize,
-            MESG_SIZE_SIZE);
-         mc_fifo_pop(
-            &stEventFifo,
-            pstMessage->ANT_MESSAGE_aucFramedData,
-            pstMessage->ANT_MESSAGE_ucSize + MESG_ID_SIZE);
+         ucHighRun = 0;
+         *peLane = EVENT_LANE_LOW;
+         return true;
       }
    }
 
-   return bGotMsg;
+   return !bHighFirst && event_claim_high(pstEvent, pstFrame, peLane, pusRecordSize, false);
+}
+
+void event_buffering_release(event_lane_t eLane, uint16_t usRecordSize)
+{
+   mc_fifo_release((eLane == EVENT_LANE_HIGH) ? &stHighFifo : &stLowFifo, usRecordSize);
 }
 
 void event_buffering_config_set(uint8_t ucConfig_, uint16_t usSizeThreshold_, uint16_t usTimeThreshold_)
 {
-   if (usSizeThreshold_ > ANT_STACK_MESSAGE_QUEUE_SIZE)
+   if (usSizeThreshold_ > stLowFifo.uiSize)
    {
-      usSizeThreshold_ = ANT_STACK_MESSAGE_QUEUE_SIZE;
+      usSizeThreshold_ = stLowFifo.uiSize;
    }
 
    // Need to request the system timer when performing time-based event buffering.
@@ -137,6 +626,14 @@ void event_buffering_config_set(uint8_t ucConfig_, uint16_t usSizeThreshold_, ui
       System_TimerRelease();
    }
 
+   if ((ucConfig ^ ucConfig_) & EVENT_BUFFER_CONFIG_COALESCE_RX)
+   {
+      uint8_t bNested;
+      sd_nvic_critical_region_enter(&bNested);
+      coalesce_reset();
+      sd_nvic_critical_region_exit(bNested);
+   }
+
    // No need to do this atomically, we are flushing the buffer at the end regardless of the settings.
    ucConfig = ucConfig_;
    usSizeThreshold = usSizeThreshold_;
@@ -153,8 +650,67 @@ void event_buffering_config_get(uint8_t *pucConfig, uint16_t *pusSizeThreshold,
    *pusTimeThreshold = ulTimeThreshold / TIMEBASE_CONVERSION_TO_10MS;
 }
 
+void event_buffering_drain_weight_set(uint8_t ucWeight)
+{
+   // Only used by claim, which is called from thread context as well.
+   ucDrainWeight = ucWeight ? ucWeight : 1;
+   ucHighRun = 0;
+}
+
+uint8_t event_buffering_drain_weight_get(void)
+{
+   return ucDrainWeight;
+}
+
+void event_buffering_burst_aggregation_set(bool bEnable)
+{
+   uint8_t bNested;
+
+   sd_nvic_critical_region_enter(&bNested);
+   bBurstAggregation = bEnable;
+   // If this fails the frame is pushed ahead of the next event.
+   (void)burst_aggregate_commit();
+   sd_nvic_critical_region_exit(bNested);
+}
+
+bool event_buffering_burst_aggregation_get(void)
+{
+   return bBurstAggregation;
+}
+
+void event_buffering_timestamp_set(bool bEnable)
+{
+   if (bEnable == bTimestampAppend)
+   {
+      return;
+   }
+
+   // Timestamps are only meaningful while the RTC runs.
+   if (bEnable)
+   {
+      System_TimerRequest();
+   }
+   else
+   {
+      System_TimerRelease();
+   }
+
+   bTimestampAppend = bEnable;
+}
+
+bool event_buffering_timestamp_get(void)
+{
+   return bTimestampAppend;
+}
+
 void event_buffering_flush(void)
 {
    bFlushing = true;
    ulFlushTime = System_GetTime_32K();
+
+   if (bFlushTimerArmed)
+   {
+      bFlushTimerArmed = false;
+      System_TimerAlarmClear();
+   }
 }
@@ -0,0 +1,198 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+#include <string.h>
+
+#include "nrf_nvic.h"
+#include "appconfig.h"
+#include "ant_parameters.h"
+#include "dsi_utility.h"
+#include "event_buffering.h"
+#include "event_trace.h"
+#include "system.h"
+
+#if !defined (EVENT_TRACE_DISABLE)
+
+#define EVENT_TRACE_MASK                  ((uint16_t)(EVENT_TRACE_SIZE - 1))
+
+#define EVENT_TRACE_CONFIG_OFFSET         0
+#define EVENT_TRACE_NEXT_OFFSET           1
+#define EVENT_TRACE_FIRST_OFFSET          3
+#define EVENT_TRACE_COUNT_OFFSET          5
+#define EVENT_TRACE_RECORDS_OFFSET        6
+
+#if (EVENT_TRACE_SIZE & (EVENT_TRACE_SIZE - 1)) || (EVENT_TRACE_SIZE > 0x8000)
+   #error "EVENT_TRACE_SIZE must be a power of 2 within the 16 bit sequence range"
+#endif
+
+static event_trace_record_t astTrace[EVENT_TRACE_SIZE];
+static uint16_t usNext;                   // sequence of the next record
+static uint16_t usAvailable;              // records held, up to EVENT_TRACE_SIZE
+static uint16_t usStopCount;              // records left to write after a stall, 0 if not stopping
+
+static volatile uint8_t ucConfig;
+static bool bTimerRequested;
+
+// Timestamps only advance while the system timer runs, hold it from enabling
+// the trace until the configuration disables it again. A trace stopped on a
+// stall keeps it until then, the stop happens in interrupt context.
+static void trace_timer_update(void)
+{
+   bool bEnabled = (ucConfig & EVENT_TRACE_CONFIG_ENABLE) != 0;
+
+   if (bEnabled && !bTimerRequested)
+   {
+      System_TimerRequest();
+   }
+   else if (!bEnabled && bTimerRequested)
+   {
+      System_TimerRelease();
+   }
+
+   bTimerRequested = bEnabled;
+}
+
+// Write a record. The ring is shared by the stack event interrupt and thread
+// context, the caller holds a critical region.
+static void trace_write(uint32_t ulTime, const ant_event_t *pstEvent, uint8_t ucFlags)
+{
+   event_trace_record_t *pstRecord = &astTrace[usNext & EVENT_TRACE_MASK];
+
+   DSI_PutULong(ulTime, pstRecord->aucTimestamp);
+   pstRecord->ucChannel = pstEvent->stMessage.ANT_MESSAGE_ucChannel;
+   pstRecord->ucEvent = pstEvent->stHeader.ucEvent;
+   pstRecord->ucMesgID = pstEvent->stMessage.ANT_MESSAGE_ucMesgID;
+   pstRecord->ucSize = (pstEvent->stMessage.ANT_MESSAGE_ucSize & EVENT_TRACE_SIZE_MASK) | ucFlags;
+
+   usNext++;
+   if (usAvailable < EVENT_TRACE_SIZE)
+   {
+      usAvailable++;
+   }
+
+   if (usStopCount && (--usStopCount == 0))
+   {
+      ucConfig &= ~EVENT_TRACE_CONFIG_ENABLE;
+   }
+}
+
+static void trace_clear(void)
+{
+   usNext = 0;
+   usAvailable = 0;
+   usStopCount = 0;
+}
+
+void event_trace_init(void)
+{
+   ucConfig = DEFAULT_EVENT_TRACE_CONFIG;
+   bTimerRequested = false;
+   trace_clear();
+   trace_timer_update();
+}
+
+void event_trace_record(const ant_event_t *pstEvent)
+{
+   uint8_t bNested;
+
+   if (!(ucConfig & EVENT_TRACE_CONFIG_ENABLE))
+   {
+      return;
+   }
+
+   sd_nvic_critical_region_enter(&bNested);
+   trace_write(DSI_GetULong((uint8_t *)pstEvent->stHeader.aucTimestamp), pstEvent, 0);
+   sd_nvic_critical_region_exit(bNested);
+}
+
+void event_trace_stall(void)
+{
+   uint8_t bNested;
+
+   if (!(ucConfig & EVENT_TRACE_CONFIG_ENABLE) || (usAvailable == 0))
+   {
+      return;
+   }
+
+   sd_nvic_critical_region_enter(&bNested);
+   astTrace[(uint16_t)(usNext - 1) & EVENT_TRACE_MASK].ucSize |= EVENT_TRACE_FLAG_STALL;
+   if ((ucConfig & EVENT_TRACE_CONFIG_STOP_ON_STALL) && (usStopCount == 0))
+   {
+      usStopCount = EVENT_TRACE_SIZE / 2;
+   }
+   sd_nvic_critical_region_exit(bNested);
+}
+
+void event_trace_resume(const ant_event_t *pstEvent)
+{
+   uint8_t bNested;
+
+   if (!(ucConfig & EVENT_TRACE_CONFIG_ENABLE))
+   {
+      return;
+   }
+
+   sd_nvic_critical_region_enter(&bNested);
+   trace_write(System_GetTime_32K(), pstEvent, EVENT_TRACE_FLAG_RESUME);
+   sd_nvic_critical_region_exit(bNested);
+}
+
+void event_trace_config_set(uint8_t ucNewConfig)
+{
+   uint8_t bNested;
+
+   sd_nvic_critical_region_enter(&bNested);
+   ucConfig = ucNewConfig & EVENT_TRACE_CONFIG_MASK;
+   trace_clear();
+   sd_nvic_critical_region_exit(bNested);
+
+   trace_timer_update();
+}
+
+uint8_t event_trace_config_get(void)
+{
+   return ucConfig;
+}
+
+void event_trace_mesg_get(uint16_t usSequence, ANT_MESSAGE *pstTxMessage)
+{
+   uint8_t bNested;
+   uint16_t usPending;
+   uint8_t ucCount;
+
+   sd_nvic_critical_region_enter(&bNested);
+
+   // Start from the oldest record held if the requested one was overwritten
+   // (or was never written).
+   usPending = usNext - usSequence;
+   if (usPending > usAvailable)
+   {
+      usPending = usAvailable;
+      usSequence = usNext - usAvailable;
+   }
+   ucCount = (usPending < EVENT_TRACE_RECORDS_PER_MESG) ? (uint8_t)usPending : EVENT_TRACE_RECORDS_PER_MESG;
+
+   pstTxMessage->ANT_MESSAGE_ucSize = MESG_EVENT_TRACE_HEADER_SIZE + (ucCount * EVENT_TRACE_RECORD_SIZE);
+   pstTxMessage->ANT_MESSAGE_ucMesgID = (uint8_t)(MESG_EVENT_TRACE_ID >> 8);
+   pstTxMessage->ANT_MESSAGE_ucSubID = (uint8_t)(MESG_EVENT_TRACE_ID);
+   pstTxMessage->ANT_MESSAGE_aucPayload[EVENT_TRACE_CONFIG_OFFSET] = ucConfig;
+   DSI_PutUShort(usNext, &pstTxMessage->ANT_MESSAGE_aucPayload[EVENT_TRACE_NEXT_OFFSET]);
+   DSI_PutUShort(usSequence, &pstTxMessage->ANT_MESSAGE_aucPayload[EVENT_TRACE_FIRST_OFFSET]);
+   pstTxMessage->ANT_MESSAGE_aucPayload[EVENT_TRACE_COUNT_OFFSET] = ucCount;
+
+   for (uint8_t i = 0; i < ucCount; i++)
+   {
+      memcpy(&pstTxMessage->ANT_MESSAGE_aucPayload[EVENT_TRACE_RECORDS_OFFSET + (i * EVENT_TRACE_RECORD_SIZE)],
+         &astTrace[(uint16_t)(usSequence + i) & EVENT_TRACE_MASK], EVENT_TRACE_RECORD_SIZE);
+   }
+
+   sd_nvic_critical_region_exit(bNested);
+}
+
+#endif // !EVENT_TRACE_DISABLE
@@ -14,6 +14,23 @@ All rights reserved.
 #include "multi_ctx_fifo.h"
 #include "nrf_nvic.h"
 
+#if defined (MC_FIFO_POW2_SIZE)
+
+// Offsets run freely, the unsigned wraparound of fifo_offset_t does the work.
+#define fifo_diff(a, b, size)    ((fifo_offset_t)((a) - (b)))
+#define fifo_sum(a, b, size)     ((fifo_offset_t)((a) + (b)))
+// Position of an offset in the buffer.
+#define fifo_index(a, size)      ((fifo_offset_t)((a) & ((size) - 1)))
+// Head == tail is always the empty condition, the whole buffer can be used.
+#define FIFO_RESERVED_SPACE      0
+
+#else
+
+#define fifo_index(a, size)      (a)
+// One byte is kept free in order to avoid setting the empty condition when
+// the fifo is in fact full.
+#define FIFO_RESERVED_SPACE      1
+
 // a - b with wraparound for given size.
 static fifo_offset_t fifo_diff(
    fifo_offset_t a,
@@ -46,57 +63,80 @@ static fifo_offset_t fifo_sum(
    }
 }
 
+#endif // MC_FIFO_POW2_SIZE
+
 /**
  * Attempt to allocate a chunk of the fifo buffer for pushing data.
- * If successful the starting offset to use for the write will be returned.
- * Otherwise the size of the fifo will be returned to indicate failure.
+ * If successful the starting offset to use for the write will be returned
+ * in puiChunkStart.
  */
-static fifo_offset_t mc_fifo_push_alloc(multi_ctx_fifo_t *pstFifo, fifo_offset_t uiLen)
+static bool mc_fifo_push_alloc(multi_ctx_fifo_t *pstFifo, fifo_offset_t uiLen, fifo_offset_t *puiChunkStart)
 {
-   fifo_offset_t uiChunkStart = pstFifo->uiSize;
+   bool bAllocated = false;
 
    uint8_t bNested;
    sd_nvic_critical_region_enter(&bNested);
 
    // Math is done as size - used_space in order to properly deal with the
-   // fifo empty condition (head == tail). It also subtracts 1 from the
-   // free space in order to avoid setting the empty condition when the fifo
-   // is in fact full.
+   // fifo empty condition (head == tail).
    fifo_offset_t uiFreeSpace =
-      (pstFifo->uiSize - fifo_diff(pstFifo->uiPushHead, pstFifo->uiTail, pstFifo->uiSize)) - 1;
+      (pstFifo->uiSize - fifo_diff(pstFifo->uiPushHead, pstFifo->uiTail, pstFifo->uiSize)) - FIFO_RESERVED_SPACE;
 
    if (uiLen <= uiFreeSpace)
    {
-      uiChunkStart = pstFifo->uiPushHead;
-      pstFifo->uiPushHead = fifo_sum(uiChunkStart, uiLen, pstFifo->uiSize);
+      *puiChunkStart = pstFifo->uiPushHead;
+      pstFifo->uiPushHead = fifo_sum(*puiChunkStart, uiLen, pstFifo->uiSize);
+      bAllocated = true;
    }
 
    sd_nvic_critical_region_exit(bNested);
 
-   return uiChunkStart;
+   return bAllocated;
 }
 
-bool mc_fifo_push(multi_ctx_fifo_t *pstFifo, const void *pvSrc, fifo_offset_t uiLen)
+void mc_fifo_init_buffer(multi_ctx_fifo_t *pstFifo, uint8_t *pucBuff, fifo_offset_t uiLen)
 {
-   fifo_offset_t uiChunkStart = mc_fifo_push_alloc(pstFifo, uiLen);
-   const uint8_t* pucRawSrc = pvSrc;
+   memset(pstFifo, 0, sizeof(*pstFifo));
+   pstFifo->pucBuff = pucBuff;
+   pstFifo->uiSize = uiLen;
+}
 
-   if (uiChunkStart == pstFifo->uiSize)
-   {
-      return false;
-   }
+void mc_fifo_write(multi_ctx_fifo_t *pstFifo, fifo_offset_t uiOffset, const void *pvSrc, fifo_offset_t uiLen)
+{
+   const uint8_t* pucRawSrc = pvSrc;
 
-   fifo_offset_t chunk_split = pstFifo->uiSize - uiChunkStart;
+   fifo_offset_t uiIndex = fifo_index(uiOffset, pstFifo->uiSize);
+   fifo_offset_t chunk_split = pstFifo->uiSize - uiIndex;
    if (chunk_split < uiLen)
    {
-      memcpy(&pstFifo->pucBuff[uiChunkStart], &pucRawSrc[0], chunk_split);
+      memcpy(&pstFifo->pucBuff[uiIndex], &pucRawSrc[0], chunk_split);
       memcpy(&pstFifo->pucBuff[0], &pucRawSrc[chunk_split], uiLen - chunk_split);
    }
    else
    {
-      memcpy(&pstFifo->pucBuff[uiChunkStart], pucRawSrc, uiLen);
+      memcpy(&pstFifo->pucBuff[uiIndex], pucRawSrc, uiLen);
+   }
+}
+
+bool mc_fifo_push(multi_ctx_fifo_t *pstFifo, const void *pvSrc, fifo_offset_t uiLen)
+{
+   fifo_offset_t uiChunkStart;
+
+   return mc_fifo_push_at(pstFifo, pvSrc, uiLen, &uiChunkStart);
+}
+
+bool mc_fifo_push_at(multi_ctx_fifo_t *pstFifo, const void *pvSrc, fifo_offset_t uiLen, fifo_offset_t *puiOffset)
+{
+   fifo_offset_t uiChunkStart;
+
+   if (!mc_fifo_push_alloc(pstFifo, uiLen, &uiChunkStart))
+   {
+      return false;
    }
 
+   mc_fifo_write(pstFifo, uiChunkStart, pvSrc, uiLen);
+   *puiOffset = uiChunkStart;
+
    // Don't need a critical section for this check because the head pointer
    // is always adjusted by the lowest context that allocated data.
    if (uiChunkStart == pstFifo->uiHead)
@@ -119,39 +159,85 @@ bool mc_fifo_push(multi_ctx_fifo_t *pstFifo, const void *pvSrc, fifo_offset_t ui
    return true;
 }
 
-bool mc_fifo_pop(multi_ctx_fifo_t *pstFifo, void *pvDst, fifo_offset_t uiLen)
+bool mc_fifo_claim(multi_ctx_fifo_t *pstFifo, mc_fifo_span_t *pstSpan, fifo_offset_t uiLen)
 {
    // This function does not need critical section for the following reasons:
    // The single read of the head is atomic.
-   // All pops (and therefore moves of the tail) are done at the same context.
-   // Outside of that tail is always accessed read-only, and is updated
-   // atomically here.
+   // All claims (and therefore moves of the read position) are done at the
+   // same context. Outside of that the read position is not accessed.
 
    fifo_offset_t uiCachedHead = pstFifo->uiHead;
-   uint8_t *pucRawDst = pvDst;
 
-   fifo_offset_t data_avail = fifo_diff(uiCachedHead, pstFifo->uiTail, pstFifo->uiSize);
+   fifo_offset_t data_avail = fifo_diff(uiCachedHead, pstFifo->uiRead, pstFifo->uiSize);
 
    if (data_avail < uiLen)
    {
       return false;
    }
 
-   fifo_offset_t chunk_split = pstFifo->uiSize - pstFifo->uiTail;
+   fifo_offset_t uiIndex = fifo_index(pstFifo->uiRead, pstFifo->uiSize);
+
+   pstSpan->pucData[0] = &pstFifo->pucBuff[uiIndex];
+   pstSpan->pucData[1] = &pstFifo->pucBuff[0];
+
+   fifo_offset_t chunk_split = pstFifo->uiSize - uiIndex;
    if (chunk_split < uiLen)
    {
-      memcpy(&pucRawDst[0], &pstFifo->pucBuff[pstFifo->uiTail], chunk_split);
-      memcpy(&pucRawDst[chunk_split], &pstFifo->pucBuff[0], uiLen - chunk_split);
+      pstSpan->uiLen[0] = chunk_split;
+      pstSpan->uiLen[1] = uiLen - chunk_split;
    }
    else
    {
-      memcpy(pucRawDst, &pstFifo->pucBuff[pstFifo->uiTail], uiLen);
+      pstSpan->uiLen[0] = uiLen;
+      pstSpan->uiLen[1] = 0;
    }
 
+   pstFifo->uiRead = fifo_sum(pstFifo->uiRead, uiLen, pstFifo->uiSize);
+   return true;
+}
+
+void mc_fifo_release(multi_ctx_fifo_t *pstFifo, fifo_offset_t uiLen)
+{
+   // The tail is updated atomically and only read by push ops, releasing
+   // space can only make them succeed.
    pstFifo->uiTail = fifo_sum(pstFifo->uiTail, uiLen, pstFifo->uiSize);
+}
+
+bool mc_fifo_peek(multi_ctx_fifo_t *pstFifo, void *pvDst, fifo_offset_t uiLen)
+{
+   fifo_offset_t uiCachedRead = pstFifo->uiRead;
+   mc_fifo_span_t stSpan;
+   uint8_t *pucRawDst = pvDst;
+
+   if (!mc_fifo_claim(pstFifo, &stSpan, uiLen))
+   {
+      return false;
+   }
+
+   memcpy(&pucRawDst[0], stSpan.pucData[0], stSpan.uiLen[0]);
+   memcpy(&pucRawDst[stSpan.uiLen[0]], stSpan.pucData[1], stSpan.uiLen[1]);
+
+   pstFifo->uiRead = uiCachedRead; // leave the data in the fifo
+   return true;
+}
+
+bool mc_fifo_pop(multi_ctx_fifo_t *pstFifo, void *pvDst, fifo_offset_t uiLen)
+{
+   if (!mc_fifo_peek(pstFifo, pvDst, uiLen))
+   {
+      return false;
+   }
+
+   pstFifo->uiRead = fifo_sum(pstFifo->uiRead, uiLen, pstFifo->uiSize);
+   pstFifo->uiTail = pstFifo->uiRead;
    return true;
 }
 
+fifo_offset_t mc_fifo_get_read_offset(multi_ctx_fifo_t *pstFifo)
+{
+   return pstFifo->uiRead;
+}
+
 fifo_offset_t mc_fifo_get_data_len(multi_ctx_fifo_t *pstFifo)
 {
    fifo_offset_t uiDataLen;
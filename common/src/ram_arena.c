@@ -0,0 +1,81 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "multi_ctx_fifo.h"
+#include "ram_arena.h"
+
+#define RAM_ARENA_ALIGN(x)             (((x) + 3u) & ~3u)
+
+// Block layout: [used by the owner][fifo buffers ->   free   <- fixed allocations]
+static uint8_t *pucArenaBase;
+static uint16_t usArenaBottom;   // end of the fifo buffers, offset from the base
+static uint16_t usArenaTop;      // start of the fixed allocations, offset from the base
+
+void ram_arena_init(uint8_t *pucBlock, uint16_t usBlockSize, uint16_t usUsedSize)
+{
+   pucArenaBase = pucBlock;
+   usArenaTop = usBlockSize & ~3u;
+   ram_arena_reset(usUsedSize);
+}
+
+void ram_arena_reset(uint16_t usUsedSize)
+{
+   usUsedSize = RAM_ARENA_ALIGN(usUsedSize);
+   usArenaBottom = (usUsedSize < usArenaTop) ? usUsedSize : usArenaTop;
+}
+
+void *ram_arena_alloc(uint16_t usSize)
+{
+   usSize = RAM_ARENA_ALIGN(usSize);
+
+   if ((usSize == 0) || (usSize > ram_arena_get_free()))
+   {
+      return NULL;
+   }
+
+   usArenaTop -= usSize;
+   return &pucArenaBase[usArenaTop];
+}
+
+bool ram_arena_fifo_grow(multi_ctx_fifo_t *pstFifo, fifo_offset_t uiMaxLen)
+{
+   uint16_t usFree = ram_arena_get_free();
+   fifo_offset_t uiLen = (usFree < uiMaxLen) ? usFree : uiMaxLen;
+
+#if defined (MC_FIFO_POW2_SIZE)
+   // Keep the highest bit only.
+   while (uiLen & (uiLen - 1))
+   {
+      uiLen &= uiLen - 1;
+   }
+#endif
+
+   if (uiLen <= pstFifo->uiSize)
+   {
+      return false;
+   }
+
+   mc_fifo_init_buffer(pstFifo, &pucArenaBase[usArenaBottom], uiLen);
+   usArenaBottom += RAM_ARENA_ALIGN(uiLen);
+   return true;
+}
+
+uint16_t ram_arena_get_free(void)
+{
+   return usArenaTop - usArenaBottom;
+}
+
+uint16_t ram_arena_get_owner_limit(void)
+{
+   return usArenaTop;
+}
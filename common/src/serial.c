@@ -11,6 +11,7 @@ All rights reserved.
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include "nrf.h"
 #include "nrf_soc.h"
 #include "nrf_sdm.h"
@@ -20,7 +21,12 @@ All rights reserved.
 #include "ant_parameters.h"
 #include "appconfig.h"
 #include "boardconfig.h"
+#include "command.h"
+#include "cycle_profile.h"
+#include "event_buffering.h"
+#include "dsi_utility.h"
 #include "global.h"
+#include "ram_arena.h"
 #include "serial.h"
 #include "system.h"
 
@@ -36,11 +42,22 @@ All rights reserved.
  * 2. Asynchronous RTS is hardware flow controlled. RTS flow control is byte level instead of message level
  *
  * NOTE: PERIPHERALS USED
- * 1. SPI0  (for Synchronous Serial)
+ * 1. SPI0 or SPIM0 (for Synchronous Serial)
  * 2. UART0 or UARTE0 (for Asynchronous Serial)
  * 3. RTC1  (for periodic low power wake-up poll)
+ * 4. TIMER2, TIMER3 and PPI 2-4 (UARTE0 only, for receive byte counting and line idle detection)
  *
  * UARTE0 with EasyDMA is enabled via preprocessor definition SERIAL_USE_UARTE
+ * UARTE0 receives into a ring of DMA chunks. The next chunk is queued on RXSTARTED, and the
+ * ring is parsed on every chunk completion and whenever the line goes idle.
+ *
+ * SPIM0 with EasyDMA is enabled via preprocessor definition SERIAL_SYNC_USE_SPIM
+ * SPIM0 clocks a block of the message per SRDY handshake instead of a single byte. A received message
+ * takes two handshakes: the header (sync and size), then the message ID, data and checksum after SEN is
+ * released. A transmitted message takes two whatever its source: everything up to the checksum, then the
+ * checksum after SEN is released. The host has to accept several bytes per SRDY.
+ * A single byte is never received on its own, which would hit nRF52832 anomaly 58 (SPIM clocks out an
+ * extra byte when RXD.MAXCNT is 1 and TXD.MAXCNT is at most 1).
  */
 
 /***************************************************************************
@@ -52,12 +69,23 @@ All rights reserved.
 /***************************************************************************
  * NRF SYNCHRONOUS SPI PERIPHERAL ACCESS DEFINITIONS
  ***************************************************************************/
-#define SERIAL_SYNC                          NRF_SPI0 //using NRF SPI Master 0
+#if defined(SERIAL_SYNC_USE_SPIM)
+   #define SERIAL_SYNC                       NRF_SPIM0 //using NRF SPI Master 0 with EasyDMA
+   #define SERIAL_SYNC_SERIAL_ENABLE()       (SERIAL_SYNC->ENABLE = (SPIM_ENABLE_ENABLE_Enabled << SPIM_ENABLE_ENABLE_Pos)) // SPIM Peripheral Enable\Disable
+   #define SERIAL_SYNC_SERIAL_DISABLE()      (SERIAL_SYNC->ENABLE = (SPIM_ENABLE_ENABLE_Disabled << SPIM_ENABLE_ENABLE_Pos))
+   #define SERIAL_SYNC_ORC                   ((uint8_t)0xFF) // clocked out while only reading
+#else
+   #define SERIAL_SYNC                       NRF_SPI0 //using NRF SPI Master 0
+   #define SERIAL_SYNC_SERIAL_ENABLE()       (SERIAL_SYNC->ENABLE |= (SPI_ENABLE_ENABLE_Enabled << SPI_ENABLE_ENABLE_Pos)) // SPI Peripheral Enable\Disable
+   #define SERIAL_SYNC_SERIAL_DISABLE()      (SERIAL_SYNC->ENABLE &= ~(SPI_ENABLE_ENABLE_Enabled << SPI_ENABLE_ENABLE_Pos))
+#endif // SERIAL_SYNC_USE_SPIM
 
-#define SERIAL_SYNC_FREQUENCY                SPI_FREQUENCY_FREQUENCY_M4
+#if defined(SERIAL_SYNC_USE_SPIM)
+   #define SERIAL_SYNC_FREQUENCY             SPI_FREQUENCY_FREQUENCY_M8 // per byte overhead is gone, use the full rate
+#else
+   #define SERIAL_SYNC_FREQUENCY             SPI_FREQUENCY_FREQUENCY_M4
+#endif
 #define SERIAL_SYNC_FREQUENCY_SLOW           SPI_FREQUENCY_FREQUENCY_K500
-#define SERIAL_SYNC_SERIAL_ENABLE()          (SERIAL_SYNC->ENABLE |= (SPI_ENABLE_ENABLE_Enabled << SPI_ENABLE_ENABLE_Pos)) // SPI Peripheral Enable\Disable
-#define SERIAL_SYNC_SERIAL_DISABLE()         (SERIAL_SYNC->ENABLE &= ~(SPI_ENABLE_ENABLE_Enabled << SPI_ENABLE_ENABLE_Pos))
 #define SYNC_SEN_ASSERT()                    NRF_GPIO->OUT &= ~(1UL << SERIAL_SYNC_PIN_SEN)
 #define SYNC_SEN_DEASSERT()                  NRF_GPIO->OUT |= (1UL << SERIAL_SYNC_PIN_SEN)
 #define IS_MRDY_ASSERTED()                   (!((NRF_GPIO->IN >> SERIAL_SYNC_PIN_SMSGRDY) & 1UL)) // true when asserted, is active low
@@ -100,14 +128,29 @@ All rights reserved.
    #define SERIAL_ASYNC_INT_ENDTX_DISABLE()     SERIAL_ASYNC->INTENCLR = (UARTE_INTENCLR_ENDTX_Clear << UARTE_INTENCLR_ENDTX_Pos)// disable Tx End Interrupt
    #define SERIAL_ASYNC_INT_ENDRX_ENABLE()      SERIAL_ASYNC->INTENSET = (UARTE_INTENSET_ENDRX_Set << UARTE_INTENSET_ENDRX_Pos) // enable Rx End Interrupt
    #define SERIAL_ASYNC_INT_ENDRX_DISABLE()     SERIAL_ASYNC->INTENCLR = (UARTE_INTENCLR_ENDRX_Clear << UARTE_INTENCLR_ENDRX_Pos)// disable Rx End Interrupt
+   #define SERIAL_ASYNC_INT_RXSTARTED_ENABLE()  SERIAL_ASYNC->INTENSET = (UARTE_INTENSET_RXSTARTED_Set << UARTE_INTENSET_RXSTARTED_Pos) // enable Rx Started Interrupt
+   #define SERIAL_ASYNC_INT_RXSTARTED_DISABLE() SERIAL_ASYNC->INTENCLR = (UARTE_INTENCLR_RXSTARTED_Clear << UARTE_INTENCLR_RXSTARTED_Pos)// disable Rx Started Interrupt
    /*** RTS Line Control ***/
-   #define SERIAL_ASYNC_RTS_ENABLE()            {SERIAL_ASYNC_INT_ENDRX_ENABLE(); SERIAL_ASYNC->PSEL.RTS = SERIAL_ASYNC_PIN_RTS;} // assign async RTS to HW control, let HW decide state
-   #define SERIAL_ASYNC_RTS_DISABLE()           {SERIAL_ASYNC_INT_ENDRX_DISABLE(); SERIAL_ASYNC->PSEL.RTS = 0xFFFFFFFF; NRF_GPIO->OUT |= (1UL << SERIAL_ASYNC_PIN_RTS);} // unassign async RTS from HW control and force it high
+   /* Reception keeps running into the DMA ring while RTS is held, the rx parser stops consuming on bHold instead */
+   #define SERIAL_ASYNC_RTS_ENABLE()            {SERIAL_ASYNC->PSEL.RTS = SERIAL_ASYNC_PIN_RTS;} // assign async RTS to HW control, let HW decide state
+   #define SERIAL_ASYNC_RTS_DISABLE()           {SERIAL_ASYNC->PSEL.RTS = 0xFFFFFFFF; NRF_GPIO->OUT |= (1UL << SERIAL_ASYNC_PIN_RTS);} // unassign async RTS from HW control and force it high
    /*** UARTE Peripheral Enable\Disable ***/
    #define SERIAL_ASYNC_SERIAL_ENABLE()         SERIAL_ASYNC->ENABLE = UARTE_ENABLE_ENABLE_Enabled << UARTE_ENABLE_ENABLE_Pos
    #define SERIAL_ASYNC_SERIAL_DISABLE()        SERIAL_ASYNC->ENABLE = UARTE_ENABLE_ENABLE_Disabled << UARTE_ENABLE_ENABLE_Pos
-   /*** UARTE Receive Restart ***/
-   #define SERIAL_ASYNC_RX_RESTART()            {SERIAL_ASYNC->EVENTS_ENDRX = 0; SERIAL_ASYNC->TASKS_STOPRX = 1; SERIAL_ASYNC->TASKS_STARTRX = 1;}
+   /*** UARTE Receive DMA Ring ***/
+   #define SERIAL_ASYNC_RX_DMA_CHUNK_SIZE       ((uint32_t)64) // bytes per EasyDMA receive transaction
+   #define SERIAL_ASYNC_RX_DMA_CHUNKS           ((uint32_t)4)  // number of chunks in the receive ring, power of 2
+   #define SERIAL_ASYNC_RX_RING_SIZE            (SERIAL_ASYNC_RX_DMA_CHUNK_SIZE * SERIAL_ASYNC_RX_DMA_CHUNKS)
+   #define SERIAL_ASYNC_RX_RING_MASK            (SERIAL_ASYNC_RX_RING_SIZE - 1)
+   #define SERIAL_ASYNC_RX_IDLE_BYTES           ((uint32_t)2)  // line idle time, in character times, before a partial chunk is parsed
+   /*** Receive byte counter (TIMER2) and line idle timer (TIMER3) ***/
+   #define SERIAL_ASYNC_RX_COUNTER              NRF_TIMER2   // counts RXDRDY events through PPI
+   #define SERIAL_ASYNC_RX_IDLE_TIMER           NRF_TIMER3   // restarted on every RXDRDY through PPI, fires on COMPARE0 when the line goes idle
+   #define SERIAL_ASYNC_RX_IDLE_TIMER_IRQn      TIMER3_IRQn
+   #define SERIAL_ASYNC_PPI_CH_RX_COUNT         ((uint8_t)2) // PPI 0 and 1 are used by PA/LNA control
+   #define SERIAL_ASYNC_PPI_CH_RX_IDLE_CLEAR    ((uint8_t)3)
+   #define SERIAL_ASYNC_PPI_CH_RX_IDLE_START    ((uint8_t)4)
+   #define SERIAL_ASYNC_PPI_CH_RX_MASK          ((1UL << SERIAL_ASYNC_PPI_CH_RX_COUNT) | (1UL << SERIAL_ASYNC_PPI_CH_RX_IDLE_CLEAR) | (1UL << SERIAL_ASYNC_PPI_CH_RX_IDLE_START))
 #else
    #define SERIAL_ASYNC                         NRF_UART0   //using NRF UART 0
    /*** Interrupt Control ***/
@@ -154,6 +197,7 @@ static volatile bool bHold;
 static volatile bool bSyncMode;
 static volatile bool bSleep;
 static volatile bool bSRdy;
+static volatile bool bHFClkRequested;     // serial holds a high frequency clock request
 
 /**/
 #define PIN_SENSE_DISABLED    0
@@ -163,6 +207,9 @@ static volatile bool bSRdy;
    static uint8_t ucPinSenseSRDY = PIN_SENSE_DISABLED;
    static uint8_t ucPinSenseMRDY = PIN_SENSE_DISABLED;
    static uint16_t usSyncSRdySleepDelay;
+   #if defined (SERIAL_SYNC_USE_SPIM)
+      static uint8_t aucSyncTxFrame[MESG_SYNC_SIZE + MESG_BUFFER_SIZE]; // event frame that wraps the event buffer, made linear for EasyDMA
+   #endif // SERIAL_SYNC_USE_SPIM
 #endif // SYNCHRONOUS_DISABLE
 /*
  * This table is a lookup for the baud rate control registers,
@@ -262,9 +309,51 @@ static struct
 {
    uint8_t padding[3]; // required to store ucMessageSyncByte and stMessageData sequentially for TX while satisfying alignment
    uint8_t ucMessageSyncByte;
-   volatile ANT_MESSAGE stMessageData; // volatile required due to polling on size during transmit
+   volatile ANT_MESSAGE stMessageData;
 } stTxMessage;
-static volatile ANT_MESSAGE stRxMessage;
+
+/*
+ * Async tx staging ring. Framed messages (sync, size, id, data, checksum) are queued back to back
+ * so that everything queued is sent with a single transfer, split only where the ring wraps.
+ * Head and tail are free running byte counts, SERIAL_TX_RING_SIZE must be a power of 2.
+ */
+#define SERIAL_TX_RING_MASK                  (SERIAL_TX_RING_SIZE - 1)
+#define SERIAL_ASYNC_TX_DMA_MAX_SIZE         ((uint16_t)255) // TXD.MAXCNT is 8-bit on nRF52832
+static uint8_t aucTxRing[SERIAL_TX_RING_SIZE];
+static volatile uint16_t usTxRingHead; // bytes queued, advanced by the application
+static volatile uint16_t usTxRingTail; // bytes transmitted, advanced from interrupt context
+#if defined(SERIAL_USE_UARTE)
+   static uint16_t usTxDMASize;        // bytes in the transfer in progress
+#endif
+
+/*
+ * Async tx frame queue. Event frames are sent in place out of the event buffer and their space is
+ * released once transmitted. The staging ring goes first, unless a frame is partially sent.
+ */
+#define SERIAL_TX_FRAME_QUEUE_MASK           (SERIAL_TX_FRAME_QUEUE_SIZE - 1)
+static struct
+{
+   mc_fifo_span_t stFrame;
+   event_lane_t eLane;    // event buffer lane the frame was claimed from
+   uint16_t usRecordSize; // event buffer space to release once the frame is out
+} astTxFrame[SERIAL_TX_FRAME_QUEUE_SIZE];
+static volatile uint8_t ucTxFrameHead; // frames queued, advanced by the application
+static volatile uint8_t ucTxFrameTail; // frames transmitted, advanced from interrupt context
+static uint8_t ucTxFrameSpan;          // span of the frame at the tail being sent
+static bool bTxFrameActive;            // last transmission was taken from the frame at the tail
+#if !defined(SERIAL_USE_UARTE)
+   static uint16_t usTxFrameOffset;    // bytes of the span sent so far
+#endif
+
+/*
+ * Rx message queue. The slot at ucRxQueueHead is being received into, the slots from ucRxQueueTail
+ * up to it are waiting to be processed. Reception is only held once every slot is in use.
+ */
+static volatile ANT_MESSAGE astRxQueue[SERIAL_RX_QUEUE_SIZE];
+static volatile ANT_MESSAGE *pastRxQueue = astRxQueue; // moved to the RAM arena when it has room for more slots
+static uint8_t ucRxQueueMask = SERIAL_RX_QUEUE_SIZE - 1;
+static volatile uint8_t ucRxQueueHead; // messages received, advanced from interrupt context
+static volatile uint8_t ucRxQueueTail; // messages processed, advanced by the application
 
 volatile BAUDRATE_TYPE eBaudSelection;
 
@@ -277,7 +366,10 @@ static uint8_t ucTxPtr;
 #endif // ASYNCHRONOUS_DISABLE
 
 #if defined(SERIAL_USE_UARTE)
-   static uint8_t aucRxBufferDMA;  // use a single byte buffer to simulate RXD on the normal UART
+   static uint8_t aucRxRingDMA[SERIAL_ASYNC_RX_RING_SIZE]; // receive ring, EasyDMA fills it one chunk at a time
+   static uint32_t ulRxDMAChunk;                           // chunk EasyDMA is currently receiving into
+   static volatile uint32_t ulRxWriteCount;                // total bytes known to be in the ring
+   static uint32_t ulRxReadCount;                          // total bytes consumed by the rx parser
 #endif
 
 /***************************************************************************
@@ -285,8 +377,19 @@ static uint8_t ucTxPtr;
  ***************************************************************************/
 
 static void AsyncProc_TxMessage(void);
+static void AsyncProc_TxFrameRelease(void);
 static void SyncProc_TxMessage(void);
+static void SyncProc_TxFrame(const mc_fifo_span_t *pstFrame);
+static volatile ANT_MESSAGE *Serial_RxQueuePush(void);
 static void Serial_Wakeup(void);
+static void HFClk_Request(void);
+static void HFClk_Release(void);
+
+#if !defined (ASYNCHRONOUS_DISABLE) && defined (SERIAL_USE_UARTE)
+   static void AsyncProc_RxStart(void);
+   static void AsyncProc_RxStop(void);
+   static void AsyncProc_RxSetIdleTimeout(void);
+#endif // !ASYNCHRONOUS_DISABLE && SERIAL_USE_UARTE
 
 #if !defined (SYNCHRONOUS_DISABLE)
    static void Gpiote_FallingEdge_Enable (void);
@@ -303,6 +406,20 @@ static void Serial_Wakeup(void);
  */
 void Serial_Init (void)
 {
+   uint8_t ucSlot;
+
+   // Fixed allocation, the rx queue stays in place when the message queues are resized.
+   for (ucSlot = SERIAL_RX_QUEUE_SIZE_MAX; (ucSlot > SERIAL_RX_QUEUE_SIZE) && (pastRxQueue == astRxQueue); ucSlot >>= 1)
+   {
+      volatile ANT_MESSAGE *pastSlots = ram_arena_alloc(ucSlot * sizeof(ANT_MESSAGE));
+
+      if (pastSlots != NULL)
+      {
+         pastRxQueue = pastSlots;
+         ucRxQueueMask = ucSlot - 1;
+      }
+   }
+
 #if defined (SERIAL_PIN_PORTSEL)
    // Set SERIAL_PIN_PORTSEL as input, This determines what type of Serial to use Async or Sync
    NRF_GPIO->PIN_CNF[SERIAL_PIN_PORTSEL] = (GPIO_PIN_CNF_DIR_Input << GPIO_PIN_CNF_DIR_Pos) |
@@ -416,7 +533,20 @@ void Serial_Init (void)
                                                    (GPIO_PIN_CNF_DRIVE_S0S1 << GPIO_PIN_CNF_DRIVE_Pos) |
                                                    (GPIO_PIN_CNF_SENSE_Disabled << GPIO_PIN_CNF_SENSE_Pos);
       #endif   
-      #if defined (SERIAL_SYNC_NRF_P1)
+      #if defined (SERIAL_SYNC_USE_SPIM)
+         #if defined (SERIAL_SYNC_NRF_P1)
+            SERIAL_SYNC->PSEL.SCK = (SERIAL_SYNC_PIN_SCLK + 32);    // Assign port pin for Serial Clock
+            SERIAL_SYNC->PSEL.MOSI = (SERIAL_SYNC_PIN_SOUT + 32);   // Assign port pin for Serial Out
+            SERIAL_SYNC->PSEL.MISO = (SERIAL_SYNC_PIN_SIN + 32);    // Assign port pin for serial In
+         #else
+            SERIAL_SYNC->PSEL.SCK = SERIAL_SYNC_PIN_SCLK;    // Assign port pin for Serial Clock
+            SERIAL_SYNC->PSEL.MOSI = SERIAL_SYNC_PIN_SOUT;   // Assign port pin for Serial Out
+            SERIAL_SYNC->PSEL.MISO = SERIAL_SYNC_PIN_SIN;    // Assign port pin for serial In
+         #endif
+         SERIAL_SYNC->ORC = SERIAL_SYNC_ORC;
+         SERIAL_SYNC->TXD.LIST = 0;
+         SERIAL_SYNC->RXD.LIST = 0;
+      #elif defined (SERIAL_SYNC_NRF_P1)
          SERIAL_SYNC->PSELSCK = (SERIAL_SYNC_PIN_SCLK + 32);    // Assign port pin for Serial Clock
          SERIAL_SYNC->PSELMOSI = (SERIAL_SYNC_PIN_SOUT + 32);   // Assign port pin for Serial Out
          SERIAL_SYNC->PSELMISO = (SERIAL_SYNC_PIN_SIN + 32);    // Assign port pin for serial In
@@ -497,7 +627,7 @@ void Serial_Init (void)
          NRF_GPIOTE->EVENTS_PORT = 0;
 
          /* Run HFCLK to latch in interrupt and auto clear flags.*/
-         sd_clock_hfclk_request();
+         HFClk_Request();
       }
 
       /* configure timer0 to be used as byte synchronous serial interface inter-byte sleep delay timer. Use 1us (1MHz) resolution 16-bit timer.
@@ -530,11 +660,40 @@ void Serial_Init (void)
       #if defined(SERIAL_USE_UARTE)
          sd_nvic_DisableIRQ(UARTE0_UART0_IRQn); // disable UART interrupts
          sd_nvic_ClearPendingIRQ(UARTE0_UART0_IRQn); // clear any pending interrupts
-         SERIAL_ASYNC->INTENCLR = (UARTE_INTENCLR_ENDTX_Clear << UARTE_INTENCLR_ENDTX_Pos) | (UARTE_INTENCLR_ENDRX_Clear << UARTE_INTENCLR_ENDRX_Pos); // disable both TX and RX END interrupt
-         SERIAL_ASYNC->RXD.PTR = (uint32_t)(&aucRxBufferDMA);
-         SERIAL_ASYNC->RXD.MAXCNT = 1; // receives 1 byte at a time
+         SERIAL_ASYNC->INTENCLR = (UARTE_INTENCLR_ENDTX_Clear << UARTE_INTENCLR_ENDTX_Pos) | (UARTE_INTENCLR_ENDRX_Clear << UARTE_INTENCLR_ENDRX_Pos) |
+                                  (UARTE_INTENCLR_RXSTARTED_Clear << UARTE_INTENCLR_RXSTARTED_Pos); // disable TX END, RX END and RX STARTED interrupt
+         SERIAL_ASYNC->SHORTS = 0;
+         SERIAL_ASYNC->RXD.MAXCNT = SERIAL_ASYNC_RX_DMA_CHUNK_SIZE; // receives a chunk at a time
          SERIAL_ASYNC->EVENTS_ENDRX = 0;
          SERIAL_ASYNC->EVENTS_ENDTX = 0;
+         SERIAL_ASYNC->EVENTS_RXSTARTED = 0;
+
+         /* configure TIMER2 as counter of received bytes. Use 32-bit so the count can be compared against the ring read count. */
+         SERIAL_ASYNC_RX_COUNTER->TASKS_STOP = 1;
+         SERIAL_ASYNC_RX_COUNTER->INTENCLR = 0xFFFFFFFF;
+         SERIAL_ASYNC_RX_COUNTER->SHORTS = 0;
+         SERIAL_ASYNC_RX_COUNTER->MODE = TIMER_MODE_MODE_Counter << TIMER_MODE_MODE_Pos;
+         SERIAL_ASYNC_RX_COUNTER->BITMODE = TIMER_BITMODE_BITMODE_32Bit << TIMER_BITMODE_BITMODE_Pos;
+
+         /* configure TIMER3 as line idle timer. Use 1us (1MHz) resolution 16-bit timer, stopped and cleared on compare. */
+         sd_nvic_DisableIRQ(SERIAL_ASYNC_RX_IDLE_TIMER_IRQn);
+         sd_nvic_ClearPendingIRQ(SERIAL_ASYNC_RX_IDLE_TIMER_IRQn);
+         SERIAL_ASYNC_RX_IDLE_TIMER->TASKS_STOP = 1;
+         SERIAL_ASYNC_RX_IDLE_TIMER->INTENCLR = 0xFFFFFFFF;
+         SERIAL_ASYNC_RX_IDLE_TIMER->MODE = TIMER_MODE_MODE_Timer << TIMER_MODE_MODE_Pos;
+         SERIAL_ASYNC_RX_IDLE_TIMER->BITMODE = TIMER_BITMODE_BITMODE_16Bit << TIMER_BITMODE_BITMODE_Pos;
+         SERIAL_ASYNC_RX_IDLE_TIMER->PRESCALER = 4 << TIMER_PRESCALER_PRESCALER_Pos;
+         SERIAL_ASYNC_RX_IDLE_TIMER->SHORTS = (TIMER_SHORTS_COMPARE0_CLEAR_Enabled << TIMER_SHORTS_COMPARE0_CLEAR_Pos) |
+                                              (TIMER_SHORTS_COMPARE0_STOP_Enabled << TIMER_SHORTS_COMPARE0_STOP_Pos);
+         SERIAL_ASYNC_RX_IDLE_TIMER->EVENTS_COMPARE[0] = 0;
+         SERIAL_ASYNC_RX_IDLE_TIMER->INTENSET = TIMER_INTENSET_COMPARE0_Set << TIMER_INTENSET_COMPARE0_Pos;
+
+         /* every received byte increments the counter and (re)starts the idle timer from zero */
+         sd_ppi_channel_enable_clr(SERIAL_ASYNC_PPI_CH_RX_MASK);
+         sd_ppi_channel_assign(SERIAL_ASYNC_PPI_CH_RX_COUNT, &SERIAL_ASYNC->EVENTS_RXDRDY, &SERIAL_ASYNC_RX_COUNTER->TASKS_COUNT);
+         sd_ppi_channel_assign(SERIAL_ASYNC_PPI_CH_RX_IDLE_CLEAR, &SERIAL_ASYNC->EVENTS_RXDRDY, &SERIAL_ASYNC_RX_IDLE_TIMER->TASKS_CLEAR);
+         sd_ppi_channel_assign(SERIAL_ASYNC_PPI_CH_RX_IDLE_START, &SERIAL_ASYNC->EVENTS_RXDRDY, &SERIAL_ASYNC_RX_IDLE_TIMER->TASKS_START);
+         sd_ppi_channel_enable_set(SERIAL_ASYNC_PPI_CH_RX_MASK);
       #else
          sd_nvic_DisableIRQ(UART0_IRQn); // disable UART interrupts
          sd_nvic_ClearPendingIRQ(UART0_IRQn); // clear any pending interrupts
@@ -655,12 +814,16 @@ void Serial_Init (void)
                                 (UARTE_CONFIG_PARITY_Excluded << UARTE_CONFIG_PARITY_Pos); // flow control and parity
          SERIAL_ASYNC->BAUDRATE = asBaudControl[ucBaudrateNdx] << UARTE_BAUDRATE_BAUDRATE_Pos; // baudrate
 
+         AsyncProc_RxSetIdleTimeout();
+
          SERIAL_ASYNC_SERIAL_ENABLE(); // enable uart and acquire pins
          SERIAL_ASYNC_INT_ENDTX_ENABLE(); // enable end tx interrupt to monitor the end of transmission
-         SERIAL_ASYNC_INT_ENDRX_ENABLE(); // enable end rx interrupt to monitor the end of receiving
+         SERIAL_ASYNC_INT_RXSTARTED_ENABLE(); // enable rx started interrupt to queue the next chunk of the receive ring
 
          sd_nvic_SetPriority(UARTE0_UART0_IRQn, APP_IRQ_PRIORITY_MID); // set it up on application high priority
          sd_nvic_EnableIRQ(UARTE0_UART0_IRQn); // enable UART interrupt
+         sd_nvic_SetPriority(SERIAL_ASYNC_RX_IDLE_TIMER_IRQn, APP_IRQ_PRIORITY_MID); // same priority as UART so the rx parser is never re-entered
+         sd_nvic_EnableIRQ(SERIAL_ASYNC_RX_IDLE_TIMER_IRQn); // enable idle timer interrupt
       #else
          #if defined(SERIAL_ASYNC_NRF_P1)
             SERIAL_ASYNC->PSELRXD = (SERIAL_ASYNC_PIN_RXD + 32); // assign port pin for RXD
@@ -694,8 +857,22 @@ void Serial_Init (void)
 #endif // !ASYNCHRONOUS_DISABLE
    }
 
-   stRxMessage.ANT_MESSAGE_ucSize = 0;
+   for (ucSlot = 0; ucSlot <= ucRxQueueMask; ucSlot++)
+      pastRxQueue[ucSlot].ANT_MESSAGE_ucSize = 0; // empty the rx queue
+   ucRxQueueHead = 0;
+   ucRxQueueTail = 0;
    stTxMessage.stMessageData.ANT_MESSAGE_ucSize = 0;
+   usTxRingHead = 0;
+   usTxRingTail = 0;
+#if defined(SERIAL_USE_UARTE)
+   usTxDMASize = 0;
+#else
+   usTxFrameOffset = 0;
+#endif
+   ucTxFrameHead = 0;
+   ucTxFrameTail = 0;
+   ucTxFrameSpan = 0;
+   bTxFrameActive = false;
 }
 
 /**
@@ -727,6 +904,33 @@ uint8_t Serial_SetByteSyncSerialSRDYSleep(uint8_t ucDelay)
 #endif // !SYNCHRONOUS DISABLE
 }
 
+/**
+ * @brief Request the high frequency clock for the serial interface
+ */
+static void HFClk_Request(void)
+{
+   sd_clock_hfclk_request();
+   bHFClkRequested = true;
+}
+
+/**
+ * @brief Release the high frequency clock of the serial interface
+ */
+static void HFClk_Release(void)
+{
+   sd_clock_hfclk_release();
+   bHFClkRequested = false;
+}
+
+/**
+ * @brief Request the high frequency clock again after the softdevice was restarted, if serial held it
+ */
+void Serial_ClockRestore(void)
+{
+   if (bHFClkRequested)
+      sd_clock_hfclk_request();
+}
+
 /**
  * @brief Serial interface sleep handler
  */
@@ -742,7 +946,7 @@ void Serial_Sleep(void)
    #if !defined (SYNCHRONOUS_DISABLE)
       if (bSyncMode)
       {
-         sd_clock_hfclk_release();
+         HFClk_Release();
          Gpiote_FallingEdge_Disable();
          SERIAL_SYNC_SERIAL_DISABLE();
 
@@ -773,8 +977,12 @@ void Serial_Sleep(void)
          uint8_t i;
 
          SERIAL_ASYNC_RTS_DISABLE();      // disable RXRDY interrupt and relinquish control of RTS line. Do this before stopping rx task
+      #if defined(SERIAL_USE_UARTE)
+         AsyncProc_RxStop();              // stop reception task and receive ring
+      #else
          SERIAL_ASYNC->TASKS_STOPRX = 1;  // stop reception task
-         sd_clock_hfclk_release();        // change power states by disabling hi freq clock
+      #endif // SERIAL_USE_UARTE
+         HFClk_Release();        // change power states by disabling hi freq clock
          SERIAL_ASYNC_SERIAL_DISABLE();
 
          /* go through every GPIO pin and save sense configuration while disabling sense during sleep */
@@ -882,7 +1090,7 @@ static void Serial_Wakeup(void)
          ucPinSenseMRDY = PIN_SENSE_DISABLED;
 
 
-         sd_clock_hfclk_request();
+         HFClk_Request();
          SERIAL_SYNC_SERIAL_ENABLE();
          Gpiote_FallingEdge_Enable(); // re-enable GPIOTE sense
       }
@@ -934,10 +1142,15 @@ static void Serial_Wakeup(void)
       #endif // PWRSAVE_DISABLE
 
 
-         stRxMessage.ANT_MESSAGE_ucSize = 0; // reset message counter
-         sd_clock_hfclk_request();           // change power states by re-enabling hi freq clock
+         if (!bHold)
+            pastRxQueue[ucRxQueueHead & ucRxQueueMask].ANT_MESSAGE_ucSize = 0; // reset message counter
+         HFClk_Request();           // change power states by re-enabling hi freq clock
          SERIAL_ASYNC_SERIAL_ENABLE();
+      #if defined(SERIAL_USE_UARTE)
+         AsyncProc_RxStart();                // start Reception into an empty receive ring as early as now. Do this before releasing RTS
+      #else
          SERIAL_ASYNC->TASKS_STARTRX = 1;    // start Reception as early as now. Do this before releasing RTS
+      #endif // SERIAL_USE_UARTE
          if (!bHold)
             SERIAL_ASYNC_RTS_ENABLE();       // re-enable UART control of RTS line if it wasn't held to begin with
 
@@ -952,7 +1165,7 @@ static void Serial_Wakeup(void)
  */
 ANT_MESSAGE *Serial_GetRxMesgPtr(void)
 {
-   return ((ANT_MESSAGE *)&stRxMessage);
+   return ((ANT_MESSAGE *)&pastRxQueue[ucRxQueueTail & ucRxQueueMask]);
 }
 
 /**
@@ -963,6 +1176,22 @@ ANT_MESSAGE *Serial_GetTxMesgPtr(void)
    return ((ANT_MESSAGE *)&stTxMessage.stMessageData);
 }
 
+/**
+ * @brief Check if serial transmission is in progress
+ */
+bool Serial_TxBusy(void)
+{
+   return bTransmitting;
+}
+
+/**
+ * @brief Check if the event frame queue is full
+ */
+bool Serial_TxEventFrameQueueFull(void)
+{
+   return ((uint8_t)(ucTxFrameHead - ucTxFrameTail) >= SERIAL_TX_FRAME_QUEUE_SIZE);
+}
+
 /**
  * @brief Set baudrate
  */
@@ -988,6 +1217,9 @@ void Serial_ActivateAsyncBaudrate()
 {
     while(bTransmitting) { }
     SERIAL_ASYNC->BAUDRATE = asBaudLookup[eBaudSelection];
+#if defined(SERIAL_USE_UARTE)
+    AsyncProc_RxSetIdleTimeout();
+#endif // SERIAL_USE_UARTE
 }
 
 /**
@@ -995,18 +1227,54 @@ void Serial_ActivateAsyncBaudrate()
  */
 void Serial_ReleaseRx(void)
 {
+   if (ucRxQueueTail != ucRxQueueHead)
+   {
+      ucRxQueueTail++; // the message has been processed, free its slot
+
+      if (ucRxQueueTail != ucRxQueueHead)
+         bEventRXSerialMessageProcess = true; // more messages were received meanwhile
+   }
+
+   if (!bHold)
+      return; // reception is running already
+
+   pastRxQueue[ucRxQueueHead & ucRxQueueMask].ANT_MESSAGE_ucSize = 0; // reset the serial receive state machine into the freed slot before release as the rx parser may resume right away
    bHold = false; // release it
 
 
 #if !defined (ASYNCHRONOUS_DISABLE)
    if(!bSyncMode)
    {
-      stRxMessage.ANT_MESSAGE_ucSize = 0; // reset the serial receive state machine
       SERIAL_ASYNC_RTS_ENABLE();
+   #if defined(SERIAL_USE_UARTE)
+      sd_nvic_SetPendingIRQ(UARTE0_UART0_IRQn); // resume parsing of bytes that arrived into the receive ring while on hold
+   #endif // SERIAL_USE_UARTE
    }
 #endif // !ASYNCHRONOUS_DISABLE
 }
 
+/**
+ * @brief Queue the message received into the slot at the head. Reception is held if the queue is full.
+ * Returns the next slot to receive into, NULL when held.
+ */
+static volatile ANT_MESSAGE *Serial_RxQueuePush(void)
+{
+   volatile ANT_MESSAGE *pstRxMessage;
+
+   ucRxQueueHead++;
+   bEventRXSerialMessageProcess = true; // flag that we have a rx serial message to process
+
+   if ((uint8_t)(ucRxQueueHead - ucRxQueueTail) > ucRxQueueMask)
+   {
+      Serial_HoldRx(); // every slot is in use, flow control until a message is released
+      return NULL;
+   }
+
+   pstRxMessage = &pastRxQueue[ucRxQueueHead & ucRxQueueMask];
+   pstRxMessage->ANT_MESSAGE_ucSize = 0;
+   return pstRxMessage;
+}
+
 /**
  * @brief Hold incoming serial communication
  */
@@ -1055,6 +1323,8 @@ bool Serial_RxMessage(void)
 
 #if !defined(PWRSAVE_DISABLE)
    return true; // allow serial sleep
+#else
+   return false; // disallow serial sleep
 #endif // !PWRSAVE_DISABLE
 }
 
@@ -1063,6 +1333,9 @@ bool Serial_RxMessage(void)
  */
 void Serial_TxMessage(void)
 {
+   uint16_t usTxRingIndex;
+   uint8_t ucFrameSize;
+
    if(stTxMessage.stMessageData.ANT_MESSAGE_ucSize) // if message size is not empty, there should be something to transmit.
    {
       Serial_Wakeup();
@@ -1079,33 +1352,109 @@ void Serial_TxMessage(void)
       return; //buffer is empty, get out of here.
    }
 
+   CYCLE_PROFILE_START(ulCycleStart);
+
+   ucFrameSize = stTxMessage.stMessageData.ANT_MESSAGE_ucSize + MESG_SYNC_SIZE + MESG_SIZE_SIZE + MESG_ID_SIZE + MESG_CHECKSUM_SIZE;
+   if (!bSyncMode && ((uint16_t)(SERIAL_TX_RING_SIZE - (uint16_t)(usTxRingHead - usTxRingTail)) < ucFrameSize))
+      return; // tx ring is full, message stays in the output buffer until enough has been transmitted, not counted
+
+   stTxMessage.stMessageData.ANT_MESSAGE_aucMesgData[stTxMessage.stMessageData.ANT_MESSAGE_ucSize] =
+      DSI_CheckSum((uint8_t *)stTxMessage.stMessageData.aucMessage, stTxMessage.stMessageData.ANT_MESSAGE_ucSize + MESG_SIZE_SIZE + MESG_ID_SIZE, MESG_TX_SYNC); // include MESG_TX_SYNC to checksum calculation
+
+   if(bSyncMode)
+   {
+      bStartMessage = true;
+      bEndMessage = false;
+      bTransmitting = true;
+
+      SyncProc_TxMessage(); // sync transmission is byte polled, message is sent out before returning
+      CYCLE_PROFILE_STOP(CYCLE_PROFILE_SERIAL_TX, ulCycleStart);
+      return;
+   }
+
+   /* frame the message into the tx ring */
+   usTxRingIndex = usTxRingHead;
+   aucTxRing[usTxRingIndex++ & SERIAL_TX_RING_MASK] = MESG_TX_SYNC;
+   for (ucTxPtr = 0; ucTxPtr < (ucFrameSize - MESG_SYNC_SIZE); ucTxPtr++) // size, id, data and checksum
+      aucTxRing[usTxRingIndex++ & SERIAL_TX_RING_MASK] = stTxMessage.stMessageData.aucMessage[ucTxPtr];
+
+   stTxMessage.stMessageData.ANT_MESSAGE_ucSize = 0; // output buffer is free again
+   usTxRingHead = usTxRingIndex; // queue the frame, the interrupt may pick it up from now on
+
    if (!bTransmitting)
    {
       bStartMessage = true;
       bEndMessage = false;
       bTransmitting = true;
 
-      stTxMessage.stMessageData.ANT_MESSAGE_ucCheckSum = MESG_TX_SYNC; // include MESG_TX_SYNC to checksum calculation
+      AsyncProc_TxMessage(); // kick the first transmission, everything queued meanwhile is chained from the tx interrupt.
+   }
 
-      for (ucTxPtr=0; ucTxPtr<=(stTxMessage.stMessageData.ANT_MESSAGE_ucSize + 1); ucTxPtr++) // have to go two more than size so we include the size and the ID
-         stTxMessage.stMessageData.ANT_MESSAGE_ucCheckSum ^= stTxMessage.stMessageData.aucMessage[ucTxPtr]; // calculate the checksum
+   CYCLE_PROFILE_STOP(CYCLE_PROFILE_SERIAL_TX, ulCycleStart);
+}
 
-      stTxMessage.stMessageData.ANT_MESSAGE_aucMesgData[stTxMessage.stMessageData.ANT_MESSAGE_ucSize] = stTxMessage.stMessageData.ANT_MESSAGE_ucCheckSum; // move the calculated checksum to the correct location in the message
+/**
+ * @brief Send serial event frame in place
+ */
+bool Serial_TxEventFrame(mc_fifo_span_t *pstFrame, event_lane_t eLane, uint16_t usRecordSize)
+{
+   uint8_t ucFrame;
 
-      if(bSyncMode)
+   if (Serial_TxEventFrameQueueFull())
+      return false;
+
+   if (pstFrame == NULL) // nothing to send, release in order with the frames in flight
+   {
+      if (!bTransmitting && (ucTxFrameHead == ucTxFrameTail))
       {
-         SyncProc_TxMessage();
+         event_buffering_release(eLane, usRecordSize);
+         return true;
       }
-      else
+   }
+   else
+   {
+      Serial_Wakeup(); // frame was completed with its checksum when it was buffered
+   }
+
+   if(bSyncMode)
+   {
+      if (pstFrame != NULL)
       {
-         AsyncProc_TxMessage(); // kick the first transmission.
-         do
-         {
-            (void)sd_app_evt_wait();
-         }
-         while (stTxMessage.stMessageData.ANT_MESSAGE_ucSize); // wait for the whole message to be transmitted
+         bStartMessage = true;
+         bEndMessage = false;
+         bTransmitting = true;
+
+         SyncProc_TxFrame(pstFrame); // sync transmission is byte polled, frame is sent out before returning
       }
+
+      event_buffering_release(eLane, usRecordSize);
+      return true;
+   }
+
+   ucFrame = ucTxFrameHead & SERIAL_TX_FRAME_QUEUE_MASK;
+   if (pstFrame != NULL)
+   {
+      astTxFrame[ucFrame].stFrame = *pstFrame;
+   }
+   else
+   {
+      astTxFrame[ucFrame].stFrame.uiLen[0] = 0;
+      astTxFrame[ucFrame].stFrame.uiLen[1] = 0;
+   }
+   astTxFrame[ucFrame].eLane = eLane;
+   astTxFrame[ucFrame].usRecordSize = usRecordSize;
+   ucTxFrameHead++; // queue the frame, the interrupt may pick it up from now on
+
+   if (!bTransmitting)
+   {
+      bStartMessage = true;
+      bEndMessage = false;
+      bTransmitting = true;
+
+      AsyncProc_TxMessage(); // kick the transmission
    }
+
+   return true;
 }
 
 #if !defined (SYNCHRONOUS_DISABLE)
@@ -1195,7 +1544,7 @@ static void SyncSRDYSleep(void)
             NRF_GPIOTE->INTENSET = GPIOTE_INTENSET_PORT_Enabled << GPIOTE_INTENSET_PORT_Pos;
             NRF_GPIO->PIN_CNF[SERIAL_SYNC_PIN_SRDY] |= (GPIO_PIN_CNF_SENSE_Low << GPIO_PIN_CNF_SENSE_Pos);
 
-            sd_clock_hfclk_release();
+            HFClk_Release();
             Gpiote_FallingEdge_Disable();
 
             while (!bSRdy)
@@ -1269,7 +1618,7 @@ static void SyncSRDYSleep(void)
 }
 #endif // !SYNCHRONOUS_DISABLE
 
-#if !defined (SYNCHRONOUS_DISABLE)
+#if !defined (SYNCHRONOUS_DISABLE) && !defined (SERIAL_SYNC_USE_SPIM)
 /**
  * @brief Handle synchronous byte transaction
  */
@@ -1288,7 +1637,26 @@ static uint8_t SyncReadWriteByte(uint8_t ucByte)
 
    return ucReadByte;
 }
-#endif // !SYNCHRONOUS_DISABLE
+#endif // !SYNCHRONOUS_DISABLE && !SERIAL_SYNC_USE_SPIM
+
+#if !defined (SYNCHRONOUS_DISABLE) && defined (SERIAL_SYNC_USE_SPIM)
+/**
+ * @brief Handle synchronous block transaction, the whole block is clocked through EasyDMA on a single SRDY
+ */
+static void SyncReadWriteBlock(uint8_t *pucTxData, uint8_t ucTxSize, uint8_t *pucRxData, uint8_t ucRxSize)
+{
+   SyncSRDYSleep(); // wait for an SRDY before beginning
+
+   SERIAL_SYNC->TXD.PTR = (uint32_t)(uintptr_t)pucTxData;
+   SERIAL_SYNC->TXD.MAXCNT = ucTxSize;
+   SERIAL_SYNC->RXD.PTR = (uint32_t)(uintptr_t)pucRxData;
+   SERIAL_SYNC->RXD.MAXCNT = ucRxSize; // ORC is clocked out once the tx block is done
+   SERIAL_SYNC->EVENTS_END = 0;
+   SERIAL_SYNC->TASKS_START = 1;
+   while (!SERIAL_SYNC->EVENTS_END); // wait for the transaction to complete
+   SERIAL_SYNC->EVENTS_END = 0; // clear bit
+}
+#endif // !SYNCHRONOUS_DISABLE && SERIAL_SYNC_USE_SPIM
 
 #if !defined (SYNCHRONOUS_DISABLE)
 /**
@@ -1296,14 +1664,25 @@ static uint8_t SyncReadWriteByte(uint8_t ucByte)
  */
 static void SyncProc_RxMessage(void)
 {
+   volatile ANT_MESSAGE *pstRxMessage = &pastRxQueue[ucRxQueueHead & ucRxQueueMask];
    uint8_t ucRxSize;
    uint8_t ucRxCheckSum;
+#if defined (SERIAL_SYNC_USE_SPIM)
+   uint8_t ucTxSync = MESG_RX_SYNC;
+   uint8_t aucRxHeader[MESG_SYNC_SIZE + MESG_SIZE_SIZE];
+#endif
 
    bStartMessage = true; // flag the start of a message
 
+#if defined (SERIAL_SYNC_USE_SPIM)
+   SyncReadWriteBlock(&ucTxSync, MESG_SYNC_SIZE, aucRxHeader, sizeof(aucRxHeader)); // write the read message sync byte and read the message size byte
+
+   ucRxSize     = aucRxHeader[MESG_SYNC_SIZE];
+#else
    SyncReadWriteByte(MESG_RX_SYNC); // write the read message sync byte
 
    ucRxSize     = SyncReadWriteByte(0xFF); // read the message size byte
+#endif
    ucRxCheckSum = MESG_RX_SYNC ^ ucRxSize; // initialize the checksum
 
    if ((ucRxSize >= SERIAL_RX_BUFFER_SIZE) || (ucRxSize  == 0)) // if the message is too big for our receive buffer or empty
@@ -1312,22 +1691,25 @@ static void SyncProc_RxMessage(void)
       return; // exit
    }
 
+#if defined (SERIAL_SYNC_USE_SPIM)
+   bEndMessage = true; // flag the end of the message, the checksum is read along with the message ID and data
+   SyncReadWriteBlock(NULL, 0, (uint8_t *)pstRxMessage->ANT_MESSAGE_aucFramedData, ucRxSize + MESG_ID_SIZE + MESG_CHECKSUM_SIZE);
+   ucRxCheckSum = DSI_CheckSum((uint8_t *)pstRxMessage->ANT_MESSAGE_aucFramedData, ucRxSize + MESG_ID_SIZE + MESG_CHECKSUM_SIZE, ucRxCheckSum); // 0 if it matches
+#else
    for (ucRxPtr=0; ucRxPtr<=ucRxSize; ucRxPtr++) // we have to account for the message ID too that's why it's <=
    {
-      stRxMessage.ANT_MESSAGE_aucFramedData[ucRxPtr] = SyncReadWriteByte(0xFF); // read the byte
-      ucRxCheckSum ^= stRxMessage.ANT_MESSAGE_aucFramedData[ucRxPtr]; // recalculate the checksum
+      pstRxMessage->ANT_MESSAGE_aucFramedData[ucRxPtr] = SyncReadWriteByte(0xFF); // read the byte
+      ucRxCheckSum ^= pstRxMessage->ANT_MESSAGE_aucFramedData[ucRxPtr]; // recalculate the checksum
    }
 
    bEndMessage = true; // flag the end of the message
    ucRxCheckSum ^= SyncReadWriteByte(0xFF); // read the checksum byte and xor it with the calculated checksum
+#endif
 
-   if (!ucRxCheckSum) // if we passed the checksum
-   {
-      Serial_HoldRx();
-      bEventRXSerialMessageProcess = true; // flag that we have a rx serial message to process
-   }
+   pstRxMessage->ANT_MESSAGE_ucSize = ucRxSize; // save the receive message size
 
-   stRxMessage.ANT_MESSAGE_ucSize = ucRxSize; // save the receive message size
+   if (!ucRxCheckSum) // if we passed the checksum
+      Serial_RxQueuePush(); // queue the message
 }
 #endif // !SYNCHRONOUS_DISABLE
 
@@ -1342,6 +1724,17 @@ static void SyncProc_TxMessage(void)
 
    bStartMessage = true; // flag the start of a message
    ucTxSize = stTxMessage.stMessageData.ANT_MESSAGE_ucSize; // read out the transmit size
+
+#if defined (SERIAL_SYNC_USE_SPIM)
+   stTxMessage.ucMessageSyncByte = MESG_TX_SYNC; // sync byte is stored right in front of the message
+   pucData = &stTxMessage.ucMessageSyncByte;
+   ucTxSize += MESG_SYNC_SIZE + MESG_SIZE_SIZE + MESG_ID_SIZE;
+   SyncReadWriteBlock(pucData, ucTxSize, NULL, 0); // send everything up to the checksum
+
+   bEndMessage = true; // flag the end of the message
+   SyncReadWriteBlock(&pucData[ucTxSize], MESG_CHECKSUM_SIZE, NULL, 0); // send the checksum
+   stTxMessage.stMessageData.ANT_MESSAGE_ucSize = 0; // clear the transmit size
+#else
    stTxMessage.stMessageData.ANT_MESSAGE_ucSize = 0; // clear the transmit size
 
    SyncReadWriteByte(MESG_TX_SYNC); // send the SYNC byte
@@ -1358,6 +1751,54 @@ static void SyncProc_TxMessage(void)
 
    bEndMessage = true; // flag the end of the message
    SyncReadWriteByte(*pucData); // send the last byte it should be the checksum
+#endif // SERIAL_SYNC_USE_SPIM
+
+   bTransmitting = false; // transmission done.
+#endif // !SYNCHRONOUS_DISABLE
+}
+
+/**
+ * @brief Synchronous tx frame
+ */
+static void SyncProc_TxFrame(const mc_fifo_span_t *pstFrame)
+{
+#if !defined (SYNCHRONOUS_DISABLE)
+#if defined (SERIAL_SYNC_USE_SPIM)
+   uint8_t *pucData = pstFrame->pucData[0];
+   uint8_t ucTxSize = (uint8_t)(pstFrame->uiLen[0] + pstFrame->uiLen[1] - MESG_CHECKSUM_SIZE);
+
+   bStartMessage = true; // flag the start of a message
+
+   if (pstFrame->uiLen[1]) // wraps around the end of the event buffer, copy it so it goes out in the same blocks as any other message
+   {
+      memcpy(aucSyncTxFrame, pstFrame->pucData[0], pstFrame->uiLen[0]);
+      memcpy(&aucSyncTxFrame[pstFrame->uiLen[0]], pstFrame->pucData[1], pstFrame->uiLen[1]);
+      pucData = aucSyncTxFrame;
+   }
+
+   SyncReadWriteBlock(pucData, ucTxSize, NULL, 0); // send everything up to the checksum, frame includes the SYNC byte
+
+   bEndMessage = true; // flag the end of the message
+   SyncReadWriteBlock(&pucData[ucTxSize], MESG_CHECKSUM_SIZE, NULL, 0); // send the checksum
+#else
+   uint16_t usTxSize;
+   uint8_t ucSpan;
+   fifo_offset_t uiIndex;
+
+   bStartMessage = true; // flag the start of a message
+   usTxSize = pstFrame->uiLen[0] + pstFrame->uiLen[1];
+
+   for (ucSpan = 0; ucSpan < 2; ucSpan++)
+   {
+      for (uiIndex = 0; uiIndex < pstFrame->uiLen[ucSpan]; uiIndex++)
+      {
+         if (--usTxSize == 0)
+            bEndMessage = true; // flag the end of the message, last byte is the checksum
+
+         SyncReadWriteByte(pstFrame->pucData[ucSpan][uiIndex]); // frame includes the SYNC byte
+      }
+   }
+#endif // SERIAL_SYNC_USE_SPIM
 
    bTransmitting = false; // transmission done.
 #endif // !SYNCHRONOUS_DISABLE
@@ -1389,168 +1830,353 @@ static bool Sync_IsMSGRDYAsserted(void)
 static void AsyncProc_TxMessage(void)
 {
 #if !defined (ASYNCHRONOUS_DISABLE)
+   uint16_t usTxRingPending;
+   mc_fifo_span_t *pstFrame;
    #if defined (SERIAL_USE_UARTE)
+      uint16_t usTxRingIndex;
+
       SERIAL_ASYNC->EVENTS_ENDTX = 0;
-      if (stTxMessage.stMessageData.ANT_MESSAGE_ucSize && !bEndMessage) // if we have a message that is ready to send
+      usTxRingTail += usTxDMASize; // release what has just been transmitted, nothing on the first kick
+      usTxDMASize = 0;
+      if (bTxFrameActive)
       {
-         if (bStartMessage)
-         {
-            bStartMessage = false;
-            stTxMessage.ucMessageSyncByte = MESG_TX_SYNC;
-            SERIAL_ASYNC->TXD.PTR = (uint32_t)(&stTxMessage.ucMessageSyncByte);
-            SERIAL_ASYNC->TXD.MAXCNT = stTxMessage.stMessageData.ANT_MESSAGE_ucSize
-                                     + MESG_SYNC_SIZE
-                                     + MESG_SIZE_SIZE
-                                     + MESG_ID_SIZE
-                                     + MESG_CHECKSUM_SIZE;
-            SERIAL_ASYNC_START_TX();
-            bTransmitting = true;
-         }
-         else
-         {
-            SERIAL_ASYNC_STOP_TX();
-            stTxMessage.stMessageData.ANT_MESSAGE_ucSize = 0;
-            bEndMessage = true;
-            bTransmitting = false;
-         }
+         bTxFrameActive = false;
+         ucTxFrameSpan++;
+      }
+      AsyncProc_TxFrameRelease();
+
+      usTxRingPending = usTxRingHead - usTxRingTail;
+      if (usTxRingPending && !ucTxFrameSpan) // if we have messages that are ready to send
+      {
+         bStartMessage = false;
+         usTxRingIndex = usTxRingTail & SERIAL_TX_RING_MASK;
+
+         /* send everything up to the end of the ring in one go */
+         usTxDMASize = SERIAL_TX_RING_SIZE - usTxRingIndex;
+         if (usTxDMASize > usTxRingPending)
+            usTxDMASize = usTxRingPending;
+         if (usTxDMASize > SERIAL_ASYNC_TX_DMA_MAX_SIZE)
+            usTxDMASize = SERIAL_ASYNC_TX_DMA_MAX_SIZE;
+
+         SERIAL_ASYNC->TXD.PTR = (uint32_t)(&aucTxRing[usTxRingIndex]);
+         SERIAL_ASYNC->TXD.MAXCNT = usTxDMASize;
+         SERIAL_ASYNC_START_TX();
+      }
+      else if (ucTxFrameTail != ucTxFrameHead) // send the frame straight out of the event buffer
+      {
+         bStartMessage = false;
+         bTxFrameActive = true;
+         pstFrame = &astTxFrame[ucTxFrameTail & SERIAL_TX_FRAME_QUEUE_MASK].stFrame;
+
+         SERIAL_ASYNC->TXD.PTR = (uint32_t)(pstFrame->pucData[ucTxFrameSpan]);
+         SERIAL_ASYNC->TXD.MAXCNT = pstFrame->uiLen[ucTxFrameSpan];
+         SERIAL_ASYNC_START_TX();
+      }
+      else
+      {
+         SERIAL_ASYNC_STOP_TX();
+         bEndMessage = true;
       }
    #else
       SERIAL_ASYNC->EVENTS_TXDRDY = 0;  // make sure flag is clear to make way for the setting on empty
 
-      if (stTxMessage.stMessageData.ANT_MESSAGE_ucSize && !bEndMessage) // if we have a message that is ready to send
+      if (bStartMessage)
       {
-         if (bStartMessage) // we have to write the SYNC byte as well
-         {
-            bStartMessage = false;
-            ucTxPtr = 0; // initialize the message pointer for below
-
-            SERIAL_ASYNC_START_TX();
-            SERIAL_ASYNC->TXD = MESG_TX_SYNC; // write the sync byte
-         }
-         else if (ucTxPtr <= (stTxMessage.stMessageData.ANT_MESSAGE_ucSize+2)) // send the data and checksum
-         {
-            SERIAL_ASYNC->TXD = stTxMessage.stMessageData.aucMessage[ucTxPtr++];
-         }
-         else
+         bStartMessage = false;
+         SERIAL_ASYNC_START_TX();
+      }
+      else if (bTxFrameActive)
+      {
+         bTxFrameActive = false;
+         if (++usTxFrameOffset >= astTxFrame[ucTxFrameTail & SERIAL_TX_FRAME_QUEUE_MASK].stFrame.uiLen[ucTxFrameSpan])
          {
-            SERIAL_ASYNC_STOP_TX();
-            stTxMessage.stMessageData.ANT_MESSAGE_ucSize = 0;
-            bEndMessage = true;
-            bTransmitting = false;
+            usTxFrameOffset = 0;
+            ucTxFrameSpan++;
          }
       }
       else
+      {
+         usTxRingTail++; // previous byte is out
+      }
+      AsyncProc_TxFrameRelease();
+
+      usTxRingPending = usTxRingHead - usTxRingTail;
+      if (usTxRingPending && !ucTxFrameSpan && !usTxFrameOffset) // send the next queued byte
+      {
+         SERIAL_ASYNC->TXD = aucTxRing[usTxRingTail & SERIAL_TX_RING_MASK];
+      }
+      else if (ucTxFrameTail != ucTxFrameHead) // send the next frame byte straight out of the event buffer
+      {
+         bTxFrameActive = true;
+         pstFrame = &astTxFrame[ucTxFrameTail & SERIAL_TX_FRAME_QUEUE_MASK].stFrame;
+         SERIAL_ASYNC->TXD = pstFrame->pucData[ucTxFrameSpan][usTxFrameOffset];
+      }
+      else
       {
          SERIAL_ASYNC_STOP_TX();
-         stTxMessage.stMessageData.ANT_MESSAGE_ucSize = 0;
          bEndMessage = true;
-         bTransmitting = false;
       }
    #endif // SERIAL_USE_UARTE
 #endif // !ASYNCHRONOUS_DISABLE
 }
 
 /**
- * @brief Asynchronous rx message
+ * @brief Release transmitted frames at the tail of the frame queue back to the event buffer
  */
+static void AsyncProc_TxFrameRelease(void)
+{
+#if !defined (ASYNCHRONOUS_DISABLE)
+   uint8_t ucFrame;
+
+   while (ucTxFrameTail != ucTxFrameHead)
+   {
+      ucFrame = ucTxFrameTail & SERIAL_TX_FRAME_QUEUE_MASK;
+      if ((ucTxFrameSpan < 2) && astTxFrame[ucFrame].stFrame.uiLen[ucTxFrameSpan])
+         break; // frame has data left to send
+
+      event_buffering_release(astTxFrame[ucFrame].eLane, astTxFrame[ucFrame].usRecordSize);
+      ucTxFrameTail++;
+      ucTxFrameSpan = 0;
+   }
+#endif // !ASYNCHRONOUS_DISABLE
+}
+
 #if !defined (ASYNCHRONOUS_DISABLE)
 #define MESG_SIZE_READ     ((uint8_t)0x55) // async control flag
+#if defined(SERIAL_USE_UARTE)
+#define SERIAL_ASYNC_RX_CHAR_TIME_SCALE   ((uint32_t)2684354560UL) // 10-bit character time in us is (10 * 2^32 / 16MHz) / BAUDRATE register value
+/**
+ * @brief Set the receive line idle timeout according to the current baudrate
+ */
+static void AsyncProc_RxSetIdleTimeout(void)
+{
+   uint32_t ulBaudrate = SERIAL_ASYNC->BAUDRATE;
+   uint32_t ulIdleTimeout = 0xFFFF; // longest 16-bit idle timeout (us)
+
+   if (ulBaudrate)
+   {
+      ulIdleTimeout = (SERIAL_ASYNC_RX_CHAR_TIME_SCALE / ulBaudrate) * SERIAL_ASYNC_RX_IDLE_BYTES + 1;
+      if (ulIdleTimeout > 0xFFFF)
+         ulIdleTimeout = 0xFFFF;
+   }
+
+   SERIAL_ASYNC_RX_IDLE_TIMER->CC[0] = ulIdleTimeout;
+}
+
+/**
+ * @brief Start reception into an empty receive ring
+ */
+static void AsyncProc_RxStart(void)
+{
+   SERIAL_ASYNC_RX_IDLE_TIMER->TASKS_STOP = 1;
+   SERIAL_ASYNC_RX_IDLE_TIMER->TASKS_CLEAR = 1;
+   SERIAL_ASYNC_RX_COUNTER->TASKS_STOP = 1;
+   SERIAL_ASYNC_RX_COUNTER->TASKS_CLEAR = 1;
+   SERIAL_ASYNC_RX_COUNTER->TASKS_START = 1; // counter mode needs to be started before it accepts COUNT tasks
+
+   ulRxDMAChunk = 0;
+   ulRxWriteCount = 0;
+   ulRxReadCount = 0;
+
+   SERIAL_ASYNC->EVENTS_RXSTARTED = 0;
+   SERIAL_ASYNC->EVENTS_ENDRX = 0;
+   SERIAL_ASYNC->RXD.PTR = (uint32_t)(&aucRxRingDMA[0]);
+   SERIAL_ASYNC->RXD.MAXCNT = SERIAL_ASYNC_RX_DMA_CHUNK_SIZE;
+   SERIAL_ASYNC->SHORTS = UARTE_SHORTS_ENDRX_STARTRX_Enabled << UARTE_SHORTS_ENDRX_STARTRX_Pos; // chain into the next chunk in hardware
+   SERIAL_ASYNC->TASKS_STARTRX = 1;
+}
+
+/**
+ * @brief Stop reception into the receive ring
+ */
+static void AsyncProc_RxStop(void)
+{
+   SERIAL_ASYNC->SHORTS = 0; // must not restart on the ENDRX generated by STOPRX
+   SERIAL_ASYNC->TASKS_STOPRX = 1;
+   SERIAL_ASYNC_RX_IDLE_TIMER->TASKS_STOP = 1;
+   SERIAL_ASYNC_RX_IDLE_TIMER->EVENTS_COMPARE[0] = 0;
+   SERIAL_ASYNC_RX_COUNTER->TASKS_STOP = 1;
+}
+
+/**
+ * @brief Queue the next chunk of the receive ring. Called on RXSTARTED, the previous chunk is complete.
+ */
+static void AsyncProc_RxChunkStarted(void)
+{
+   uint32_t ulCompleteCount;
+
+   SERIAL_ASYNC->EVENTS_RXSTARTED = 0;
+
+   ulRxDMAChunk++; // chunk (ulRxDMAChunk - 1) is being received into now
+   SERIAL_ASYNC->RXD.PTR = (uint32_t)(&aucRxRingDMA[(ulRxDMAChunk & (SERIAL_ASYNC_RX_DMA_CHUNKS - 1)) * SERIAL_ASYNC_RX_DMA_CHUNK_SIZE]);
+
+   ulCompleteCount = (ulRxDMAChunk - 1) * SERIAL_ASYNC_RX_DMA_CHUNK_SIZE;
+   if ((int32_t)(ulCompleteCount - ulRxWriteCount) > 0)
+      ulRxWriteCount = ulCompleteCount;
+
+   /* the chunk just queued must not hold any unread bytes, otherwise they are lost */
+   if ((int32_t)(ulCompleteCount + (2 * SERIAL_ASYNC_RX_DMA_CHUNK_SIZE) - SERIAL_ASYNC_RX_RING_SIZE - ulRxReadCount) > 0)
+   {
+      ulRxReadCount = ulCompleteCount; // drop everything up to the chunk being received
+      if (!bHold)
+         pastRxQueue[ucRxQueueHead & ucRxQueueMask].ANT_MESSAGE_ucSize = 0; // reset the RX message
+   }
+}
+
+/**
+ * @brief Asynchronous rx message. Parses every byte available in the receive ring.
+ */
 static void AsyncProc_RxMessage(void)
 {
+   volatile ANT_MESSAGE *pstRxMessage = &pastRxQueue[ucRxQueueHead & ucRxQueueMask];
+   uint32_t ulWriteCount;
    uint8_t ucByte;
    uint8_t ucURxStatus;
-   #if defined(SERIAL_USE_UARTE)
-      SERIAL_ASYNC->EVENTS_ENDRX = 0; // clear the pending interrupt flag
-      ucByte = aucRxBufferDMA; // read the incoming char
-      SERIAL_ASYNC->RXD.MAXCNT = 1;
-      SERIAL_ASYNC->TASKS_STARTRX = 1;
-   #else
-      SERIAL_ASYNC->EVENTS_RXDRDY = 0;  // clear the pending interrupt flag
-      ucByte = SERIAL_ASYNC->RXD;  // read the incoming char
-   #endif // SERIAL_USE_UARTE
+   uint8_t ucSize;
+   uint8_t ucCheckSum;
+
+   ucURxStatus = SERIAL_ASYNC->ERRORSRC; // read the error flags
+   if (ucURxStatus & (UARTE_ERRORSRC_FRAMING_Msk | UARTE_ERRORSRC_PARITY_Msk | UARTE_ERRORSRC_OVERRUN_Msk)) // if we had a character error
+   {
+      SERIAL_ASYNC->ERRORSRC = ucURxStatus;
+      if (!bHold)
+         pstRxMessage->ANT_MESSAGE_ucSize = 0;
+   }
+
+   if (bHold) // rx queue is full, leave any following bytes untouched until a message is released
+      return;
+
+   ulWriteCount = ulRxWriteCount;
+   ucSize = pstRxMessage->ANT_MESSAGE_ucSize;
+   ucCheckSum = pstRxMessage->ANT_MESSAGE_ucCheckSum;
+
+   while (ulRxReadCount != ulWriteCount)
+   {
+      ucByte = aucRxRingDMA[ulRxReadCount++ & SERIAL_ASYNC_RX_RING_MASK];
+
+      if (!ucSize) // we are looking for the sync byte of a message
+      {
+         if (ucByte == MESG_TX_SYNC) // this is a valid SYNC byte
+         {
+            ucCheckSum = MESG_TX_SYNC; // init the checksum
+            ucSize     = MESG_SIZE_READ; // set the byte pointer to get the size byte
+         }
+      }
+      else if (ucSize == MESG_SIZE_READ) // if we are processing the size byte of a message
+      {
+         ucSize = 0; // if the size is invalid we want to reset the rx message
+
+         if (ucByte <= MESG_MAX_SIZE_VALUE) // make sure this is a valid message
+         {
+            ucSize      = ucByte; // save the size of the message
+            ucCheckSum ^= ucByte; // calculate checksum
+            ucRxPtr     = 0; // set the byte pointer to start collecting the message
+         }
+      }
+      else
+      {
+         ucCheckSum ^= ucByte; // calculate checksum
+
+         if (ucRxPtr > ucSize) // we have received the whole message + 1 for the message ID
+         {
+            if (!ucCheckSum) // the checksum passed
+            {
+               pstRxMessage->ANT_MESSAGE_ucSize = ucSize;
+               pstRxMessage->ANT_MESSAGE_ucCheckSum = ucCheckSum;
+               pstRxMessage = Serial_RxQueuePush(); // queue the message and carry on in the next slot
+               if (pstRxMessage == NULL)
+                  return; // the rest of the ring is parsed once released
+            }
+
+            ucSize = 0; // reset the RX message
+         }
+         else // this is a data byte
+         {
+            pstRxMessage->ANT_MESSAGE_aucFramedData[ucRxPtr++] = ucByte; // save the byte
+         }
+      }
+   }
+
+   pstRxMessage->ANT_MESSAGE_ucSize = ucSize;
+   pstRxMessage->ANT_MESSAGE_ucCheckSum = ucCheckSum;
+}
+#else
+/**
+ * @brief Asynchronous rx message
+ */
+static void AsyncProc_RxMessage(void)
+{
+   volatile ANT_MESSAGE *pstRxMessage = &pastRxQueue[ucRxQueueHead & ucRxQueueMask];
+   uint8_t ucByte;
+   uint8_t ucURxStatus;
+
+   SERIAL_ASYNC->EVENTS_RXDRDY = 0;  // clear the pending interrupt flag
+   ucByte = SERIAL_ASYNC->RXD;  // read the incoming char
    ucURxStatus = SERIAL_ASYNC->ERRORSRC; // read the overflow flag
 
-   #if defined(SERIAL_USE_UARTE)
-   if (ucURxStatus & UARTE_ERRORSRC_FRAMING_Msk) // if we had a character error
-   #else
-   if (ucURxStatus & UART_ERRORSRC_FRAMING_Msk)
-   #endif
+   if (bHold) // rx queue is full, drop the byte
    {
       SERIAL_ASYNC->ERRORSRC = ucURxStatus;
-      stRxMessage.ANT_MESSAGE_ucSize = 0;
-      #if defined(SERIAL_USE_UARTE)
-         SERIAL_ASYNC_RX_RESTART();
-      #endif // SERIAL_USE_UARTE
+      return;
+   }
+
+   if (ucURxStatus & UART_ERRORSRC_FRAMING_Msk) // if we had a character error
+   {
+      SERIAL_ASYNC->ERRORSRC = ucURxStatus;
+      pstRxMessage->ANT_MESSAGE_ucSize = 0;
    }
-   #if defined(SERIAL_USE_UARTE)
-   if (ucURxStatus & (UARTE_ERRORSRC_PARITY_Msk))
-   #else
    if (ucURxStatus & (UART_ERRORSRC_PARITY_Msk))
-   #endif
    {
       SERIAL_ASYNC->ERRORSRC = ucURxStatus;
-      stRxMessage.ANT_MESSAGE_ucSize = 0;
-      #if defined(SERIAL_USE_UARTE)
-         SERIAL_ASYNC_RX_RESTART();
-      #endif // SERIAL_USE_UARTE
+      pstRxMessage->ANT_MESSAGE_ucSize = 0;
    }
-   #if defined(SERIAL_USE_UARTE)
-   if (ucURxStatus & (UARTE_ERRORSRC_OVERRUN_Msk))
-   #else
    if (ucURxStatus & (UART_ERRORSRC_OVERRUN_Msk))
-   #endif
    {
       SERIAL_ASYNC->ERRORSRC = ucURxStatus;
-      stRxMessage.ANT_MESSAGE_ucSize = 0;
-      #if defined(SERIAL_USE_UARTE)
-         SERIAL_ASYNC_RX_RESTART();
-      #endif // SERIAL_USE_UARTE
+      pstRxMessage->ANT_MESSAGE_ucSize = 0;
    }
 
-   if (!stRxMessage.ANT_MESSAGE_ucSize) // we are looking for the sync byte of a message
+   if (!pstRxMessage->ANT_MESSAGE_ucSize) // we are looking for the sync byte of a message
    {
       if (ucByte == MESG_TX_SYNC) // this is a valid SYNC byte
       {
-         stRxMessage.ANT_MESSAGE_ucCheckSum = MESG_TX_SYNC; // init the checksum
-         stRxMessage.ANT_MESSAGE_ucSize     = MESG_SIZE_READ; // set the byte pointer to get the size byte
+         pstRxMessage->ANT_MESSAGE_ucCheckSum = MESG_TX_SYNC; // init the checksum
+         pstRxMessage->ANT_MESSAGE_ucSize     = MESG_SIZE_READ; // set the byte pointer to get the size byte
       }
    }
-   else if (stRxMessage.ANT_MESSAGE_ucSize == MESG_SIZE_READ) // if we are processing the size byte of a message
+   else if (pstRxMessage->ANT_MESSAGE_ucSize == MESG_SIZE_READ) // if we are processing the size byte of a message
    {
-      stRxMessage.ANT_MESSAGE_ucSize = 0; // if the size is invalid we want to reset the rx message
+      pstRxMessage->ANT_MESSAGE_ucSize = 0; // if the size is invalid we want to reset the rx message
 
       if (ucByte <= MESG_MAX_SIZE_VALUE) // make sure this is a valid message
       {
-         stRxMessage.ANT_MESSAGE_ucSize      = ucByte; // save the size of the message
-         stRxMessage.ANT_MESSAGE_ucCheckSum ^= ucByte; // calculate checksum
+         pstRxMessage->ANT_MESSAGE_ucSize      = ucByte; // save the size of the message
+         pstRxMessage->ANT_MESSAGE_ucCheckSum ^= ucByte; // calculate checksum
          ucRxPtr       = 0; // set the byte pointer to start collecting the message
       }
    }
    else
    {
-      stRxMessage.ANT_MESSAGE_ucCheckSum ^= ucByte; // calculate checksum
+      pstRxMessage->ANT_MESSAGE_ucCheckSum ^= ucByte; // calculate checksum
 
-      if (ucRxPtr > stRxMessage.ANT_MESSAGE_ucSize) // we have received the whole message + 1 for the message ID
+      if (ucRxPtr > pstRxMessage->ANT_MESSAGE_ucSize) // we have received the whole message + 1 for the message ID
       {
-         #if defined (SERIAL_USE_UARTE)
-            SERIAL_ASYNC_RX_RESTART();
-         #endif // SERIAL_USE_UARTE
-         if (!stRxMessage.ANT_MESSAGE_ucCheckSum) // the checksum passed
+         if (!pstRxMessage->ANT_MESSAGE_ucCheckSum) // the checksum passed
          {
-            Serial_HoldRx();
-            bEventRXSerialMessageProcess = true; // flag that we have a rx serial message to process
+            Serial_RxQueuePush(); // queue the message, the next byte goes into the next slot
          }
          else
          {
-            stRxMessage.ANT_MESSAGE_ucSize = 0; // reset the RX message
+            pstRxMessage->ANT_MESSAGE_ucSize = 0; // reset the RX message
          }
       }
       else // this is a data byte
       {
-         stRxMessage.ANT_MESSAGE_aucFramedData[ucRxPtr++] = ucByte; // save the byte
+         pstRxMessage->ANT_MESSAGE_aucFramedData[ucRxPtr++] = ucByte; // save the byte
       }
    }
 }
+#endif // SERIAL_USE_UARTE
 #endif // !ASYNCHRONOUS_DISABLE
 
 /**
@@ -1559,14 +2185,20 @@ static void AsyncProc_RxMessage(void)
 void Serial_UART0_IRQHandler(void)
 {
 #if !defined(ASYNCHRONOUS_DISABLE)
+   CYCLE_PROFILE_START(ulCycleStart);
+
    #if defined (SERIAL_USE_UARTE)
-   if (SERIAL_ASYNC->EVENTS_ENDRX && (SERIAL_ASYNC->INTENSET & (UARTE_INTENSET_ENDRX_Set << UARTE_INTENSET_ENDRX_Pos)))
+   if (SERIAL_ASYNC->EVENTS_RXSTARTED && (SERIAL_ASYNC->INTENSET & (UARTE_INTENSET_RXSTARTED_Set << UARTE_INTENSET_RXSTARTED_Pos)))
+   {
+      AsyncProc_RxChunkStarted();
+   }
+   AsyncProc_RxMessage(); // parse completed chunks, also resumes parsing after Serial_ReleaseRx
    #else
    if (SERIAL_ASYNC->EVENTS_RXDRDY && (SERIAL_ASYNC->INTENSET & (UART_INTENSET_RXDRDY_Set << UART_INTENSET_RXDRDY_Pos)))
-   #endif // SERIAL_USE_UARTE
    {
       AsyncProc_RxMessage();
    }
+   #endif // SERIAL_USE_UARTE
    #if defined (SERIAL_USE_UARTE)
    if (SERIAL_ASYNC->EVENTS_ENDTX && (SERIAL_ASYNC->INTENSET & (UARTE_INTENSET_ENDTX_Set << UARTE_INTENSET_ENDTX_Pos)))
    #else
@@ -1575,9 +2207,34 @@ void Serial_UART0_IRQHandler(void)
    {
       AsyncProc_TxMessage();
    }
+
+   CYCLE_PROFILE_STOP(CYCLE_PROFILE_UART0_IRQ, ulCycleStart);
 #endif // !ASYNCHRONOUS_DISABLE
 }
 
+/**
+ * @brief Interrupt handler for asynchronous serial receive line idle timer
+ */
+void Serial_TIMER3_IRQHandler(void)
+{
+#if !defined(ASYNCHRONOUS_DISABLE) && defined (SERIAL_USE_UARTE)
+   uint32_t ulCount;
+
+   if (SERIAL_ASYNC_RX_IDLE_TIMER->EVENTS_COMPARE[0])
+   {
+      SERIAL_ASYNC_RX_IDLE_TIMER->EVENTS_COMPARE[0] = 0;
+
+      /* line is idle, every counted byte has been written to the receive ring */
+      SERIAL_ASYNC_RX_COUNTER->TASKS_CAPTURE[0] = 1;
+      ulCount = SERIAL_ASYNC_RX_COUNTER->CC[0];
+      if ((int32_t)(ulCount - ulRxWriteCount) > 0)
+         ulRxWriteCount = ulCount;
+
+      AsyncProc_RxMessage();
+   }
+#endif // !ASYNCHRONOUS_DISABLE && SERIAL_USE_UARTE
+}
+
 /**
  * @brief Interrupt handler for synchronous serial SMSGRDY and SRDY interrupt. Uses GPIOTE 0 and 1
  */
@@ -1685,24 +2342,15 @@ void Serial_GPIOTE_IRQHandler(void)
 /**
  * @brief ANT event handler used by serial interface
  */
-void Serial_ANTEventHandler(uint8_t ucEvent, ANT_MESSAGE *pstANTMessage)
+bool Serial_ANTEventHandler(uint8_t ucEvent, uint8_t ucChannel)
 {
    if ((ucEvent == EVENT_TRANSFER_NEXT_DATA_BLOCK) || (ucEvent == EVENT_TRANSFER_TX_COMPLETED) || (ucEvent == EVENT_TRANSFER_TX_FAILED) || (ucEvent == EVENT_QUE_OVERFLOW))
    {
-      // if a burst transfer process was queued
-      if (ucQueuedTxBurstChannel != 0xFF)
-      {
-         if ((ucQueuedTxBurstChannel == (pstANTMessage->ANT_MESSAGE_ucChannel & CHANNEL_NUMBER_MASK)) || // event and queued channel number matches
-             (ucEvent == EVENT_QUE_OVERFLOW)) // queue overflow (channel events might be lost)
-         {
-            ucQueuedTxBurstChannel = 0xFF;
-            Serial_ReleaseRx(); // release input buffer
-         }
-      }
+      Command_BurstTransferEvent(ucEvent, ucChannel); // hand the next staged burst packet over
 
       if (ucEvent == EVENT_TRANSFER_NEXT_DATA_BLOCK)
       {
-         pstANTMessage->ANT_MESSAGE_ucSize = 0; // do not send out this event message
+         return false; // do not send out this event message
       }
       else if (ucEvent == EVENT_TRANSFER_TX_FAILED)
       {
@@ -1710,4 +2358,5 @@ void Serial_ANTEventHandler(uint8_t ucEvent, ANT_MESSAGE *pstANTMessage)
       }
    }
 
+   return true;
 }
@@ -26,7 +26,11 @@ All rights reserved.
 #include "ant_error.h"
 #include "appconfig.h"
 #include "boardconfig.h"
+#include "command.h"
 #include "dsi_utility.h"
+#include "event_buffering.h"
+#include "main.h"
+#include "ram_arena.h"
 #include "serial.h"
 #include "global.h"
 
@@ -58,14 +62,21 @@ All rights reserved.
 // Since the RTC is on a different clock domain we need to delay to ensure
 // tasks have taken effect.
 #define SYS_TIME_RTC_TASK_LATENCY_US                     46
+// Compare channel used for the system timer alarm, cc[3] is used for serial wake-up.
+#define SYS_TIME_RTC_ALARM_CC                            0
+// The compare event is not guaranteed to trigger when CC is set to COUNTER + 1.
+#define SYS_TIME_RTC_ALARM_MIN_TICKS                     2
 
 static bool bFlashBusy = false;                                         // For monitoring flash write progress
+static bool bFlashFailed = false;                                       // Result of the last flash operation
 
 // Keep track of a base time since the RTC doesn't have enough bits.
 static uint32_t ulSysTimeOffset;
 
 static uint32_t ulTimerRequests;
 
+static bool bDCToDCEnabled;                                             // DC/DC converter enabled by the host
+static uint8_t ucTxBurstQueueSize = ANT_STACK_TX_BURST_QUEUE_SIZE_DEFAULT; // not part of ANT_ENABLE, the stack takes what is left of its block
 
 /**
  * @brief Application system level initialization
@@ -330,6 +341,31 @@ uint8_t System_SetRSSICal(ANT_MESSAGE *pstRxMessage)
    return RESPONSE_NO_ERROR;
 }
 
+/**
+ * @brief Sets the DC/DC converter mode.
+ */
+uint8_t System_SetDCToDC(uint8_t ucMode)
+{
+   if (ucMode == DC_TO_DC_OFF)
+      bDCToDCEnabled = false;
+   else if (ucMode == DC_TO_DC_ON)
+      bDCToDCEnabled = true;
+   else
+      return INVALID_PARAMETER_PROVIDED;
+
+   sd_power_dcdc_mode_set(bDCToDCEnabled ? NRF_POWER_DCDC_ENABLE : NRF_POWER_DCDC_DISABLE);
+   return RESPONSE_NO_ERROR;
+}
+
+/**
+ * @brief Applies the SoC settings made through the softdevice again, they are dropped when it is disabled.
+ */
+void System_SoftDeviceRestore(void)
+{
+   if (bDCToDCEnabled)
+      sd_power_dcdc_mode_set(NRF_POWER_DCDC_ENABLE);
+}
+
 /**
  * @brief Constructs RSSI calibration message and calls function to retrieve calibration data.
  */
@@ -352,6 +388,77 @@ void System_GetRSSICalData(uint8_t *pucRSSICal)
    pucRSSICal[0] = ulCalData & 0x000000FF;
 }
 
+/**
+ * @brief Restarts the ANT stack with the channel memory configuration given by the host
+ */
+uint8_t System_SetANTMemoryConfig(ANT_MESSAGE *pstRxMessage, ANT_MESSAGE *pstTxMessage)
+{
+   ANT_ENABLE stANTEnable;
+   uint32_t ulRequiredSize;
+   uint32_t ulErrorCode;
+
+   if (pstRxMessage->ANT_MESSAGE_ucSize != MESG_ANT_MEMORY_CONFIG_SET_SIZE)
+      return INVALID_MESSAGE;
+
+   stANTEnable.ucTotalNumberOfChannels = pstRxMessage->ANT_MESSAGE_aucPayload[0];
+   stANTEnable.ucNumberOfEncryptedChannels = pstRxMessage->ANT_MESSAGE_aucPayload[1];
+   stANTEnable.usNumberOfEvents = pstRxMessage->ANT_MESSAGE_aucPayload[3];
+
+   if ((stANTEnable.ucTotalNumberOfChannels == 0) || (stANTEnable.ucTotalNumberOfChannels > ANT_STACK_TOTAL_CHANNELS_ALLOCATED_MAX) ||
+       (stANTEnable.ucNumberOfEncryptedChannels > stANTEnable.ucTotalNumberOfChannels) || (stANTEnable.ucNumberOfEncryptedChannels > ANT_STACK_ENCRYPTED_CHANNELS_MAX) ||
+       (pstRxMessage->ANT_MESSAGE_aucPayload[2] > ANT_STACK_TX_BURST_QUEUE_SIZE_MAX) ||
+       (stANTEnable.usNumberOfEvents == 0) || (stANTEnable.usNumberOfEvents > ANT_STACK_EVENT_QUEUE_NUM_EVENTS_MAX))
+      return INVALID_PARAMETER_PROVIDED;
+
+   ulRequiredSize = ANT_ENABLE_GET_REQUIRED_SPACE(stANTEnable.ucTotalNumberOfChannels, stANTEnable.ucNumberOfEncryptedChannels, pstRxMessage->ANT_MESSAGE_aucPayload[2], stANTEnable.usNumberOfEvents);
+   if (ulRequiredSize > ram_arena_get_owner_limit()) // the channel block is shared with the serial rx queue
+      return INVALID_PARAMETER_PROVIDED;
+
+   stANTEnable.pucMemoryBlockStartLocation = aucANTChannelBlock;
+   stANTEnable.usMemoryBlockByteSize = (uint16_t)ulRequiredSize;
+
+   // Event frames are sent straight out of the message queues, which move with the stack memory.
+   while (Serial_TxBusy());
+
+   ulErrorCode = Main_ANTReconfigure(&stANTEnable);
+   if (ulErrorCode == NRF_SUCCESS)
+      ucTxBurstQueueSize = pstRxMessage->ANT_MESSAGE_aucPayload[2];
+
+   // Queued events and burst data belong to the previous stack, the queues grow into what is left this time.
+   ram_arena_reset(stANTChannelEnable.usMemoryBlockByteSize);
+   event_buffering_reset();
+   Command_Init();
+
+   if (ulErrorCode != NRF_SUCCESS)
+      return (uint8_t)ulErrorCode;
+
+   System_GetANTMemoryConfigMesg(pstTxMessage); // report the new memory split
+   return RESPONSE_NO_ERROR;
+}
+
+/**
+ * @brief Constructs the ANT stack channel memory configuration message
+ */
+void System_GetANTMemoryConfigMesg(ANT_MESSAGE *pstTxMessage)
+{
+   uint16_t usHighSize;
+   uint16_t usLowSize;
+
+   event_buffering_queue_size_get(&usHighSize, &usLowSize);
+
+   pstTxMessage->ANT_MESSAGE_ucSize = MESG_ANT_MEMORY_CONFIG_SIZE;
+   pstTxMessage->ANT_MESSAGE_ucMesgID = (uint8_t)(MESG_ANT_MEMORY_CONFIG_ID >> 8);
+   pstTxMessage->ANT_MESSAGE_ucSubID = (uint8_t)(MESG_ANT_MEMORY_CONFIG_ID);
+   pstTxMessage->ANT_MESSAGE_aucPayload[0] = stANTChannelEnable.ucTotalNumberOfChannels;
+   pstTxMessage->ANT_MESSAGE_aucPayload[1] = stANTChannelEnable.ucNumberOfEncryptedChannels;
+   pstTxMessage->ANT_MESSAGE_aucPayload[2] = ucTxBurstQueueSize;
+   pstTxMessage->ANT_MESSAGE_aucPayload[3] = (uint8_t)stANTChannelEnable.usNumberOfEvents;
+   DSI_PutUShort(stANTChannelEnable.usMemoryBlockByteSize, &pstTxMessage->ANT_MESSAGE_aucPayload[4]);
+   DSI_PutUShort(usHighSize, &pstTxMessage->ANT_MESSAGE_aucPayload[6]);
+   DSI_PutUShort(usLowSize, &pstTxMessage->ANT_MESSAGE_aucPayload[8]);
+   DSI_PutUShort(ram_arena_get_free(), &pstTxMessage->ANT_MESSAGE_aucPayload[10]);
+}
+
 /**
  * @brief Starts the SD flash write call and sets up the Flash Busy flag
  */
@@ -360,6 +467,21 @@ uint32_t System_FlashWrite(uint32_t* ulAddress, uint32_t * pulData, uint8_t ucLe
    uint32_t ulErrCode = sd_flash_write(ulAddress , pulData, ucLength);
    if (ulErrCode == NRF_SUCCESS)
    {
+      bFlashFailed = false;
+      bFlashBusy = true;
+   }
+   return ulErrCode;
+}
+
+/**
+ * @brief Starts the SD flash page erase call and sets up the Flash Busy flag
+ */
+uint32_t System_FlashPageErase(uint32_t ulPageNumber)
+{
+   uint32_t ulErrCode = sd_flash_page_erase(ulPageNumber);
+   if (ulErrCode == NRF_SUCCESS)
+   {
+      bFlashFailed = false;
       bFlashBusy = true;
    }
    return ulErrCode;
@@ -372,10 +494,19 @@ void System_FlashEventProcess(uint32_t ulEvent)
 {
    if ((ulEvent == NRF_EVT_FLASH_OPERATION_SUCCESS) || (ulEvent == NRF_EVT_FLASH_OPERATION_ERROR))
    {
+      bFlashFailed = (ulEvent == NRF_EVT_FLASH_OPERATION_ERROR);
       bFlashBusy = false;
    }
 }
 
+/**
+ * @brief Reports whether the last flash operation failed
+ */
+bool System_FlashFailed(void)
+{
+   return bFlashFailed;
+}
+
 /**
  * @brief Reports whether flash write is in progress
  */
@@ -420,6 +551,11 @@ void System_TimerRelease(void)
    }
 }
 
+bool System_TimerRequested(void)
+{
+   return ulTimerRequests != 0;
+}
+
 uint32_t System_GetTime_32K(void)
 {
    uint32_t result = SYS_TIME_RTC->COUNTER;
@@ -439,3 +575,39 @@ uint32_t System_GetTime_32K(void)
 
    return result;
 }
+
+bool System_TimerAlarmSet(uint32_t ulTime)
+{
+   uint32_t ulDelta = ulTime - System_GetTime_32K();
+
+   if ((ulDelta < SYS_TIME_RTC_ALARM_MIN_TICKS) || (ulDelta >= SYS_TIME_RTC_OVRFLW))
+   {
+      return false; // too close to be caught by the compare, or already passed
+   }
+
+   SYS_TIME_RTC->EVENTS_COMPARE[SYS_TIME_RTC_ALARM_CC] = 0;
+   // Make sure write takes effect before clearing the IRQ, a previous expiry left
+   // pending would keep waking the core up. An overflow pends it again.
+   (void)SYS_TIME_RTC->EVENTS_COMPARE[SYS_TIME_RTC_ALARM_CC];
+   sd_nvic_ClearPendingIRQ(SYS_TIME_RTC_IRQn);
+   SYS_TIME_RTC->CC[SYS_TIME_RTC_ALARM_CC] = ulTime & (SYS_TIME_RTC_OVRFLW - 1);
+   // Like the overflow, the compare only pends the (disabled) interrupt to wake us up.
+   SYS_TIME_RTC->INTENSET = RTC_INTENSET_COMPARE0_Msk << SYS_TIME_RTC_ALARM_CC;
+
+   return true;
+}
+
+void System_TimerAlarmClear(void)
+{
+   SYS_TIME_RTC->INTENCLR = RTC_INTENCLR_COMPARE0_Msk << SYS_TIME_RTC_ALARM_CC;
+   SYS_TIME_RTC->EVENTS_COMPARE[SYS_TIME_RTC_ALARM_CC] = 0;
+   // Make sure write takes effect before clearing the IRQ.
+   (void)SYS_TIME_RTC->EVENTS_COMPARE[SYS_TIME_RTC_ALARM_CC];
+   sd_nvic_ClearPendingIRQ(SYS_TIME_RTC_IRQn);
+}
+
+bool System_TimerAlarmExpired(void)
+{
+   return (SYS_TIME_RTC->INTENSET & (RTC_INTENSET_COMPARE0_Msk << SYS_TIME_RTC_ALARM_CC)) &&
+      SYS_TIME_RTC->EVENTS_COMPARE[SYS_TIME_RTC_ALARM_CC];
+}
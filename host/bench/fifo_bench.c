@@ -0,0 +1,136 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+/*
+ * Cost of the multi context fifo operations, built once with power of two
+ * offset masking and once with MC_FIFO_POW2_SIZE_DISABLE. Records are sized
+ * like buffered ANT events so they keep wrapping at different offsets.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "multi_ctx_fifo.h"
+#include "nrf_nvic.h"
+#include "host_np.h"
+
+#if !defined (FIFO_BENCH_VARIANT)
+   #define FIFO_BENCH_VARIANT             "default"
+#endif
+
+#define FIFO_BENCH_SIZE                   1024
+#define FIFO_BENCH_RECORD_SIZE            ((fifo_offset_t)22)
+#define FIFO_BENCH_BATCH                  8     // records in the fifo at a time
+#define FIFO_BENCH_OPS                    ((uint32_t)1000000)
+#define FIFO_BENCH_RUNS                   7     // best of
+
+// Interrupts are not involved here, the fifo runs on its own.
+uint32_t sd_nvic_critical_region_enter(uint8_t *p_is_nested_critical_region)
+{
+   *p_is_nested_critical_region = 0;
+   return 0;
+}
+
+uint32_t sd_nvic_critical_region_exit(uint8_t is_nested_critical_region)
+{
+   (void)is_nested_critical_region;
+   return 0;
+}
+
+static multi_ctx_fifo_t stFifo;
+
+static void fifo_fail(const char *pcWhat)
+{
+   fprintf(stderr, "fifo_bench: %s failed\n", pcWhat);
+   exit(EXIT_FAILURE);
+}
+
+static uint64_t push_pop_run(void)
+{
+   uint8_t aucRecord[FIFO_BENCH_RECORD_SIZE] = {0};
+   uint64_t ullCycles = host_np_cycles();
+
+   for (uint32_t i = 0; i < FIFO_BENCH_OPS; i += FIFO_BENCH_BATCH)
+   {
+      for (uint8_t j = 0; j < FIFO_BENCH_BATCH; j++)
+      {
+         aucRecord[0] = j;
+         if (!mc_fifo_push(&stFifo, aucRecord, sizeof(aucRecord)))
+            fifo_fail("push");
+      }
+
+      for (uint8_t j = 0; j < FIFO_BENCH_BATCH; j++)
+      {
+         if (!mc_fifo_pop(&stFifo, aucRecord, sizeof(aucRecord)))
+            fifo_fail("pop");
+      }
+   }
+
+   return host_np_cycles() - ullCycles;
+}
+
+static uint64_t claim_release_run(void)
+{
+   uint8_t aucRecord[FIFO_BENCH_RECORD_SIZE] = {0};
+   mc_fifo_span_t stSpan;
+   uint32_t ulSum = 0;
+   uint64_t ullCycles = host_np_cycles();
+
+   for (uint32_t i = 0; i < FIFO_BENCH_OPS; i += FIFO_BENCH_BATCH)
+   {
+      for (uint8_t j = 0; j < FIFO_BENCH_BATCH; j++)
+      {
+         aucRecord[0] = j;
+         if (!mc_fifo_push(&stFifo, aucRecord, sizeof(aucRecord)))
+            fifo_fail("push");
+      }
+
+      for (uint8_t j = 0; j < FIFO_BENCH_BATCH; j++)
+      {
+         if (!mc_fifo_claim(&stFifo, &stSpan, sizeof(aucRecord)))
+            fifo_fail("claim");
+         ulSum += stSpan.pucData[0][0];
+         mc_fifo_release(&stFifo, sizeof(aucRecord));
+      }
+   }
+
+   ullCycles = host_np_cycles() - ullCycles;
+   if (ulSum == UINT32_MAX)
+      printf("\n"); // keep the reads
+   return ullCycles;
+}
+
+static void bench_report(const char *pcName, uint64_t (*pfRun)(void))
+{
+   uint64_t ullBest = UINT64_MAX;
+
+   for (uint8_t i = 0; i < FIFO_BENCH_RUNS; i++)
+   {
+      uint64_t ullCycles = pfRun();
+
+      if (ullCycles < ullBest)
+         ullBest = ullCycles;
+   }
+
+   // A push and a pop, or a push and a claim/release, per record.
+   printf("fifo_%s_%s ops=%u cycles_per_op=%.2f\n",
+      FIFO_BENCH_VARIANT, pcName, FIFO_BENCH_OPS, (double)ullBest / FIFO_BENCH_OPS);
+}
+
+int main(void)
+{
+   mc_fifo_init(&stFifo, FIFO_BENCH_SIZE);
+
+   bench_report("push_pop", push_pop_run);
+   bench_report("claim_release", claim_release_run);
+
+   return EXIT_SUCCESS;
+}
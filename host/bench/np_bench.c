@@ -0,0 +1,623 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+/*
+ * Throughput benchmarks of the network processor built for the host. Synthetic
+ * ANT event streams and serial command streams go through the real main loop,
+ * event buffering and serial code. Every benchmark prints one line:
+ *
+ *    <name> key=value ...
+ *
+ * np_bench --compare BASELINE CURRENT TOLERANCE fails if any cost in CURRENT
+ * (cycles, bytes or queue occupancy) grew by more than TOLERANCE percent.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ant_parameters.h"
+#include "boardconfig.h"
+#include "command.h"
+#include "event_buffering.h"
+#include "serial.h"
+#include "host_np.h"
+
+#define BENCH_STREAM_EVENTS               ((uint32_t)20000)
+#define BENCH_COMMANDS                    ((uint32_t)20000)
+#define BENCH_DISPATCHES                  ((uint32_t)200000)
+#define BENCH_DISPATCH_RUNS               7  // best of
+
+#define BENCH_CHANNELS                    ((uint8_t)8)
+#define BENCH_TICKS_PER_STEP              ((uint32_t)33) // about 1 ms of the 32768 Hz clock
+#define BENCH_TICKS_PER_SECOND            ((uint32_t)32768)
+#define BENCH_BITS_PER_BYTE               ((uint32_t)10) // start, 8 data, stop
+#define BENCH_STEPS_MAX                   ((uint32_t)10000000)
+#define BENCH_STALLS_MAX                  ((uint32_t)100000)
+
+#define BENCH_LINE_SIZE                   512
+#define BENCH_NAME_SIZE                   64
+#define BENCH_KEY_SIZE                    32
+#define BENCH_FRAME_SIZE                  (MESG_SYNC_SIZE + MESG_BUFFER_SIZE)
+
+// Event buffering configuration, as sent in the configure event buffer command.
+#define BENCH_BUFFER_LOW_PRIORITY         ((uint8_t)0x00)
+#define BENCH_BUFFER_ALL                  ((uint8_t)0x01)
+#define BENCH_BUFFER_COALESCE_RX          ((uint8_t)0x80)
+
+typedef struct
+{
+   const char *pcName;
+   uint32_t ulEventsPerSecond;            // offered protocol event rate
+   uint32_t ulBaudrate;                   // serial line rate, 0 for the one configured by the processor
+   void (*pfSetup)(void);
+   void (*pfEventGet)(uint32_t ulIndex, uint8_t *pucChannel, uint8_t *pucEvent, uint8_t *pucMessage);
+} stream_bench_t;
+
+typedef struct
+{
+   const char *pcName;
+   uint8_t ucMesgID;
+   uint8_t ucSize;
+   uint8_t aucData[MESG_MAX_SIZE_VALUE];
+} command_bench_t;
+
+// Serial output of the processor, parsed into frames.
+static struct
+{
+   uint8_t ucState;
+   uint8_t ucSize;
+   uint8_t ucIndex;
+   uint8_t aucFrame[MESG_BUFFER_SIZE];
+   uint32_t ulFrames;
+   uint32_t ulBytes;
+   uint8_t ucLastResponseID;              // response event to the last command
+   uint8_t ucLastResponse;
+} stSink;
+
+static uint16_t usPeakHigh;
+static uint16_t usPeakLow;
+
+enum
+{
+   SINK_SYNC,
+   SINK_SIZE,
+   SINK_DATA,
+   SINK_CHECKSUM
+};
+
+static void bench_fail(const char *pcWhat)
+{
+   fprintf(stderr, "np_bench: %s\n", pcWhat);
+   exit(EXIT_FAILURE);
+}
+
+static void sink_byte(uint8_t ucByte, void *pvContext)
+{
+   (void)pvContext;
+   stSink.ulBytes++;
+
+   switch (stSink.ucState)
+   {
+      case SINK_SYNC:
+         if (ucByte == MESG_TX_SYNC)
+            stSink.ucState = SINK_SIZE;
+         break;
+
+      case SINK_SIZE:
+         stSink.ucSize = ucByte;
+         stSink.ucIndex = 0;
+         stSink.ucState = (ucByte <= MESG_MAX_SIZE_VALUE) ? SINK_DATA : SINK_SYNC;
+         break;
+
+      case SINK_DATA:
+         stSink.aucFrame[stSink.ucIndex++] = ucByte;
+         if (stSink.ucIndex == (uint8_t)(MESG_ID_SIZE + stSink.ucSize))
+            stSink.ucState = SINK_CHECKSUM;
+         break;
+
+      case SINK_CHECKSUM:
+         stSink.ulFrames++;
+         if ((stSink.aucFrame[0] == MESG_RESPONSE_EVENT_ID) && (stSink.ucSize == MESG_RESPONSE_EVENT_SIZE) &&
+             (stSink.aucFrame[2] != MESG_EVENT_ID))
+         {
+            stSink.ucLastResponseID = stSink.aucFrame[2];
+            stSink.ucLastResponse = stSink.aucFrame[3];
+         }
+         stSink.ucState = SINK_SYNC;
+         break;
+   }
+}
+
+static void sink_clear(void)
+{
+   stSink.ulFrames = 0;
+   stSink.ulBytes = 0;
+}
+
+static uint32_t frame_build(uint8_t *pucFrame, uint8_t ucMesgID, const uint8_t *pucData, uint8_t ucSize)
+{
+   uint8_t ucCheckSum = 0;
+   uint32_t ulLength = 0;
+
+   pucFrame[ulLength++] = MESG_TX_SYNC;
+   pucFrame[ulLength++] = ucSize;
+   pucFrame[ulLength++] = ucMesgID;
+   memcpy(&pucFrame[ulLength], pucData, ucSize);
+   ulLength += ucSize;
+
+   for (uint32_t i = 0; i < ulLength; i++)
+      ucCheckSum ^= pucFrame[i];
+   pucFrame[ulLength++] = ucCheckSum;
+
+   return ulLength;
+}
+
+static void levels_sample(void)
+{
+   uint16_t usHigh;
+   uint16_t usLow;
+
+   event_buffering_queue_level_get(&usHigh, &usLow);
+   if (usHigh > usPeakHigh)
+      usPeakHigh = usHigh;
+   if (usLow > usPeakLow)
+      usPeakLow = usLow;
+}
+
+// Feed bytes to the processor, letting it run whenever it holds off reception.
+static void serial_write(const uint8_t *pucData, uint32_t ulSize)
+{
+   uint32_t ulTaken = 0;
+   uint32_t ulStalls = 0;
+
+   while (ulTaken < ulSize)
+   {
+      uint32_t ulMoved = host_np_uart_rx_buffer(&pucData[ulTaken], ulSize - ulTaken);
+
+      ulTaken += ulMoved;
+      if (ulTaken == ulSize)
+         break;
+
+      host_np_run();
+      ulMoved += host_np_uart_tx_pump(HOST_NP_UART_TX_UNLIMITED);
+      ulStalls = ulMoved ? 0 : ulStalls + 1;
+      if (ulStalls > BENCH_STALLS_MAX)
+         bench_fail("processor stopped taking serial input");
+   }
+}
+
+static uint8_t command_send(uint8_t ucMesgID, const uint8_t *pucData, uint8_t ucSize)
+{
+   uint8_t aucFrame[BENCH_FRAME_SIZE];
+   uint32_t ulLength = frame_build(aucFrame, ucMesgID, pucData, ucSize);
+
+   stSink.ucLastResponseID = 0;
+   stSink.ucLastResponse = NO_RESPONSE_MESSAGE;
+   serial_write(aucFrame, ulLength);
+   host_np_settle();
+
+   return (stSink.ucLastResponseID == ucMesgID) ? stSink.ucLastResponse : NO_RESPONSE_MESSAGE;
+}
+
+static void channels_open(void)
+{
+   for (uint8_t i = 0; i < BENCH_CHANNELS; i++)
+   {
+      uint8_t aucAssign[] = {i, CHANNEL_TYPE_SLAVE, 0};
+      uint8_t aucOpen[] = {i};
+
+      if ((command_send(MESG_ASSIGN_CHANNEL_ID, aucAssign, sizeof(aucAssign)) != RESPONSE_NO_ERROR) ||
+          (command_send(MESG_OPEN_CHANNEL_ID, aucOpen, sizeof(aucOpen)) != RESPONSE_NO_ERROR))
+      {
+         bench_fail("could not open the channels");
+      }
+   }
+}
+
+/***************************************************************************
+ * Event streams
+ ***************************************************************************/
+static void setup_default(void)
+{
+   event_buffering_config_set(BENCH_BUFFER_LOW_PRIORITY, 0, 0);
+   event_buffering_burst_aggregation_set(false);
+   event_buffering_timestamp_set(false);
+}
+
+static void setup_buffered(void)
+{
+   setup_default();
+   event_buffering_config_set(BENCH_BUFFER_ALL, 256, 10); // 100 ms
+}
+
+static void setup_coalesce(void)
+{
+   setup_default();
+   event_buffering_config_set(BENCH_BUFFER_LOW_PRIORITY | BENCH_BUFFER_COALESCE_RX, 0, 0);
+}
+
+static void setup_burst_aggregation(void)
+{
+   setup_default();
+   event_buffering_burst_aggregation_set(true);
+}
+
+static void setup_timestamp(void)
+{
+   setup_default();
+   event_buffering_timestamp_set(true);
+}
+
+static void event_broadcast_get(uint32_t ulIndex, uint8_t *pucChannel, uint8_t *pucEvent, uint8_t *pucMessage)
+{
+   *pucChannel = (uint8_t)(ulIndex % BENCH_CHANNELS);
+   *pucEvent = EVENT_RX;
+   pucMessage[0] = MESG_CHANNEL_NUM_SIZE + ANT_STANDARD_DATA_PAYLOAD_SIZE;
+   pucMessage[1] = MESG_BROADCAST_DATA_ID;
+   pucMessage[2] = *pucChannel;
+   for (uint8_t i = 0; i < ANT_STANDARD_DATA_PAYLOAD_SIZE; i++)
+      pucMessage[3 + i] = (uint8_t)(ulIndex + i);
+}
+
+static void event_broadcast_ext_get(uint32_t ulIndex, uint8_t *pucChannel, uint8_t *pucEvent, uint8_t *pucMessage)
+{
+   uint8_t *pucFlags = &pucMessage[3 + ANT_STANDARD_DATA_PAYLOAD_SIZE];
+
+   event_broadcast_get(ulIndex, pucChannel, pucEvent, pucMessage);
+   pucMessage[0] += MESG_EXT_MESG_BF_SIZE + ANT_EXT_MESG_DEVICE_ID_FIELD_SIZE;
+   pucFlags[0] = ANT_EXT_MESG_BITFIELD_DEVICE_ID;
+   pucFlags[1] = (uint8_t)(0x10 + *pucChannel); // device number
+   pucFlags[2] = 0x00;
+   pucFlags[3] = 0x78;                         // device type
+   pucFlags[4] = 0x01;                         // transmission type
+}
+
+static void event_mixed_get(uint32_t ulIndex, uint8_t *pucChannel, uint8_t *pucEvent, uint8_t *pucMessage)
+{
+   // Broadcasts with the odd transmit and failure event, as a mix of master and slave channels would give.
+   if ((ulIndex % 4) != 3)
+   {
+      event_broadcast_get(ulIndex, pucChannel, pucEvent, pucMessage);
+      return;
+   }
+
+   *pucChannel = (uint8_t)(ulIndex % BENCH_CHANNELS);
+   *pucEvent = ((ulIndex % 8) == 3) ? EVENT_TX : EVENT_RX_FAIL;
+   pucMessage[0] = MESG_RESPONSE_EVENT_SIZE;
+   pucMessage[1] = MESG_RESPONSE_EVENT_ID;
+   pucMessage[2] = *pucChannel;
+   pucMessage[3] = MESG_EVENT_ID;
+   pucMessage[4] = *pucEvent;
+}
+
+static void event_burst_get(uint32_t ulIndex, uint8_t *pucChannel, uint8_t *pucEvent, uint8_t *pucMessage)
+{
+   // Bursts of 32 packets on channel 0.
+   uint32_t ulPacket = ulIndex % 32;
+   uint8_t ucSequence;
+
+   if (ulPacket == 0)
+      ucSequence = SEQUENCE_FIRST_MESSAGE;
+   else
+      ucSequence = (uint8_t)((((ulPacket - 1) % 3) + 1) * SEQUENCE_NUMBER_INC);
+   if (ulPacket == 31)
+      ucSequence |= SEQUENCE_LAST_MESSAGE;
+
+   event_broadcast_get(ulIndex, pucChannel, pucEvent, pucMessage);
+   *pucChannel = 0;
+   pucMessage[1] = MESG_BURST_DATA_ID;
+   pucMessage[2] = ucSequence;
+}
+
+static const stream_bench_t astStreamBench[] =
+{
+   {"rx_broadcast",           500, 0,     setup_default,           event_broadcast_get},
+   {"rx_broadcast_ext",       500, 0,     setup_default,           event_broadcast_ext_get},
+   {"rx_mixed",               800, 0,     setup_default,           event_mixed_get},
+   {"rx_timestamp",           500, 0,     setup_timestamp,         event_broadcast_get},
+   {"rx_buffered_all",        500, 0,     setup_buffered,          event_broadcast_get},
+   {"rx_coalesce_slow_line", 2000, 19200, setup_coalesce,          event_broadcast_get},
+   {"rx_burst",               600, 0,     setup_default,           event_burst_get},
+   {"rx_burst_aggregated",   1100, 0,     setup_burst_aggregation, event_burst_get},
+};
+
+// Serial output allowed for the step, keeping the remainder for the next one.
+static uint32_t line_budget(uint32_t ulBaudrate, uint32_t *pulRemainder)
+{
+   uint32_t ulBits = ulBaudrate * BENCH_TICKS_PER_STEP + *pulRemainder;
+   uint32_t ulPerByte = BENCH_BITS_PER_BYTE * BENCH_TICKS_PER_SECOND;
+
+   *pulRemainder = ulBits % ulPerByte;
+   return ulBits / ulPerByte;
+}
+
+static void line_drain(uint32_t ulBudget)
+{
+   uint32_t ulMoved;
+
+   do
+   {
+      ulMoved = host_np_uart_tx_pump(ulBudget);
+      ulBudget -= ulMoved;
+      host_np_run();
+   } while (ulMoved && ulBudget);
+}
+
+static void stream_bench_run(const stream_bench_t *pstBench)
+{
+   uint8_t aucMessage[MESG_BUFFER_SIZE];
+   uint8_t ucChannel = 0;
+   uint8_t ucEvent = 0;
+   uint32_t ulPushed = 0;
+   uint32_t ulOffered = 0;
+   uint32_t ulRateRemainder = 0;
+   uint32_t ulLineRemainder = 0;
+   uint32_t ulSteps = 0;
+   bool bPending = false;
+   uint64_t ullCycles;
+   uint64_t ullTime;
+   host_np_stats_t stStats;
+
+   pstBench->pfSetup();
+   host_np_settle();
+   host_np_stats_clear();
+   sink_clear();
+   usPeakHigh = 0;
+   usPeakLow = 0;
+
+   ullTime = host_np_nanoseconds();
+   ullCycles = host_np_cycles();
+
+   for (;;)
+   {
+      uint32_t ulBaudrate = pstBench->ulBaudrate ? pstBench->ulBaudrate : host_np_uart_baudrate();
+      uint32_t ulRate = pstBench->ulEventsPerSecond * BENCH_TICKS_PER_STEP + ulRateRemainder;
+      uint16_t usHigh;
+      uint16_t usLow;
+
+      ulRateRemainder = ulRate % BENCH_TICKS_PER_SECOND;
+      ulOffered += ulRate / BENCH_TICKS_PER_SECOND;
+      if (ulOffered > BENCH_STREAM_EVENTS)
+         ulOffered = BENCH_STREAM_EVENTS;
+
+      // Events the stack could not queue are offered again on the next step.
+      while (ulPushed < ulOffered)
+      {
+         if (!bPending)
+            pstBench->pfEventGet(ulPushed, &ucChannel, &ucEvent, aucMessage);
+         bPending = !host_np_ant_event_push(ucChannel, ucEvent, aucMessage);
+         if (bPending)
+            break;
+
+         ulPushed++;
+         levels_sample();
+      }
+
+      host_np_time_advance(BENCH_TICKS_PER_STEP);
+      host_np_run();
+      levels_sample();
+      line_drain(line_budget(ulBaudrate, &ulLineRemainder));
+
+      if (++ulSteps > BENCH_STEPS_MAX)
+         bench_fail("event stream did not drain");
+
+      host_np_stats_get(&stStats);
+      event_buffering_queue_level_get(&usHigh, &usLow);
+      if ((ulPushed == BENCH_STREAM_EVENTS) && !stStats.usEventsPending && !usHigh && !usLow &&
+          !Serial_TxBusy())
+      {
+         break;
+      }
+   }
+
+   ullCycles = host_np_cycles() - ullCycles;
+   ullTime = host_np_nanoseconds() - ullTime;
+   host_np_stats_get(&stStats);
+
+   printf("%s msgs=%u frames=%u msgs_per_s=%.0f cycles_per_msg=%.0f bytes_per_msg=%.2f "
+          "peak_high=%u peak_low=%u peak_sd=%u sd_full=%u\n",
+      pstBench->pcName, BENCH_STREAM_EVENTS, stSink.ulFrames,
+      (double)BENCH_STREAM_EVENTS * 1e9 / (double)(ullTime ? ullTime : 1),
+      (double)ullCycles / BENCH_STREAM_EVENTS,
+      (double)stSink.ulBytes / BENCH_STREAM_EVENTS,
+      usPeakHigh, usPeakLow, stStats.usEventsPendingPeak, stStats.ulEventsDropped);
+}
+
+/***************************************************************************
+ * Command streams
+ ***************************************************************************/
+static const command_bench_t astCommandBench[] =
+{
+   {"cmd_broadcast",    MESG_BROADCAST_DATA_ID,    9, {0, 1, 2, 3, 4, 5, 6, 7, 8}},
+   {"cmd_acknowledged", MESG_ACKNOWLEDGED_DATA_ID, 9, {1, 1, 2, 3, 4, 5, 6, 7, 8}},
+   {"cmd_request",      MESG_REQUEST_ID,           2, {2, MESG_CHANNEL_STATUS_ID}},
+};
+
+static void command_bench_run(const command_bench_t *pstBench)
+{
+   uint8_t aucFrame[BENCH_FRAME_SIZE];
+   uint32_t ulLength = frame_build(aucFrame, pstBench->ucMesgID, pstBench->aucData, pstBench->ucSize);
+   uint64_t ullCycles;
+   uint64_t ullTime;
+
+   setup_default();
+   host_np_settle();
+   sink_clear();
+
+   ullTime = host_np_nanoseconds();
+   ullCycles = host_np_cycles();
+
+   for (uint32_t i = 0; i < BENCH_COMMANDS; i++)
+      serial_write(aucFrame, ulLength);
+   host_np_settle();
+
+   ullCycles = host_np_cycles() - ullCycles;
+   ullTime = host_np_nanoseconds() - ullTime;
+
+   printf("%s msgs=%u frames=%u msgs_per_s=%.0f cycles_per_msg=%.0f bytes_per_msg=%.2f\n",
+      pstBench->pcName, BENCH_COMMANDS, stSink.ulFrames,
+      (double)BENCH_COMMANDS * 1e9 / (double)(ullTime ? ullTime : 1),
+      (double)ullCycles / BENCH_COMMANDS,
+      (double)stSink.ulBytes / BENCH_COMMANDS);
+}
+
+// Command table dispatch alone, without the serial path.
+static void dispatch_bench_run(const command_bench_t *pstBench)
+{
+   ANT_MESSAGE stRxMessage;
+   ANT_MESSAGE stTxMessage;
+   uint64_t ullBest = UINT64_MAX;
+
+   memset(&stRxMessage, 0, sizeof(stRxMessage));
+   stRxMessage.ANT_MESSAGE_ucSize = pstBench->ucSize;
+   stRxMessage.ANT_MESSAGE_ucMesgID = pstBench->ucMesgID;
+   memcpy(stRxMessage.ANT_MESSAGE_aucMesgData, pstBench->aucData, pstBench->ucSize);
+
+   for (uint8_t ucRun = 0; ucRun < BENCH_DISPATCH_RUNS; ucRun++)
+   {
+      uint64_t ullCycles = host_np_cycles();
+
+      for (uint32_t i = 0; i < BENCH_DISPATCHES; i++)
+         Command_SerialMessageProcess(&stRxMessage, &stTxMessage);
+
+      ullCycles = host_np_cycles() - ullCycles;
+      if (ullCycles < ullBest)
+         ullBest = ullCycles;
+   }
+
+   printf("dispatch_%s msgs=%u cycles_per_msg=%.1f\n",
+      &pstBench->pcName[sizeof("cmd_") - 1], BENCH_DISPATCHES, (double)ullBest / BENCH_DISPATCHES);
+}
+
+/***************************************************************************
+ * Regression check
+ ***************************************************************************/
+// Results where a larger value is a regression.
+static const char *const apcCosts[] =
+{
+   "cycles_per_msg", "cycles_per_op", "bytes_per_msg", "peak_high", "peak_low", "peak_sd"
+};
+
+static bool cost_key(const char *pcKey)
+{
+   for (size_t i = 0; i < sizeof(apcCosts) / sizeof(apcCosts[0]); i++)
+   {
+      if (strcmp(pcKey, apcCosts[i]) == 0)
+         return true;
+   }
+   return false;
+}
+
+static bool result_find(FILE *pstFile, const char *pcName, const char *pcKey, double *pdValue)
+{
+   char acLine[BENCH_LINE_SIZE];
+   char acName[BENCH_NAME_SIZE];
+
+   rewind(pstFile);
+   while (fgets(acLine, sizeof(acLine), pstFile) != NULL)
+   {
+      char acPattern[BENCH_KEY_SIZE + 2];
+      const char *pcValue;
+
+      if ((sscanf(acLine, "%63s", acName) != 1) || (strcmp(acName, pcName) != 0))
+         continue;
+
+      snprintf(acPattern, sizeof(acPattern), " %s=", pcKey);
+      pcValue = strstr(acLine, acPattern);
+      if (pcValue == NULL)
+         return false;
+
+      *pdValue = strtod(pcValue + strlen(acPattern), NULL);
+      return true;
+   }
+   return false;
+}
+
+static int results_compare(const char *pcBaseline, const char *pcCurrent, double dTolerance)
+{
+   FILE *pstBaseline = fopen(pcBaseline, "r");
+   FILE *pstCurrent = fopen(pcCurrent, "r");
+   char acLine[BENCH_LINE_SIZE];
+   int iRegressions = 0;
+
+   if ((pstBaseline == NULL) || (pstCurrent == NULL))
+   {
+      fprintf(stderr, "np_bench: cannot open %s\n", (pstBaseline == NULL) ? pcBaseline : pcCurrent);
+      return EXIT_FAILURE;
+   }
+
+   while (fgets(acLine, sizeof(acLine), pstCurrent) != NULL)
+   {
+      char acName[BENCH_NAME_SIZE];
+      char *pcField;
+
+      if (sscanf(acLine, "%63s", acName) != 1)
+         continue;
+
+      for (pcField = strchr(acLine, ' '); pcField != NULL; pcField = strchr(pcField + 1, ' '))
+      {
+         char acKey[BENCH_KEY_SIZE];
+         double dCurrent;
+         double dBaseline;
+
+         if ((sscanf(pcField, " %31[^=]=%lf", acKey, &dCurrent) != 2) || !cost_key(acKey))
+            continue;
+         if (!result_find(pstBaseline, acName, acKey, &dBaseline))
+            continue; // new benchmark
+
+         if (dCurrent > dBaseline * (1.0 + dTolerance / 100.0))
+         {
+            printf("REGRESSION %s %s: %.2f -> %.2f\n", acName, acKey, dBaseline, dCurrent);
+            iRegressions++;
+         }
+      }
+   }
+
+   fclose(pstBaseline);
+   fclose(pstCurrent);
+
+   if (iRegressions)
+      return EXIT_FAILURE;
+
+   printf("no regression beyond %.0f%%\n", dTolerance);
+   return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+   if ((argc == 5) && (strcmp(argv[1], "--compare") == 0))
+      return results_compare(argv[2], argv[3], strtod(argv[4], NULL));
+
+   if (argc != 1)
+   {
+      fprintf(stderr, "usage: %s [--compare BASELINE CURRENT TOLERANCE_PERCENT]\n", argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   host_np_init();
+   host_np_gpio_in_set(1UL << SERIAL_ASYNC_BR3); // 115200 baud
+   host_np_uart_sink_set(sink_byte, NULL);
+   host_np_boot();
+   host_np_settle();
+   channels_open();
+
+   for (size_t i = 0; i < sizeof(astStreamBench) / sizeof(astStreamBench[0]); i++)
+      stream_bench_run(&astStreamBench[i]);
+
+   for (size_t i = 0; i < sizeof(astCommandBench) / sizeof(astCommandBench[0]); i++)
+      command_bench_run(&astCommandBench[i]);
+
+   for (size_t i = 0; i < sizeof(astCommandBench) / sizeof(astCommandBench[0]); i++)
+      dispatch_bench_run(&astCommandBench[i]);
+
+   return EXIT_SUCCESS;
+}
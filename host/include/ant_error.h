@@ -0,0 +1,34 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+/*
+ * Host stand-in for the ANT SoftDevice error codes. The low byte of an ANT error
+ * is the response code reported to the host.
+ */
+
+#ifndef _ANT_ERROR_H_
+#define _ANT_ERROR_H_
+
+#include "ant_parameters.h"
+
+#define NRF_ANT_ERROR_OFFSET                 (0x4000)
+
+#define NRF_ANT_ERROR_CHANNEL_IN_WRONG_STATE (NRF_ANT_ERROR_OFFSET + CHANNEL_IN_WRONG_STATE)
+#define NRF_ANT_ERROR_CHANNEL_NOT_OPENED     (NRF_ANT_ERROR_OFFSET + CHANNEL_NOT_OPENED)
+#define NRF_ANT_ERROR_CHANNEL_ID_NOT_SET     (NRF_ANT_ERROR_OFFSET + CHANNEL_ID_NOT_SET)
+#define NRF_ANT_ERROR_TRANSFER_IN_PROGRESS   (NRF_ANT_ERROR_OFFSET + TRANSFER_IN_PROGRESS)
+#define NRF_ANT_ERROR_TRANSFER_SEQUENCE_NUMBER_ERROR (NRF_ANT_ERROR_OFFSET + TRANSFER_SEQUENCE_NUMBER_ERROR)
+#define NRF_ANT_ERROR_TRANSFER_IN_ERROR      (NRF_ANT_ERROR_OFFSET + TRANSFER_IN_ERROR)
+#define NRF_ANT_ERROR_TRANSFER_BUSY          (NRF_ANT_ERROR_OFFSET + TRANSFER_BUSY)
+#define NRF_ANT_ERROR_MESSAGE_SIZE_EXCEEDS_LIMIT (NRF_ANT_ERROR_OFFSET + MESSAGE_SIZE_EXCEEDS_LIMIT)
+#define NRF_ANT_ERROR_INVALID_MESSAGE        (NRF_ANT_ERROR_OFFSET + INVALID_MESSAGE)
+#define NRF_ANT_ERROR_INVALID_NETWORK_NUMBER (NRF_ANT_ERROR_OFFSET + INVALID_NETWORK_NUMBER)
+#define NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED (NRF_ANT_ERROR_OFFSET + INVALID_PARAMETER_PROVIDED)
+
+#endif // _ANT_ERROR_H_
@@ -0,0 +1,81 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+/*
+ * Host stand-in for the ANT SoftDevice API, see host/src/softdevice.c.
+ */
+
+#ifndef _ANT_INTERFACE_H_
+#define _ANT_INTERFACE_H_
+
+#include <stdint.h>
+#include "ant_parameters.h"
+#include "ant_error.h"
+
+uint32_t sd_ant_enable(ANT_ENABLE *const pstANTEnableParameters);
+uint32_t sd_ant_stack_reset(void);
+uint32_t sd_ant_event_get(uint8_t *pucChannel, uint8_t *pucEvent, uint8_t *aucANTMesg);
+uint32_t sd_ant_capabilities_get(uint8_t *pucCapabilities);
+uint32_t sd_ant_version_get(uint8_t *aucVersion);
+
+uint32_t sd_ant_channel_assign(uint8_t ucChannel, uint8_t ucChannelType, uint8_t ucNetwork, uint8_t ucExtAssign);
+uint32_t sd_ant_channel_unassign(uint8_t ucChannel);
+uint32_t sd_ant_channel_open(uint8_t ucChannel);
+uint32_t sd_ant_channel_open_with_offset(uint8_t ucChannel, uint16_t usOffset);
+uint32_t sd_ant_channel_close(uint8_t ucChannel);
+uint32_t sd_ant_channel_status_get(uint8_t ucChannel, uint8_t *pucStatus);
+uint32_t sd_ant_channel_id_set(uint8_t ucChannel, uint16_t usDeviceNumber, uint8_t ucDeviceType, uint8_t ucTransmitType);
+uint32_t sd_ant_channel_id_get(uint8_t ucChannel, uint16_t *pusDeviceNumber, uint8_t *pucDeviceType, uint8_t *pucTransmitType);
+uint32_t sd_ant_channel_period_set(uint8_t ucChannel, uint16_t usPeriod);
+uint32_t sd_ant_channel_radio_freq_set(uint8_t ucChannel, uint8_t ucFreq);
+uint32_t sd_ant_channel_radio_tx_power_set(uint8_t ucChannel, uint8_t ucTxPower, uint8_t ucCustomTxPower);
+uint32_t sd_ant_channel_rx_search_timeout_set(uint8_t ucChannel, uint8_t ucTimeout);
+uint32_t sd_ant_channel_low_priority_rx_search_timeout_set(uint8_t ucChannel, uint8_t ucTimeout);
+uint32_t sd_ant_channel_radio_crc_mode_set(uint8_t ucChannel, uint8_t ucMode);
+uint32_t sd_ant_channel_radio_crc_mode_get(uint8_t ucChannel, uint8_t *pucMode);
+uint32_t sd_ant_network_address_set(uint8_t ucNetwork, uint8_t *pucNetworkAddress);
+uint32_t sd_ant_search_waveform_set(uint8_t ucChannel, uint16_t usWaveform);
+uint32_t sd_ant_search_channel_priority_set(uint8_t ucChannel, uint8_t ucPriority);
+uint32_t sd_ant_prox_search_set(uint8_t ucChannel, uint8_t ucProxThreshold, uint8_t ucCustomProxThreshold);
+uint32_t sd_ant_auto_freq_hop_table_set(uint8_t ucChannel, uint8_t ucFreq0, uint8_t ucFreq1, uint8_t ucFreq2);
+uint32_t sd_ant_id_list_add(uint8_t ucChannel, uint8_t *pucDevice, uint8_t ucListIndex);
+uint32_t sd_ant_id_list_config(uint8_t ucChannel, uint8_t ucIDListSize, uint8_t ucIncExcFlag);
+uint32_t sd_ant_rx_scan_mode_start(uint8_t ucSyncChannelPacketsOnly);
+uint32_t sd_ant_lib_config_set(uint8_t ucANTLibConfig);
+uint32_t sd_ant_lib_config_clear(uint8_t ucANTLibConfigMask);
+
+uint32_t sd_ant_broadcast_message_tx(uint8_t ucChannel, uint8_t ucSize, uint8_t *aucMesg);
+uint32_t sd_ant_acknowledge_message_tx(uint8_t ucChannel, uint8_t ucSize, uint8_t *aucMesg);
+uint32_t sd_ant_burst_handler_request(uint8_t ucChannel, uint16_t usSize, uint8_t *aucData, uint8_t ucBurstSegment);
+
+uint32_t sd_ant_adv_burst_config_set(uint8_t *aucConfig, uint8_t ucSize);
+uint32_t sd_ant_adv_burst_config_get(uint8_t ucRequestType, uint8_t *aucConfig);
+uint32_t sd_ant_coex_config_set(uint8_t ucChannel, ANT_BUFFER_PTR *pstCoexConfig, ANT_BUFFER_PTR *pstAdvCoexConfig);
+uint32_t sd_ant_coex_config_get(uint8_t ucChannel, ANT_BUFFER_PTR *pstCoexConfig, ANT_BUFFER_PTR *pstAdvCoexConfig);
+uint32_t sd_ant_high_duty_search_config_set(ANT_HIGH_DUTY_SEARCH_CONFIG *pstHighDutyConfig);
+uint32_t sd_ant_high_duty_search_config_get(ANT_HIGH_DUTY_SEARCH_CONFIG *pstHighDutyConfig);
+uint32_t sd_ant_active_search_sharing_cycles_set(uint8_t ucChannel, uint8_t ucCycles);
+uint32_t sd_ant_active_search_sharing_cycles_get(uint8_t ucChannel, uint8_t *pucCycles);
+uint32_t sd_ant_event_filtering_set(uint16_t usFilter);
+uint32_t sd_ant_event_filtering_get(uint16_t *pusFilter);
+uint32_t sd_ant_sdu_mask_set(uint8_t ucMaskNumber, uint8_t *pucMask);
+uint32_t sd_ant_sdu_mask_get(uint8_t ucMaskNumber, uint8_t *pucMask);
+uint32_t sd_ant_sdu_mask_config(uint8_t ucChannel, uint8_t ucMaskConfig);
+uint32_t sd_ant_crypto_channel_enable(uint8_t ucChannel, uint8_t ucEnable, uint8_t ucKeyNum, uint8_t ucDecimationRate);
+uint32_t sd_ant_crypto_key_set(uint8_t ucKeyNum, uint8_t *pucKey);
+uint32_t sd_ant_crypto_info_set(uint8_t ucType, uint8_t *pucInfo);
+uint32_t sd_ant_crypto_info_get(uint8_t ucType, uint8_t *pucInfo);
+uint32_t sd_ant_rfactive_notification_config_set(uint8_t ucMode, uint16_t usTimeThreshold);
+uint32_t sd_ant_rfactive_notification_config_get(uint8_t *pucMode, uint16_t *pusTimeThreshold);
+uint32_t sd_ant_config_pa_lna_set(ANT_PA_LNA_CONFIG *pstPALNAConfig);
+uint32_t sd_ant_config_pa_lna_get(ANT_PA_LNA_CONFIG *pstPALNAConfig);
+uint32_t sd_ant_cw_test_mode_init(void);
+uint32_t sd_ant_cw_test_mode(uint8_t ucRadioFreq, uint8_t ucTxPower, uint8_t ucCustomTxPower, uint8_t ucMode);
+
+#endif // _ANT_INTERFACE_H_
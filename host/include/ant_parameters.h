@@ -0,0 +1,361 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+/*
+ * Host stand-in for the ANT SoftDevice parameter header. Values follow the ANT
+ * message protocol, the few SoftDevice specific message IDs that are not part of
+ * it only need to be unique on the host.
+ */
+
+#ifndef _ANT_PARAMETERS_H_
+#define _ANT_PARAMETERS_H_
+
+#include <stdint.h>
+
+/***************************************************************************
+ * Message framing
+ ***************************************************************************/
+#define MESG_TX_SYNC                         ((uint8_t)0xA4)
+#define MESG_RX_SYNC                         ((uint8_t)0xA5)
+#define MESG_SYNC_SIZE                       ((uint8_t)1)
+#define MESG_SIZE_SIZE                       ((uint8_t)1)
+#define MESG_ID_SIZE                         ((uint8_t)1)
+#define MESG_CHANNEL_NUM_SIZE                ((uint8_t)1)
+#define MESG_EXT_MESG_BF_SIZE                ((uint8_t)1)
+#define MESG_CHECKSUM_SIZE                   ((uint8_t)1)
+#define MESG_DATA_SIZE                       ((uint8_t)9)
+
+#define ANT_STANDARD_DATA_PAYLOAD_SIZE       ((uint8_t)8)
+#define ANT_EXT_MESG_DEVICE_ID_FIELD_SIZE    ((uint8_t)4)
+#define ANT_ID_SIZE                          ((uint8_t)4)
+
+#define MESG_MAX_SIZE_VALUE                  ((uint8_t)41)
+#define MESG_MAX_DATA_SIZE                   ((uint8_t)40)
+#define MESG_BUFFER_SIZE                     ((uint8_t)(MESG_SIZE_SIZE + MESG_ID_SIZE + MESG_MAX_SIZE_VALUE + MESG_CHECKSUM_SIZE))
+#define MESG_ANT_MAX_PAYLOAD_SIZE            ANT_STANDARD_DATA_PAYLOAD_SIZE
+
+#define CHANNEL_NUMBER_MASK                  ((uint8_t)0x1F)
+#define SEQUENCE_NUMBER_MASK                 ((uint8_t)0xE0)
+#define SEQUENCE_NUMBER_ROLLOVER             ((uint8_t)0x60)
+#define SEQUENCE_FIRST_MESSAGE               ((uint8_t)0x00)
+#define SEQUENCE_LAST_MESSAGE                ((uint8_t)0x80)
+#define SEQUENCE_NUMBER_INC                  ((uint8_t)0x20)
+#define MSG_EXT_ID_MASK                      ((uint8_t)0xE0)
+
+typedef union
+{
+   uint32_t ulForceAlign;
+   uint8_t aucMessage[MESG_BUFFER_SIZE];
+   struct
+   {
+      uint8_t ucSize;
+      union
+      {
+         uint8_t aucFramedData[MESG_ID_SIZE + MESG_MAX_SIZE_VALUE];
+         struct
+         {
+            uint8_t ucMesgID;
+            union
+            {
+               uint8_t aucMesgData[MESG_MAX_SIZE_VALUE];
+               struct
+               {
+                  union
+                  {
+                     uint8_t ucChannel;
+                     uint8_t ucSubID;
+                  } uFramedByte;
+                  uint8_t aucPayload[MESG_MAX_SIZE_VALUE - MESG_CHANNEL_NUM_SIZE];
+               } stMesgData;
+            } uMesgData;
+         } stFramedData;
+      } uFramedData;
+      uint8_t ucCheckSum;
+   } stMessage;
+} ANT_MESSAGE;
+
+#define ANT_MESSAGE_ucSize                   stMessage.ucSize
+#define ANT_MESSAGE_aucFramedData            stMessage.uFramedData.aucFramedData
+#define ANT_MESSAGE_ucMesgID                 stMessage.uFramedData.stFramedData.ucMesgID
+#define ANT_MESSAGE_aucMesgData              stMessage.uFramedData.stFramedData.uMesgData.aucMesgData
+#define ANT_MESSAGE_ucChannel                stMessage.uFramedData.stFramedData.uMesgData.stMesgData.uFramedByte.ucChannel
+#define ANT_MESSAGE_ucSubID                  stMessage.uFramedData.stFramedData.uMesgData.stMesgData.uFramedByte.ucSubID
+#define ANT_MESSAGE_aucPayload               stMessage.uFramedData.stFramedData.uMesgData.stMesgData.aucPayload
+#define ANT_MESSAGE_ucCheckSum               stMessage.ucCheckSum
+
+/***************************************************************************
+ * Stack configuration
+ ***************************************************************************/
+typedef struct
+{
+   uint8_t ucTotalNumberOfChannels;
+   uint8_t ucNumberOfEncryptedChannels;
+   uint16_t usNumberOfEvents;
+   uint8_t *pucMemoryBlockStartLocation;
+   uint16_t usMemoryBlockByteSize;
+} ANT_ENABLE;
+
+#define SIZE_OF_NONENCRYPTED_ANT_CHANNEL     ((uint16_t)80)
+#define SIZE_OF_ENCRYPTED_ANT_CHANNEL        ((uint16_t)124)
+#define SIZE_OF_ANT_EVENT                    ((uint16_t)32)
+#define SIZE_OF_BURST_QUEUE_OVERHEAD         ((uint16_t)16)
+
+#define ANT_ENABLE_GET_REQUIRED_SPACE(num_total_channels, num_encrypted_channels, burst_tx_size, events_queue_size) \
+   (((num_total_channels) * SIZE_OF_NONENCRYPTED_ANT_CHANNEL) +                                                  \
+    ((num_encrypted_channels) * (SIZE_OF_ENCRYPTED_ANT_CHANNEL - SIZE_OF_NONENCRYPTED_ANT_CHANNEL)) +            \
+    ((burst_tx_size) + SIZE_OF_BURST_QUEUE_OVERHEAD) +                                                          \
+    ((events_queue_size) * SIZE_OF_ANT_EVENT))
+
+typedef struct
+{
+   uint8_t *pucBuffer;
+   uint8_t ucBufferSize;
+} ANT_BUFFER_PTR;
+
+typedef struct
+{
+   uint8_t bEnable;
+   uint8_t ucSearchSuppressionWindows;
+   uint16_t usRestartInterval;
+} ANT_HIGH_DUTY_SEARCH_CONFIG;
+
+typedef struct
+{
+   uint8_t bEnabled;
+   uint8_t bActiveState;
+   uint8_t ucGPIO;
+} ANT_PA_LNA_PIN;
+
+typedef struct
+{
+   ANT_PA_LNA_PIN PA_CONFIG;
+   ANT_PA_LNA_PIN LNA_CONFIG;
+   uint8_t ucGPIOTECh;
+   uint8_t ucPPIChEnable;
+   uint8_t ucPPIChDisable;
+} ANT_PA_LNA_CONFIG;
+
+typedef enum
+{
+   BAUD1200 = 0,
+   BAUD2400,
+   BAUD4800,
+   BAUD9600,
+   BAUD19200,
+   BAUD38400,
+   BAUD50000,
+   BAUD57600,
+   BAUD115200,
+   BAUD230400,
+   BAUD460800,
+   BAUD921600
+} BAUDRATE_TYPE;
+
+/***************************************************************************
+ * Channel and library configuration
+ ***************************************************************************/
+#define CHANNEL_TYPE_SLAVE                   ((uint8_t)0x00)
+#define CHANNEL_TYPE_MASTER                  ((uint8_t)0x10)
+#define CHANNEL_TYPE_SHARED_SLAVE            ((uint8_t)0x20)
+#define CHANNEL_TYPE_SHARED_MASTER           ((uint8_t)0x30)
+#define CHANNEL_TYPE_SLAVE_RX_ONLY           ((uint8_t)0x40)
+#define CHANNEL_TYPE_MASTER_TX_ONLY          ((uint8_t)0x50)
+
+#define STATUS_UNASSIGNED_CHANNEL            ((uint8_t)0x00)
+#define STATUS_ASSIGNED_CHANNEL              ((uint8_t)0x01)
+#define STATUS_SEARCHING_CHANNEL             ((uint8_t)0x02)
+#define STATUS_TRACKING_CHANNEL              ((uint8_t)0x03)
+
+#define ANT_EXT_MESG_BITFIELD_DEVICE_ID      ((uint8_t)0x80)
+#define ANT_EXT_MESG_BITFIELD_RSSI           ((uint8_t)0x40)
+#define ANT_EXT_MESG_BITFIELD_TIME_STAMP     ((uint8_t)0x20)
+
+#define ANT_LIB_CONFIG_MESG_OUT_INC_DEVICE_ID ((uint8_t)0x80)
+#define ANT_LIB_CONFIG_MESG_OUT_INC_RSSI     ((uint8_t)0x40)
+#define ANT_LIB_CONFIG_MESG_OUT_INC_TIME_STAMP ((uint8_t)0x20)
+#define ANT_LIB_CONFIG_RADIO_CONFIG_ALWAYS   ((uint8_t)0x01)
+#define ANT_LIB_CONFIG_MASK_ALL              ((uint8_t)0xFF)
+
+#define BURST_SEGMENT_CONTINUE               ((uint8_t)0x00)
+#define BURST_SEGMENT_START                  ((uint8_t)0x01)
+#define BURST_SEGMENT_END                    ((uint8_t)0x02)
+
+#define CAPABILITIES_SERIAL_NUMBER_ENABLED   ((uint8_t)0x08) // advanced options
+#define CAPABILITIES_EVENT_BUFFERING_ENABLED ((uint8_t)0x02) // advanced options 3
+
+#define ENCRYPTION_INFO_GET_SUPPORTED_MODE   ((uint8_t)0x00)
+#define ENCRYPTION_INFO_GET_CRYPTO_ID        ((uint8_t)0x01)
+#define ENCRYPTION_INFO_GET_CUSTOM_USER_DATA ((uint8_t)0x02)
+
+#define DC_TO_DC_OFF                         ((uint8_t)0x00)
+#define DC_TO_DC_ON                          ((uint8_t)0x01)
+
+#define RESET_POR                            ((uint8_t)0x00)
+#define RESET_RST                            ((uint8_t)0x01)
+#define RESET_WDT                            ((uint8_t)0x02)
+#define RESET_CMD                            ((uint8_t)0x20)
+#define RESET_SYNC                           ((uint8_t)0x40)
+#define RESET_SUSPEND                        ((uint8_t)0x80)
+
+/***************************************************************************
+ * Message IDs
+ ***************************************************************************/
+#define MESG_INVALID_ID                      ((uint8_t)0x00)
+#define MESG_EVENT_ID                        ((uint8_t)0x01)
+#define MESG_VERSION_ID                      ((uint8_t)0x3E)
+#define MESG_RESPONSE_EVENT_ID               ((uint8_t)0x40)
+#define MESG_UNASSIGN_CHANNEL_ID             ((uint8_t)0x41)
+#define MESG_ASSIGN_CHANNEL_ID               ((uint8_t)0x42)
+#define MESG_CHANNEL_MESG_PERIOD_ID          ((uint8_t)0x43)
+#define MESG_CHANNEL_SEARCH_TIMEOUT_ID       ((uint8_t)0x44)
+#define MESG_CHANNEL_RADIO_FREQ_ID           ((uint8_t)0x45)
+#define MESG_NETWORK_KEY_ID                  ((uint8_t)0x46)
+#define MESG_RADIO_TX_POWER_ID               ((uint8_t)0x47)
+#define MESG_RADIO_CW_MODE_ID                ((uint8_t)0x48)
+#define MESG_SEARCH_WAVEFORM_ID              ((uint8_t)0x49)
+#define MESG_SYSTEM_RESET_ID                 ((uint8_t)0x4A)
+#define MESG_OPEN_CHANNEL_ID                 ((uint8_t)0x4B)
+#define MESG_CLOSE_CHANNEL_ID                ((uint8_t)0x4C)
+#define MESG_REQUEST_ID                      ((uint8_t)0x4D)
+#define MESG_BROADCAST_DATA_ID               ((uint8_t)0x4E)
+#define MESG_ACKNOWLEDGED_DATA_ID            ((uint8_t)0x4F)
+#define MESG_BURST_DATA_ID                   ((uint8_t)0x50)
+#define MESG_CHANNEL_ID_ID                   ((uint8_t)0x51)
+#define MESG_CHANNEL_STATUS_ID               ((uint8_t)0x52)
+#define MESG_RADIO_CW_INIT_ID                ((uint8_t)0x53)
+#define MESG_CAPABILITIES_ID                 ((uint8_t)0x54)
+#define MESG_ID_LIST_ADD_ID                  ((uint8_t)0x59)
+#define MESG_ID_LIST_CONFIG_ID               ((uint8_t)0x5A)
+#define MESG_OPEN_RX_SCAN_ID                 ((uint8_t)0x5B)
+#define MESG_EXT_BROADCAST_DATA_ID           ((uint8_t)0x5D)
+#define MESG_EXT_ACKNOWLEDGED_DATA_ID        ((uint8_t)0x5E)
+#define MESG_EXT_BURST_DATA_ID               ((uint8_t)0x5F)
+#define MESG_CHANNEL_RADIO_TX_POWER_ID       ((uint8_t)0x60)
+#define MESG_GET_SERIAL_NUM_ID               ((uint8_t)0x61)
+#define MESG_SET_LP_SEARCH_TIMEOUT_ID        ((uint8_t)0x63)
+#define MESG_SERIAL_NUM_SET_CHANNEL_ID_ID    ((uint8_t)0x65)
+#define MESG_RX_EXT_MESGS_ENABLE_ID          ((uint8_t)0x66)
+#define MESG_ANTLIB_CONFIG_ID                ((uint8_t)0x6E)
+#define MESG_STARTUP_MESG_ID                 ((uint8_t)0x6F)
+#define MESG_AUTO_FREQ_CONFIG_ID             ((uint8_t)0x70)
+#define MESG_PROX_SEARCH_CONFIG_ID           ((uint8_t)0x71)
+#define MESG_ADV_BURST_DATA_ID               ((uint8_t)0x72)
+#define MESG_EVENT_BUFFERING_CONFIG_ID       ((uint8_t)0x74)
+#define MESG_SET_SEARCH_CH_PRIORITY_ID       ((uint8_t)0x75)
+#define MESG_HIGH_DUTY_SEARCH_MODE_ID        ((uint8_t)0x77)
+#define MESG_CONFIG_ADV_BURST_ID             ((uint8_t)0x78)
+#define MESG_EVENT_FILTER_CONFIG_ID          ((uint8_t)0x79)
+#define MESG_SDU_CONFIG_ID                   ((uint8_t)0x7A)
+#define MESG_SDU_SET_MASK_ID                 ((uint8_t)0x7B)
+#define MESG_ENCRYPT_ENABLE_ID               ((uint8_t)0x7D)
+#define MESG_SET_ENCRYPT_KEY_ID              ((uint8_t)0x7E)
+#define MESG_SET_ENCRYPT_INFO_ID             ((uint8_t)0x7F)
+#define MESG_ACTIVE_SEARCH_SHARING_ID        ((uint8_t)0x81)
+#define MESG_RFACTIVE_NOTIFICATION_ID        ((uint8_t)0x84) // SoftDevice specific, host value
+#define MESG_CHANNEL_CRC_MODE_ID             ((uint8_t)0x88) // SoftDevice specific, host value
+#define MESG_COEX_PRIORITY_CONFIG_ID         ((uint8_t)0x8A) // SoftDevice specific, host value
+#define MESG_COEX_ADV_PRIORITY_CONFIG_ID     ((uint8_t)0x8B) // SoftDevice specific, host value
+#define MESG_PA_LNA_CONFIG_ID                ((uint8_t)0x8C) // SoftDevice specific, host value
+#define MESG_UNLOCK_INTERFACE_ID             ((uint8_t)0xAD)
+#define MESG_SERIAL_ERROR_ID                 ((uint8_t)0xAE)
+#define MESG_SLEEP_ID                        ((uint8_t)0xC5)
+
+#define MESG_EXT_ID_0                        ((uint8_t)0xE0)
+#define MESG_EXT_ID_1                        ((uint8_t)0xE1)
+#define MESG_EXT_ID_2                        ((uint8_t)0xE2)
+#define MESG_EXT_ID_3                        ((uint8_t)0xE3)
+#define MESG_EXT_ID_4                        ((uint8_t)0xE4)
+
+#define MESG_EXT_REQUEST_ID                  ((uint16_t)0xE100)
+#define MESG_EXT_RESPONSE_ID                 ((uint16_t)0xE101)
+#define MESG_SET_SYNC_SERIAL_BIT_RATE        ((uint16_t)0xE110)
+#define MESG_SET_SYNC_SERIAL_SRDY_SLEEP      ((uint16_t)0xE111)
+#define MESG_SET_ASYNC_BAUDRATE              ((uint16_t)0xE112)
+#define MESG_SET_DC_TO_DC                    ((uint16_t)0xE113)
+
+/***************************************************************************
+ * Message sizes
+ ***************************************************************************/
+#define MESG_RESPONSE_EVENT_SIZE             ((uint8_t)3)
+#define MESG_ASSIGN_CHANNEL_SIZE             ((uint8_t)3)
+#define MESG_CHANNEL_ID_SIZE                 ((uint8_t)5)
+#define MESG_CHANNEL_STATUS_SIZE             ((uint8_t)2)
+#define MESG_CAPABILITIES_SIZE               ((uint8_t)8)
+#define MESG_VERSION_SIZE                    ((uint8_t)11)
+#define MESG_GET_SERIAL_NUM_SIZE             ((uint8_t)4)
+#define MESG_STARTUP_MESG_SIZE               ((uint8_t)1)
+#define MESG_OPEN_CHANNEL_WITH_OFFSET_SIZE   ((uint8_t)3)
+#define MESG_OPEN_RX_SCAN_SIZE               ((uint8_t)2)
+#define MESG_PROX_SEARCH_CONFIG_SIZE         ((uint8_t)2)
+#define MESG_RADIO_TX_POWER_SIZE             ((uint8_t)2)
+#define MESG_CHANNEL_RADIO_TX_POWER_SIZE     ((uint8_t)2)
+#define MESG_RADIO_CW_MODE_SIZE              ((uint8_t)3)
+#define MESG_HIGH_DUTY_SEARCH_MODE_EN_SIZE   ((uint8_t)2)
+#define MESG_HIGH_DUTY_SEARCH_MODE_REQ_SIZE  ((uint8_t)5)
+#define MESG_ACTIVE_SEARCH_SHARING_REQ_SIZE  ((uint8_t)2)
+#define MESG_EVENT_BUFFERING_CONFIG_REQ_SIZE ((uint8_t)6)
+#define MESG_EVENT_FILTER_CONFIG_REQ_SIZE    ((uint8_t)3)
+#define MESG_CONFIG_ADV_BURST_REQ_CAPABILITIES_SIZE ((uint8_t)5)
+#define MESG_CONFIG_ADV_BURST_REQ_CONFIG_SIZE ((uint8_t)12)
+#define MESG_CONFIG_ENCRYPT_REQ_CAPABILITIES_SIZE ((uint8_t)2)
+#define MESG_CONFIG_ENCRYPT_REQ_CONFIG_ID_SIZE ((uint8_t)5)
+#define MESG_CONFIG_ENCRYPT_REQ_CONFIG_USER_DATA_SIZE ((uint8_t)20)
+#define MESG_RFACTIVE_NOTIFICATION_SIZE      ((uint8_t)4)
+#define MESG_PA_LNA_CONFIG_SIZE              ((uint8_t)5)
+#define MESG_CHANNEL_CRC_MODE_SIZE           ((uint8_t)2)
+#define MESG_SET_BIT_RATE_REQ_SIZE           ((uint8_t)3)
+#define MESG_SET_BAUDRATE_REQ_SIZE           ((uint8_t)4)
+
+/***************************************************************************
+ * Response and event codes
+ ***************************************************************************/
+#define RESPONSE_NO_ERROR                    ((uint8_t)0x00)
+#define NO_EVENT                             ((uint8_t)0x00)
+#define EVENT_RX_SEARCH_TIMEOUT              ((uint8_t)0x01)
+#define EVENT_RX_FAIL                        ((uint8_t)0x02)
+#define EVENT_TX                             ((uint8_t)0x03)
+#define EVENT_TRANSFER_RX_FAILED             ((uint8_t)0x04)
+#define EVENT_TRANSFER_TX_COMPLETED          ((uint8_t)0x05)
+#define EVENT_TRANSFER_TX_FAILED             ((uint8_t)0x06)
+#define EVENT_CHANNEL_CLOSED                 ((uint8_t)0x07)
+#define EVENT_RX_FAIL_GO_TO_SEARCH           ((uint8_t)0x08)
+#define EVENT_CHANNEL_COLLISION              ((uint8_t)0x09)
+#define EVENT_TRANSFER_TX_START              ((uint8_t)0x0A)
+#define EVENT_TRANSFER_NEXT_DATA_BLOCK       ((uint8_t)0x11)
+#define CHANNEL_IN_WRONG_STATE               ((uint8_t)0x15)
+#define CHANNEL_NOT_OPENED                   ((uint8_t)0x16)
+#define CHANNEL_ID_NOT_SET                   ((uint8_t)0x18)
+#define CLOSE_ALL_CHANNELS                   ((uint8_t)0x19)
+#define TRANSFER_IN_PROGRESS                 ((uint8_t)0x1F)
+#define TRANSFER_SEQUENCE_NUMBER_ERROR       ((uint8_t)0x20)
+#define TRANSFER_IN_ERROR                    ((uint8_t)0x21)
+#define TRANSFER_BUSY                        ((uint8_t)0x22)
+#define MESSAGE_SIZE_EXCEEDS_LIMIT           ((uint8_t)0x27)
+#define INVALID_MESSAGE                      ((uint8_t)0x28)
+#define INVALID_NETWORK_NUMBER               ((uint8_t)0x29)
+#define INVALID_LIST_ID                      ((uint8_t)0x30)
+#define INVALID_SCAN_TX_CHANNEL              ((uint8_t)0x31)
+#define INVALID_PARAMETER_PROVIDED           ((uint8_t)0x33)
+#define EVENT_SERIAL_QUE_OVERFLOW            ((uint8_t)0x34)
+#define EVENT_QUE_OVERFLOW                   ((uint8_t)0x35)
+#define EVENT_ENCRYPT_NEGOTIATION_SUCCESS    ((uint8_t)0x38)
+#define EVENT_ENCRYPT_NEGOTIATION_FAIL       ((uint8_t)0x39)
+#define NVM_FULL_ERROR                       ((uint8_t)0x40)
+#define NVM_WRITE_ERROR                      ((uint8_t)0x41)
+#define NO_RESPONSE_MESSAGE                  ((uint8_t)0x50)
+#define RETURN_TO_MFG                        ((uint8_t)0x51) // host value
+#define EVENT_RX                             ((uint8_t)0x80)
+#define EVENT_RX_BURST_PACKET                ((uint8_t)0x81)
+#define EVENT_RX_EXT                         ((uint8_t)0x82)
+#define EVENT_RX_ADV_BURST_PACKET            ((uint8_t)0x83)
+
+#define FILTER_EVENT_TRANSFER_TX_COMPLETED   ((uint16_t)(1 << (EVENT_TRANSFER_TX_COMPLETED - 1)))
+#define FILTER_EVENT_TRANSFER_TX_FAILED      ((uint16_t)(1 << (EVENT_TRANSFER_TX_FAILED - 1)))
+
+#endif // _ANT_PARAMETERS_H_
@@ -0,0 +1,26 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+#ifndef _APP_ERROR_H_
+#define _APP_ERROR_H_
+
+#include <stdint.h>
+#include "nrf_error.h"
+
+void app_error_handler(uint32_t ulErrorCode, uint32_t ulLineNum, const uint8_t *pucFileName);
+
+#define APP_ERROR_CHECK(ERR_CODE)                                                \
+   do                                                                            \
+   {                                                                             \
+      const uint32_t LOCAL_ERR_CODE = (ERR_CODE);                                \
+      if (LOCAL_ERR_CODE != NRF_SUCCESS)                                         \
+         app_error_handler(LOCAL_ERR_CODE, __LINE__, (const uint8_t *)__FILE__); \
+   } while (0)
+
+#endif // _APP_ERROR_H_
@@ -0,0 +1,18 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+#ifndef _APP_UTIL_PLATFORM_H_
+#define _APP_UTIL_PLATFORM_H_
+
+#define APP_IRQ_PRIORITY_HIGH                (2)
+#define APP_IRQ_PRIORITY_MID                 (3)
+#define APP_IRQ_PRIORITY_LOW                 (6)
+#define APP_IRQ_PRIORITY_LOWEST              (7)
+
+#endif // _APP_UTIL_PLATFORM_H_
@@ -0,0 +1,18 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+#ifndef _COMPILER_ABSTRACTION_H_
+#define _COMPILER_ABSTRACTION_H_
+
+#define __ALIGN(n)                           __attribute__((aligned(n)))
+#define __WEAK                               __attribute__((weak))
+#define __INLINE                             inline
+#define __STATIC_INLINE                      static inline
+
+#endif // _COMPILER_ABSTRACTION_H_
@@ -0,0 +1,235 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+/*
+ * Control interface of the host build. The network processor runs its real
+ * main() loop (np_main) in a context of its own and hands control back to
+ * the host every time it waits for events in sd_app_evt_wait. The host plays
+ * the hardware and the ANT stack in between: it moves serial bytes, feeds
+ * protocol events and advances time. Interrupts raised by the host are taken
+ * right away unless the processor holds them off, as on the target.
+ */
+
+#ifndef _HOST_NP_H_
+#define _HOST_NP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "nrf.h"
+
+#define HOST_NP_UART_TX_UNLIMITED         ((uint32_t)0xFFFFFFFF)
+
+// Number of protocol events the ANT stack stand-in holds before dropping.
+#define HOST_NP_ANT_EVENT_QUEUE_SIZE      ((uint16_t)256)
+
+typedef void (*host_np_uart_sink_t)(uint8_t ucByte, void *pvContext);
+typedef void (*host_np_reset_handler_t)(void);
+
+// ANT channel as set up by the processor.
+typedef struct
+{
+   uint8_t ucStatus;                // STATUS_* as in the channel status message
+   uint8_t ucType;                  // CHANNEL_TYPE_*
+   uint16_t usPeriod;               // message period in 32768 Hz ticks
+   uint16_t usDeviceNumber;
+   uint8_t ucDeviceType;
+   uint8_t ucTransmitType;
+} host_np_channel_t;
+
+typedef struct
+{
+   uint32_t ulEventsQueued;         // protocol events accepted by the stack stand-in
+   uint32_t ulEventsDropped;        // protocol events pushed while its queue was full
+   uint16_t usEventsPending;        // protocol events not read out by the processor yet
+   uint16_t usEventsPendingPeak;
+   uint32_t ulUartTxBytes;          // bytes sent by the processor
+   uint32_t ulUartRxBytes;          // bytes taken by the processor
+   uint32_t ulUartRxRefused;        // bytes refused while RTS was deasserted
+   uint32_t ulFlashOperations;
+} host_np_stats_t;
+
+/**
+ * Reset the peripheral and stack stand-ins to their power on state.
+ *
+ * Call before host_np_boot.
+ */
+void host_np_init(void);
+
+/**
+ * Start the network processor and run it until it first waits for events.
+ *
+ * The processor cannot be restarted within a process, a reset request ends
+ * up in the reset handler.
+ */
+void host_np_boot(void);
+
+/**
+ * Run the network processor until it waits for events again.
+ *
+ * @return false if the processor is not running.
+ */
+bool host_np_run(void);
+
+/**
+ * Alternate between running the network processor and draining its serial
+ * output until it has nothing left to do.
+ */
+void host_np_settle(void);
+
+/**
+ * Deliver the SoftDevice and peripheral events that are due, as the interrupt
+ * of a busy processor would. Called periodically from a timer signal while
+ * the processor runs, the host calls it between runs.
+ */
+void host_np_service(void);
+
+/**
+ * Called when the processor requests a system reset. The default one exits.
+ */
+void host_np_reset_handler_set(host_np_reset_handler_t pfHandler);
+
+/**
+ * Move bytes written by the processor to the serial sink, at most ulMaxBytes.
+ *
+ * @return number of bytes moved.
+ */
+uint32_t host_np_uart_tx_pump(uint32_t ulMaxBytes);
+
+/**
+ * Receive a byte on the processor's serial input.
+ *
+ * @return false if the processor holds off reception (RTS deasserted) or has
+ *          not read the previous byte yet. The byte is not taken.
+ */
+bool host_np_uart_rx(uint8_t ucByte);
+
+/**
+ * Receive a buffer, stopping at the first byte refused.
+ *
+ * @return number of bytes taken.
+ */
+uint32_t host_np_uart_rx_buffer(const uint8_t *pucData, uint32_t ulSize);
+
+/**
+ * Check whether the processor accepts serial input.
+ */
+bool host_np_uart_rts(void);
+
+/**
+ * Serial line rate currently configured by the processor, in baud.
+ */
+uint32_t host_np_uart_baudrate(void);
+
+/**
+ * Drive the processor's input pins, one bit per pin. Serial mode and rate
+ * straps are read once at startup, set them before host_np_boot.
+ */
+void host_np_gpio_in_set(uint32_t ulPins);
+
+/**
+ * Set where the serial output goes.
+ */
+void host_np_uart_sink_set(host_np_uart_sink_t pfSink, void *pvContext);
+
+/**
+ * Queue a protocol event from the ANT stack stand-in.
+ *
+ * @param[in] pucMessage Event message as returned by sd_ant_event_get: size,
+ *          message ID and message data.
+ *
+ * @return false if the event queue is full, the event is dropped.
+ */
+bool host_np_ant_event_push(uint8_t ucChannel, uint8_t ucEvent, const uint8_t *pucMessage);
+
+/**
+ * Number of channels the ANT stack was enabled with.
+ */
+uint8_t host_np_ant_channels(void);
+
+/**
+ * Retrieve the setup of a channel, to generate traffic that matches it.
+ *
+ * @return false if the channel does not exist.
+ */
+bool host_np_ant_channel_get(uint8_t ucChannel, host_np_channel_t *pstChannel);
+
+/**
+ * ANT library configuration (ANT_LIB_CONFIG_*), telling which extended data
+ * received messages carry.
+ */
+uint8_t host_np_ant_lib_config(void);
+
+/**
+ * Advance the 32768 Hz low frequency clock by ulTicks.
+ */
+void host_np_time_advance(uint32_t ulTicks);
+
+/**
+ * Current low frequency clock time in ticks, as seen by the processor.
+ */
+uint32_t host_np_time_get(void);
+
+/**
+ * Retrieve the stand-in counters.
+ */
+void host_np_stats_get(host_np_stats_t *pstStats);
+
+/**
+ * Clear the stand-in counters.
+ */
+void host_np_stats_clear(void);
+
+/**
+ * Free running cycle counter of the host CPU.
+ */
+static inline uint64_t host_np_cycles(void)
+{
+#if defined (__x86_64__) || defined (__i386__)
+   uint32_t ulLow;
+   uint32_t ulHigh;
+
+   __asm__ volatile ("rdtsc" : "=a" (ulLow), "=d" (ulHigh));
+   return ((uint64_t)ulHigh << 32) | ulLow;
+#elif defined (__aarch64__)
+   uint64_t ullCount;
+
+   __asm__ volatile ("mrs %0, cntvct_el0" : "=r" (ullCount));
+   return ullCount;
+#else
+   struct timespec stNow;
+
+   clock_gettime(CLOCK_MONOTONIC, &stNow);
+   return (uint64_t)stNow.tv_sec * 1000000000ull + (uint64_t)stNow.tv_nsec;
+#endif
+}
+
+/**
+ * Monotonic wall clock time in nanoseconds.
+ */
+static inline uint64_t host_np_nanoseconds(void)
+{
+   struct timespec stNow;
+
+   clock_gettime(CLOCK_MONOTONIC, &stNow);
+   return (uint64_t)stNow.tv_sec * 1000000000ull + (uint64_t)stNow.tv_nsec;
+}
+
+// Shared between the peripheral and stack stand-ins.
+void host_np_lock(void);
+void host_np_unlock(void);
+void host_np_irq_dispatch(void);
+bool host_np_irq_raise(IRQn_Type eIRQn);
+void host_np_sd_service(void);
+void host_np_sd_reset(void);
+void host_np_sd_stats_get(host_np_stats_t *pstStats);
+void host_np_sd_stats_clear(void);
+
+#endif // _HOST_NP_H_
@@ -0,0 +1,481 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+/*
+ * Host stand-in for the nRF52 device header. Only the peripherals and register
+ * fields used by the network processor are modelled, the register blocks are
+ * plain memory owned by host/src/peripherals.c.
+ */
+
+#ifndef _NRF_H_
+#define _NRF_H_
+
+#include <stdint.h>
+
+#define __I                                  volatile const
+#define __O                                  volatile
+#define __IO                                 volatile
+
+/***************************************************************************
+ * Interrupt numbers
+ ***************************************************************************/
+typedef enum
+{
+   UARTE0_UART0_IRQn                         = 2,
+   SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQn    = 3,
+   GPIOTE_IRQn                               = 6,
+   TIMER1_IRQn                               = 9,
+   TIMER2_IRQn                               = 10,
+   RTC1_IRQn                                 = 17,
+   SWI0_EGU0_IRQn                            = 20,
+   SWI1_EGU1_IRQn                            = 21,
+   SWI2_EGU2_IRQn                            = 22,
+   SWI3_EGU3_IRQn                            = 23,
+   TIMER3_IRQn                               = 26,
+   TIMER4_IRQn                               = 27,
+   HOST_IRQn_COUNT                           = 32
+} IRQn_Type;
+
+#define UART0_IRQn                           UARTE0_UART0_IRQn
+#define SWI0_IRQn                            SWI0_EGU0_IRQn
+#define SWI1_IRQn                            SWI1_EGU1_IRQn
+#define SWI2_IRQn                            SWI2_EGU2_IRQn
+#define SWI3_IRQn                            SWI3_EGU3_IRQn
+#define SPI0_TWI0_IRQn                       SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQn
+
+/***************************************************************************
+ * Register blocks
+ ***************************************************************************/
+typedef struct
+{
+   __IO uint32_t OUT;
+   __IO uint32_t OUTSET;
+   __IO uint32_t OUTCLR;
+   __I  uint32_t IN;
+   __IO uint32_t DIR;
+   __IO uint32_t DIRSET;
+   __IO uint32_t DIRCLR;
+   __IO uint32_t LATCH;
+   __IO uint32_t DETECTMODE;
+   __IO uint32_t PIN_CNF[32];
+} NRF_GPIO_Type;
+
+typedef struct
+{
+   __O  uint32_t TASKS_OUT[8];
+   __O  uint32_t TASKS_SET[8];
+   __O  uint32_t TASKS_CLR[8];
+   __IO uint32_t EVENTS_IN[8];
+   __IO uint32_t EVENTS_PORT;
+   __IO uint32_t INTENSET;
+   __IO uint32_t INTENCLR;
+   __IO uint32_t CONFIG[8];
+} NRF_GPIOTE_Type;
+
+typedef struct
+{
+   __O  uint32_t TASKS_STARTRX;
+   __O  uint32_t TASKS_STOPRX;
+   __O  uint32_t TASKS_STARTTX;
+   __O  uint32_t TASKS_STOPTX;
+   __O  uint32_t TASKS_SUSPEND;
+   __IO uint32_t EVENTS_CTS;
+   __IO uint32_t EVENTS_NCTS;
+   __IO uint32_t EVENTS_RXDRDY;
+   __IO uint32_t EVENTS_TXDRDY;
+   __IO uint32_t EVENTS_ERROR;
+   __IO uint32_t EVENTS_RXTO;
+   __IO uint32_t SHORTS;
+   __IO uint32_t INTENSET;
+   __IO uint32_t INTENCLR;
+   __IO uint32_t ERRORSRC;
+   __IO uint32_t ENABLE;
+   __IO uint32_t PSELRTS;
+   __IO uint32_t PSELTXD;
+   __IO uint32_t PSELCTS;
+   __IO uint32_t PSELRXD;
+   __I  uint32_t RXD;
+   __O  uint32_t TXD;
+   __IO uint32_t BAUDRATE;
+   __IO uint32_t CONFIG;
+} NRF_UART_Type;
+
+typedef struct
+{
+   __IO uint32_t RTS;
+   __IO uint32_t TXD;
+   __IO uint32_t CTS;
+   __IO uint32_t RXD;
+} UARTE_PSEL_Type;
+
+typedef struct
+{
+   __IO uint32_t PTR;
+   __IO uint32_t MAXCNT;
+   __I  uint32_t AMOUNT;
+} UARTE_RXD_Type;
+
+typedef struct
+{
+   __IO uint32_t PTR;
+   __IO uint32_t MAXCNT;
+   __I  uint32_t AMOUNT;
+} UARTE_TXD_Type;
+
+typedef struct
+{
+   __O  uint32_t TASKS_STARTRX;
+   __O  uint32_t TASKS_STOPRX;
+   __O  uint32_t TASKS_STARTTX;
+   __O  uint32_t TASKS_STOPTX;
+   __O  uint32_t TASKS_FLUSHRX;
+   __IO uint32_t EVENTS_CTS;
+   __IO uint32_t EVENTS_NCTS;
+   __IO uint32_t EVENTS_RXDRDY;
+   __IO uint32_t EVENTS_ENDRX;
+   __IO uint32_t EVENTS_TXDRDY;
+   __IO uint32_t EVENTS_ENDTX;
+   __IO uint32_t EVENTS_ERROR;
+   __IO uint32_t EVENTS_RXTO;
+   __IO uint32_t EVENTS_RXSTARTED;
+   __IO uint32_t EVENTS_TXSTARTED;
+   __IO uint32_t EVENTS_TXSTOPPED;
+   __IO uint32_t SHORTS;
+   __IO uint32_t INTEN;
+   __IO uint32_t INTENSET;
+   __IO uint32_t INTENCLR;
+   __IO uint32_t ERRORSRC;
+   __IO uint32_t ENABLE;
+   UARTE_PSEL_Type PSEL;
+   __IO uint32_t BAUDRATE;
+   UARTE_RXD_Type RXD;
+   UARTE_TXD_Type TXD;
+   __IO uint32_t CONFIG;
+} NRF_UARTE_Type;
+
+typedef struct
+{
+   __IO uint32_t EVENTS_READY;
+   __IO uint32_t INTENSET;
+   __IO uint32_t INTENCLR;
+   __IO uint32_t ENABLE;
+   __IO uint32_t PSELSCK;
+   __IO uint32_t PSELMOSI;
+   __IO uint32_t PSELMISO;
+   __I  uint32_t RXD;
+   __IO uint32_t TXD;
+   __IO uint32_t FREQUENCY;
+   __IO uint32_t CONFIG;
+} NRF_SPI_Type;
+
+typedef struct
+{
+   __IO uint32_t SCK;
+   __IO uint32_t MOSI;
+   __IO uint32_t MISO;
+} SPIM_PSEL_Type;
+
+typedef struct
+{
+   __IO uint32_t PTR;
+   __IO uint32_t MAXCNT;
+   __I  uint32_t AMOUNT;
+   __IO uint32_t LIST;
+} SPIM_RXD_Type;
+
+typedef struct
+{
+   __IO uint32_t PTR;
+   __IO uint32_t MAXCNT;
+   __I  uint32_t AMOUNT;
+   __IO uint32_t LIST;
+} SPIM_TXD_Type;
+
+typedef struct
+{
+   __O  uint32_t TASKS_START;
+   __O  uint32_t TASKS_STOP;
+   __IO uint32_t EVENTS_END;
+   __IO uint32_t EVENTS_ENDRX;
+   __IO uint32_t EVENTS_ENDTX;
+   __IO uint32_t INTENSET;
+   __IO uint32_t INTENCLR;
+   __IO uint32_t ENABLE;
+   SPIM_PSEL_Type PSEL;
+   __IO uint32_t FREQUENCY;
+   SPIM_RXD_Type RXD;
+   SPIM_TXD_Type TXD;
+   __IO uint32_t CONFIG;
+   __IO uint32_t ORC;
+} NRF_SPIM_Type;
+
+typedef struct
+{
+   __O  uint32_t TASKS_START;
+   __O  uint32_t TASKS_STOP;
+   __O  uint32_t TASKS_COUNT;
+   __O  uint32_t TASKS_CLEAR;
+   __O  uint32_t TASKS_SHUTDOWN;
+   __O  uint32_t TASKS_CAPTURE[6];
+   __IO uint32_t EVENTS_COMPARE[6];
+   __IO uint32_t SHORTS;
+   __IO uint32_t INTENSET;
+   __IO uint32_t INTENCLR;
+   __IO uint32_t MODE;
+   __IO uint32_t BITMODE;
+   __IO uint32_t PRESCALER;
+   __IO uint32_t CC[6];
+} NRF_TIMER_Type;
+
+typedef struct
+{
+   __O  uint32_t TASKS_START;
+   __O  uint32_t TASKS_STOP;
+   __O  uint32_t TASKS_CLEAR;
+   __O  uint32_t TASKS_TRIGOVRFLW;
+   __IO uint32_t EVENTS_TICK;
+   __IO uint32_t EVENTS_OVRFLW;
+   __IO uint32_t EVENTS_COMPARE[4];
+   __IO uint32_t INTENSET;
+   __IO uint32_t INTENCLR;
+   __IO uint32_t EVTEN;
+   __IO uint32_t EVTENSET;
+   __IO uint32_t EVTENCLR;
+   __I  uint32_t COUNTER;
+   __IO uint32_t PRESCALER;
+   __IO uint32_t CC[4];
+} NRF_RTC_Type;
+
+typedef struct
+{
+   __I  uint32_t CODEPAGESIZE;
+   __I  uint32_t CODESIZE;
+   __I  uint32_t DEVICEID[2];
+} NRF_FICR_Type;
+
+typedef struct
+{
+   __IO uint32_t RESERVED[32];
+   __IO uint32_t CUSTOMER[32];
+} NRF_UICR_Type;
+
+typedef struct
+{
+   __IO uint32_t SCR;
+} SCB_Type;
+
+typedef struct
+{
+   __IO uint32_t CTRL;
+   __IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+   __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+/***************************************************************************
+ * Register bit fields
+ ***************************************************************************/
+#define GPIO_PIN_CNF_DIR_Pos                 (0UL)
+#define GPIO_PIN_CNF_DIR_Input               (0UL)
+#define GPIO_PIN_CNF_DIR_Output              (1UL)
+#define GPIO_PIN_CNF_INPUT_Pos               (1UL)
+#define GPIO_PIN_CNF_INPUT_Connect           (0UL)
+#define GPIO_PIN_CNF_INPUT_Disconnect        (1UL)
+#define GPIO_PIN_CNF_PULL_Pos                (2UL)
+#define GPIO_PIN_CNF_PULL_Disabled           (0UL)
+#define GPIO_PIN_CNF_DRIVE_Pos               (8UL)
+#define GPIO_PIN_CNF_DRIVE_S0S1              (0UL)
+#define GPIO_PIN_CNF_SENSE_Pos               (16UL)
+#define GPIO_PIN_CNF_SENSE_Msk               (0x3UL << GPIO_PIN_CNF_SENSE_Pos)
+#define GPIO_PIN_CNF_SENSE_Disabled          (0UL)
+#define GPIO_PIN_CNF_SENSE_High              (2UL)
+#define GPIO_PIN_CNF_SENSE_Low               (3UL)
+
+#define GPIOTE_CONFIG_MODE_Pos               (0UL)
+#define GPIOTE_CONFIG_MODE_Event             (1UL)
+#define GPIOTE_CONFIG_PSEL_Pos               (8UL)
+#define GPIOTE_CONFIG_POLARITY_Pos           (16UL)
+#define GPIOTE_CONFIG_POLARITY_LoToHi        (1UL)
+#define GPIOTE_CONFIG_POLARITY_HiToLo        (2UL)
+#define GPIOTE_INTENSET_PORT_Pos             (31UL)
+#define GPIOTE_INTENSET_PORT_Enabled         (1UL)
+
+#define UART_ENABLE_ENABLE_Pos               (0UL)
+#define UART_ENABLE_ENABLE_Disabled          (0UL)
+#define UART_ENABLE_ENABLE_Enabled           (4UL)
+#define UART_INTENSET_RXDRDY_Pos             (2UL)
+#define UART_INTENSET_RXDRDY_Set             (1UL)
+#define UART_INTENSET_TXDRDY_Pos             (7UL)
+#define UART_INTENSET_TXDRDY_Set             (1UL)
+#define UART_INTENCLR_RXDRDY_Pos             (2UL)
+#define UART_INTENCLR_RXDRDY_Clear           (1UL)
+#define UART_INTENCLR_TXDRDY_Pos             (7UL)
+#define UART_INTENCLR_TXDRDY_Clear           (1UL)
+#define UART_ERRORSRC_OVERRUN_Msk            (0x1UL)
+#define UART_ERRORSRC_PARITY_Msk             (0x2UL)
+#define UART_ERRORSRC_FRAMING_Msk            (0x4UL)
+#define UART_CONFIG_HWFC_Pos                 (0UL)
+#define UART_CONFIG_HWFC_Enabled             (1UL)
+#define UART_CONFIG_PARITY_Pos               (1UL)
+#define UART_CONFIG_PARITY_Excluded          (0UL)
+#define UART_BAUDRATE_BAUDRATE_Pos           (0UL)
+#define UART_BAUDRATE_BAUDRATE_Baud1200      (0x0004F000UL)
+#define UART_BAUDRATE_BAUDRATE_Baud2400      (0x0009D000UL)
+#define UART_BAUDRATE_BAUDRATE_Baud4800      (0x0013B000UL)
+#define UART_BAUDRATE_BAUDRATE_Baud9600      (0x00275000UL)
+#define UART_BAUDRATE_BAUDRATE_Baud19200     (0x004EA000UL)
+#define UART_BAUDRATE_BAUDRATE_Baud38400     (0x009D5000UL)
+#define UART_BAUDRATE_BAUDRATE_Baud57600     (0x00EBF000UL)
+#define UART_BAUDRATE_BAUDRATE_Baud115200    (0x01D7E000UL)
+#define UART_BAUDRATE_BAUDRATE_Baud230400    (0x03AFB000UL)
+#define UART_BAUDRATE_BAUDRATE_Baud460800    (0x075F7000UL)
+#define UART_BAUDRATE_BAUDRATE_Baud921600    (0x0EBEDFA4UL)
+
+#define UARTE_ENABLE_ENABLE_Pos              (0UL)
+#define UARTE_ENABLE_ENABLE_Disabled         (0UL)
+#define UARTE_ENABLE_ENABLE_Enabled          (8UL)
+#define UARTE_INTENSET_ENDRX_Pos             (4UL)
+#define UARTE_INTENSET_ENDRX_Set             (1UL)
+#define UARTE_INTENSET_ENDTX_Pos             (8UL)
+#define UARTE_INTENSET_ENDTX_Set             (1UL)
+#define UARTE_INTENSET_RXSTARTED_Pos         (19UL)
+#define UARTE_INTENSET_RXSTARTED_Set         (1UL)
+#define UARTE_INTENCLR_ENDRX_Pos             (4UL)
+#define UARTE_INTENCLR_ENDRX_Clear           (1UL)
+#define UARTE_INTENCLR_ENDTX_Pos             (8UL)
+#define UARTE_INTENCLR_ENDTX_Clear           (1UL)
+#define UARTE_INTENCLR_RXSTARTED_Pos         (19UL)
+#define UARTE_INTENCLR_RXSTARTED_Clear       (1UL)
+#define UARTE_SHORTS_ENDRX_STARTRX_Pos       (5UL)
+#define UARTE_SHORTS_ENDRX_STARTRX_Enabled   (1UL)
+#define UARTE_ERRORSRC_OVERRUN_Msk           (0x1UL)
+#define UARTE_ERRORSRC_PARITY_Msk            (0x2UL)
+#define UARTE_ERRORSRC_FRAMING_Msk           (0x4UL)
+#define UARTE_CONFIG_HWFC_Pos                (0UL)
+#define UARTE_CONFIG_HWFC_Enabled            (1UL)
+#define UARTE_CONFIG_PARITY_Pos              (1UL)
+#define UARTE_CONFIG_PARITY_Excluded         (0UL)
+#define UARTE_BAUDRATE_BAUDRATE_Pos          (0UL)
+#define UARTE_BAUDRATE_BAUDRATE_Baud1200     (0x0004F000UL)
+#define UARTE_BAUDRATE_BAUDRATE_Baud2400     (0x0009D000UL)
+#define UARTE_BAUDRATE_BAUDRATE_Baud4800     (0x0013B000UL)
+#define UARTE_BAUDRATE_BAUDRATE_Baud9600     (0x00275000UL)
+#define UARTE_BAUDRATE_BAUDRATE_Baud19200    (0x004EA000UL)
+#define UARTE_BAUDRATE_BAUDRATE_Baud38400    (0x009C0000UL)
+#define UARTE_BAUDRATE_BAUDRATE_Baud57600    (0x00EB0000UL)
+#define UARTE_BAUDRATE_BAUDRATE_Baud115200   (0x01D60000UL)
+#define UARTE_BAUDRATE_BAUDRATE_Baud230400   (0x03B00000UL)
+#define UARTE_BAUDRATE_BAUDRATE_Baud460800   (0x07400000UL)
+#define UARTE_BAUDRATE_BAUDRATE_Baud921600   (0x0F000000UL)
+
+#define TIMER_MODE_MODE_Pos                  (0UL)
+#define TIMER_MODE_MODE_Timer                (0UL)
+#define TIMER_MODE_MODE_Counter              (2UL)
+#define TIMER_BITMODE_BITMODE_Pos            (0UL)
+#define TIMER_BITMODE_BITMODE_16Bit          (0UL)
+#define TIMER_BITMODE_BITMODE_32Bit          (3UL)
+#define TIMER_PRESCALER_PRESCALER_Pos        (0UL)
+#define TIMER_SHORTS_COMPARE0_CLEAR_Pos      (0UL)
+#define TIMER_SHORTS_COMPARE0_CLEAR_Enabled  (1UL)
+#define TIMER_SHORTS_COMPARE0_STOP_Pos       (8UL)
+#define TIMER_SHORTS_COMPARE0_STOP_Enabled   (1UL)
+#define TIMER_INTENSET_COMPARE0_Pos          (16UL)
+#define TIMER_INTENSET_COMPARE0_Set          (1UL)
+#define TIMER_INTENCLR_COMPARE0_Pos          (16UL)
+#define TIMER_INTENCLR_COMPARE0_Clear        (1UL)
+#define TIMER_INTENCLR_COMPARE1_Pos          (17UL)
+#define TIMER_INTENCLR_COMPARE1_Clear        (1UL)
+#define TIMER_INTENCLR_COMPARE2_Pos          (18UL)
+#define TIMER_INTENCLR_COMPARE2_Clear        (1UL)
+#define TIMER_INTENCLR_COMPARE3_Pos          (19UL)
+#define TIMER_INTENCLR_COMPARE3_Clear        (1UL)
+
+#define RTC_INTENSET_OVRFLW_Msk              (0x1UL << 1)
+#define RTC_INTENSET_COMPARE0_Msk            (0x1UL << 16)
+#define RTC_INTENCLR_OVRFLW_Msk              (0x1UL << 1)
+#define RTC_INTENCLR_COMPARE0_Msk            (0x1UL << 16)
+
+#define SPI_ENABLE_ENABLE_Pos                (0UL)
+#define SPI_ENABLE_ENABLE_Enabled            (1UL)
+#define SPI_FREQUENCY_FREQUENCY_Pos          (0UL)
+#define SPI_FREQUENCY_FREQUENCY_K500         (0x08000000UL)
+#define SPI_FREQUENCY_FREQUENCY_M1           (0x10000000UL)
+#define SPI_FREQUENCY_FREQUENCY_M2           (0x20000000UL)
+#define SPI_FREQUENCY_FREQUENCY_M4           (0x40000000UL)
+#define SPI_FREQUENCY_FREQUENCY_M8           (0x80000000UL)
+#define SPI_CONFIG_ORDER_Pos                 (0UL)
+#define SPI_CONFIG_ORDER_LsbFirst            (1UL)
+#define SPI_CONFIG_CPHA_Pos                  (1UL)
+#define SPI_CONFIG_CPHA_Trailing             (1UL)
+#define SPI_CONFIG_CPOL_Pos                  (2UL)
+#define SPI_CONFIG_CPOL_ActiveLow            (1UL)
+#define SPIM_ENABLE_ENABLE_Pos               (0UL)
+#define SPIM_ENABLE_ENABLE_Disabled          (0UL)
+#define SPIM_ENABLE_ENABLE_Enabled           (7UL)
+
+#define POWER_RESETREAS_RESETPIN_Msk         (0x1UL << 0)
+#define POWER_RESETREAS_DOG_Msk              (0x1UL << 1)
+#define POWER_RESETREAS_SREQ_Msk             (0x1UL << 2)
+#define POWER_RESETREAS_LOCKUP_Msk           (0x1UL << 3)
+#define POWER_RESETREAS_OFF_Msk              (0x1UL << 16)
+
+#define SCB_SCR_SEVONPEND_Msk                (0x1UL << 4)
+#define DWT_CTRL_CYCCNTENA_Msk               (0x1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk           (0x1UL << 24)
+
+/***************************************************************************
+ * Peripheral instances, see host/src/peripherals.c
+ ***************************************************************************/
+extern NRF_GPIO_Type    stHostGPIO;
+extern NRF_GPIOTE_Type  stHostGPIOTE;
+extern NRF_UART_Type    stHostUART0;
+extern NRF_SPI_Type     stHostSPI0;
+extern NRF_SPIM_Type    stHostSPIM0;
+extern NRF_TIMER_Type   astHostTimer[4];
+extern NRF_RTC_Type     stHostRTC1;
+extern NRF_FICR_Type    stHostFICR;
+extern NRF_UICR_Type    stHostUICR;
+extern SCB_Type         stHostSCB;
+extern CoreDebug_Type   stHostCoreDebug;
+extern uint8_t          aucHostFlash[];
+
+#define NRF_GPIO                             (&stHostGPIO)
+#define NRF_P0                               (&stHostGPIO)
+#define NRF_GPIOTE                           (&stHostGPIOTE)
+#define NRF_UART0                            (&stHostUART0)
+#define NRF_UARTE0                           ((NRF_UARTE_Type *)&stHostUART0) // not modelled, the host build uses the legacy UART
+#define NRF_SPI0                             (&stHostSPI0)  // not modelled, the synchronous port is only compiled
+#define NRF_SPIM0                            (&stHostSPIM0) // not modelled, the synchronous port is only compiled
+#define NRF_TIMER1                           (&astHostTimer[1])
+#define NRF_TIMER2                           (&astHostTimer[2])
+#define NRF_TIMER3                           (&astHostTimer[3])
+#define NRF_RTC1                             (&stHostRTC1)
+#define NRF_FICR                             (&stHostFICR)
+#define NRF_UICR                             (&stHostUICR)
+#define NRF_UICR_BASE                        ((uintptr_t)&stHostUICR)
+#define SCB                                  (&stHostSCB)
+#define CoreDebug                            (&stHostCoreDebug)
+#define DWT                                  (host_np_dwt()) // CYCCNT follows the host cycle counter while enabled
+
+#define HOST_FLASH_PAGE_SIZE                 (4096UL)
+#define HOST_FLASH_PAGES                     (2UL)
+#define HOST_FLASH_START                     ((uintptr_t)aucHostFlash)
+
+void NVIC_SystemReset(void);
+DWT_Type *host_np_dwt(void);
+
+#define __DMB()
+#define __DSB()
+#define __ISB()
+#define __WFE()
+
+#endif // _NRF_H_
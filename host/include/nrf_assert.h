@@ -0,0 +1,17 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+#ifndef _NRF_ASSERT_H_
+#define _NRF_ASSERT_H_
+
+#include <assert.h>
+
+#define ASSERT(expr)                         assert(expr)
+
+#endif // _NRF_ASSERT_H_
@@ -0,0 +1,17 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+#ifndef _NRF_DELAY_H_
+#define _NRF_DELAY_H_
+
+#include <stdint.h>
+
+void nrf_delay_us(uint32_t number_of_us);
+
+#endif // _NRF_DELAY_H_
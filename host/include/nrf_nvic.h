@@ -0,0 +1,38 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+/*
+ * Host stand-in for the SoftDevice NVIC API. Interrupts are dispatched by
+ * host/src/peripherals.c, critical regions hold them off.
+ */
+
+#ifndef _NRF_NVIC_H_
+#define _NRF_NVIC_H_
+
+#include <stdint.h>
+#include "nrf.h"
+
+typedef struct
+{
+   volatile uint32_t __irq_masks[2];
+   volatile uint32_t __cr_flag;
+} nrf_nvic_state_t;
+
+uint32_t sd_nvic_EnableIRQ(IRQn_Type IRQn);
+uint32_t sd_nvic_DisableIRQ(IRQn_Type IRQn);
+uint32_t sd_nvic_GetPendingIRQ(IRQn_Type IRQn, uint32_t *p_pending_irq);
+uint32_t sd_nvic_SetPendingIRQ(IRQn_Type IRQn);
+uint32_t sd_nvic_ClearPendingIRQ(IRQn_Type IRQn);
+uint32_t sd_nvic_SetPriority(IRQn_Type IRQn, uint32_t priority);
+uint32_t sd_nvic_GetPriority(IRQn_Type IRQn, uint32_t *p_priority);
+uint32_t sd_nvic_SystemReset(void);
+uint32_t sd_nvic_critical_region_enter(uint8_t *p_is_nested_critical_region);
+uint32_t sd_nvic_critical_region_exit(uint8_t is_nested_critical_region);
+
+#endif // _NRF_NVIC_H_
@@ -0,0 +1,40 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+/*
+ * Host stand-in for the SoftDevice manager API, see host/src/softdevice.c.
+ */
+
+#ifndef _NRF_SDM_H_
+#define _NRF_SDM_H_
+
+#include <stdint.h>
+#include "nrf_error.h"
+
+#define NRF_CLOCK_LF_SRC_RC                  (0)
+#define NRF_CLOCK_LF_SRC_XTAL                (1)
+#define NRF_CLOCK_LF_SRC_SYNTH               (2)
+#define NRF_CLOCK_LF_ACCURACY_50_PPM         (7)
+
+#define ANT_LICENSE_KEY                      "HOST-STAND-IN"
+
+typedef struct
+{
+   uint8_t source;
+   uint8_t rc_ctiv;
+   uint8_t rc_temp_ctiv;
+   uint8_t accuracy;
+} nrf_clock_lf_cfg_t;
+
+typedef void (*nrf_fault_handler_t)(uint32_t id, uint32_t pc, uint32_t info);
+
+uint32_t sd_softdevice_enable(nrf_clock_lf_cfg_t const *p_clock_lf_cfg, nrf_fault_handler_t fault_handler, const char *p_license_key);
+uint32_t sd_softdevice_disable(void);
+
+#endif // _NRF_SDM_H_
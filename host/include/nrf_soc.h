@@ -0,0 +1,55 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+/*
+ * Host stand-in for the SoftDevice SoC API, see host/src/softdevice.c.
+ */
+
+#ifndef _NRF_SOC_H_
+#define _NRF_SOC_H_
+
+#include <stdint.h>
+#include "nrf.h"
+#include "nrf_error.h"
+
+#define RADIO_NOTIFICATION_IRQn              SWI1_IRQn
+#define SD_EVT_IRQn                          SWI2_IRQn
+
+#define NRF_POWER_DCDC_DISABLE               (0)
+#define NRF_POWER_DCDC_ENABLE                (1)
+
+enum NRF_SOC_EVTS
+{
+   NRF_EVT_HFCLKSTARTED,
+   NRF_EVT_POWER_FAILURE_WARNING,
+   NRF_EVT_FLASH_OPERATION_SUCCESS,
+   NRF_EVT_FLASH_OPERATION_ERROR,
+   NRF_EVT_RADIO_BLOCKED,
+   NRF_EVT_RADIO_CANCELED,
+   NRF_EVT_RADIO_SIGNAL_CALLBACK_INVALID_RETURN,
+   NRF_EVT_RADIO_SESSION_IDLE,
+   NRF_EVT_RADIO_SESSION_CLOSED,
+   NRF_EVT_NUMBER_OF_EVTS
+};
+
+uint32_t sd_app_evt_wait(void);
+uint32_t sd_evt_get(uint32_t *p_evt_id);
+uint32_t sd_clock_hfclk_request(void);
+uint32_t sd_clock_hfclk_release(void);
+uint32_t sd_flash_write(uint32_t *p_dst, uint32_t const *p_src, uint32_t size);
+uint32_t sd_flash_page_erase(uint32_t page_number);
+uint32_t sd_power_reset_reason_get(uint32_t *p_reset_reason);
+uint32_t sd_power_reset_reason_clr(uint32_t reset_reason_clr_msk);
+uint32_t sd_power_system_off(void);
+uint32_t sd_power_dcdc_mode_set(uint8_t dcdc_mode);
+uint32_t sd_ppi_channel_assign(uint8_t channel_num, const volatile void *evt_endpoint, const volatile void *task_endpoint);
+uint32_t sd_ppi_channel_enable_set(uint32_t channel_enable_set_msk);
+uint32_t sd_ppi_channel_enable_clr(uint32_t channel_enable_clr_msk);
+
+#endif // _NRF_SOC_H_
@@ -0,0 +1,715 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+/*
+ * Network processor simulator. Runs the host build of the processor in real
+ * time and exposes its asynchronous serial port on a pseudo terminal, so ANT
+ * host libraries can talk to it like to a module on a serial port. Serial
+ * bytes move at the simulated line rate in both directions and the processor
+ * holds off reception through its RTS as on the target. Traffic generators
+ * feed received messages to the channels the host opens.
+ *
+ * Everything runs on the simulated clock: with the same seed and the same
+ * commands from the host, the processor sees the same events at the same
+ * simulated times whatever the wall clock speed.
+ */
+
+#define _GNU_SOURCE // pseudo terminals
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ant_parameters.h"
+#include "boardconfig.h"
+#include "event_buffering.h"
+#include "host_np.h"
+
+#define SIM_TICKS_PER_SECOND              ((uint64_t)32768)
+#define SIM_STEP_NS                       ((uint64_t)1000000) // 1 ms of simulated time per step
+#define SIM_STEPS_PER_SECOND              ((uint64_t)1000)
+#define SIM_BITS_PER_BYTE                 ((uint32_t)10)      // start, 8 data, stop
+#define SIM_LAG_MAX_NS                    ((uint64_t)100000000) // wall clock lag given up on
+
+#define SIM_TRAFFIC_MAX                   16
+#define SIM_CHANNELS_MAX                  32
+#define SIM_BURST_PACKETS                 32
+#define SIM_RX_BUFFER_SIZE                256
+#define SIM_TX_BUFFER_SIZE                ((uint32_t)65536)
+#define SIM_DEVICE_NUMBER_BASE            ((uint16_t)1000) // for channels with a wildcard device number
+#define SIM_DEVICE_TYPE                   ((uint8_t)0x78)
+#define SIM_TRANSMIT_TYPE                 ((uint8_t)0x01)
+
+#define SIM_DEFAULT_BAUD                  ((uint32_t)57600)
+#define SIM_LINE_RATE_PROCESSOR           ((uint32_t)0xFFFFFFFF) // follow the rate set by the processor
+
+typedef enum
+{
+   TRAFFIC_CHANNELS,                      // every open channel
+   TRAFFIC_DEVICES,                       // many devices received on one channel, as in scan mode
+   TRAFFIC_BURST                          // back to back burst transfers on one channel
+} traffic_kind_t;
+
+typedef struct
+{
+   traffic_kind_t eKind;
+   uint8_t ucChannel;
+   uint32_t ulDevices;
+   uint32_t ulRateMilliHz;                // per channel, device or burst packet, 0 for the channel period
+   uint64_t aullDue[SIM_CHANNELS_MAX];   // next message time in ticks, per channel
+   uint64_t ullAccumulator;               // fractional events, in ticks * 1000
+   uint32_t ulNext;                       // next device or burst packet
+} traffic_t;
+
+// Baud rate strap of the asynchronous port, see the baud rate selection in README.md.
+static const struct
+{
+   uint32_t ulBaudrate;
+   uint32_t ulPins;
+} astBaudStrap[] =
+{
+   {2400,   (1UL << SERIAL_ASYNC_BR3) | (1UL << SERIAL_ASYNC_BR2)},
+   {4800,   0},
+   {9600,   (1UL << SERIAL_ASYNC_BR3) | (1UL << SERIAL_ASYNC_BR1)},
+   {19200,  (1UL << SERIAL_ASYNC_BR2)},
+   {38400,  (1UL << SERIAL_ASYNC_BR1)},
+   {57600,  (1UL << SERIAL_ASYNC_BR2) | (1UL << SERIAL_ASYNC_BR1)},
+   {115200, (1UL << SERIAL_ASYNC_BR3)},
+};
+
+static traffic_t astTraffic[SIM_TRAFFIC_MAX];
+static uint8_t ucTrafficCount;
+static uint32_t ulSeed = 1;
+static uint32_t ulLineRate = SIM_LINE_RATE_PROCESSOR;
+static double dSpeed = 1.0;
+static uint32_t ulStatsInterval;          // simulated seconds, 0 at exit only
+static const char *pcLink;
+
+static int iMaster = -1;
+static int iSlave = -1;
+static char **ppcArgv;
+
+static uint8_t aucRx[SIM_RX_BUFFER_SIZE];
+static uint32_t ulRxHead;
+static uint32_t ulRxTail;
+static uint8_t aucTx[SIM_TX_BUFFER_SIZE];
+static uint32_t ulTxLength;
+
+static uint64_t ullTicks;                 // simulated time
+static uint64_t ullSteps;
+static uint64_t ullPaceSteps;             // steps since the wall clock was last caught up with
+static uint32_t ulEventsGenerated;
+static uint16_t usPeakHigh;
+static uint16_t usPeakLow;
+static volatile sig_atomic_t bStop;
+
+static void sim_fail(const char *pcWhat)
+{
+   fprintf(stderr, "np_sim: %s: %s\n", pcWhat, strerror(errno));
+   exit(EXIT_FAILURE);
+}
+
+/***************************************************************************
+ * Traffic
+ ***************************************************************************/
+static uint32_t random_next(void)
+{
+   // xorshift32, reproducible for a given seed.
+   ulSeed ^= ulSeed << 13;
+   ulSeed ^= ulSeed >> 17;
+   ulSeed ^= ulSeed << 5;
+   return ulSeed;
+}
+
+static bool channel_receiving(uint8_t ucChannel, host_np_channel_t *pstChannel)
+{
+   return host_np_ant_channel_get(ucChannel, pstChannel) &&
+      ((pstChannel->ucStatus == STATUS_SEARCHING_CHANNEL) || (pstChannel->ucStatus == STATUS_TRACKING_CHANNEL));
+}
+
+static void event_push(uint8_t ucChannel, uint8_t ucEvent, const uint8_t *pucMessage)
+{
+   ulEventsGenerated++;
+   host_np_ant_event_push(ucChannel, ucEvent, pucMessage); // the stand-in counts what does not fit
+}
+
+// Received data message, with the device ID as extended data if the host asked for it.
+static void rx_push(uint8_t ucChannel, uint8_t ucMesgID, uint8_t ucChannelByte, uint16_t usDeviceNumber, uint8_t ucDeviceType, uint8_t ucTransmitType)
+{
+   uint8_t aucMessage[MESG_BUFFER_SIZE];
+   uint8_t ucSize = MESG_CHANNEL_NUM_SIZE + ANT_STANDARD_DATA_PAYLOAD_SIZE;
+   uint32_t ulRandom = random_next();
+
+   aucMessage[1] = ucMesgID;
+   aucMessage[2] = ucChannelByte;
+   for (uint8_t i = 0; i < ANT_STANDARD_DATA_PAYLOAD_SIZE; i++)
+      aucMessage[3 + i] = (uint8_t)(ulRandom >> ((i & 3) * 8)) ^ i;
+
+   if (host_np_ant_lib_config() & ANT_LIB_CONFIG_MESG_OUT_INC_DEVICE_ID)
+   {
+      uint8_t *pucExt = &aucMessage[MESG_SIZE_SIZE + MESG_ID_SIZE + ucSize];
+
+      pucExt[0] = ANT_EXT_MESG_BITFIELD_DEVICE_ID;
+      pucExt[1] = (uint8_t)usDeviceNumber;
+      pucExt[2] = (uint8_t)(usDeviceNumber >> 8);
+      pucExt[3] = ucDeviceType;
+      pucExt[4] = ucTransmitType;
+      ucSize += MESG_EXT_MESG_BF_SIZE + ANT_EXT_MESG_DEVICE_ID_FIELD_SIZE;
+   }
+
+   aucMessage[0] = ucSize;
+   event_push(ucChannel, EVENT_RX, aucMessage);
+}
+
+static void tx_event_push(uint8_t ucChannel)
+{
+   uint8_t aucMessage[MESG_SIZE_SIZE + MESG_ID_SIZE + MESG_RESPONSE_EVENT_SIZE];
+
+   aucMessage[0] = MESG_RESPONSE_EVENT_SIZE;
+   aucMessage[1] = MESG_RESPONSE_EVENT_ID;
+   aucMessage[2] = ucChannel;
+   aucMessage[3] = MESG_EVENT_ID;
+   aucMessage[4] = EVENT_TX;
+   event_push(ucChannel, EVENT_TX, aucMessage);
+}
+
+static uint64_t traffic_interval(const traffic_t *pstTraffic, const host_np_channel_t *pstChannel)
+{
+   if (pstTraffic->ulRateMilliHz)
+      return (SIM_TICKS_PER_SECOND * 1000 + pstTraffic->ulRateMilliHz - 1) / pstTraffic->ulRateMilliHz;
+
+   return pstChannel->usPeriod ? pstChannel->usPeriod : 1;
+}
+
+// Every open channel sends or receives once per period, masters get the
+// transmit event, slaves receive from their device.
+static void traffic_channels(traffic_t *pstTraffic)
+{
+   uint8_t ucChannels = host_np_ant_channels();
+
+   if (ucChannels > SIM_CHANNELS_MAX)
+      ucChannels = SIM_CHANNELS_MAX;
+
+   for (uint8_t ucChannel = 0; ucChannel < ucChannels; ucChannel++)
+   {
+      host_np_channel_t stChannel;
+      uint64_t *pullDue = &pstTraffic->aullDue[ucChannel];
+
+      if (!channel_receiving(ucChannel, &stChannel))
+      {
+         *pullDue = 0;
+         continue;
+      }
+
+      if (*pullDue == 0)
+         *pullDue = ullTicks + traffic_interval(pstTraffic, &stChannel); // first message one period after opening
+
+      while (*pullDue <= ullTicks)
+      {
+         if (stChannel.ucType & CHANNEL_TYPE_MASTER)
+         {
+            tx_event_push(ucChannel);
+         }
+         else
+         {
+            uint16_t usDeviceNumber = stChannel.usDeviceNumber ? stChannel.usDeviceNumber : (uint16_t)(SIM_DEVICE_NUMBER_BASE + ucChannel);
+
+            rx_push(ucChannel, MESG_BROADCAST_DATA_ID, ucChannel, usDeviceNumber,
+               stChannel.ucDeviceType ? stChannel.ucDeviceType : SIM_DEVICE_TYPE,
+               stChannel.ucTransmitType ? stChannel.ucTransmitType : SIM_TRANSMIT_TYPE);
+         }
+         *pullDue += traffic_interval(pstTraffic, &stChannel);
+      }
+   }
+}
+
+// Events due over the last step at the rate of the generator times ulSources.
+static uint32_t traffic_due(traffic_t *pstTraffic, uint32_t ulStepTicks, uint32_t ulSources)
+{
+   uint64_t ullPeriod = SIM_TICKS_PER_SECOND * 1000; // ticks * 1000 per event at 1 mHz
+   uint32_t ulDue;
+
+   pstTraffic->ullAccumulator += (uint64_t)ulStepTicks * pstTraffic->ulRateMilliHz * ulSources;
+   ulDue = (uint32_t)(pstTraffic->ullAccumulator / ullPeriod);
+   pstTraffic->ullAccumulator %= ullPeriod;
+
+   return ulDue;
+}
+
+static void traffic_devices(traffic_t *pstTraffic, uint32_t ulStepTicks)
+{
+   host_np_channel_t stChannel;
+   uint32_t ulDue = traffic_due(pstTraffic, ulStepTicks, pstTraffic->ulDevices);
+
+   if (!channel_receiving(pstTraffic->ucChannel, &stChannel))
+      return;
+
+   while (ulDue--)
+   {
+      uint32_t ulDevice = pstTraffic->ulNext;
+
+      pstTraffic->ulNext = (ulDevice + 1) % pstTraffic->ulDevices;
+      rx_push(pstTraffic->ucChannel, MESG_BROADCAST_DATA_ID, pstTraffic->ucChannel,
+         (uint16_t)(1 + ulDevice), SIM_DEVICE_TYPE, SIM_TRANSMIT_TYPE);
+   }
+}
+
+static void traffic_burst(traffic_t *pstTraffic, uint32_t ulStepTicks)
+{
+   host_np_channel_t stChannel;
+   uint32_t ulDue = traffic_due(pstTraffic, ulStepTicks, 1);
+
+   if (!channel_receiving(pstTraffic->ucChannel, &stChannel))
+      return;
+
+   while (ulDue--)
+   {
+      uint32_t ulPacket = pstTraffic->ulNext;
+      uint8_t ucSequence = SEQUENCE_FIRST_MESSAGE;
+
+      pstTraffic->ulNext = (ulPacket + 1) % SIM_BURST_PACKETS;
+      if (ulPacket)
+         ucSequence = (uint8_t)((((ulPacket - 1) % 3) + 1) * SEQUENCE_NUMBER_INC);
+      if (ulPacket == SIM_BURST_PACKETS - 1)
+         ucSequence |= SEQUENCE_LAST_MESSAGE;
+
+      rx_push(pstTraffic->ucChannel, MESG_BURST_DATA_ID, (uint8_t)(pstTraffic->ucChannel | ucSequence),
+         stChannel.usDeviceNumber, stChannel.ucDeviceType, stChannel.ucTransmitType);
+   }
+}
+
+static void traffic_generate(uint32_t ulStepTicks)
+{
+   for (uint8_t i = 0; i < ucTrafficCount; i++)
+   {
+      switch (astTraffic[i].eKind)
+      {
+         case TRAFFIC_CHANNELS:
+            traffic_channels(&astTraffic[i]);
+            break;
+
+         case TRAFFIC_DEVICES:
+            traffic_devices(&astTraffic[i], ulStepTicks);
+            break;
+
+         case TRAFFIC_BURST:
+            traffic_burst(&astTraffic[i], ulStepTicks);
+            break;
+      }
+   }
+}
+
+static uint32_t rate_parse(const char *pcRate)
+{
+   return (uint32_t)(strtod(pcRate, NULL) * 1000.0 + 0.5);
+}
+
+// channels[:HZ] | devices:CHANNEL:COUNT:HZ | burst:CHANNEL:PACKETS_PER_S
+static bool traffic_parse(const char *pcSpec)
+{
+   traffic_t *pstTraffic;
+   char acKind[16];
+   unsigned int uiChannel;
+   unsigned int uiCount;
+   char acRate[32] = "0";
+
+   if (ucTrafficCount == SIM_TRAFFIC_MAX)
+      return false;
+
+   pstTraffic = &astTraffic[ucTrafficCount];
+   memset(pstTraffic, 0, sizeof(*pstTraffic));
+
+   if (sscanf(pcSpec, "%15[a-z]", acKind) != 1)
+      return false;
+
+   if (strcmp(acKind, "channels") == 0)
+   {
+      pstTraffic->eKind = TRAFFIC_CHANNELS;
+      if (pcSpec[sizeof("channels") - 1] == ':')
+         pstTraffic->ulRateMilliHz = rate_parse(&pcSpec[sizeof("channels")]);
+   }
+   else if ((strcmp(acKind, "devices") == 0) &&
+            (sscanf(pcSpec, "devices:%u:%u:%31s", &uiChannel, &uiCount, acRate) == 3) && uiCount)
+   {
+      pstTraffic->eKind = TRAFFIC_DEVICES;
+      pstTraffic->ucChannel = (uint8_t)uiChannel;
+      pstTraffic->ulDevices = uiCount;
+      pstTraffic->ulRateMilliHz = rate_parse(acRate);
+   }
+   else if ((strcmp(acKind, "burst") == 0) &&
+            (sscanf(pcSpec, "burst:%u:%31s", &uiChannel, acRate) == 2))
+   {
+      pstTraffic->eKind = TRAFFIC_BURST;
+      pstTraffic->ucChannel = (uint8_t)uiChannel;
+      pstTraffic->ulRateMilliHz = rate_parse(acRate);
+   }
+   else
+   {
+      return false;
+   }
+
+   if ((pstTraffic->eKind != TRAFFIC_CHANNELS) && !pstTraffic->ulRateMilliHz)
+      return false;
+
+   ucTrafficCount++;
+   return true;
+}
+
+/***************************************************************************
+ * Serial line
+ ***************************************************************************/
+static void pty_open(int iInherited)
+{
+   struct termios stTermios;
+   const char *pcSlave;
+
+   iMaster = (iInherited >= 0) ? iInherited : posix_openpt(O_RDWR | O_NOCTTY);
+   if ((iMaster < 0) || (grantpt(iMaster) != 0) || (unlockpt(iMaster) != 0))
+      sim_fail("cannot create the pseudo terminal");
+
+   pcSlave = ptsname(iMaster);
+   if (pcSlave == NULL)
+      sim_fail("cannot name the pseudo terminal");
+
+   // Keeping the slave open keeps the line up between host connections.
+   iSlave = open(pcSlave, O_RDWR | O_NOCTTY);
+   if ((iSlave < 0) || (tcgetattr(iSlave, &stTermios) != 0))
+      sim_fail("cannot open the pseudo terminal");
+   cfmakeraw(&stTermios);
+   tcsetattr(iSlave, TCSANOW, &stTermios);
+   fcntl(iMaster, F_SETFL, fcntl(iMaster, F_GETFL) | O_NONBLOCK);
+
+   if (pcLink != NULL)
+   {
+      unlink(pcLink);
+      if (symlink(pcSlave, pcLink) != 0)
+         sim_fail("cannot link the pseudo terminal");
+   }
+
+   fprintf(stderr, "np_sim: serial port on %s%s%s\n", pcSlave, pcLink ? " linked as " : "", pcLink ? pcLink : "");
+}
+
+static void sink_byte(uint8_t ucByte, void *pvContext)
+{
+   (void)pvContext;
+   aucTx[ulTxLength++] = ucByte; // the pump is never given more than the room left
+}
+
+static void tx_flush(void)
+{
+   ssize_t lWritten;
+
+   if (!ulTxLength)
+      return;
+
+   lWritten = write(iMaster, aucTx, ulTxLength);
+   if (lWritten <= 0)
+      return; // nobody reads, the line backs up as with CTS deasserted
+
+   ulTxLength -= (uint32_t)lWritten;
+   memmove(aucTx, &aucTx[lWritten], ulTxLength);
+}
+
+static void rx_fill(void)
+{
+   ssize_t lRead;
+
+   if (ulRxHead != ulRxTail)
+      return; // the kernel buffer holds the rest back from the host
+
+   lRead = read(iMaster, aucRx, sizeof(aucRx));
+   ulRxHead = 0;
+   ulRxTail = (lRead > 0) ? (uint32_t)lRead : 0;
+}
+
+static uint32_t line_rate(void)
+{
+   return (ulLineRate == SIM_LINE_RATE_PROCESSOR) ? host_np_uart_baudrate() : ulLineRate;
+}
+
+// Bytes the line carries per direction over the step, the remainder carries over.
+static uint32_t line_budget(uint32_t ulRate, uint32_t *pulRemainder)
+{
+   uint64_t ullBits = (uint64_t)ulRate + *pulRemainder; // bits per second over 1 ms, in 1/1000 bits
+   uint32_t ulPerByte = SIM_BITS_PER_BYTE * SIM_STEPS_PER_SECOND;
+
+   if (ulRate == 0)
+      return UINT32_MAX;
+
+   *pulRemainder = (uint32_t)(ullBits % ulPerByte);
+   return (uint32_t)(ullBits / ulPerByte);
+}
+
+static void line_receive(uint32_t ulBudget)
+{
+   while (ulBudget)
+   {
+      uint32_t ulTaken;
+
+      rx_fill();
+      if (ulRxHead == ulRxTail)
+         return;
+
+      ulTaken = host_np_uart_rx_buffer(&aucRx[ulRxHead], (ulRxTail - ulRxHead) < ulBudget ? (ulRxTail - ulRxHead) : ulBudget);
+      ulRxHead += ulTaken;
+      ulBudget -= ulTaken;
+      if (!ulTaken)
+      {
+         // Held off by RTS, let the processor catch up.
+         host_np_run();
+         if (!host_np_uart_rts())
+            return;
+      }
+   }
+}
+
+static void line_transmit(uint32_t ulBudget)
+{
+   for (;;)
+   {
+      uint32_t ulRoom = SIM_TX_BUFFER_SIZE - ulTxLength;
+      uint32_t ulMoved = host_np_uart_tx_pump(ulBudget < ulRoom ? ulBudget : ulRoom);
+
+      ulBudget -= ulMoved;
+      host_np_run(); // queue the next frame
+      if (!ulMoved || !ulBudget)
+         break;
+   }
+
+   tx_flush();
+}
+
+/***************************************************************************
+ * Statistics
+ ***************************************************************************/
+static void levels_sample(void)
+{
+   uint16_t usHigh;
+   uint16_t usLow;
+
+   event_buffering_queue_level_get(&usHigh, &usLow);
+   if (usHigh > usPeakHigh)
+      usPeakHigh = usHigh;
+   if (usLow > usPeakLow)
+      usPeakLow = usLow;
+}
+
+static void stats_print(void)
+{
+   host_np_stats_t stStats;
+
+   host_np_stats_get(&stStats);
+   fprintf(stderr, "np_sim: time=%.3f baud=%u events=%u dropped=%u peak_sd=%u peak_high=%u peak_low=%u "
+      "tx_bytes=%u rx_bytes=%u rx_held=%u\n",
+      (double)ullTicks / SIM_TICKS_PER_SECOND, line_rate(), ulEventsGenerated, stStats.ulEventsDropped,
+      stStats.usEventsPendingPeak, usPeakHigh, usPeakLow,
+      stStats.ulUartTxBytes, stStats.ulUartRxBytes, stStats.ulUartRxRefused);
+}
+
+/***************************************************************************
+ * Main
+ ***************************************************************************/
+static void stop_handler(int iSignal)
+{
+   (void)iSignal;
+   bStop = 1;
+}
+
+// The processor cannot restart within the process: start over with the same terminal.
+static void reset_handler(void)
+{
+   struct itimerval stTimer;
+   char acFd[16];
+   char **ppcNewArgv;
+   int iArgc = 0;
+
+   tx_flush();
+   memset(&stTimer, 0, sizeof(stTimer));
+   setitimer(ITIMER_REAL, &stTimer, NULL); // the interval timer outlives exec
+
+   while (ppcArgv[iArgc] != NULL)
+      iArgc++;
+   ppcNewArgv = calloc((size_t)iArgc + 3, sizeof(char *));
+   if (ppcNewArgv == NULL)
+      exit(EXIT_FAILURE);
+
+   snprintf(acFd, sizeof(acFd), "%d", iMaster);
+   for (int i = 0; i < iArgc; i++)
+      ppcNewArgv[i] = ppcArgv[i];
+   ppcNewArgv[iArgc] = "--pty-fd";
+   ppcNewArgv[iArgc + 1] = acFd;
+
+   fprintf(stderr, "np_sim: reset\n");
+   stats_print();
+   close(iSlave);
+   execv("/proc/self/exe", ppcNewArgv);
+   sim_fail("cannot restart");
+}
+
+static uint32_t baud_strap(uint32_t ulBaudrate)
+{
+   for (size_t i = 0; i < sizeof(astBaudStrap) / sizeof(astBaudStrap[0]); i++)
+   {
+      if (astBaudStrap[i].ulBaudrate == ulBaudrate)
+         return astBaudStrap[i].ulPins;
+   }
+
+   fprintf(stderr, "np_sim: no baud rate strap for %u\n", ulBaudrate);
+   exit(EXIT_FAILURE);
+}
+
+static void usage(const char *pcName)
+{
+   fprintf(stderr,
+      "usage: %s [options]\n"
+      "  -l, --link PATH         symbolic link to the serial port\n"
+      "  -b, --baud RATE         baud rate strap: 2400, 4800, 9600, 19200, 38400, 57600 (default), 115200\n"
+      "  -r, --line-rate RATE    simulated line rate in baud, 0 for no limit (default: as set by the processor)\n"
+      "  -t, --traffic SPEC      traffic generator, may be repeated:\n"
+      "                            channels[:HZ]               every open channel, at its period or HZ\n"
+      "                            devices:CHANNEL:COUNT:HZ    COUNT devices at HZ each on CHANNEL\n"
+      "                            burst:CHANNEL:PACKETS_PER_S bursts of %u packets on CHANNEL\n"
+      "                          default: channels\n"
+      "  -s, --speed FACTOR      simulated time per wall clock time, 0 for as fast as possible (default 1)\n"
+      "  -S, --seed N            seed of the message payloads (default 1)\n"
+      "  -i, --stats SECONDS     print statistics every SECONDS of simulated time (default: at exit)\n",
+      pcName, SIM_BURST_PACKETS);
+}
+
+int main(int argc, char **argv)
+{
+   static const struct option astOptions[] =
+   {
+      {"link",      required_argument, NULL, 'l'},
+      {"baud",      required_argument, NULL, 'b'},
+      {"line-rate", required_argument, NULL, 'r'},
+      {"traffic",   required_argument, NULL, 't'},
+      {"speed",     required_argument, NULL, 's'},
+      {"seed",      required_argument, NULL, 'S'},
+      {"stats",     required_argument, NULL, 'i'},
+      {"pty-fd",    required_argument, NULL, 'F'},
+      {"help",      no_argument,       NULL, 'h'},
+      {NULL, 0, NULL, 0}
+   };
+   uint32_t ulBaudrate = SIM_DEFAULT_BAUD;
+   int iInherited = -1;
+   int iOption;
+   uint32_t ulRxRemainder = 0;
+   uint32_t ulTxRemainder = 0;
+   struct timespec stStart;
+
+   ppcArgv = argv;
+   while ((iOption = getopt_long(argc, argv, "l:b:r:t:s:S:i:h", astOptions, NULL)) != -1)
+   {
+      switch (iOption)
+      {
+         case 'l': pcLink = optarg; break;
+         case 'b': ulBaudrate = (uint32_t)strtoul(optarg, NULL, 0); break;
+         case 'r': ulLineRate = (uint32_t)strtoul(optarg, NULL, 0); break;
+         case 's': dSpeed = strtod(optarg, NULL); break;
+         case 'S': ulSeed = (uint32_t)strtoul(optarg, NULL, 0) | 1; break;
+         case 'i': ulStatsInterval = (uint32_t)strtoul(optarg, NULL, 0); break;
+         case 'F': iInherited = atoi(optarg); break;
+
+         case 't':
+            if (!traffic_parse(optarg))
+            {
+               fprintf(stderr, "np_sim: bad traffic %s\n", optarg);
+               return EXIT_FAILURE;
+            }
+            break;
+
+         default:
+            usage(argv[0]);
+            return (iOption == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+      }
+   }
+
+   if (!ucTrafficCount)
+      traffic_parse("channels");
+
+   signal(SIGINT, stop_handler);
+   signal(SIGTERM, stop_handler);
+   signal(SIGPIPE, SIG_IGN);
+   pty_open(iInherited);
+
+   host_np_init();
+   host_np_gpio_in_set(baud_strap(ulBaudrate));
+   host_np_uart_sink_set(sink_byte, NULL);
+   host_np_reset_handler_set(reset_handler);
+   host_np_boot();
+
+   clock_gettime(CLOCK_MONOTONIC, &stStart);
+
+   while (!bStop)
+   {
+      uint64_t ullNextTicks = (ullSteps + 1) * SIM_TICKS_PER_SECOND / SIM_STEPS_PER_SECOND;
+      uint32_t ulStepTicks = (uint32_t)(ullNextTicks - ullTicks);
+      uint32_t ulRate = line_rate();
+
+      if (dSpeed > 0)
+      {
+         // Keep to the wall clock, giving up on time lost when the host machine lags.
+         uint64_t ullTarget = (uint64_t)((double)(ullPaceSteps * SIM_STEP_NS) / dSpeed);
+         struct timespec stNow;
+         uint64_t ullNow;
+
+         clock_gettime(CLOCK_MONOTONIC, &stNow);
+         ullNow = (uint64_t)(stNow.tv_sec - stStart.tv_sec) * 1000000000ull + (uint64_t)stNow.tv_nsec - (uint64_t)stStart.tv_nsec;
+         if (ullNow > ullTarget + SIM_LAG_MAX_NS)
+         {
+            stStart = stNow;
+            ullPaceSteps = 0;
+         }
+         else if (ullNow < ullTarget)
+         {
+            struct timespec stSleep = {(time_t)((ullTarget - ullNow) / 1000000000ull), (long)((ullTarget - ullNow) % 1000000000ull)};
+
+            while ((nanosleep(&stSleep, &stSleep) != 0) && (errno == EINTR) && !bStop)
+               ;
+         }
+      }
+
+      line_receive(line_budget(ulRate, &ulRxRemainder));
+      traffic_generate(ulStepTicks);
+      levels_sample();
+
+      host_np_time_advance(ulStepTicks);
+      ullTicks += ulStepTicks;
+      ullSteps++;
+      ullPaceSteps++;
+      if (!host_np_run())
+         break;
+      levels_sample();
+
+      line_transmit(line_budget(ulRate, &ulTxRemainder));
+
+      if (ulStatsInterval && ((ullTicks / SIM_TICKS_PER_SECOND) != ((ullTicks - ulStepTicks) / SIM_TICKS_PER_SECOND)) &&
+          ((ullTicks / SIM_TICKS_PER_SECOND) % ulStatsInterval) == 0)
+      {
+         stats_print();
+      }
+   }
+
+   stats_print();
+   if (pcLink != NULL)
+      unlink(pcLink);
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,720 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+/*
+ * Event trace tool. Fetches the event trace (MESG_EVENT_TRACE_ID) of a
+ * network processor over its serial port, and replays saved traces through
+ * the event buffering of the host build once per buffering configuration.
+ *
+ * The replay plays the ANT stack event queue, the stack event interrupt and
+ * the main loop around event_buffering_put/claim/release: traced events
+ * arrive at their recorded time, wait in the stack queue (dropped once it is
+ * full) while a put is refused, and claimed frames are released once the
+ * serial line has sent them. Latency is measured from the arrival of an event
+ * to the end of its frame on the line.
+ *
+ * The trace does not record message payloads. Coalescing sees one device
+ * per channel and frames carry no extended data unless the traced message
+ * size includes it.
+ */
+
+#define _GNU_SOURCE // cfmakeraw
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "ant_interface.h"
+#include "ant_parameters.h"
+#include "appconfig.h"
+#include "dsi_utility.h"
+#include "event_buffering.h"
+#include "event_trace.h"
+#include "global.h"
+#include "ram_arena.h"
+#include "system.h"
+#include "host_np.h"
+
+#define REPLAY_TICKS_PER_SECOND           ((uint64_t)32768)
+#define REPLAY_NS_PER_SECOND              ((uint64_t)1000000000)
+#define REPLAY_STEP_MAX_NS                ((uint64_t)1000000) // bounds how late a flush alarm is seen
+#define REPLAY_BITS_PER_BYTE              ((uint64_t)10)      // start, 8 data, stop
+#define REPLAY_CONFIGS_MAX                16
+#define REPLAY_DEFAULT_BAUD               ((uint32_t)57600)
+// Channel block taken by the ANT stack at startup, the lanes get the rest as on the target.
+#define REPLAY_ANT_MEMORY_SIZE            ANT_ENABLE_GET_REQUIRED_SPACE(ANT_STACK_TOTAL_CHANNELS_ALLOCATED_DEFAULT, \
+   ANT_STACK_ENCRYPTED_CHANNELS_DEFAULT, ANT_STACK_TX_BURST_QUEUE_SIZE_DEFAULT, ANT_STACK_EVENT_QUEUE_NUM_EVENTS_DEFAULT)
+
+#define FETCH_TIMEOUT_MS                  1000
+#define FETCH_FRAME_MAX                   (MESG_SYNC_SIZE + MESG_BUFFER_SIZE)
+#define FETCH_REQUEST_SIZE                ((uint8_t)5) // sub ID, requested ID, sequence
+
+#define TRACE_NEXT_OFFSET                 1 // in the payload of the trace message
+#define TRACE_FIRST_OFFSET                3
+#define TRACE_COUNT_OFFSET                5
+#define TRACE_RECORDS_OFFSET              6
+
+typedef struct
+{
+   uint8_t ucConfig;
+   uint16_t usSizeThreshold;                 // bytes
+   uint16_t usTimeThreshold;                 // 10 ms
+} replay_config_t;
+
+typedef struct
+{
+   uint32_t ulEvents;
+   uint32_t ulDropped;                       // stack queue full
+   uint32_t ulStalls;                        // puts refused
+   uint64_t ullStallNs;
+   uint32_t ulFrames;
+   uint64_t ullBytes;
+   uint32_t ulUnsent;                        // frames left in the buffer at the end of the trace
+   uint16_t usStackPeak;
+   uint16_t usHighPeak;
+   uint16_t usLowPeak;
+   uint64_t ullLatencySumNs;
+   uint64_t ullLatencyMaxNs;
+} replay_result_t;
+
+static const replay_config_t astDefaultConfigs[] =
+{
+   { 0x00, 0,    0  }, // high priority events only, no buffering
+   { 0x01, 256,  0  },
+   { 0x01, 1024, 0  },
+   { 0x01, 256,  5  },
+   { 0x01, 1024, 10 },
+   { 0x81, 1024, 10 }, // coalesced broadcast events
+};
+
+static event_trace_record_t *pastTrace;
+static uint32_t ulTraceRecords;
+
+static void fail(const char *pcWhat)
+{
+   fprintf(stderr, "trace_replay: %s\n", pcWhat);
+   exit(EXIT_FAILURE);
+}
+
+// Rounded up, so the clock has reached the tick at the returned time.
+static uint64_t ticks_to_ns(uint64_t ullTicks)
+{
+   return ((ullTicks * REPLAY_NS_PER_SECOND) + REPLAY_TICKS_PER_SECOND - 1) / REPLAY_TICKS_PER_SECOND;
+}
+
+static uint32_t record_time(const event_trace_record_t *pstRecord)
+{
+   return DSI_GetULong((uint8_t *)pstRecord->aucTimestamp);
+}
+
+///////////////////////////////////////////////////////////////////////
+// Replay
+///////////////////////////////////////////////////////////////////////
+
+static void trace_load(const char *pcPath)
+{
+   FILE *pfTrace = fopen(pcPath, "rb");
+   long lSize;
+
+   if ((pfTrace == NULL) || fseek(pfTrace, 0, SEEK_END) || ((lSize = ftell(pfTrace)) < 0) || fseek(pfTrace, 0, SEEK_SET))
+      fail("cannot read the trace");
+
+   ulTraceRecords = (uint32_t)(lSize / sizeof(event_trace_record_t));
+   pastTrace = malloc(ulTraceRecords * sizeof(event_trace_record_t) + 1);
+   if ((pastTrace == NULL) || (fread(pastTrace, sizeof(event_trace_record_t), ulTraceRecords, pfTrace) != ulTraceRecords))
+      fail("cannot read the trace");
+
+   fclose(pfTrace);
+}
+
+static void trace_report(void)
+{
+   uint32_t ulEvents = 0;
+   uint32_t ulStalls = 0;
+   uint32_t ulResumes = 0;
+   uint32_t ulSpan = 0;
+
+   for (uint32_t i = 0; i < ulTraceRecords; i++)
+   {
+      if (pastTrace[i].ucSize & EVENT_TRACE_FLAG_RESUME)
+      {
+         ulResumes++;
+         continue;
+      }
+
+      ulEvents++;
+      if (pastTrace[i].ucSize & EVENT_TRACE_FLAG_STALL)
+         ulStalls++;
+   }
+
+   if (ulTraceRecords)
+      ulSpan = record_time(&pastTrace[ulTraceRecords - 1]) - record_time(&pastTrace[0]);
+
+   printf("trace records=%u events=%u span_ms=%.1f recorded_stalls=%u recorded_resumes=%u\n",
+      ulTraceRecords, ulEvents, (double)ticks_to_ns(ulSpan) / 1e6, ulStalls, ulResumes);
+}
+
+static void replay_event_build(const event_trace_record_t *pstRecord, uint32_t ulTime, ant_event_t *pstEvent)
+{
+   uint8_t ucSize = pstRecord->ucSize & EVENT_TRACE_SIZE_MASK;
+
+   if (ucSize > MESG_MAX_SIZE_VALUE)
+      ucSize = MESG_MAX_SIZE_VALUE;
+
+   memset(pstEvent, 0, sizeof(*pstEvent));
+   pstEvent->stHeader.ucChannel = pstRecord->ucChannel & CHANNEL_NUMBER_MASK;
+   pstEvent->stHeader.ucEvent = pstRecord->ucEvent;
+   DSI_PutULong(ulTime, pstEvent->stHeader.aucTimestamp);
+   pstEvent->stMessage.ANT_MESSAGE_ucSize = ucSize;
+   pstEvent->stMessage.ANT_MESSAGE_ucMesgID = pstRecord->ucMesgID;
+   pstEvent->stMessage.ANT_MESSAGE_ucChannel = pstRecord->ucChannel; // with the burst sequence number
+}
+
+static void replay_levels_update(replay_result_t *pstResult, uint16_t usStackLevel)
+{
+   uint16_t usHigh;
+   uint16_t usLow;
+
+   event_buffering_queue_level_get(&usHigh, &usLow);
+   if (usHigh > pstResult->usHighPeak)
+      pstResult->usHighPeak = usHigh;
+   if (usLow > pstResult->usLowPeak)
+      pstResult->usLowPeak = usLow;
+   if (usStackLevel > pstResult->usStackPeak)
+      pstResult->usStackPeak = usStackLevel;
+}
+
+static void replay_run(const replay_config_t *pstConfig, uint32_t ulBaud, uint16_t usStackQueue, uint8_t ucDrainWeight,
+   bool bTimestamp, bool bAggregation, replay_result_t *pstResult)
+{
+   uint32_t *pulStack = malloc(usStackQueue * sizeof(uint32_t)); // queued trace records
+   uint16_t usStackHead = 0;
+   uint16_t usStackLevel = 0;
+   ant_event_t stHeld;                       // event refused by the last put
+   bool bStalled = false;
+   uint64_t ullStallStart = 0;
+   bool bSending = false;
+   uint64_t ullLineFree = 0;
+   event_lane_t eSendingLane = EVENT_LANE_HIGH;
+   uint16_t usSendingRecord = 0;
+   uint32_t ulSendingTime = 0;
+   uint64_t ullNow = 0;
+   uint64_t ullTicks = 0;                    // ticks of ullNow handed to the clock
+   uint32_t ulBase;
+   uint32_t ulFirst = ulTraceRecords ? record_time(&pastTrace[0]) : 0;
+   uint32_t i = 0;
+
+   if (pulStack == NULL)
+      fail("out of memory");
+
+   memset(pstResult, 0, sizeof(*pstResult));
+
+   // Start from empty lanes sized as at startup.
+   event_buffering_config_set(0, 0, 0);
+   ram_arena_reset(REPLAY_ANT_MEMORY_SIZE);
+   event_buffering_init();
+   event_buffering_config_set(pstConfig->ucConfig, pstConfig->usSizeThreshold, pstConfig->usTimeThreshold);
+   event_buffering_drain_weight_set(ucDrainWeight);
+   event_buffering_timestamp_set(bTimestamp);
+   event_buffering_burst_aggregation_set(bAggregation);
+   ulBase = System_GetTime_32K();
+
+   while (true)
+   {
+      ant_event_hdr_t stHeader;
+      mc_fifo_span_t stFrame;
+      event_lane_t eLane;
+      uint16_t usRecordSize;
+      uint16_t usHigh;
+      uint16_t usLow;
+      uint64_t ullNext;
+
+      // Events reach the stack queue.
+      while ((i < ulTraceRecords) && (ticks_to_ns((uint32_t)(record_time(&pastTrace[i]) - ulFirst)) <= ullNow))
+      {
+         if (!(pastTrace[i].ucSize & EVENT_TRACE_FLAG_RESUME))
+         {
+            pstResult->ulEvents++;
+            if (usStackLevel == usStackQueue)
+               pstResult->ulDropped++;
+            else
+               pulStack[(uint16_t)(usStackHead + usStackLevel++) % usStackQueue] = i;
+         }
+         i++;
+      }
+
+      // Main loop retry of the held event.
+      if (bStalled && event_buffering_put(&stHeld))
+      {
+         bStalled = false;
+         pstResult->ullStallNs += ullNow - ullStallStart;
+      }
+
+      // Stack event interrupt.
+      while (!bStalled && usStackLevel)
+      {
+         const event_trace_record_t *pstRecord = &pastTrace[pulStack[usStackHead]];
+
+         replay_event_build(pstRecord, ulBase + (uint32_t)(record_time(pstRecord) - ulFirst), &stHeld);
+         usStackHead = (uint16_t)(usStackHead + 1) % usStackQueue;
+         usStackLevel--;
+         if (!event_buffering_put(&stHeld))
+         {
+            bStalled = true;
+            ullStallStart = ullNow;
+            pstResult->ulStalls++;
+         }
+      }
+
+      (void)event_buffering_tick();
+      replay_levels_update(pstResult, usStackLevel);
+
+      // Serial line, one frame at a time.
+      if (bSending && (ullNow >= ullLineFree))
+      {
+         uint64_t ullLatency = ullNow - ticks_to_ns((uint32_t)(ulSendingTime - ulBase));
+
+         event_buffering_release(eSendingLane, usSendingRecord);
+         bSending = false;
+         pstResult->ulFrames++;
+         pstResult->ullLatencySumNs += ullLatency;
+         if (ullLatency > pstResult->ullLatencyMaxNs)
+            pstResult->ullLatencyMaxNs = ullLatency;
+         continue; // the released space may take a held event
+      }
+
+      if (!bSending && event_buffering_claim(&stHeader, &stFrame, &eLane, &usRecordSize))
+      {
+         uint64_t ullBytes = stFrame.uiLen[0] + stFrame.uiLen[1];
+
+         pstResult->ullBytes += ullBytes;
+         ullLineFree = ullNow + (ullBytes * REPLAY_BITS_PER_BYTE * REPLAY_NS_PER_SECOND) / ulBaud;
+         eSendingLane = eLane;
+         usSendingRecord = usRecordSize;
+         ulSendingTime = DSI_GetULong(stHeader.aucTimestamp);
+         bSending = true;
+         continue;
+      }
+
+      event_buffering_queue_level_get(&usHigh, &usLow);
+
+      // Done once everything that can go out went out. Events left waiting
+      // for a flush that only more events would trigger are counted.
+      if ((i == ulTraceRecords) && !usStackLevel && !bStalled && !bSending && (!usLow || (pstConfig->usTimeThreshold == 0)))
+      {
+         event_buffering_flush();
+         while (event_buffering_claim(&stHeader, &stFrame, &eLane, &usRecordSize))
+         {
+            pstResult->ulUnsent++;
+            event_buffering_release(eLane, usRecordSize);
+         }
+         break;
+      }
+
+      // Move on to the next arrival or the end of the frame on the line, in
+      // steps short enough to see flush alarms while events are buffered.
+      ullNext = UINT64_MAX;
+      if (i < ulTraceRecords)
+         ullNext = ticks_to_ns((uint32_t)(record_time(&pastTrace[i]) - ulFirst));
+      if (bSending && (ullLineFree < ullNext))
+         ullNext = ullLineFree;
+      if ((usLow || bStalled) && (ullNow + REPLAY_STEP_MAX_NS < ullNext))
+         ullNext = ullNow + REPLAY_STEP_MAX_NS;
+
+      ullNow = ullNext;
+      if ((ullNow * REPLAY_TICKS_PER_SECOND) / REPLAY_NS_PER_SECOND > ullTicks)
+      {
+         uint64_t ullTarget = (ullNow * REPLAY_TICKS_PER_SECOND) / REPLAY_NS_PER_SECOND;
+
+         host_np_time_advance((uint32_t)(ullTarget - ullTicks));
+         ullTicks = ullTarget;
+         System_Tick();
+      }
+   }
+
+   free(pulStack);
+}
+
+static void replay_report(const replay_config_t *pstConfig, uint32_t ulBaud, const replay_result_t *pstResult)
+{
+   printf("replay config=0x%02X size=%u time=%u baud=%u events=%u dropped=%u stalls=%u stall_ms=%.1f "
+      "peak_stack=%u peak_high=%u peak_low=%u frames=%u bytes=%llu unsent=%u latency_avg_ms=%.2f latency_max_ms=%.2f\n",
+      pstConfig->ucConfig, pstConfig->usSizeThreshold, pstConfig->usTimeThreshold, ulBaud,
+      pstResult->ulEvents, pstResult->ulDropped, pstResult->ulStalls, (double)pstResult->ullStallNs / 1e6,
+      pstResult->usStackPeak, pstResult->usHighPeak, pstResult->usLowPeak,
+      pstResult->ulFrames, (unsigned long long)pstResult->ullBytes, pstResult->ulUnsent,
+      pstResult->ulFrames ? ((double)pstResult->ullLatencySumNs / pstResult->ulFrames) / 1e6 : 0.0,
+      (double)pstResult->ullLatencyMaxNs / 1e6);
+}
+
+///////////////////////////////////////////////////////////////////////
+// Fetch
+///////////////////////////////////////////////////////////////////////
+
+static int fetch_port_open(const char *pcPort, uint32_t ulBaud)
+{
+   struct termios stTermios;
+   speed_t tSpeed;
+   int iFd = open(pcPort, O_RDWR | O_NOCTTY);
+
+   switch (ulBaud)
+   {
+      case 2400:   tSpeed = B2400;   break;
+      case 4800:   tSpeed = B4800;   break;
+      case 9600:   tSpeed = B9600;   break;
+      case 19200:  tSpeed = B19200;  break;
+      case 38400:  tSpeed = B38400;  break;
+      case 57600:  tSpeed = B57600;  break;
+      case 115200: tSpeed = B115200; break;
+      default:     fail("unsupported baud rate");
+   }
+
+   if ((iFd < 0) || tcgetattr(iFd, &stTermios))
+      fail("cannot open the serial port");
+
+   cfmakeraw(&stTermios);
+   cfsetspeed(&stTermios, tSpeed);
+   stTermios.c_cflag |= CRTSCTS;
+   if (tcsetattr(iFd, TCSANOW, &stTermios))
+      fail("cannot set up the serial port");
+
+   return iFd;
+}
+
+// Send a message: size, message ID and message data.
+static void fetch_send(int iFd, uint8_t *pucMessage)
+{
+   uint8_t aucFrame[FETCH_FRAME_MAX];
+   uint8_t ucLength = pucMessage[0] + MESG_SIZE_SIZE + MESG_ID_SIZE;
+
+   aucFrame[0] = MESG_TX_SYNC;
+   memcpy(&aucFrame[MESG_SYNC_SIZE], pucMessage, ucLength);
+   aucFrame[MESG_SYNC_SIZE + ucLength] = DSI_CheckSum(pucMessage, ucLength, MESG_TX_SYNC);
+
+   if (write(iFd, aucFrame, MESG_SYNC_SIZE + ucLength + MESG_CHECKSUM_SIZE) != (ssize_t)(MESG_SYNC_SIZE + ucLength + MESG_CHECKSUM_SIZE))
+      fail("serial port write failed");
+}
+
+// Receive the next message with a good checksum: size, message ID and message data.
+static bool fetch_receive(int iFd, uint8_t *pucMessage)
+{
+   static uint8_t aucBuffer[FETCH_FRAME_MAX * 4];
+   static uint32_t ulLevel;
+
+   while (true)
+   {
+      struct pollfd stPoll = { iFd, POLLIN, 0 };
+      ssize_t lRead;
+
+      // Drop bytes up to a sync byte, then look for a whole frame.
+      while (ulLevel && (aucBuffer[0] != MESG_TX_SYNC))
+         memmove(aucBuffer, &aucBuffer[1], --ulLevel);
+
+      if ((ulLevel > MESG_SIZE_SIZE) && (aucBuffer[MESG_SYNC_SIZE] > MESG_MAX_SIZE_VALUE))
+      {
+         memmove(aucBuffer, &aucBuffer[1], --ulLevel);
+         continue;
+      }
+
+      if (ulLevel > MESG_SIZE_SIZE)
+      {
+         uint8_t ucLength = aucBuffer[MESG_SYNC_SIZE] + MESG_SIZE_SIZE + MESG_ID_SIZE;
+         uint32_t ulFrame = MESG_SYNC_SIZE + ucLength + MESG_CHECKSUM_SIZE;
+
+         if (ulLevel >= ulFrame)
+         {
+            bool bGood = (DSI_CheckSum(&aucBuffer[MESG_SYNC_SIZE], ucLength, MESG_TX_SYNC) == aucBuffer[MESG_SYNC_SIZE + ucLength]);
+
+            if (bGood)
+               memcpy(pucMessage, &aucBuffer[MESG_SYNC_SIZE], ucLength);
+            else
+               ulFrame = MESG_SYNC_SIZE; // not a frame, look for the next sync byte
+
+            ulLevel -= ulFrame;
+            memmove(aucBuffer, &aucBuffer[ulFrame], ulLevel);
+            if (bGood)
+               return true;
+            continue;
+         }
+      }
+
+      if (poll(&stPoll, 1, FETCH_TIMEOUT_MS) <= 0)
+         return false;
+
+      lRead = read(iFd, &aucBuffer[ulLevel], sizeof(aucBuffer) - ulLevel);
+      if ((lRead < 0) && (errno != EINTR) && (errno != EAGAIN))
+         fail("serial port read failed");
+      if (lRead > 0)
+         ulLevel += (uint32_t)lRead;
+   }
+}
+
+static void fetch_config_set(int iFd, uint8_t ucConfig)
+{
+   uint8_t aucMessage[MESG_BUFFER_SIZE] =
+   {
+      MESG_EVENT_TRACE_CONFIG_SIZE, (uint8_t)(MESG_EVENT_TRACE_ID >> 8), (uint8_t)MESG_EVENT_TRACE_ID, ucConfig
+   };
+
+   fetch_send(iFd, aucMessage);
+
+   while (fetch_receive(iFd, aucMessage))
+   {
+      ANT_MESSAGE *pstMessage = (ANT_MESSAGE *)aucMessage;
+
+      if ((pstMessage->ANT_MESSAGE_ucMesgID == (uint8_t)(MESG_EXT_RESPONSE_ID >> 8)) &&
+         (pstMessage->ANT_MESSAGE_ucSubID == (uint8_t)MESG_EXT_RESPONSE_ID) &&
+         (pstMessage->ANT_MESSAGE_aucPayload[0] == (uint8_t)(MESG_EVENT_TRACE_ID >> 8)) &&
+         (pstMessage->ANT_MESSAGE_aucPayload[1] == (uint8_t)MESG_EVENT_TRACE_ID))
+      {
+         if (pstMessage->ANT_MESSAGE_aucPayload[2] != RESPONSE_NO_ERROR)
+            fail("trace configuration refused");
+         return;
+      }
+   }
+
+   fail("no response to the trace configuration");
+}
+
+// Request trace records from a sequence number, or from the oldest one held.
+static void fetch_request(int iFd, bool bSequence, uint16_t usSequence, ANT_MESSAGE *pstMessage)
+{
+   uint8_t aucRequest[MESG_BUFFER_SIZE] =
+   {
+      FETCH_REQUEST_SIZE, (uint8_t)(MESG_EXT_REQUEST_ID >> 8), (uint8_t)MESG_EXT_REQUEST_ID,
+      (uint8_t)(MESG_EVENT_TRACE_ID >> 8), (uint8_t)MESG_EVENT_TRACE_ID
+   };
+
+   if (bSequence)
+      DSI_PutUShort(usSequence, &aucRequest[5]);
+   else
+      aucRequest[0] -= sizeof(usSequence);
+
+   fetch_send(iFd, aucRequest);
+
+   while (fetch_receive(iFd, pstMessage->aucMessage))
+   {
+      if ((pstMessage->ANT_MESSAGE_ucMesgID == (uint8_t)(MESG_EVENT_TRACE_ID >> 8)) &&
+         (pstMessage->ANT_MESSAGE_ucSubID == (uint8_t)MESG_EVENT_TRACE_ID))
+         return;
+
+      if (pstMessage->ANT_MESSAGE_ucMesgID == MESG_RESPONSE_EVENT_ID)
+         fail("trace request refused, event trace not supported");
+   }
+
+   fail("no response to the trace request");
+}
+
+static void fetch(int iFd, const char *pcPath)
+{
+   FILE *pfTrace = fopen(pcPath, "wb");
+   ANT_MESSAGE stMessage;
+   uint16_t usSequence;
+   uint16_t usEnd;
+   uint32_t ulRecords = 0;
+   uint32_t ulMissed = 0;
+   uint8_t ucConfig;
+   uint8_t ucCount;
+
+   if (pfTrace == NULL)
+      fail("cannot write the trace");
+
+   fetch_request(iFd, false, 0, &stMessage);
+   ucConfig = stMessage.ANT_MESSAGE_aucPayload[0];
+   usEnd = DSI_GetUShort(&stMessage.ANT_MESSAGE_aucPayload[TRACE_NEXT_OFFSET]); // records written later are left out
+   usSequence = DSI_GetUShort(&stMessage.ANT_MESSAGE_aucPayload[TRACE_FIRST_OFFSET]);
+
+   while (true)
+   {
+      uint16_t usFirst = DSI_GetUShort(&stMessage.ANT_MESSAGE_aucPayload[TRACE_FIRST_OFFSET]);
+
+      ucCount = stMessage.ANT_MESSAGE_aucPayload[TRACE_COUNT_OFFSET];
+      if ((uint16_t)(usFirst - usSequence) > (uint16_t)(usEnd - usSequence))
+         break; // trace cleared in the meantime
+
+      ulMissed += (uint16_t)(usFirst - usSequence); // overwritten before they were fetched
+      usSequence = usFirst;
+      if ((uint16_t)(usEnd - usSequence) < ucCount)
+         ucCount = (uint8_t)(usEnd - usSequence);
+      if (fwrite(&stMessage.ANT_MESSAGE_aucPayload[TRACE_RECORDS_OFFSET], EVENT_TRACE_RECORD_SIZE, ucCount, pfTrace) != ucCount)
+         fail("cannot write the trace");
+
+      ulRecords += ucCount;
+      usSequence += ucCount;
+      if ((ucCount == 0) || (usSequence == usEnd))
+         break;
+
+      fetch_request(iFd, true, usSequence, &stMessage);
+   }
+
+   fclose(pfTrace);
+   printf("fetched records=%u missed=%u config=0x%02X\n", ulRecords, ulMissed, ucConfig);
+}
+
+///////////////////////////////////////////////////////////////////////
+// Options
+///////////////////////////////////////////////////////////////////////
+
+static void usage(const char *pcName)
+{
+   fprintf(stderr,
+      "usage: %s [options] TRACE            replay a saved trace\n"
+      "       %s -p PORT [-a CONFIG] [-o TRACE]  configure and/or fetch the trace of a network processor\n"
+      "  -c, --config MODE:SIZE:TIME   event buffering configuration to replay, may be repeated:\n"
+      "                                mode as in the event buffering message, size threshold in bytes,\n"
+      "                                time threshold in 10 ms (default: a sweep)\n"
+      "  -b, --baud RATE               serial line rate (default %u)\n"
+      "  -q, --stack-queue EVENTS      ANT stack event queue size (default %u)\n"
+      "  -w, --drain-weight N          event buffering drain weight (default %u)\n"
+      "  -T, --timestamp               append event timestamps\n"
+      "  -A, --aggregate               aggregate received bursts\n"
+      "  -p, --port PORT               serial port of the network processor\n"
+      "  -a, --arm CONFIG              set the trace configuration, which clears it: 1 to record,\n"
+      "                                3 to stop half a trace after stack events stall, 0 to stop\n"
+      "  -o, --output TRACE            fetch the trace to a file\n",
+      pcName, pcName, REPLAY_DEFAULT_BAUD, ANT_STACK_EVENT_QUEUE_NUM_EVENTS_DEFAULT, DEFAULT_EVENT_BUFFERING_DRAIN_WEIGHT);
+}
+
+int main(int argc, char **argv)
+{
+   static const struct option astOptions[] =
+   {
+      {"config",       required_argument, NULL, 'c'},
+      {"baud",         required_argument, NULL, 'b'},
+      {"stack-queue",  required_argument, NULL, 'q'},
+      {"drain-weight", required_argument, NULL, 'w'},
+      {"timestamp",    no_argument,       NULL, 'T'},
+      {"aggregate",    no_argument,       NULL, 'A'},
+      {"port",         required_argument, NULL, 'p'},
+      {"arm",          required_argument, NULL, 'a'},
+      {"output",       required_argument, NULL, 'o'},
+      {"help",         no_argument,       NULL, 'h'},
+      {NULL,           0,                 NULL, 0}
+   };
+   replay_config_t astConfigs[REPLAY_CONFIGS_MAX];
+   uint8_t ucConfigs = 0;
+   uint32_t ulBaud = REPLAY_DEFAULT_BAUD;
+   uint16_t usStackQueue = ANT_STACK_EVENT_QUEUE_NUM_EVENTS_DEFAULT;
+   uint8_t ucDrainWeight = DEFAULT_EVENT_BUFFERING_DRAIN_WEIGHT;
+   bool bTimestamp = false;
+   bool bAggregation = false;
+   const char *pcPort = NULL;
+   const char *pcOutput = NULL;
+   int iArm = -1;
+   int iOption;
+
+   while ((iOption = getopt_long(argc, argv, "c:b:q:w:TAp:a:o:h", astOptions, NULL)) != -1)
+   {
+      switch (iOption)
+      {
+         case 'c':
+         {
+            int iMode;
+            unsigned int uiSize;
+            unsigned int uiTime;
+
+            if ((ucConfigs == REPLAY_CONFIGS_MAX) || (sscanf(optarg, "%i:%u:%u", &iMode, &uiSize, &uiTime) != 3) ||
+               (iMode < 0) || (iMode > 0xFF) || (uiSize > 0xFFFF) || (uiTime > 0xFFFF))
+               fail("bad buffering configuration");
+
+            astConfigs[ucConfigs].ucConfig = (uint8_t)iMode;
+            astConfigs[ucConfigs].usSizeThreshold = (uint16_t)uiSize;
+            astConfigs[ucConfigs].usTimeThreshold = (uint16_t)uiTime;
+            ucConfigs++;
+            break;
+         }
+         case 'b':
+            ulBaud = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+         case 'q':
+            usStackQueue = (uint16_t)strtoul(optarg, NULL, 0);
+            break;
+         case 'w':
+            ucDrainWeight = (uint8_t)strtoul(optarg, NULL, 0);
+            break;
+         case 'T':
+            bTimestamp = true;
+            break;
+         case 'A':
+            bAggregation = true;
+            break;
+         case 'p':
+            pcPort = optarg;
+            break;
+         case 'a':
+            iArm = (int)strtol(optarg, NULL, 0);
+            break;
+         case 'o':
+            pcOutput = optarg;
+            break;
+         default:
+            usage(argv[0]);
+            return (iOption == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+      }
+   }
+
+   if (pcPort != NULL)
+   {
+      int iFd;
+
+      if ((iArm < 0) && (pcOutput == NULL))
+      {
+         usage(argv[0]);
+         return EXIT_FAILURE;
+      }
+
+      iFd = fetch_port_open(pcPort, ulBaud);
+      if (pcOutput != NULL)
+         fetch(iFd, pcOutput);
+      if (iArm >= 0)
+         fetch_config_set(iFd, (uint8_t)iArm);
+      close(iFd);
+      return EXIT_SUCCESS;
+   }
+
+   if ((optind != argc - 1) || (ulBaud == 0) || (usStackQueue == 0))
+   {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   if (ucConfigs == 0)
+   {
+      memcpy(astConfigs, astDefaultConfigs, sizeof(astDefaultConfigs));
+      ucConfigs = sizeof(astDefaultConfigs) / sizeof(replay_config_t);
+   }
+
+   trace_load(argv[optind]);
+   trace_report();
+
+   // The event buffering runs on its own, against the clock of the stand-ins.
+   host_np_init();
+   ram_arena_init(aucANTChannelBlock, sizeof(aucANTChannelBlock), REPLAY_ANT_MEMORY_SIZE);
+   System_Init();
+   event_buffering_init();
+
+   for (uint8_t i = 0; i < ucConfigs; i++)
+   {
+      replay_result_t stResult;
+
+      replay_run(&astConfigs[i], ulBaud, usStackQueue, ucDrainWeight, bTimestamp, bAggregation, &stResult);
+      replay_report(&astConfigs[i], ulBaud, &stResult);
+   }
+
+   free(pastTrace);
+   return EXIT_SUCCESS;
+}
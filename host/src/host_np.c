@@ -0,0 +1,163 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+/*
+ * Runs the network processor main loop in a context of its own. Control comes
+ * back to the host whenever the processor waits for events. A timer signal
+ * stands in for the interrupts that a processor busy waiting on hardware
+ * (flash, serial) relies on.
+ */
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <ucontext.h>
+
+#include "nrf.h"
+#include "nrf_soc.h"
+#include "host_np.h"
+
+#define NP_STACK_SIZE                     ((size_t)(256 * 1024))
+#define NP_SERVICE_PERIOD_US              250
+// Timer periods the processor may run without waiting for events before the
+// hardware is serviced from the signal, it is then taken to be busy waiting.
+#define NP_BUSY_PERIODS                   2
+
+extern int np_main(void);
+void host_np_service_async(void);
+
+static ucontext_t stHostContext;
+static ucontext_t stNPContext;
+static uint8_t *pucNPStack;
+static volatile bool bNPStarted;
+static volatile bool bNPRunning;                // processor context is executing
+static volatile uint8_t ucBusyPeriods;
+static host_np_reset_handler_t pfResetHandler;
+
+static void np_entry(void)
+{
+   np_main();
+   fprintf(stderr, "host_np: np_main returned\n");
+   bNPStarted = false;
+   bNPRunning = false;
+}
+
+static void np_signal_handler(int iSignal)
+{
+   (void)iSignal;
+
+   if (!bNPRunning)
+      return; // the host services the hardware itself between runs
+
+   if (++ucBusyPeriods >= NP_BUSY_PERIODS)
+      host_np_service_async();
+}
+
+static void np_timer_start(void)
+{
+   struct sigaction stAction;
+   struct itimerval stTimer;
+
+   memset(&stAction, 0, sizeof(stAction));
+   stAction.sa_handler = np_signal_handler;
+   stAction.sa_flags = SA_RESTART;
+   sigemptyset(&stAction.sa_mask);
+   sigaction(SIGALRM, &stAction, NULL);
+
+   stTimer.it_interval.tv_sec = 0;
+   stTimer.it_interval.tv_usec = NP_SERVICE_PERIOD_US;
+   stTimer.it_value = stTimer.it_interval;
+   setitimer(ITIMER_REAL, &stTimer, NULL);
+}
+
+void host_np_boot(void)
+{
+   if (bNPStarted)
+      return;
+
+   pucNPStack = malloc(NP_STACK_SIZE);
+   if (pucNPStack == NULL)
+   {
+      fprintf(stderr, "host_np: out of memory\n");
+      exit(EXIT_FAILURE);
+   }
+
+   getcontext(&stNPContext);
+   stNPContext.uc_stack.ss_sp = pucNPStack;
+   stNPContext.uc_stack.ss_size = NP_STACK_SIZE;
+   stNPContext.uc_link = &stHostContext;
+   makecontext(&stNPContext, np_entry, 0);
+
+   np_timer_start();
+   bNPStarted = true;
+   host_np_run();
+}
+
+bool host_np_run(void)
+{
+   if (!bNPStarted)
+      return false;
+
+   ucBusyPeriods = 0;
+   bNPRunning = true;
+   swapcontext(&stHostContext, &stNPContext);
+   bNPRunning = false;
+
+   return bNPStarted;
+}
+
+void host_np_settle(void)
+{
+   do
+   {
+      host_np_service();
+      host_np_run();
+   } while (host_np_uart_tx_pump(HOST_NP_UART_TX_UNLIMITED));
+}
+
+void host_np_service(void)
+{
+   host_np_uart_tx_pump(HOST_NP_UART_TX_UNLIMITED);
+   host_np_sd_service();
+   host_np_irq_dispatch();
+}
+
+void host_np_reset_handler_set(host_np_reset_handler_t pfHandler)
+{
+   pfResetHandler = pfHandler;
+}
+
+/**
+ * The processor waits for events: hand control back to the host.
+ */
+uint32_t sd_app_evt_wait(void)
+{
+   if (bNPRunning)
+   {
+      bNPRunning = false;
+      swapcontext(&stNPContext, &stHostContext);
+      bNPRunning = true;
+      ucBusyPeriods = 0;
+   }
+
+   return NRF_SUCCESS;
+}
+
+void NVIC_SystemReset(void)
+{
+   if (pfResetHandler != NULL)
+      pfResetHandler();
+
+   fprintf(stderr, "host_np: system reset requested\n");
+   exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,550 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+/*
+ * Host stand-ins for the nRF52 peripherals used by the network processor and
+ * the interrupt controller. Register blocks are plain memory, the models pick
+ * up what the processor wrote whenever they are serviced.
+ *
+ * Writes to the interrupt enable set/clear registers overwrite each other, so
+ * the UART takes its interrupt enables from the state the serial driver keeps
+ * them in step with: TXDRDY while the UART is enabled, RXDRDY while RTS is
+ * assigned to it.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nrf.h"
+#include "nrf_delay.h"
+#include "nrf_error.h"
+#include "nrf_nvic.h"
+#include "nrf_soc.h"
+#include "host_np.h"
+
+// Read only registers are initialized through this.
+#define HOST_REG(reg)                     (*(uint32_t *)&(reg))
+
+// TXD holds this while the transmitter is idle, any byte written shows below it.
+#define UART_TXD_EMPTY                    ((uint32_t)0xFFFFFFFF)
+#define UART_PSELRTS_DISCONNECTED         ((uint32_t)0xFFFFFFFF)
+#define UART_ENABLED                      (UART_ENABLE_ENABLE_Enabled << UART_ENABLE_ENABLE_Pos)
+#define UART_INT_RXDRDY                   (UART_INTENSET_RXDRDY_Set << UART_INTENSET_RXDRDY_Pos)
+#define UART_INT_TXDRDY                   (UART_INTENSET_TXDRDY_Set << UART_INTENSET_TXDRDY_Pos)
+
+#define RTC_COUNTER_MASK                  ((uint32_t)0x00FFFFFF)
+#define RTC_CC_NUM                        4
+
+#define NVIC_PRIORITY_THREAD              ((uint32_t)0x100)
+
+NRF_GPIO_Type    stHostGPIO;
+NRF_GPIOTE_Type  stHostGPIOTE;
+NRF_UART_Type    stHostUART0;
+NRF_SPI_Type     stHostSPI0;
+NRF_SPIM_Type    stHostSPIM0;
+NRF_TIMER_Type   astHostTimer[4];
+NRF_RTC_Type     stHostRTC1;
+NRF_FICR_Type    stHostFICR;
+NRF_UICR_Type    stHostUICR;
+SCB_Type         stHostSCB;
+CoreDebug_Type   stHostCoreDebug;
+uint8_t          aucHostFlash[HOST_FLASH_PAGES * HOST_FLASH_PAGE_SIZE] __attribute__((aligned(HOST_FLASH_PAGE_SIZE)));
+
+// Handlers of the network processor, resolved at link time.
+extern void UART0_IRQHandler(void) __attribute__((weak));
+extern void UARTE0_UART0_IRQHandler(void) __attribute__((weak));
+extern void GPIOTE_IRQHandler(void) __attribute__((weak));
+extern void TIMER1_IRQHandler(void) __attribute__((weak));
+extern void TIMER2_IRQHandler(void) __attribute__((weak));
+extern void TIMER3_IRQHandler(void) __attribute__((weak));
+extern void RTC1_IRQHandler(void) __attribute__((weak));
+extern void SWI0_IRQHandler(void) __attribute__((weak));
+extern void RADIO_NOTIFICATION_IRQHandler(void) __attribute__((weak));
+extern void SD_EVT_IRQHandler(void) __attribute__((weak));
+
+static void (*apfIRQHandler[HOST_IRQn_COUNT])(void);
+
+static volatile uint32_t ulIRQEnabled;
+static volatile uint32_t ulIRQPending;
+static uint32_t aulIRQPriority[HOST_IRQn_COUNT];
+static volatile uint32_t ulActivePriority;      // priority of the handler running, thread level if none
+static volatile bool bCriticalRegion;
+static volatile uint32_t ulLockDepth;           // model state is being changed, interrupts are held off
+static volatile bool bServiceDeferred;          // service came in while interrupts were held off
+
+static host_np_uart_sink_t pfUARTSink;
+static void *pvUARTSinkContext;
+static uint32_t ulUARTTxBytes;
+static uint32_t ulUARTRxBytes;
+static uint32_t ulUARTRxRefused;
+
+static uint32_t ulRTCCounter;                   // 24 bit RTC1 counter
+static uint32_t ulRTCTime;                      // free running tick count
+
+static void irq_handlers_init(void)
+{
+   memset(apfIRQHandler, 0, sizeof(apfIRQHandler));
+   apfIRQHandler[UARTE0_UART0_IRQn] = UART0_IRQHandler ? UART0_IRQHandler : UARTE0_UART0_IRQHandler;
+   apfIRQHandler[GPIOTE_IRQn] = GPIOTE_IRQHandler;
+   apfIRQHandler[TIMER1_IRQn] = TIMER1_IRQHandler;
+   apfIRQHandler[TIMER2_IRQn] = TIMER2_IRQHandler;
+   apfIRQHandler[TIMER3_IRQn] = TIMER3_IRQHandler;
+   apfIRQHandler[RTC1_IRQn] = RTC1_IRQHandler;
+   apfIRQHandler[SWI0_IRQn] = SWI0_IRQHandler;
+   apfIRQHandler[RADIO_NOTIFICATION_IRQn] = RADIO_NOTIFICATION_IRQHandler;
+   apfIRQHandler[SD_EVT_IRQn] = SD_EVT_IRQHandler;
+}
+
+/***************************************************************************
+ * Interrupt controller
+ ***************************************************************************/
+void host_np_lock(void)
+{
+   ulLockDepth++;
+}
+
+void host_np_unlock(void)
+{
+   if (--ulLockDepth)
+      return;
+
+   if (bServiceDeferred && !bCriticalRegion)
+   {
+      bServiceDeferred = false;
+      host_np_service();
+   }
+}
+
+// Show the interrupt enables the UART runs with, as reading the registers would.
+static void uart_inten_sync(void)
+{
+   uint32_t ulInten = 0;
+
+   if (stHostUART0.ENABLE == UART_ENABLED)
+      ulInten |= UART_INT_TXDRDY;
+   if (host_np_uart_rts())
+      ulInten |= UART_INT_RXDRDY;
+
+   stHostUART0.INTENSET = ulInten;
+   stHostUART0.INTENCLR = ulInten;
+}
+
+/**
+ * Take the highest priority pending interrupt that may preempt what is
+ * running, until there is none left.
+ */
+void host_np_irq_dispatch(void)
+{
+   for (;;)
+   {
+      uint32_t ulReady;
+      uint32_t ulBest = HOST_IRQn_COUNT;
+      uint32_t ulPrevious;
+      uint32_t ulIRQ;
+
+      if (ulLockDepth || bCriticalRegion)
+         return;
+
+      host_np_lock();
+      ulReady = ulIRQPending & ulIRQEnabled;
+      for (ulIRQ = 0; ulReady; ulIRQ++, ulReady >>= 1)
+      {
+         if ((ulReady & 1) && (aulIRQPriority[ulIRQ] < ulActivePriority) &&
+             ((ulBest == HOST_IRQn_COUNT) || (aulIRQPriority[ulIRQ] < aulIRQPriority[ulBest])))
+            ulBest = ulIRQ;
+      }
+
+      if (ulBest == HOST_IRQn_COUNT)
+      {
+         host_np_unlock(); // a service held off meanwhile dispatches on its own
+         return;
+      }
+
+      ulIRQPending &= ~(1UL << ulBest);
+      ulPrevious = ulActivePriority;
+      ulActivePriority = aulIRQPriority[ulBest];
+      if (ulBest == UARTE0_UART0_IRQn)
+         uart_inten_sync();
+      ulLockDepth--;
+
+      if (apfIRQHandler[ulBest] != NULL)
+         apfIRQHandler[ulBest]();
+
+      host_np_lock();
+      ulActivePriority = ulPrevious;
+      host_np_unlock();
+   }
+}
+
+/**
+ * Pend an interrupt from the hardware side, it is taken when allowed.
+ */
+bool host_np_irq_raise(IRQn_Type eIRQn)
+{
+   host_np_lock();
+   ulIRQPending |= (1UL << eIRQn);
+   host_np_unlock();
+   host_np_irq_dispatch();
+   return true;
+}
+
+uint32_t sd_nvic_EnableIRQ(IRQn_Type IRQn)
+{
+   host_np_lock();
+   ulIRQEnabled |= (1UL << IRQn);
+   host_np_unlock();
+   host_np_irq_dispatch();
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_nvic_DisableIRQ(IRQn_Type IRQn)
+{
+   host_np_lock();
+   ulIRQEnabled &= ~(1UL << IRQn);
+   host_np_unlock();
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_nvic_GetPendingIRQ(IRQn_Type IRQn, uint32_t *p_pending_irq)
+{
+   *p_pending_irq = (ulIRQPending >> IRQn) & 1;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_nvic_SetPendingIRQ(IRQn_Type IRQn)
+{
+   return host_np_irq_raise(IRQn) ? NRF_SUCCESS : NRF_ERROR_INVALID_PARAM;
+}
+
+uint32_t sd_nvic_ClearPendingIRQ(IRQn_Type IRQn)
+{
+   host_np_lock();
+   ulIRQPending &= ~(1UL << IRQn);
+   host_np_unlock();
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_nvic_SetPriority(IRQn_Type IRQn, uint32_t priority)
+{
+   aulIRQPriority[IRQn] = priority;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_nvic_GetPriority(IRQn_Type IRQn, uint32_t *p_priority)
+{
+   *p_priority = aulIRQPriority[IRQn];
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_nvic_SystemReset(void)
+{
+   NVIC_SystemReset();
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_nvic_critical_region_enter(uint8_t *p_is_nested_critical_region)
+{
+   *p_is_nested_critical_region = bCriticalRegion;
+   bCriticalRegion = true;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_nvic_critical_region_exit(uint8_t is_nested_critical_region)
+{
+   if (is_nested_critical_region)
+      return NRF_SUCCESS;
+
+   bCriticalRegion = false;
+   host_np_lock();
+   host_np_unlock(); // picks up a service that was held off
+   host_np_irq_dispatch();
+   return NRF_SUCCESS;
+}
+
+/***************************************************************************
+ * Pins
+ ***************************************************************************/
+void host_np_gpio_in_set(uint32_t ulPins)
+{
+   HOST_REG(stHostGPIO.IN) = ulPins;
+}
+
+/***************************************************************************
+ * Serial port, legacy UART0
+ ***************************************************************************/
+uint32_t host_np_uart_tx_pump(uint32_t ulMaxBytes)
+{
+   uint32_t ulBytes = 0;
+
+   while (ulBytes < ulMaxBytes)
+   {
+      uint32_t ulTxd;
+
+      host_np_lock();
+      ulTxd = stHostUART0.TXD;
+      if (ulTxd == UART_TXD_EMPTY)
+      {
+         host_np_unlock();
+         break;
+      }
+
+      stHostUART0.TXD = UART_TXD_EMPTY;
+      stHostUART0.EVENTS_TXDRDY = 1;
+      ulUARTTxBytes++;
+      ulBytes++;
+      if (pfUARTSink != NULL)
+         pfUARTSink((uint8_t)ulTxd, pvUARTSinkContext);
+
+      if (stHostUART0.ENABLE == UART_ENABLED)
+         ulIRQPending |= (1UL << UARTE0_UART0_IRQn);
+      host_np_unlock();
+      host_np_irq_dispatch(); // the handler queues the next byte
+   }
+
+   return ulBytes;
+}
+
+bool host_np_uart_rts(void)
+{
+   return stHostUART0.PSELRTS != UART_PSELRTS_DISCONNECTED;
+}
+
+bool host_np_uart_rx(uint8_t ucByte)
+{
+   host_np_lock();
+   if ((stHostUART0.ENABLE != UART_ENABLED) || !host_np_uart_rts() || stHostUART0.EVENTS_RXDRDY)
+   {
+      ulUARTRxRefused++;
+      host_np_unlock();
+      return false;
+   }
+
+   HOST_REG(stHostUART0.RXD) = ucByte;
+   stHostUART0.EVENTS_RXDRDY = 1;
+   ulUARTRxBytes++;
+   ulIRQPending |= (1UL << UARTE0_UART0_IRQn);
+   host_np_unlock();
+   host_np_irq_dispatch();
+   return true;
+}
+
+uint32_t host_np_uart_rx_buffer(const uint8_t *pucData, uint32_t ulSize)
+{
+   uint32_t ulTaken = 0;
+
+   while ((ulTaken < ulSize) && host_np_uart_rx(pucData[ulTaken]))
+      ulTaken++;
+
+   return ulTaken;
+}
+
+uint32_t host_np_uart_baudrate(void)
+{
+   static const struct
+   {
+      uint32_t ulRegister;
+      uint32_t ulBaud;
+   } astBaud[] =
+   {
+      {UART_BAUDRATE_BAUDRATE_Baud1200, 1200},
+      {UART_BAUDRATE_BAUDRATE_Baud2400, 2400},
+      {UART_BAUDRATE_BAUDRATE_Baud4800, 4800},
+      {UART_BAUDRATE_BAUDRATE_Baud9600, 9600},
+      {UART_BAUDRATE_BAUDRATE_Baud19200, 19200},
+      {UART_BAUDRATE_BAUDRATE_Baud38400, 38400},
+      {UART_BAUDRATE_BAUDRATE_Baud57600, 57600},
+      {UART_BAUDRATE_BAUDRATE_Baud115200, 115200},
+      {UART_BAUDRATE_BAUDRATE_Baud230400, 230400},
+      {UART_BAUDRATE_BAUDRATE_Baud460800, 460800},
+      {UART_BAUDRATE_BAUDRATE_Baud921600, 921600},
+   };
+   uint32_t i;
+
+   for (i = 0; i < sizeof(astBaud) / sizeof(astBaud[0]); i++)
+   {
+      if (astBaud[i].ulRegister == stHostUART0.BAUDRATE)
+         return astBaud[i].ulBaud;
+   }
+
+   // Unlisted value, the register holds baud * 2^32 / 16 MHz.
+   return (uint32_t)(((uint64_t)stHostUART0.BAUDRATE * 16000000ull) >> 32);
+}
+
+void host_np_uart_sink_set(host_np_uart_sink_t pfSink, void *pvContext)
+{
+   host_np_lock();
+   pfUARTSink = pfSink;
+   pvUARTSinkContext = pvContext;
+   host_np_unlock();
+}
+
+/***************************************************************************
+ * Cycle counter, DWT
+ ***************************************************************************/
+static DWT_Type stHostDWT;
+static uint32_t ulDWTOffset;                    // host cycles to cycle count
+
+// The counter runs off the host cycle counter while the processor has it
+// enabled. A value the processor wrote is picked up on the next access.
+DWT_Type *host_np_dwt(void)
+{
+   static uint32_t ulDWTLast;
+   uint32_t ulNow = (uint32_t)host_np_cycles();
+
+   if (stHostDWT.CYCCNT != ulDWTLast)
+      ulDWTOffset = stHostDWT.CYCCNT - ulNow;
+
+   if ((stHostDWT.CTRL & DWT_CTRL_CYCCNTENA_Msk) && (stHostCoreDebug.DEMCR & CoreDebug_DEMCR_TRCENA_Msk))
+      stHostDWT.CYCCNT = ulNow + ulDWTOffset;
+   else
+      ulDWTOffset = stHostDWT.CYCCNT - ulNow; // stopped, resumes from where it is
+
+   ulDWTLast = stHostDWT.CYCCNT;
+   return &stHostDWT;
+}
+
+/***************************************************************************
+ * Low frequency clock, RTC1
+ ***************************************************************************/
+// Tasks take effect on the next clock edge, they are picked up here.
+static void rtc_tasks_update(void)
+{
+   if (stHostRTC1.TASKS_CLEAR)
+   {
+      stHostRTC1.TASKS_CLEAR = 0;
+      ulRTCCounter = 0;
+      HOST_REG(stHostRTC1.COUNTER) = 0;
+   }
+   stHostRTC1.TASKS_START = 0;
+   stHostRTC1.TASKS_STOP = 0;
+}
+
+void host_np_time_advance(uint32_t ulTicks)
+{
+   uint32_t ulCC;
+
+   host_np_lock();
+   rtc_tasks_update();
+
+   // The counter keeps running while stopped as far as the processor can
+   // tell, it only stops the RTC to clear it.
+   for (ulCC = 0; ulCC < RTC_CC_NUM; ulCC++)
+   {
+      uint32_t ulDistance = (stHostRTC1.CC[ulCC] - ulRTCCounter - 1) & RTC_COUNTER_MASK;
+
+      if ((ulTicks > ulDistance) && (ulTicks - ulDistance <= RTC_COUNTER_MASK + 1))
+         stHostRTC1.EVENTS_COMPARE[ulCC] = 1;
+   }
+   if (ulRTCCounter + (uint64_t)ulTicks > RTC_COUNTER_MASK)
+      stHostRTC1.EVENTS_OVRFLW = 1;
+
+   ulRTCCounter = (ulRTCCounter + ulTicks) & RTC_COUNTER_MASK;
+   ulRTCTime += ulTicks;
+   HOST_REG(stHostRTC1.COUNTER) = ulRTCCounter;
+
+   if (stHostRTC1.EVENTS_OVRFLW || stHostRTC1.EVENTS_COMPARE[0])
+      ulIRQPending |= (1UL << RTC1_IRQn);
+   host_np_unlock();
+   host_np_irq_dispatch();
+}
+
+uint32_t host_np_time_get(void)
+{
+   return ulRTCTime;
+}
+
+void nrf_delay_us(uint32_t number_of_us)
+{
+   (void)number_of_us;
+   host_np_lock();
+   rtc_tasks_update();
+   host_np_unlock();
+}
+
+/***************************************************************************
+ * Power on state
+ ***************************************************************************/
+void host_np_init(void)
+{
+   host_np_lock();
+   memset(&stHostGPIO, 0, sizeof(stHostGPIO));
+   memset(&stHostGPIOTE, 0, sizeof(stHostGPIOTE));
+   memset(&stHostUART0, 0, sizeof(stHostUART0));
+   memset(astHostTimer, 0, sizeof(astHostTimer));
+   memset(&stHostRTC1, 0, sizeof(stHostRTC1));
+   memset(&stHostSCB, 0, sizeof(stHostSCB));
+   memset(&stHostCoreDebug, 0, sizeof(stHostCoreDebug));
+   memset(&stHostDWT, 0, sizeof(stHostDWT));
+   memset(aucHostFlash, 0xFF, sizeof(aucHostFlash));
+   memset(&stHostUICR, 0xFF, sizeof(stHostUICR));
+
+   HOST_REG(stHostFICR.CODEPAGESIZE) = HOST_FLASH_PAGE_SIZE;
+   HOST_REG(stHostFICR.CODESIZE) = 128;
+   HOST_REG(stHostFICR.DEVICEID[0]) = 0x484F5354; // "HOST"
+   HOST_REG(stHostFICR.DEVICEID[1]) = 0x4E503532; // "NP52"
+
+   stHostUART0.TXD = UART_TXD_EMPTY;
+   stHostUART0.PSELRTS = UART_PSELRTS_DISCONNECTED;
+   stHostUART0.BAUDRATE = UART_BAUDRATE_BAUDRATE_Baud57600;
+   ulUARTTxBytes = 0;
+   ulUARTRxBytes = 0;
+   ulUARTRxRefused = 0;
+
+   ulRTCCounter = 0;
+   ulRTCTime = 0;
+
+   irq_handlers_init();
+   ulIRQEnabled = 0;
+   ulIRQPending = 0;
+   memset(aulIRQPriority, 0, sizeof(aulIRQPriority));
+   ulActivePriority = NVIC_PRIORITY_THREAD;
+   bCriticalRegion = false;
+   bServiceDeferred = false;
+
+   host_np_sd_reset();
+   host_np_unlock();
+}
+
+void host_np_stats_get(host_np_stats_t *pstStats)
+{
+   memset(pstStats, 0, sizeof(*pstStats));
+   host_np_lock();
+   pstStats->ulUartTxBytes = ulUARTTxBytes;
+   pstStats->ulUartRxBytes = ulUARTRxBytes;
+   pstStats->ulUartRxRefused = ulUARTRxRefused;
+   host_np_sd_stats_get(pstStats);
+   host_np_unlock();
+}
+
+void host_np_stats_clear(void)
+{
+   host_np_lock();
+   ulUARTTxBytes = 0;
+   ulUARTRxBytes = 0;
+   ulUARTRxRefused = 0;
+   host_np_sd_stats_clear();
+   host_np_unlock();
+}
+
+/**
+ * Signal handler side of the service: held off like an interrupt.
+ */
+void host_np_service_async(void)
+{
+   if (ulLockDepth || bCriticalRegion)
+   {
+      bServiceDeferred = true;
+      return;
+   }
+
+   host_np_service();
+}
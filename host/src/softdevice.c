@@ -0,0 +1,920 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+/*
+ * Host stand-in for the ANT SoftDevice. Channel configuration is kept so it
+ * can be read back and checked for state, nothing goes on air: protocol
+ * events come from the host through host_np_ant_event_push. Flash operations
+ * are applied at once and reported complete on the next service, as the
+ * processor waits for the SoC event like on the target.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "nrf.h"
+#include "nrf_error.h"
+#include "nrf_nvic.h"
+#include "nrf_sdm.h"
+#include "nrf_soc.h"
+#include "ant_error.h"
+#include "ant_interface.h"
+#include "ant_parameters.h"
+#include "host_np.h"
+
+#define SD_CHANNELS_MAX                   ((uint8_t)16)
+#define SD_CHANNELS_DEFAULT               ((uint8_t)8) // until sd_ant_enable is called
+#define SD_NETWORKS                       ((uint8_t)8)
+#define SD_NETWORK_KEY_SIZE               ((uint8_t)8)
+#define SD_SOC_EVENT_QUEUE_SIZE           ((uint8_t)8)
+#define SD_ENCRYPTION_KEYS                ((uint8_t)4)
+#define SD_ENCRYPTION_KEY_SIZE            ((uint8_t)16)
+#define SD_SDU_MASKS                      ((uint8_t)8)
+#define SD_SDU_MASK_SIZE                  ((uint8_t)8)
+
+#define SD_VERSION_STRING                 "HOSTNP0.00"
+
+typedef struct
+{
+   uint8_t ucStatus;
+   uint8_t ucType;
+   uint8_t ucNetwork;
+   uint8_t ucExtAssign;
+   uint16_t usDeviceNumber;
+   uint8_t ucDeviceType;
+   uint8_t ucTransmitType;
+   uint16_t usPeriod;
+   uint8_t ucFreq;
+   uint8_t ucCRCMode;
+   uint8_t ucSearchSharingCycles;
+} sd_channel_t;
+
+typedef struct
+{
+   uint8_t ucChannel;
+   uint8_t ucEvent;
+   uint8_t aucMessage[MESG_BUFFER_SIZE];
+} sd_event_t;
+
+static bool bEnabled;
+static uint8_t ucChannels;
+static sd_channel_t astChannel[SD_CHANNELS_MAX];
+static uint8_t aaucNetworkKey[SD_NETWORKS][SD_NETWORK_KEY_SIZE];
+static uint8_t ucLibConfig;
+static uint16_t usEventFilter;
+static ANT_HIGH_DUTY_SEARCH_CONFIG stHighDutySearch;
+static uint8_t aucAdvBurstConfig[MESG_CONFIG_ADV_BURST_REQ_CONFIG_SIZE];
+static uint8_t aaucCryptoKey[SD_ENCRYPTION_KEYS][SD_ENCRYPTION_KEY_SIZE];
+static uint8_t aucCryptoID[MESG_CONFIG_ENCRYPT_REQ_CONFIG_ID_SIZE - 1];
+static uint8_t aucCryptoUserData[MESG_CONFIG_ENCRYPT_REQ_CONFIG_USER_DATA_SIZE - 1];
+static uint8_t aaucSduMask[SD_SDU_MASKS][SD_SDU_MASK_SIZE];
+static uint8_t ucRFActiveMode;
+static uint16_t usRFActiveThreshold;
+static ANT_PA_LNA_CONFIG stPALNAConfig;
+
+static sd_event_t astEventQueue[HOST_NP_ANT_EVENT_QUEUE_SIZE];
+static uint16_t usEventHead;
+static uint16_t usEventTail;
+
+static uint32_t aulSocEvent[SD_SOC_EVENT_QUEUE_SIZE];
+static uint8_t ucSocEventHead;
+static uint8_t ucSocEventTail;
+static bool bFlashPending;
+static bool bFlashFailed;
+
+static uint32_t ulResetReason;
+static host_np_stats_t stStats;
+
+static sd_channel_t *channel_get(uint8_t ucChannel);
+
+/***************************************************************************
+ * Host side
+ ***************************************************************************/
+void host_np_sd_reset(void)
+{
+   bEnabled = false;
+   ucChannels = 0;
+   memset(astChannel, 0, sizeof(astChannel));
+   usEventHead = 0;
+   usEventTail = 0;
+   ucSocEventHead = 0;
+   ucSocEventTail = 0;
+   bFlashPending = false;
+   bFlashFailed = false;
+   ulResetReason = POWER_RESETREAS_RESETPIN_Msk;
+   memset(&stStats, 0, sizeof(stStats));
+}
+
+bool host_np_ant_event_push(uint8_t ucChannel, uint8_t ucEvent, const uint8_t *pucMessage)
+{
+   sd_event_t *pstEvent;
+   uint16_t usPending;
+
+   host_np_lock();
+   usPending = (uint16_t)(usEventHead - usEventTail);
+   if (!bEnabled || (usPending >= HOST_NP_ANT_EVENT_QUEUE_SIZE))
+   {
+      stStats.ulEventsDropped++;
+      host_np_unlock();
+      return false;
+   }
+
+   pstEvent = &astEventQueue[usEventHead % HOST_NP_ANT_EVENT_QUEUE_SIZE];
+   pstEvent->ucChannel = ucChannel;
+   pstEvent->ucEvent = ucEvent;
+   memcpy(pstEvent->aucMessage, pucMessage, MESG_SIZE_SIZE + MESG_ID_SIZE + pucMessage[0]);
+   usEventHead++;
+
+   // A searching channel has found its master once it receives.
+   if ((ucEvent == EVENT_RX) && (ucChannel < ucChannels) && (astChannel[ucChannel].ucStatus == STATUS_SEARCHING_CHANNEL))
+      astChannel[ucChannel].ucStatus = STATUS_TRACKING_CHANNEL;
+
+   stStats.ulEventsQueued++;
+   if (++usPending > stStats.usEventsPendingPeak)
+      stStats.usEventsPendingPeak = usPending;
+   host_np_unlock();
+
+   host_np_irq_raise(SD_EVT_IRQn);
+   return true;
+}
+
+uint8_t host_np_ant_channels(void)
+{
+   return ucChannels;
+}
+
+bool host_np_ant_channel_get(uint8_t ucChannel, host_np_channel_t *pstChannel)
+{
+   const sd_channel_t *pstSdChannel = channel_get(ucChannel);
+
+   if (pstSdChannel == NULL)
+      return false;
+
+   host_np_lock();
+   pstChannel->ucStatus = pstSdChannel->ucStatus;
+   pstChannel->ucType = pstSdChannel->ucType;
+   pstChannel->usPeriod = pstSdChannel->usPeriod;
+   pstChannel->usDeviceNumber = pstSdChannel->usDeviceNumber;
+   pstChannel->ucDeviceType = pstSdChannel->ucDeviceType;
+   pstChannel->ucTransmitType = pstSdChannel->ucTransmitType;
+   host_np_unlock();
+   return true;
+}
+
+uint8_t host_np_ant_lib_config(void)
+{
+   return ucLibConfig;
+}
+
+static void soc_event_push(uint32_t ulEvent)
+{
+   if ((uint8_t)(ucSocEventHead - ucSocEventTail) < SD_SOC_EVENT_QUEUE_SIZE)
+      aulSocEvent[ucSocEventHead++ % SD_SOC_EVENT_QUEUE_SIZE] = ulEvent;
+}
+
+void host_np_sd_service(void)
+{
+   host_np_lock();
+   if (bFlashPending)
+   {
+      bFlashPending = false;
+      soc_event_push(bFlashFailed ? NRF_EVT_FLASH_OPERATION_ERROR : NRF_EVT_FLASH_OPERATION_SUCCESS);
+      host_np_unlock();
+      host_np_irq_raise(SD_EVT_IRQn);
+      return;
+   }
+   host_np_unlock();
+}
+
+void host_np_sd_stats_get(host_np_stats_t *pstStats)
+{
+   pstStats->ulEventsQueued = stStats.ulEventsQueued;
+   pstStats->ulEventsDropped = stStats.ulEventsDropped;
+   pstStats->usEventsPending = (uint16_t)(usEventHead - usEventTail);
+   pstStats->usEventsPendingPeak = stStats.usEventsPendingPeak;
+   pstStats->ulFlashOperations = stStats.ulFlashOperations;
+}
+
+void host_np_sd_stats_clear(void)
+{
+   memset(&stStats, 0, sizeof(stStats));
+}
+
+/***************************************************************************
+ * SoftDevice manager and SoC
+ ***************************************************************************/
+uint32_t sd_softdevice_enable(nrf_clock_lf_cfg_t const *p_clock_lf_cfg, nrf_fault_handler_t fault_handler, const char *p_license_key)
+{
+   (void)p_clock_lf_cfg;
+   (void)fault_handler;
+   (void)p_license_key;
+
+   host_np_lock();
+   bEnabled = true;
+   ucChannels = SD_CHANNELS_DEFAULT;
+   memset(astChannel, 0, sizeof(astChannel));
+   usEventTail = usEventHead;
+   host_np_unlock();
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_softdevice_disable(void)
+{
+   host_np_lock();
+   bEnabled = false;
+   usEventTail = usEventHead; // events of the stack are gone with it
+   host_np_unlock();
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_evt_get(uint32_t *p_evt_id)
+{
+   uint32_t ulResult = NRF_ERROR_NOT_FOUND;
+
+   host_np_lock();
+   if (ucSocEventTail != ucSocEventHead)
+   {
+      *p_evt_id = aulSocEvent[ucSocEventTail++ % SD_SOC_EVENT_QUEUE_SIZE];
+      ulResult = NRF_SUCCESS;
+   }
+   host_np_unlock();
+   return ulResult;
+}
+
+uint32_t sd_clock_hfclk_request(void)
+{
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_clock_hfclk_release(void)
+{
+   return NRF_SUCCESS;
+}
+
+// Flash and UICR live in host memory, pages are found back from the low address bits.
+static bool flash_range_valid(const void *pvDest, uint32_t ulBytes)
+{
+   const uint8_t *pucDest = pvDest;
+
+   if ((pucDest >= aucHostFlash) && (pucDest + ulBytes <= aucHostFlash + HOST_FLASH_PAGES * HOST_FLASH_PAGE_SIZE))
+      return true;
+
+   return (pucDest >= (const uint8_t *)&stHostUICR) && (pucDest + ulBytes <= (const uint8_t *)(&stHostUICR + 1));
+}
+
+uint32_t sd_flash_write(uint32_t *p_dst, uint32_t const *p_src, uint32_t size)
+{
+   uint32_t i;
+
+   if (bFlashPending)
+      return NRF_ERROR_BUSY;
+
+   if (((uintptr_t)p_dst & 0x03) || !flash_range_valid(p_dst, size * sizeof(uint32_t)))
+      return NRF_ERROR_INVALID_ADDR;
+
+   host_np_lock();
+   for (i = 0; i < size; i++)
+      p_dst[i] &= p_src[i]; // bits can only be programmed to 0
+   bFlashFailed = false;
+   bFlashPending = true;
+   stStats.ulFlashOperations++;
+   host_np_unlock();
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_flash_page_erase(uint32_t page_number)
+{
+   uint32_t ulPage;
+
+   if (bFlashPending)
+      return NRF_ERROR_BUSY;
+
+   for (ulPage = 0; ulPage < HOST_FLASH_PAGES; ulPage++)
+   {
+      uint8_t *pucPage = &aucHostFlash[ulPage * HOST_FLASH_PAGE_SIZE];
+
+      if ((uint32_t)(uintptr_t)pucPage / HOST_FLASH_PAGE_SIZE == page_number)
+      {
+         host_np_lock();
+         memset(pucPage, 0xFF, HOST_FLASH_PAGE_SIZE);
+         bFlashFailed = false;
+         bFlashPending = true;
+         stStats.ulFlashOperations++;
+         host_np_unlock();
+         return NRF_SUCCESS;
+      }
+   }
+
+   return NRF_ERROR_INVALID_ADDR;
+}
+
+uint32_t sd_power_reset_reason_get(uint32_t *p_reset_reason)
+{
+   *p_reset_reason = ulResetReason;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_power_reset_reason_clr(uint32_t reset_reason_clr_msk)
+{
+   ulResetReason &= ~reset_reason_clr_msk;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_power_system_off(void)
+{
+   NVIC_SystemReset(); // wakes up through reset
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_power_dcdc_mode_set(uint8_t dcdc_mode)
+{
+   (void)dcdc_mode;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ppi_channel_assign(uint8_t channel_num, const volatile void *evt_endpoint, const volatile void *task_endpoint)
+{
+   (void)channel_num;
+   (void)evt_endpoint;
+   (void)task_endpoint;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ppi_channel_enable_set(uint32_t channel_enable_set_msk)
+{
+   (void)channel_enable_set_msk;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ppi_channel_enable_clr(uint32_t channel_enable_clr_msk)
+{
+   (void)channel_enable_clr_msk;
+   return NRF_SUCCESS;
+}
+
+/***************************************************************************
+ * ANT stack
+ ***************************************************************************/
+static sd_channel_t *channel_get(uint8_t ucChannel)
+{
+   return (ucChannel < ucChannels) ? &astChannel[ucChannel] : NULL;
+}
+
+static bool channel_open(const sd_channel_t *pstChannel)
+{
+   return (pstChannel->ucStatus == STATUS_SEARCHING_CHANNEL) || (pstChannel->ucStatus == STATUS_TRACKING_CHANNEL);
+}
+
+// Queue an event generated by the stack itself, as a response to a command.
+static void channel_event_push(uint8_t ucChannel, uint8_t ucEvent)
+{
+   uint8_t aucMessage[MESG_SIZE_SIZE + MESG_ID_SIZE + MESG_RESPONSE_EVENT_SIZE];
+
+   aucMessage[0] = MESG_RESPONSE_EVENT_SIZE;
+   aucMessage[1] = MESG_RESPONSE_EVENT_ID;
+   aucMessage[2] = ucChannel;
+   aucMessage[3] = MESG_EVENT_ID;
+   aucMessage[4] = ucEvent;
+   host_np_ant_event_push(ucChannel, ucEvent, aucMessage);
+}
+
+uint32_t sd_ant_enable(ANT_ENABLE *const pstANTEnableParameters)
+{
+   if ((pstANTEnableParameters->ucTotalNumberOfChannels == 0) ||
+       (pstANTEnableParameters->ucTotalNumberOfChannels > SD_CHANNELS_MAX))
+      return NRF_ERROR_INVALID_PARAM;
+
+   ucChannels = pstANTEnableParameters->ucTotalNumberOfChannels;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_stack_reset(void)
+{
+   host_np_lock();
+   memset(astChannel, 0, sizeof(astChannel));
+   usEventTail = usEventHead;
+   ucLibConfig = 0;
+   host_np_unlock();
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_event_get(uint8_t *pucChannel, uint8_t *pucEvent, uint8_t *aucANTMesg)
+{
+   const sd_event_t *pstEvent;
+
+   host_np_lock();
+   if (usEventTail == usEventHead)
+   {
+      host_np_unlock();
+      return NRF_ERROR_NOT_FOUND;
+   }
+
+   pstEvent = &astEventQueue[usEventTail % HOST_NP_ANT_EVENT_QUEUE_SIZE];
+   *pucChannel = pstEvent->ucChannel;
+   *pucEvent = pstEvent->ucEvent;
+   memcpy(aucANTMesg, pstEvent->aucMessage, MESG_SIZE_SIZE + MESG_ID_SIZE + pstEvent->aucMessage[0]);
+   usEventTail++;
+   host_np_unlock();
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_capabilities_get(uint8_t *pucCapabilities)
+{
+   memset(pucCapabilities, 0, MESG_CAPABILITIES_SIZE);
+   pucCapabilities[0] = ucChannels;
+   pucCapabilities[1] = SD_NETWORKS;
+   pucCapabilities[3] = CAPABILITIES_SERIAL_NUMBER_ENABLED;
+   pucCapabilities[4] = CAPABILITIES_EVENT_BUFFERING_ENABLED;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_version_get(uint8_t *aucVersion)
+{
+   memcpy(aucVersion, SD_VERSION_STRING, sizeof(SD_VERSION_STRING));
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_channel_assign(uint8_t ucChannel, uint8_t ucChannelType, uint8_t ucNetwork, uint8_t ucExtAssign)
+{
+   sd_channel_t *pstChannel = channel_get(ucChannel);
+
+   if (pstChannel == NULL)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+   if (ucNetwork >= SD_NETWORKS)
+      return NRF_ANT_ERROR_INVALID_NETWORK_NUMBER;
+   if (pstChannel->ucStatus != STATUS_UNASSIGNED_CHANNEL)
+      return NRF_ANT_ERROR_CHANNEL_IN_WRONG_STATE;
+
+   memset(pstChannel, 0, sizeof(*pstChannel));
+   pstChannel->ucStatus = STATUS_ASSIGNED_CHANNEL;
+   pstChannel->ucType = ucChannelType;
+   pstChannel->ucNetwork = ucNetwork;
+   pstChannel->ucExtAssign = ucExtAssign;
+   pstChannel->usPeriod = 8192;
+   pstChannel->ucFreq = 66;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_channel_unassign(uint8_t ucChannel)
+{
+   sd_channel_t *pstChannel = channel_get(ucChannel);
+
+   if (pstChannel == NULL)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+   if (pstChannel->ucStatus != STATUS_ASSIGNED_CHANNEL)
+      return NRF_ANT_ERROR_CHANNEL_IN_WRONG_STATE;
+
+   pstChannel->ucStatus = STATUS_UNASSIGNED_CHANNEL;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_channel_open_with_offset(uint8_t ucChannel, uint16_t usOffset)
+{
+   sd_channel_t *pstChannel = channel_get(ucChannel);
+
+   (void)usOffset;
+   if (pstChannel == NULL)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+   if (pstChannel->ucStatus != STATUS_ASSIGNED_CHANNEL)
+      return NRF_ANT_ERROR_CHANNEL_IN_WRONG_STATE;
+
+   // Masters track right away, slaves search until something is received.
+   pstChannel->ucStatus = (pstChannel->ucType & CHANNEL_TYPE_MASTER) ? STATUS_TRACKING_CHANNEL : STATUS_SEARCHING_CHANNEL;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_channel_open(uint8_t ucChannel)
+{
+   return sd_ant_channel_open_with_offset(ucChannel, 0);
+}
+
+uint32_t sd_ant_channel_close(uint8_t ucChannel)
+{
+   sd_channel_t *pstChannel = channel_get(ucChannel);
+
+   if (pstChannel == NULL)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+   if (!channel_open(pstChannel))
+      return NRF_ANT_ERROR_CHANNEL_NOT_OPENED;
+
+   pstChannel->ucStatus = STATUS_ASSIGNED_CHANNEL;
+   channel_event_push(ucChannel, EVENT_CHANNEL_CLOSED);
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_channel_status_get(uint8_t ucChannel, uint8_t *pucStatus)
+{
+   sd_channel_t *pstChannel = channel_get(ucChannel);
+
+   if (pstChannel == NULL)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+
+   *pucStatus = pstChannel->ucStatus | ((pstChannel->ucNetwork & 0x03) << 2) | (pstChannel->ucType & 0xF0);
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_channel_id_set(uint8_t ucChannel, uint16_t usDeviceNumber, uint8_t ucDeviceType, uint8_t ucTransmitType)
+{
+   sd_channel_t *pstChannel = channel_get(ucChannel);
+
+   if (pstChannel == NULL)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+   if (pstChannel->ucStatus == STATUS_UNASSIGNED_CHANNEL)
+      return NRF_ANT_ERROR_CHANNEL_IN_WRONG_STATE;
+
+   pstChannel->usDeviceNumber = usDeviceNumber;
+   pstChannel->ucDeviceType = ucDeviceType;
+   pstChannel->ucTransmitType = ucTransmitType;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_channel_id_get(uint8_t ucChannel, uint16_t *pusDeviceNumber, uint8_t *pucDeviceType, uint8_t *pucTransmitType)
+{
+   sd_channel_t *pstChannel = channel_get(ucChannel);
+
+   if (pstChannel == NULL)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+
+   *pusDeviceNumber = pstChannel->usDeviceNumber;
+   *pucDeviceType = pstChannel->ucDeviceType;
+   *pucTransmitType = pstChannel->ucTransmitType;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_channel_period_set(uint8_t ucChannel, uint16_t usPeriod)
+{
+   sd_channel_t *pstChannel = channel_get(ucChannel);
+
+   if (pstChannel == NULL)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+
+   pstChannel->usPeriod = usPeriod;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_channel_radio_freq_set(uint8_t ucChannel, uint8_t ucFreq)
+{
+   sd_channel_t *pstChannel = channel_get(ucChannel);
+
+   if (pstChannel == NULL)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+
+   pstChannel->ucFreq = ucFreq;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_channel_radio_tx_power_set(uint8_t ucChannel, uint8_t ucTxPower, uint8_t ucCustomTxPower)
+{
+   (void)ucTxPower;
+   (void)ucCustomTxPower;
+   return channel_get(ucChannel) ? NRF_SUCCESS : NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+}
+
+uint32_t sd_ant_channel_rx_search_timeout_set(uint8_t ucChannel, uint8_t ucTimeout)
+{
+   (void)ucTimeout;
+   return channel_get(ucChannel) ? NRF_SUCCESS : NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+}
+
+uint32_t sd_ant_channel_low_priority_rx_search_timeout_set(uint8_t ucChannel, uint8_t ucTimeout)
+{
+   (void)ucTimeout;
+   return channel_get(ucChannel) ? NRF_SUCCESS : NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+}
+
+uint32_t sd_ant_channel_radio_crc_mode_set(uint8_t ucChannel, uint8_t ucMode)
+{
+   sd_channel_t *pstChannel = channel_get(ucChannel);
+
+   if (pstChannel == NULL)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+
+   pstChannel->ucCRCMode = ucMode;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_channel_radio_crc_mode_get(uint8_t ucChannel, uint8_t *pucMode)
+{
+   sd_channel_t *pstChannel = channel_get(ucChannel);
+
+   if (pstChannel == NULL)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+
+   *pucMode = pstChannel->ucCRCMode;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_network_address_set(uint8_t ucNetwork, uint8_t *pucNetworkAddress)
+{
+   if (ucNetwork >= SD_NETWORKS)
+      return NRF_ANT_ERROR_INVALID_NETWORK_NUMBER;
+
+   memcpy(aaucNetworkKey[ucNetwork], pucNetworkAddress, SD_NETWORK_KEY_SIZE);
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_search_waveform_set(uint8_t ucChannel, uint16_t usWaveform)
+{
+   (void)usWaveform;
+   return channel_get(ucChannel) ? NRF_SUCCESS : NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+}
+
+uint32_t sd_ant_search_channel_priority_set(uint8_t ucChannel, uint8_t ucPriority)
+{
+   (void)ucPriority;
+   return channel_get(ucChannel) ? NRF_SUCCESS : NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+}
+
+uint32_t sd_ant_prox_search_set(uint8_t ucChannel, uint8_t ucProxThreshold, uint8_t ucCustomProxThreshold)
+{
+   (void)ucProxThreshold;
+   (void)ucCustomProxThreshold;
+   return channel_get(ucChannel) ? NRF_SUCCESS : NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+}
+
+uint32_t sd_ant_auto_freq_hop_table_set(uint8_t ucChannel, uint8_t ucFreq0, uint8_t ucFreq1, uint8_t ucFreq2)
+{
+   (void)ucFreq0;
+   (void)ucFreq1;
+   (void)ucFreq2;
+   return channel_get(ucChannel) ? NRF_SUCCESS : NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+}
+
+uint32_t sd_ant_id_list_add(uint8_t ucChannel, uint8_t *pucDevice, uint8_t ucListIndex)
+{
+   (void)pucDevice;
+   (void)ucListIndex;
+   return channel_get(ucChannel) ? NRF_SUCCESS : NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+}
+
+uint32_t sd_ant_id_list_config(uint8_t ucChannel, uint8_t ucIDListSize, uint8_t ucIncExcFlag)
+{
+   (void)ucIDListSize;
+   (void)ucIncExcFlag;
+   return channel_get(ucChannel) ? NRF_SUCCESS : NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+}
+
+uint32_t sd_ant_rx_scan_mode_start(uint8_t ucSyncChannelPacketsOnly)
+{
+   sd_channel_t *pstChannel = channel_get(0);
+
+   (void)ucSyncChannelPacketsOnly;
+   if ((pstChannel == NULL) || (pstChannel->ucStatus != STATUS_ASSIGNED_CHANNEL))
+      return NRF_ANT_ERROR_CHANNEL_IN_WRONG_STATE;
+
+   pstChannel->ucStatus = STATUS_SEARCHING_CHANNEL;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_lib_config_set(uint8_t ucANTLibConfig)
+{
+   ucLibConfig |= ucANTLibConfig;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_lib_config_clear(uint8_t ucANTLibConfigMask)
+{
+   ucLibConfig &= ~ucANTLibConfigMask;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_broadcast_message_tx(uint8_t ucChannel, uint8_t ucSize, uint8_t *aucMesg)
+{
+   sd_channel_t *pstChannel = channel_get(ucChannel);
+
+   (void)aucMesg;
+   if (pstChannel == NULL)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+   if (ucSize > ANT_STANDARD_DATA_PAYLOAD_SIZE + 1) // payload with optional extended data flag byte
+      return NRF_ANT_ERROR_INVALID_MESSAGE;
+   if (!channel_open(pstChannel))
+      return NRF_ANT_ERROR_CHANNEL_NOT_OPENED;
+
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_acknowledge_message_tx(uint8_t ucChannel, uint8_t ucSize, uint8_t *aucMesg)
+{
+   return sd_ant_broadcast_message_tx(ucChannel, ucSize, aucMesg);
+}
+
+uint32_t sd_ant_burst_handler_request(uint8_t ucChannel, uint16_t usSize, uint8_t *aucData, uint8_t ucBurstSegment)
+{
+   sd_channel_t *pstChannel = channel_get(ucChannel);
+
+   (void)usSize;
+   (void)aucData;
+   if (pstChannel == NULL)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+   if (!channel_open(pstChannel))
+      return NRF_ANT_ERROR_CHANNEL_NOT_OPENED;
+
+   if (ucBurstSegment & BURST_SEGMENT_END)
+      channel_event_push(ucChannel, EVENT_TRANSFER_TX_COMPLETED);
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_adv_burst_config_set(uint8_t *aucConfig, uint8_t ucSize)
+{
+   if (ucSize > sizeof(aucAdvBurstConfig))
+      return NRF_ANT_ERROR_INVALID_MESSAGE;
+
+   memcpy(aucAdvBurstConfig, aucConfig, ucSize);
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_adv_burst_config_get(uint8_t ucRequestType, uint8_t *aucConfig)
+{
+   if (ucRequestType == 0)
+      memset(aucConfig, 0, MESG_CONFIG_ADV_BURST_REQ_CAPABILITIES_SIZE);
+   else
+      memcpy(aucConfig, aucAdvBurstConfig, sizeof(aucAdvBurstConfig));
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_coex_config_set(uint8_t ucChannel, ANT_BUFFER_PTR *pstCoexConfig, ANT_BUFFER_PTR *pstAdvCoexConfig)
+{
+   (void)pstCoexConfig;
+   (void)pstAdvCoexConfig;
+   return channel_get(ucChannel) ? NRF_SUCCESS : NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+}
+
+uint32_t sd_ant_coex_config_get(uint8_t ucChannel, ANT_BUFFER_PTR *pstCoexConfig, ANT_BUFFER_PTR *pstAdvCoexConfig)
+{
+   if (pstCoexConfig != NULL)
+      memset(pstCoexConfig->pucBuffer, 0, pstCoexConfig->ucBufferSize);
+   if (pstAdvCoexConfig != NULL)
+      memset(pstAdvCoexConfig->pucBuffer, 0, pstAdvCoexConfig->ucBufferSize);
+   return channel_get(ucChannel) ? NRF_SUCCESS : NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+}
+
+uint32_t sd_ant_high_duty_search_config_set(ANT_HIGH_DUTY_SEARCH_CONFIG *pstHighDutyConfig)
+{
+   stHighDutySearch = *pstHighDutyConfig;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_high_duty_search_config_get(ANT_HIGH_DUTY_SEARCH_CONFIG *pstHighDutyConfig)
+{
+   *pstHighDutyConfig = stHighDutySearch;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_active_search_sharing_cycles_set(uint8_t ucChannel, uint8_t ucCycles)
+{
+   sd_channel_t *pstChannel = channel_get(ucChannel);
+
+   if (pstChannel == NULL)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+
+   pstChannel->ucSearchSharingCycles = ucCycles;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_active_search_sharing_cycles_get(uint8_t ucChannel, uint8_t *pucCycles)
+{
+   sd_channel_t *pstChannel = channel_get(ucChannel);
+
+   if (pstChannel == NULL)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+
+   *pucCycles = pstChannel->ucSearchSharingCycles;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_event_filtering_set(uint16_t usFilter)
+{
+   usEventFilter = usFilter;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_event_filtering_get(uint16_t *pusFilter)
+{
+   *pusFilter = usEventFilter;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_sdu_mask_set(uint8_t ucMaskNumber, uint8_t *pucMask)
+{
+   if (ucMaskNumber >= SD_SDU_MASKS)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+
+   memcpy(aaucSduMask[ucMaskNumber], pucMask, SD_SDU_MASK_SIZE);
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_sdu_mask_get(uint8_t ucMaskNumber, uint8_t *pucMask)
+{
+   if (ucMaskNumber >= SD_SDU_MASKS)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+
+   memcpy(pucMask, aaucSduMask[ucMaskNumber], SD_SDU_MASK_SIZE);
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_sdu_mask_config(uint8_t ucChannel, uint8_t ucMaskConfig)
+{
+   (void)ucMaskConfig;
+   return channel_get(ucChannel) ? NRF_SUCCESS : NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+}
+
+uint32_t sd_ant_crypto_channel_enable(uint8_t ucChannel, uint8_t ucEnable, uint8_t ucKeyNum, uint8_t ucDecimationRate)
+{
+   (void)ucEnable;
+   (void)ucDecimationRate;
+   if (ucKeyNum >= SD_ENCRYPTION_KEYS)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+   return channel_get(ucChannel) ? NRF_SUCCESS : NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+}
+
+uint32_t sd_ant_crypto_key_set(uint8_t ucKeyNum, uint8_t *pucKey)
+{
+   if (ucKeyNum >= SD_ENCRYPTION_KEYS)
+      return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+
+   memcpy(aaucCryptoKey[ucKeyNum], pucKey, SD_ENCRYPTION_KEY_SIZE);
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_crypto_info_set(uint8_t ucType, uint8_t *pucInfo)
+{
+   switch (ucType)
+   {
+      case ENCRYPTION_INFO_GET_CRYPTO_ID:
+         memcpy(aucCryptoID, pucInfo, sizeof(aucCryptoID));
+         return NRF_SUCCESS;
+
+      case ENCRYPTION_INFO_GET_CUSTOM_USER_DATA:
+         memcpy(aucCryptoUserData, pucInfo, sizeof(aucCryptoUserData));
+         return NRF_SUCCESS;
+   }
+
+   return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+}
+
+uint32_t sd_ant_crypto_info_get(uint8_t ucType, uint8_t *pucInfo)
+{
+   switch (ucType)
+   {
+      case ENCRYPTION_INFO_GET_SUPPORTED_MODE:
+         pucInfo[0] = 0;
+         return NRF_SUCCESS;
+
+      case ENCRYPTION_INFO_GET_CRYPTO_ID:
+         memcpy(pucInfo, aucCryptoID, sizeof(aucCryptoID));
+         return NRF_SUCCESS;
+
+      case ENCRYPTION_INFO_GET_CUSTOM_USER_DATA:
+         memcpy(pucInfo, aucCryptoUserData, sizeof(aucCryptoUserData));
+         return NRF_SUCCESS;
+   }
+
+   return NRF_ANT_ERROR_INVALID_PARAMETER_PROVIDED;
+}
+
+uint32_t sd_ant_rfactive_notification_config_set(uint8_t ucMode, uint16_t usTimeThreshold)
+{
+   ucRFActiveMode = ucMode;
+   usRFActiveThreshold = usTimeThreshold;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_rfactive_notification_config_get(uint8_t *pucMode, uint16_t *pusTimeThreshold)
+{
+   *pucMode = ucRFActiveMode;
+   *pusTimeThreshold = usRFActiveThreshold;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_config_pa_lna_set(ANT_PA_LNA_CONFIG *pstPALNAConfig)
+{
+   stPALNAConfig = *pstPALNAConfig;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_config_pa_lna_get(ANT_PA_LNA_CONFIG *pstPALNAConfig)
+{
+   *pstPALNAConfig = stPALNAConfig;
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_cw_test_mode_init(void)
+{
+   return NRF_SUCCESS;
+}
+
+uint32_t sd_ant_cw_test_mode(uint8_t ucRadioFreq, uint8_t ucTxPower, uint8_t ucCustomTxPower, uint8_t ucMode)
+{
+   (void)ucRadioFreq;
+   (void)ucTxPower;
+   (void)ucCustomTxPower;
+   (void)ucMode;
+   return NRF_SUCCESS;
+}
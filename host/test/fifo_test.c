@@ -0,0 +1,327 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+/*
+ * Functional tests of the multi context fifo, built once with power of two
+ * offset masking and once with MC_FIFO_POW2_SIZE_DISABLE. Every test prints
+ * one line:
+ *
+ *    <variant> <name> ok|FAILED
+ *
+ * and the run fails if any of them failed.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "multi_ctx_fifo.h"
+#include "nrf_nvic.h"
+
+#if !defined (FIFO_TEST_VARIANT)
+   #define FIFO_TEST_VARIANT              "default"
+#endif
+
+#define FIFO_TEST_SIZE                    ((fifo_offset_t)64)
+#define FIFO_TEST_RECORD_SIZE             ((fifo_offset_t)5) // does not divide the fifo size, records wrap at different offsets
+#define FIFO_TEST_WRAP_RECORDS            ((uint32_t)20000)  // runs the free running offsets past their range
+
+#if defined (MC_FIFO_POW2_SIZE)
+   #define FIFO_TEST_CAPACITY             FIFO_TEST_SIZE
+#else
+   #define FIFO_TEST_CAPACITY             (FIFO_TEST_SIZE - 1) // one byte tells full from empty
+#endif
+
+#define TEST_CHECK(cond)                  test_check((cond), #cond, __LINE__)
+
+static multi_ctx_fifo_t stFifo;
+static uint8_t aucBuff[FIFO_TEST_SIZE];
+static bool bTestFailed;
+static uint32_t ulFailures;
+
+// Called once on the next exit from a critical region, as an interrupt
+// taken right after it would be.
+static void (*pfInterrupt)(void);
+
+uint32_t sd_nvic_critical_region_enter(uint8_t *p_is_nested_critical_region)
+{
+   *p_is_nested_critical_region = 0;
+   return 0;
+}
+
+uint32_t sd_nvic_critical_region_exit(uint8_t is_nested_critical_region)
+{
+   void (*pfHandler)(void) = pfInterrupt;
+
+   (void)is_nested_critical_region;
+   if (pfHandler != NULL)
+   {
+      pfInterrupt = NULL;
+      pfHandler();
+   }
+   return 0;
+}
+
+static void test_check(bool bPassed, const char *pcCond, int iLine)
+{
+   if (!bPassed)
+   {
+      fprintf(stderr, "fifo_test: line %d: %s\n", iLine, pcCond);
+      bTestFailed = true;
+   }
+}
+
+static void test_run(const char *pcName, void (*pfTest)(void))
+{
+   bTestFailed = false;
+   memset(aucBuff, 0xAA, sizeof(aucBuff));
+   mc_fifo_init_buffer(&stFifo, aucBuff, sizeof(aucBuff));
+
+   pfTest();
+
+   printf("%s %s %s\n", FIFO_TEST_VARIANT, pcName, bTestFailed ? "FAILED" : "ok");
+   if (bTestFailed)
+      ulFailures++;
+}
+
+static void record_fill(uint8_t *pucRecord, fifo_offset_t uiLen, uint32_t ulSeed)
+{
+   for (fifo_offset_t i = 0; i < uiLen; i++)
+      pucRecord[i] = (uint8_t)(ulSeed * 7 + i);
+}
+
+// Copy claimed data out of its spans.
+static void span_copy(const mc_fifo_span_t *pstSpan, uint8_t *pucDst)
+{
+   memcpy(pucDst, pstSpan->pucData[0], pstSpan->uiLen[0]);
+   memcpy(&pucDst[pstSpan->uiLen[0]], pstSpan->pucData[1], pstSpan->uiLen[1]);
+}
+
+/***************************************************************************
+ * Tests
+ ***************************************************************************/
+static void test_push_pop(void)
+{
+   uint8_t aucIn[FIFO_TEST_RECORD_SIZE];
+   uint8_t aucOut[FIFO_TEST_RECORD_SIZE];
+
+   TEST_CHECK(!mc_fifo_pop(&stFifo, aucOut, 1));
+   TEST_CHECK(mc_fifo_get_data_len(&stFifo) == 0);
+
+   for (uint32_t i = 0; i < 3; i++)
+   {
+      record_fill(aucIn, sizeof(aucIn), i);
+      TEST_CHECK(mc_fifo_push(&stFifo, aucIn, sizeof(aucIn)));
+   }
+   TEST_CHECK(mc_fifo_get_data_len(&stFifo) == 3 * FIFO_TEST_RECORD_SIZE);
+
+   // Peek leaves the data in place, a pop larger than the data fails whole.
+   record_fill(aucIn, sizeof(aucIn), 0);
+   TEST_CHECK(mc_fifo_peek(&stFifo, aucOut, sizeof(aucOut)));
+   TEST_CHECK(memcmp(aucIn, aucOut, sizeof(aucIn)) == 0);
+   TEST_CHECK(!mc_fifo_pop(&stFifo, aucOut, 3 * FIFO_TEST_RECORD_SIZE + 1));
+   TEST_CHECK(mc_fifo_get_data_len(&stFifo) == 3 * FIFO_TEST_RECORD_SIZE);
+
+   for (uint32_t i = 0; i < 3; i++)
+   {
+      record_fill(aucIn, sizeof(aucIn), i);
+      TEST_CHECK(mc_fifo_pop(&stFifo, aucOut, sizeof(aucOut)));
+      TEST_CHECK(memcmp(aucIn, aucOut, sizeof(aucIn)) == 0);
+   }
+   TEST_CHECK(mc_fifo_get_data_len(&stFifo) == 0);
+}
+
+static void test_full(void)
+{
+   uint8_t aucData[FIFO_TEST_SIZE + 1];
+   uint8_t aucOut[FIFO_TEST_SIZE + 1];
+
+   record_fill(aucData, sizeof(aucData), 1);
+
+   // A push is never partial.
+   TEST_CHECK(!mc_fifo_push(&stFifo, aucData, FIFO_TEST_CAPACITY + 1));
+   TEST_CHECK(mc_fifo_get_data_len(&stFifo) == 0);
+
+   TEST_CHECK(mc_fifo_push(&stFifo, aucData, FIFO_TEST_CAPACITY - 1));
+   TEST_CHECK(!mc_fifo_push(&stFifo, aucData, 2));
+   TEST_CHECK(mc_fifo_push(&stFifo, &aucData[FIFO_TEST_CAPACITY - 1], 1));
+   TEST_CHECK(!mc_fifo_push(&stFifo, aucData, 1));
+   TEST_CHECK(mc_fifo_get_data_len(&stFifo) == FIFO_TEST_CAPACITY);
+
+   TEST_CHECK(mc_fifo_pop(&stFifo, aucOut, FIFO_TEST_CAPACITY));
+   TEST_CHECK(memcmp(aucData, aucOut, FIFO_TEST_CAPACITY) == 0);
+   TEST_CHECK(mc_fifo_get_data_len(&stFifo) == 0);
+}
+
+// Records of a size that does not divide the fifo keep wrapping at different
+// offsets, until the offsets themselves wrap around.
+static void test_wrap(void)
+{
+   uint8_t aucIn[FIFO_TEST_RECORD_SIZE];
+   uint8_t aucOut[FIFO_TEST_RECORD_SIZE];
+   uint32_t ulPopped = 0;
+
+   for (uint32_t i = 0; i < FIFO_TEST_WRAP_RECORDS; i++)
+   {
+      record_fill(aucIn, sizeof(aucIn), i);
+      if (!mc_fifo_push(&stFifo, aucIn, sizeof(aucIn)))
+      {
+         TEST_CHECK(mc_fifo_get_data_len(&stFifo) > (FIFO_TEST_CAPACITY - FIFO_TEST_RECORD_SIZE));
+
+         // Drain half of it and retry.
+         while (mc_fifo_get_data_len(&stFifo) > (FIFO_TEST_SIZE / 2))
+         {
+            record_fill(aucIn, sizeof(aucIn), ulPopped++);
+            TEST_CHECK(mc_fifo_pop(&stFifo, aucOut, sizeof(aucOut)));
+            TEST_CHECK(memcmp(aucIn, aucOut, sizeof(aucIn)) == 0);
+         }
+
+         record_fill(aucIn, sizeof(aucIn), i);
+         TEST_CHECK(mc_fifo_push(&stFifo, aucIn, sizeof(aucIn)));
+      }
+
+      if (bTestFailed)
+         return;
+   }
+
+   while (ulPopped < FIFO_TEST_WRAP_RECORDS)
+   {
+      record_fill(aucIn, sizeof(aucIn), ulPopped++);
+      TEST_CHECK(mc_fifo_pop(&stFifo, aucOut, sizeof(aucOut)));
+      TEST_CHECK(memcmp(aucIn, aucOut, sizeof(aucIn)) == 0);
+   }
+   TEST_CHECK(mc_fifo_get_data_len(&stFifo) == 0);
+}
+
+static void test_claim_release(void)
+{
+   uint8_t aucIn[FIFO_TEST_SIZE];
+   uint8_t aucOut[FIFO_TEST_SIZE];
+   mc_fifo_span_t stFirst;
+   mc_fifo_span_t stSecond;
+   fifo_offset_t uiRead;
+
+   // Start close to the end of the buffer so the second record wraps.
+   record_fill(aucIn, sizeof(aucIn), 0);
+   TEST_CHECK(mc_fifo_push(&stFifo, aucIn, FIFO_TEST_SIZE - 10));
+   TEST_CHECK(mc_fifo_pop(&stFifo, aucOut, FIFO_TEST_SIZE - 10));
+
+   record_fill(aucIn, sizeof(aucIn), 1);
+   TEST_CHECK(mc_fifo_push(&stFifo, aucIn, 6));
+   TEST_CHECK(mc_fifo_push(&stFifo, &aucIn[6], 12));
+
+   uiRead = mc_fifo_get_read_offset(&stFifo);
+   TEST_CHECK(mc_fifo_claim(&stFifo, &stFirst, 6));
+   TEST_CHECK((stFirst.uiLen[0] == 6) && (stFirst.uiLen[1] == 0));
+   TEST_CHECK(mc_fifo_get_read_offset(&stFifo) != uiRead);
+
+   TEST_CHECK(!mc_fifo_claim(&stFifo, &stSecond, 13));
+   TEST_CHECK(mc_fifo_claim(&stFifo, &stSecond, 12));
+   TEST_CHECK((stSecond.uiLen[0] == 4) && (stSecond.uiLen[1] == 8));
+   TEST_CHECK(stSecond.pucData[1] == aucBuff);
+
+   span_copy(&stFirst, aucOut);
+   span_copy(&stSecond, &aucOut[6]);
+   TEST_CHECK(memcmp(aucIn, aucOut, 18) == 0);
+
+   // Claimed data is no longer returned, but its space stays in use.
+   TEST_CHECK(!mc_fifo_peek(&stFifo, aucOut, 1));
+   TEST_CHECK(mc_fifo_get_data_len(&stFifo) == 18);
+   TEST_CHECK(!mc_fifo_push(&stFifo, aucIn, FIFO_TEST_CAPACITY - 17));
+
+   mc_fifo_release(&stFifo, 6);
+   TEST_CHECK(mc_fifo_get_data_len(&stFifo) == 12);
+   TEST_CHECK(mc_fifo_push(&stFifo, aucIn, FIFO_TEST_CAPACITY - 12));
+   TEST_CHECK(!mc_fifo_push(&stFifo, aucIn, 1));
+
+   mc_fifo_release(&stFifo, 12);
+   TEST_CHECK(mc_fifo_get_data_len(&stFifo) == FIFO_TEST_CAPACITY - 12);
+   TEST_CHECK(mc_fifo_pop(&stFifo, aucOut, FIFO_TEST_CAPACITY - 12));
+   TEST_CHECK(memcmp(aucIn, aucOut, FIFO_TEST_CAPACITY - 12) == 0);
+}
+
+static void test_push_at_write(void)
+{
+   uint8_t aucIn[FIFO_TEST_RECORD_SIZE];
+   uint8_t aucNew[FIFO_TEST_RECORD_SIZE];
+   uint8_t aucOut[FIFO_TEST_RECORD_SIZE];
+   fifo_offset_t auiOffset[2];
+
+   // Place the second record across the end of the buffer.
+   record_fill(aucOut, sizeof(aucOut), 0);
+   for (fifo_offset_t i = 0; i < (FIFO_TEST_SIZE - 2 * FIFO_TEST_RECORD_SIZE + 2); i++)
+   {
+      TEST_CHECK(mc_fifo_push(&stFifo, aucOut, 1));
+      TEST_CHECK(mc_fifo_pop(&stFifo, aucOut, 1));
+   }
+
+   for (uint32_t i = 0; i < 2; i++)
+   {
+      record_fill(aucIn, sizeof(aucIn), i);
+      TEST_CHECK(mc_fifo_push_at(&stFifo, aucIn, sizeof(aucIn), &auiOffset[i]));
+   }
+   TEST_CHECK(auiOffset[0] == mc_fifo_get_read_offset(&stFifo));
+
+   record_fill(aucNew, sizeof(aucNew), 100);
+   mc_fifo_write(&stFifo, auiOffset[1], aucNew, sizeof(aucNew));
+   // A shorter write only replaces the start of the record.
+   mc_fifo_write(&stFifo, auiOffset[0], aucNew, 2);
+
+   record_fill(aucIn, sizeof(aucIn), 0);
+   memcpy(aucIn, aucNew, 2);
+   TEST_CHECK(mc_fifo_pop(&stFifo, aucOut, sizeof(aucOut)));
+   TEST_CHECK(memcmp(aucIn, aucOut, sizeof(aucIn)) == 0);
+   TEST_CHECK(mc_fifo_pop(&stFifo, aucOut, sizeof(aucOut)));
+   TEST_CHECK(memcmp(aucNew, aucOut, sizeof(aucNew)) == 0);
+}
+
+static uint8_t aucNested[FIFO_TEST_RECORD_SIZE];
+
+static void nested_push(void)
+{
+   uint8_t aucOut[1];
+
+   TEST_CHECK(mc_fifo_push(&stFifo, aucNested, sizeof(aucNested)));
+   // Committed only once the push it interrupted completes.
+   TEST_CHECK(!mc_fifo_peek(&stFifo, aucOut, sizeof(aucOut)));
+}
+
+// A push interrupted by another push right after allocating its space.
+static void test_nested_push(void)
+{
+   uint8_t aucIn[FIFO_TEST_RECORD_SIZE];
+   uint8_t aucOut[FIFO_TEST_RECORD_SIZE];
+
+   record_fill(aucIn, sizeof(aucIn), 1);
+   record_fill(aucNested, sizeof(aucNested), 2);
+
+   pfInterrupt = nested_push;
+   TEST_CHECK(mc_fifo_push(&stFifo, aucIn, sizeof(aucIn)));
+   TEST_CHECK(pfInterrupt == NULL);
+   TEST_CHECK(mc_fifo_get_data_len(&stFifo) == 2 * FIFO_TEST_RECORD_SIZE);
+
+   TEST_CHECK(mc_fifo_pop(&stFifo, aucOut, sizeof(aucOut)));
+   TEST_CHECK(memcmp(aucIn, aucOut, sizeof(aucIn)) == 0);
+   TEST_CHECK(mc_fifo_pop(&stFifo, aucOut, sizeof(aucOut)));
+   TEST_CHECK(memcmp(aucNested, aucOut, sizeof(aucNested)) == 0);
+}
+
+int main(void)
+{
+   test_run("push_pop", test_push_pop);
+   test_run("full", test_full);
+   test_run("wrap", test_wrap);
+   test_run("claim_release", test_claim_release);
+   test_run("push_at_write", test_push_at_write);
+   test_run("nested_push", test_nested_push);
+
+   return ulFailures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
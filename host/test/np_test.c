@@ -0,0 +1,634 @@
+/*
+This software is subject to the license described in the LICENSE_A+SS.txt file
+included with this software distribution. You may not use this file except in compliance
+with this license.
+
+Copyright (c) Garmin Canada Inc. 2019
+All rights reserved.
+*/
+
+/*
+ * Functional tests of the network processor built for the host: command
+ * dispatch, command batches and the event buffering lanes. Commands and
+ * protocol events go through the real main loop and serial code, the lanes
+ * are also driven directly while the processor waits for events. Every test
+ * prints one line:
+ *
+ *    <name> ok|FAILED
+ *
+ * and the run fails if any of them failed.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ant_parameters.h"
+#include "boardconfig.h"
+#include "event_buffering.h"
+#include "serial.h"
+#include "host_np.h"
+
+#define TEST_FRAMES_MAX                   64
+#define TEST_FRAME_SIZE                   (MESG_SYNC_SIZE + MESG_BUFFER_SIZE)
+#define TEST_STALLS_MAX                   ((uint32_t)100000)
+#define TEST_LANE_EVENTS                  6
+
+// Not exported by the processor, as sent by the host.
+#define TEST_COMMAND_BATCH_ID             ((uint16_t)0xE414)
+#define TEST_BUFFER_ALL                   ((uint8_t)0x01)
+
+#define TEST_CHECK(cond)                  test_check((cond), #cond, __LINE__)
+
+// Serial output of the processor, parsed into frames of size, message ID and data.
+static struct
+{
+   uint8_t ucState;
+   uint8_t ucIndex;
+   uint8_t ucCheckSum;
+   uint8_t aucFrame[MESG_BUFFER_SIZE];
+   uint8_t aaucFrames[TEST_FRAMES_MAX][MESG_BUFFER_SIZE];
+   uint32_t ulFrames;
+   uint32_t ulBadFrames;                  // checksum errors and frames that did not fit
+} stSink;
+
+enum
+{
+   SINK_SYNC,
+   SINK_SIZE,
+   SINK_DATA,
+   SINK_CHECKSUM
+};
+
+static bool bTestFailed;
+static uint32_t ulFailures;
+
+static void test_check(bool bPassed, const char *pcCond, int iLine)
+{
+   if (!bPassed)
+   {
+      fprintf(stderr, "np_test: line %d: %s\n", iLine, pcCond);
+      bTestFailed = true;
+   }
+}
+
+static void sink_byte(uint8_t ucByte, void *pvContext)
+{
+   (void)pvContext;
+
+   switch (stSink.ucState)
+   {
+      case SINK_SYNC:
+         if (ucByte == MESG_TX_SYNC)
+         {
+            stSink.ucCheckSum = ucByte;
+            stSink.ucState = SINK_SIZE;
+         }
+         break;
+
+      case SINK_SIZE:
+         stSink.aucFrame[0] = ucByte;
+         stSink.ucIndex = 1;
+         stSink.ucCheckSum ^= ucByte;
+         stSink.ucState = (ucByte <= MESG_MAX_SIZE_VALUE) ? SINK_DATA : SINK_SYNC;
+         break;
+
+      case SINK_DATA:
+         stSink.aucFrame[stSink.ucIndex++] = ucByte;
+         stSink.ucCheckSum ^= ucByte;
+         if (stSink.ucIndex == (uint8_t)(MESG_SIZE_SIZE + MESG_ID_SIZE + stSink.aucFrame[0]))
+            stSink.ucState = SINK_CHECKSUM;
+         break;
+
+      case SINK_CHECKSUM:
+         if ((stSink.ucCheckSum != ucByte) || (stSink.ulFrames == TEST_FRAMES_MAX))
+            stSink.ulBadFrames++;
+         else
+            memcpy(stSink.aaucFrames[stSink.ulFrames++], stSink.aucFrame, stSink.ucIndex);
+         stSink.ucState = SINK_SYNC;
+         break;
+   }
+}
+
+static void sink_clear(void)
+{
+   stSink.ulFrames = 0;
+   stSink.ulBadFrames = 0;
+}
+
+static void test_run(const char *pcName, void (*pfTest)(void))
+{
+   bTestFailed = false;
+   host_np_settle();
+   sink_clear();
+
+   pfTest();
+
+   host_np_settle();
+   TEST_CHECK(stSink.ulBadFrames == 0);
+
+   printf("%s %s\n", pcName, bTestFailed ? "FAILED" : "ok");
+   if (bTestFailed)
+      ulFailures++;
+}
+
+/***************************************************************************
+ * Serial
+ ***************************************************************************/
+static uint32_t frame_build(uint8_t *pucFrame, uint8_t ucMesgID, const uint8_t *pucData, uint8_t ucSize)
+{
+   uint8_t ucCheckSum = 0;
+   uint32_t ulLength = 0;
+
+   pucFrame[ulLength++] = MESG_TX_SYNC;
+   pucFrame[ulLength++] = ucSize;
+   pucFrame[ulLength++] = ucMesgID;
+   memcpy(&pucFrame[ulLength], pucData, ucSize);
+   ulLength += ucSize;
+
+   for (uint32_t i = 0; i < ulLength; i++)
+      ucCheckSum ^= pucFrame[i];
+   pucFrame[ulLength++] = ucCheckSum;
+
+   return ulLength;
+}
+
+// Feed bytes to the processor, letting it run whenever it holds off reception.
+static void serial_write(const uint8_t *pucData, uint32_t ulSize)
+{
+   uint32_t ulTaken = 0;
+   uint32_t ulStalls = 0;
+
+   while (ulTaken < ulSize)
+   {
+      uint32_t ulMoved = host_np_uart_rx_buffer(&pucData[ulTaken], ulSize - ulTaken);
+
+      ulTaken += ulMoved;
+      if (ulTaken == ulSize)
+         break;
+
+      host_np_run();
+      ulMoved += host_np_uart_tx_pump(HOST_NP_UART_TX_UNLIMITED);
+      ulStalls = ulMoved ? 0 : ulStalls + 1;
+      if (ulStalls > TEST_STALLS_MAX)
+      {
+         fprintf(stderr, "np_test: processor stopped taking serial input\n");
+         exit(EXIT_FAILURE);
+      }
+   }
+}
+
+// Send a command and return the first frame sent back, NULL if there is none.
+static const uint8_t *command_send(uint8_t ucMesgID, const uint8_t *pucData, uint8_t ucSize)
+{
+   uint8_t aucFrame[TEST_FRAME_SIZE];
+   uint32_t ulLength = frame_build(aucFrame, ucMesgID, pucData, ucSize);
+
+   sink_clear();
+   serial_write(aucFrame, ulLength);
+   host_np_settle();
+
+   return stSink.ulFrames ? stSink.aaucFrames[0] : NULL;
+}
+
+// Response code of a response event to ucMesgID, NO_RESPONSE_MESSAGE if the frame is something else.
+static uint8_t response_get(const uint8_t *pucFrame, uint8_t ucMesgID)
+{
+   if ((pucFrame == NULL) ||
+       (pucFrame[0] != MESG_RESPONSE_EVENT_SIZE) || (pucFrame[1] != MESG_RESPONSE_EVENT_ID) ||
+       (pucFrame[3] != ucMesgID))
+   {
+      return NO_RESPONSE_MESSAGE;
+   }
+
+   return pucFrame[4];
+}
+
+// Response code of an extended response to usExtID, NO_RESPONSE_MESSAGE if the frame is something else.
+static uint8_t ext_response_get(const uint8_t *pucFrame, uint16_t usExtID)
+{
+   if ((pucFrame == NULL) || (pucFrame[0] != 4) ||
+       (pucFrame[1] != (uint8_t)(MESG_EXT_RESPONSE_ID >> 8)) || (pucFrame[2] != (uint8_t)MESG_EXT_RESPONSE_ID) ||
+       (pucFrame[3] != (uint8_t)(usExtID >> 8)) || (pucFrame[4] != (uint8_t)usExtID))
+   {
+      return NO_RESPONSE_MESSAGE;
+   }
+
+   return pucFrame[5];
+}
+
+static const uint8_t *ext_command_send(uint16_t usExtID, const uint8_t *pucData, uint8_t ucSize)
+{
+   uint8_t aucData[MESG_MAX_SIZE_VALUE];
+
+   aucData[0] = (uint8_t)usExtID;
+   memcpy(&aucData[1], pucData, ucSize);
+
+   return command_send((uint8_t)(usExtID >> 8), aucData, ucSize + 1);
+}
+
+/***************************************************************************
+ * Command dispatch
+ ***************************************************************************/
+static void test_dispatch_invalid(void)
+{
+   uint8_t aucChannel[] = {0};
+   uint8_t aucShortPeriod[] = {0};
+   uint8_t aucOutOfRange[] = {host_np_ant_channels()};
+
+   // No handler, size below the fields read, channel number out of range.
+   TEST_CHECK(response_get(command_send(MESG_STARTUP_MESG_ID, aucChannel, sizeof(aucChannel)), MESG_STARTUP_MESG_ID) == INVALID_MESSAGE);
+   TEST_CHECK(response_get(command_send(MESG_CHANNEL_MESG_PERIOD_ID, aucShortPeriod, sizeof(aucShortPeriod)), MESG_CHANNEL_MESG_PERIOD_ID) == INVALID_MESSAGE);
+   TEST_CHECK(response_get(command_send(MESG_OPEN_CHANNEL_ID, aucOutOfRange, sizeof(aucOutOfRange)), MESG_OPEN_CHANNEL_ID) == INVALID_MESSAGE);
+}
+
+static void test_dispatch_command(void)
+{
+   uint8_t aucAssign[] = {1, CHANNEL_TYPE_SLAVE, 0};
+   uint8_t aucPeriod[] = {1, 0x00, 0x20};
+   uint8_t aucUnassign[] = {1};
+
+   TEST_CHECK(response_get(command_send(MESG_ASSIGN_CHANNEL_ID, aucAssign, sizeof(aucAssign)), MESG_ASSIGN_CHANNEL_ID) == RESPONSE_NO_ERROR);
+   TEST_CHECK(response_get(command_send(MESG_CHANNEL_MESG_PERIOD_ID, aucPeriod, sizeof(aucPeriod)), MESG_CHANNEL_MESG_PERIOD_ID) == RESPONSE_NO_ERROR);
+   TEST_CHECK(response_get(command_send(MESG_UNASSIGN_CHANNEL_ID, aucUnassign, sizeof(aucUnassign)), MESG_UNASSIGN_CHANNEL_ID) == RESPONSE_NO_ERROR);
+}
+
+static void test_dispatch_request(void)
+{
+   uint8_t aucStatus[] = {0, MESG_CHANNEL_STATUS_ID};
+   uint8_t aucNoRequest[] = {0, MESG_OPEN_CHANNEL_ID};
+   const uint8_t *pucFrame;
+
+   pucFrame = command_send(MESG_REQUEST_ID, aucStatus, sizeof(aucStatus));
+   TEST_CHECK((pucFrame != NULL) && (pucFrame[0] == MESG_CHANNEL_STATUS_SIZE) && (pucFrame[1] == MESG_CHANNEL_STATUS_ID) && (pucFrame[2] == 0));
+
+   TEST_CHECK(response_get(command_send(MESG_REQUEST_ID, aucNoRequest, sizeof(aucNoRequest)), MESG_REQUEST_ID) == INVALID_MESSAGE);
+}
+
+static void test_dispatch_ext(void)
+{
+   uint8_t aucWeight[] = {3};
+   uint8_t aucNoWeight[] = {0};
+   uint8_t aucRequest[] = {(uint8_t)(MESG_EVENT_BUFFERING_DRAIN_CONFIG_ID >> 8), (uint8_t)MESG_EVENT_BUFFERING_DRAIN_CONFIG_ID};
+   uint8_t aucNone[] = {0};
+   const uint8_t *pucFrame;
+
+   TEST_CHECK(ext_response_get(ext_command_send(MESG_EVENT_BUFFERING_DRAIN_CONFIG_ID, aucWeight, sizeof(aucWeight)),
+      MESG_EVENT_BUFFERING_DRAIN_CONFIG_ID) == RESPONSE_NO_ERROR);
+   TEST_CHECK(ext_response_get(ext_command_send(MESG_EVENT_BUFFERING_DRAIN_CONFIG_ID, aucNoWeight, sizeof(aucNoWeight)),
+      MESG_EVENT_BUFFERING_DRAIN_CONFIG_ID) == INVALID_PARAMETER_PROVIDED);
+
+   // Requests are dispatched by the requested extended ID.
+   pucFrame = ext_command_send(MESG_EXT_REQUEST_ID, aucRequest, sizeof(aucRequest));
+   TEST_CHECK((pucFrame != NULL) && (pucFrame[0] == MESG_EVENT_BUFFERING_DRAIN_CONFIG_SIZE) &&
+      (pucFrame[1] == aucRequest[0]) && (pucFrame[2] == aucRequest[1]) && (pucFrame[3] == 3));
+
+   // Sub ID past the end of its page, page without a table.
+   TEST_CHECK(response_get(ext_command_send(((uint16_t)MESG_EXT_ID_4 << 8) | 0xFF, aucNone, sizeof(aucNone)), MESG_EXT_ID_4) == INVALID_MESSAGE);
+   TEST_CHECK(response_get(ext_command_send((uint16_t)MESG_EXT_ID_2 << 8, aucNone, sizeof(aucNone)), MESG_EXT_ID_2) == INVALID_MESSAGE);
+
+   event_buffering_drain_weight_set(DEFAULT_EVENT_BUFFERING_DRAIN_WEIGHT);
+}
+
+/***************************************************************************
+ * Command batches
+ ***************************************************************************/
+// Send a batch and check the number of commands processed and their response codes.
+static void batch_check(const uint8_t *pucBatch, uint8_t ucSize, const uint8_t *pucResponses, uint8_t ucCount)
+{
+   const uint8_t *pucFrame = ext_command_send(TEST_COMMAND_BATCH_ID, pucBatch, ucSize);
+
+   TEST_CHECK((pucFrame != NULL) && (pucFrame[0] == (uint8_t)(2 + ucCount)) &&
+      (pucFrame[1] == (uint8_t)(TEST_COMMAND_BATCH_ID >> 8)) && (pucFrame[2] == (uint8_t)TEST_COMMAND_BATCH_ID) &&
+      (pucFrame[3] == ucCount) && (memcmp(&pucFrame[4], pucResponses, ucCount) == 0));
+}
+
+static void test_batch(void)
+{
+   uint8_t ucChannels = host_np_ant_channels();
+   const uint8_t aucSetup[] =
+   {
+      3, MESG_ASSIGN_CHANNEL_ID, 1, CHANNEL_TYPE_SLAVE, 0,
+      3, MESG_CHANNEL_MESG_PERIOD_ID, 1, 0x00, 0x20,
+      1, MESG_UNASSIGN_CHANNEL_ID, 1,
+   };
+   const uint8_t aucSetupResponses[] = {RESPONSE_NO_ERROR, RESPONSE_NO_ERROR, RESPONSE_NO_ERROR};
+   // Processing stops at the first command that fails.
+   const uint8_t aucFailing[] =
+   {
+      3, MESG_ASSIGN_CHANNEL_ID, 1, CHANNEL_TYPE_SLAVE, 0,
+      1, MESG_OPEN_CHANNEL_ID, ucChannels,
+      1, MESG_UNASSIGN_CHANNEL_ID, 1,
+   };
+   const uint8_t aucFailingResponses[] = {RESPONSE_NO_ERROR, INVALID_MESSAGE};
+   const uint8_t aucCleanup[] = {1, MESG_UNASSIGN_CHANNEL_ID, 1};
+   const uint8_t aucCleanupResponses[] = {RESPONSE_NO_ERROR};
+   // Commands without a response code of their own are rejected.
+   const uint8_t aucRequest[] = {2, MESG_REQUEST_ID, 0, MESG_CHANNEL_STATUS_ID};
+   const uint8_t aucRequestResponses[] = {INVALID_MESSAGE};
+   // Size running past the end of the batch.
+   const uint8_t aucTruncated[] =
+   {
+      3, MESG_ASSIGN_CHANNEL_ID, 1, CHANNEL_TYPE_SLAVE, 0,
+      5, MESG_CHANNEL_MESG_PERIOD_ID, 1,
+   };
+   const uint8_t aucTruncatedResponses[] = {RESPONSE_NO_ERROR, INVALID_MESSAGE};
+
+   batch_check(aucSetup, sizeof(aucSetup), aucSetupResponses, sizeof(aucSetupResponses));
+   batch_check(aucFailing, sizeof(aucFailing), aucFailingResponses, sizeof(aucFailingResponses));
+   batch_check(aucCleanup, sizeof(aucCleanup), aucCleanupResponses, sizeof(aucCleanupResponses));
+   batch_check(aucRequest, sizeof(aucRequest), aucRequestResponses, sizeof(aucRequestResponses));
+   batch_check(aucTruncated, sizeof(aucTruncated), aucTruncatedResponses, sizeof(aucTruncatedResponses));
+   batch_check(aucCleanup, sizeof(aucCleanup), aucCleanupResponses, sizeof(aucCleanupResponses));
+}
+
+/***************************************************************************
+ * Event lanes
+ ***************************************************************************/
+static void lanes_default(void)
+{
+   event_buffering_config_set(DEFAULT_EVENT_BUFFERING_CONFIG, DEFAULT_EVENT_BUFFERING_SIZE_THRESHOLD, DEFAULT_EVENT_BUFFERING_TIME_THRESHOLD);
+   event_buffering_drain_weight_set(DEFAULT_EVENT_BUFFERING_DRAIN_WEIGHT);
+}
+
+static bool event_claim(event_lane_t *peLane, uint16_t *pusRecordSize, uint8_t *pucTag);
+
+// Buffer every event without ever reaching the size threshold.
+static void lanes_buffer_all(void)
+{
+   event_lane_t eLane;
+   uint16_t usRecordSize;
+   uint16_t usHighSize;
+   uint16_t usLowSize;
+   uint8_t ucTag;
+
+   event_buffering_queue_size_get(&usHighSize, &usLowSize);
+   event_buffering_config_set(TEST_BUFFER_ALL, usLowSize, 0);
+   // The flush started by the configuration ends once the lanes are found empty.
+   TEST_CHECK(!event_claim(&eLane, &usRecordSize, &ucTag));
+}
+
+// Received broadcast on channel 0, or a command response if ucEvent is NO_EVENT.
+static void event_build(ant_event_t *pstEvent, uint8_t ucEvent, uint8_t ucTag)
+{
+   memset(pstEvent, 0, sizeof(*pstEvent));
+   pstEvent->stHeader.ucEvent = ucEvent;
+
+   if (ucEvent == NO_EVENT)
+   {
+      pstEvent->stMessage.ANT_MESSAGE_ucSize = MESG_RESPONSE_EVENT_SIZE;
+      pstEvent->stMessage.ANT_MESSAGE_ucMesgID = MESG_RESPONSE_EVENT_ID;
+      pstEvent->stMessage.ANT_MESSAGE_aucPayload[0] = ucTag; // message ID responded to
+      pstEvent->stMessage.ANT_MESSAGE_aucPayload[1] = RESPONSE_NO_ERROR;
+   }
+   else
+   {
+      pstEvent->stMessage.ANT_MESSAGE_ucSize = MESG_CHANNEL_NUM_SIZE + ANT_STANDARD_DATA_PAYLOAD_SIZE;
+      pstEvent->stMessage.ANT_MESSAGE_ucMesgID = MESG_BROADCAST_DATA_ID;
+      pstEvent->stMessage.ANT_MESSAGE_aucPayload[0] = ucTag;
+   }
+}
+
+static void event_put(uint8_t ucEvent, uint8_t ucTag)
+{
+   ant_event_t stEvent;
+
+   event_build(&stEvent, ucEvent, ucTag);
+   TEST_CHECK(event_buffering_put(&stEvent));
+}
+
+// Claim the next event, check its frame and return its tag.
+static bool event_claim(event_lane_t *peLane, uint16_t *pusRecordSize, uint8_t *pucTag)
+{
+   ant_event_hdr_t stHeader;
+   mc_fifo_span_t stFrame;
+   uint8_t aucFrame[TEST_FRAME_SIZE];
+   uint8_t ucCheckSum = 0;
+   uint16_t usFrameSize;
+
+   if (!event_buffering_claim(&stHeader, &stFrame, peLane, pusRecordSize))
+      return false;
+
+   usFrameSize = stFrame.uiLen[0] + stFrame.uiLen[1];
+   TEST_CHECK((usFrameSize + sizeof(stHeader)) == *pusRecordSize);
+   if (usFrameSize > sizeof(aucFrame))
+      return false;
+
+   memcpy(aucFrame, stFrame.pucData[0], stFrame.uiLen[0]);
+   memcpy(&aucFrame[stFrame.uiLen[0]], stFrame.pucData[1], stFrame.uiLen[1]);
+   for (uint16_t i = 0; i < usFrameSize; i++)
+      ucCheckSum ^= aucFrame[i];
+
+   TEST_CHECK(aucFrame[0] == MESG_TX_SYNC);
+   TEST_CHECK(usFrameSize == (MESG_SYNC_SIZE + MESG_SIZE_SIZE + MESG_ID_SIZE + aucFrame[1] + MESG_CHECKSUM_SIZE));
+   TEST_CHECK(ucCheckSum == 0);
+
+   *pucTag = aucFrame[MESG_SYNC_SIZE + MESG_SIZE_SIZE + MESG_ID_SIZE + MESG_CHANNEL_NUM_SIZE]; // first payload byte
+   return true;
+}
+
+static void levels_check(uint16_t usHighExpected, uint16_t usLowExpected)
+{
+   uint16_t usHigh;
+   uint16_t usLow;
+
+   event_buffering_queue_level_get(&usHigh, &usLow);
+   TEST_CHECK((usHigh == usHighExpected) && (usLow == usLowExpected));
+}
+
+// Protocol events of all kinds go out in the order they were received.
+static void test_lanes_default_order(void)
+{
+   uint8_t aucAssign[] = {0, CHANNEL_TYPE_SLAVE, 0};
+   uint8_t aucOpen[] = {0};
+   uint8_t aucClose[] = {0};
+   uint8_t aucUnassign[] = {0};
+   uint8_t aucMessage[MESG_BUFFER_SIZE];
+
+   lanes_default();
+   TEST_CHECK(response_get(command_send(MESG_ASSIGN_CHANNEL_ID, aucAssign, sizeof(aucAssign)), MESG_ASSIGN_CHANNEL_ID) == RESPONSE_NO_ERROR);
+   TEST_CHECK(response_get(command_send(MESG_OPEN_CHANNEL_ID, aucOpen, sizeof(aucOpen)), MESG_OPEN_CHANNEL_ID) == RESPONSE_NO_ERROR);
+
+   sink_clear();
+   for (uint8_t i = 0; i < 3 * TEST_LANE_EVENTS; i++)
+   {
+      memset(aucMessage, 0, sizeof(aucMessage));
+      aucMessage[2] = 0; // channel
+
+      if (i % 3)
+      {
+         // Low priority events, bufferable if a threshold was set.
+         aucMessage[0] = MESG_RESPONSE_EVENT_SIZE;
+         aucMessage[1] = MESG_RESPONSE_EVENT_ID;
+         aucMessage[3] = MESG_EVENT_ID;
+         aucMessage[4] = (i % 3 == 1) ? EVENT_TX : EVENT_RX_FAIL;
+         TEST_CHECK(host_np_ant_event_push(0, aucMessage[4], aucMessage));
+      }
+      else
+      {
+         aucMessage[0] = MESG_CHANNEL_NUM_SIZE + ANT_STANDARD_DATA_PAYLOAD_SIZE;
+         aucMessage[1] = MESG_BROADCAST_DATA_ID;
+         aucMessage[3] = i;
+         TEST_CHECK(host_np_ant_event_push(0, EVENT_RX, aucMessage));
+      }
+   }
+   host_np_settle();
+
+   TEST_CHECK(stSink.ulFrames == 3 * TEST_LANE_EVENTS);
+   for (uint32_t i = 0; (i < stSink.ulFrames) && (i < 3 * TEST_LANE_EVENTS); i++)
+   {
+      const uint8_t *pucFrame = stSink.aaucFrames[i];
+
+      if (i % 3)
+         TEST_CHECK((pucFrame[1] == MESG_RESPONSE_EVENT_ID) && (pucFrame[4] == ((i % 3 == 1) ? EVENT_TX : EVENT_RX_FAIL)));
+      else
+         TEST_CHECK((pucFrame[1] == MESG_BROADCAST_DATA_ID) && (pucFrame[3] == i));
+   }
+   levels_check(0, 0);
+
+   // The channel closed event follows the response.
+   TEST_CHECK(response_get(command_send(MESG_CLOSE_CHANNEL_ID, aucClose, sizeof(aucClose)), MESG_CLOSE_CHANNEL_ID) == RESPONSE_NO_ERROR);
+   TEST_CHECK(response_get(command_send(MESG_UNASSIGN_CHANNEL_ID, aucUnassign, sizeof(aucUnassign)), MESG_UNASSIGN_CHANNEL_ID) == RESPONSE_NO_ERROR);
+}
+
+// Buffered events wait for a flush, command responses never do.
+static void test_lanes_no_event(void)
+{
+   event_lane_t eLane;
+   uint16_t usRecordSize;
+   uint16_t usLowRecordSize;
+   uint8_t ucTag;
+
+   lanes_buffer_all();
+
+   event_put(EVENT_RX, 1);
+   TEST_CHECK(!event_claim(&eLane, &usRecordSize, &ucTag));
+
+   event_put(NO_EVENT, 2);
+   TEST_CHECK(event_claim(&eLane, &usRecordSize, &ucTag));
+   TEST_CHECK((eLane == EVENT_LANE_HIGH) && (ucTag == 2));
+   event_buffering_release(eLane, usRecordSize);
+   TEST_CHECK(!event_claim(&eLane, &usRecordSize, &ucTag));
+
+   event_buffering_flush();
+   TEST_CHECK(event_claim(&eLane, &usLowRecordSize, &ucTag));
+   TEST_CHECK((eLane == EVENT_LANE_LOW) && (ucTag == 1));
+   event_buffering_release(eLane, usLowRecordSize);
+   TEST_CHECK(!event_claim(&eLane, &usRecordSize, &ucTag));
+   levels_check(0, 0);
+
+   lanes_default();
+}
+
+// While the low priority lane is flushing, it gets one event through after
+// every drain weight high priority events.
+static void lanes_drain_check(uint8_t ucWeight, uint8_t ucHighEvents)
+{
+   event_lane_t eLane;
+   uint16_t usRecordSize;
+   uint8_t ucTag;
+   uint8_t ucHigh = 0;
+   uint8_t ucLow = 0;
+   uint8_t ucRun = 0;
+
+   lanes_buffer_all();
+   event_buffering_drain_weight_set(ucWeight);
+
+   for (uint8_t i = 0; i < TEST_LANE_EVENTS; i++)
+      event_put(EVENT_RX, i);
+   event_buffering_flush();
+   for (uint8_t i = 0; i < ucHighEvents; i++)
+      event_put(NO_EVENT, i);
+
+   while (event_claim(&eLane, &usRecordSize, &ucTag))
+   {
+      if (eLane == EVENT_LANE_HIGH)
+      {
+         TEST_CHECK(ucTag == ucHigh++);
+         // Only bounded while low priority events are waiting.
+         TEST_CHECK((++ucRun <= ucWeight) || (ucLow == TEST_LANE_EVENTS));
+      }
+      else
+      {
+         TEST_CHECK(ucTag == ucLow++);
+         // Low priority events only go first once the high priority lane had its turns.
+         TEST_CHECK((ucRun == ucWeight) || (ucHigh == ucHighEvents));
+         ucRun = 0;
+      }
+
+      event_buffering_release(eLane, usRecordSize);
+      if (bTestFailed)
+         break;
+   }
+
+   TEST_CHECK((ucHigh == ucHighEvents) && (ucLow == TEST_LANE_EVENTS));
+   levels_check(0, 0);
+   lanes_default();
+}
+
+static void test_lanes_drain_weight(void)
+{
+   lanes_drain_check(1, 2 * TEST_LANE_EVENTS);
+   lanes_drain_check(2, 3 * TEST_LANE_EVENTS);
+   lanes_drain_check(DEFAULT_EVENT_BUFFERING_DRAIN_WEIGHT, 2 * TEST_LANE_EVENTS);
+
+   // A weight of 0 would starve the low priority lane.
+   event_buffering_drain_weight_set(0);
+   TEST_CHECK(event_buffering_drain_weight_get() == 1);
+   lanes_default();
+}
+
+// Each release goes to the lane its event was claimed from.
+static void test_lanes_release(void)
+{
+   event_lane_t eHighLane;
+   event_lane_t eLowLane;
+   uint16_t usHighSize;
+   uint16_t usLowSize;
+   uint8_t ucTag;
+
+   lanes_buffer_all();
+   event_buffering_drain_weight_set(1);
+
+   event_put(EVENT_RX, 0);
+   event_buffering_flush();
+   event_put(NO_EVENT, 0);
+   event_put(NO_EVENT, 1);
+
+   TEST_CHECK(event_claim(&eHighLane, &usHighSize, &ucTag) && (eHighLane == EVENT_LANE_HIGH));
+   TEST_CHECK(event_claim(&eLowLane, &usLowSize, &ucTag) && (eLowLane == EVENT_LANE_LOW));
+   levels_check(2 * usHighSize, usLowSize);
+
+   event_buffering_release(eLowLane, usLowSize);
+   levels_check(2 * usHighSize, 0);
+   event_buffering_release(eHighLane, usHighSize);
+   levels_check(usHighSize, 0);
+
+   TEST_CHECK(event_claim(&eHighLane, &usHighSize, &ucTag) && (eHighLane == EVENT_LANE_HIGH) && (ucTag == 1));
+   event_buffering_release(eHighLane, usHighSize);
+   levels_check(0, 0);
+
+   lanes_default();
+}
+
+int main(void)
+{
+   host_np_init();
+   host_np_gpio_in_set(1UL << SERIAL_ASYNC_BR3); // 115200 baud
+   host_np_uart_sink_set(sink_byte, NULL);
+   host_np_boot();
+
+   test_run("dispatch_invalid", test_dispatch_invalid);
+   test_run("dispatch_command", test_dispatch_command);
+   test_run("dispatch_request", test_dispatch_request);
+   test_run("dispatch_ext", test_dispatch_ext);
+   test_run("batch", test_batch);
+   test_run("lanes_default_order", test_lanes_default_order);
+   test_run("lanes_no_event", test_lanes_no_event);
+   test_run("lanes_drain_weight", test_lanes_drain_weight);
+   test_run("lanes_release", test_lanes_release);
+
+   return ulFailures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
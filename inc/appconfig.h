@@ -23,12 +23,24 @@ All rights reserved.
 #define ANT_STACK_EVENT_QUEUE_NUM_EVENTS_DEFAULT      32    // Default number of events in event queue
 
 #define ANT_STACK_MESSAGE_QUEUE_SIZE                  0x200 // Size in bytes of the message queue in the network processor. When full events will back up into the softdevice buffer.
+#define ANT_STACK_LOW_PRIORITY_MESSAGE_QUEUE_SIZE     0x200 // Size in bytes of the queue holding buffered (low priority) events until they are flushed, power of 2
+#define COMMAND_BURST_STAGING_QUEUE_SIZE              0x800 // Size in bytes of the queue staging host burst packets ahead of the burst handler, power of 2
+
+// The queues above grow into the part of aucANTChannelBlock not used by the ANT stack, up to these sizes
+#define ANT_STACK_MESSAGE_QUEUE_SIZE_MAX              0x800
+#define ANT_STACK_LOW_PRIORITY_MESSAGE_QUEUE_SIZE_MAX 0x1000
+#define COMMAND_BURST_STAGING_QUEUE_SIZE_MAX          0x1000
+#define COMMAND_RESPONSE_QUEUE_SIZE                   4     // Number of command responses queued ahead of the message queue, power of 2
+#define EVENT_TRACE_SIZE                              128   // Number of records in the event trace ring (8 bytes each), power of 2
 
 
 #if defined (NRF52_N548_CONFIG) //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // General Application Config
 //#define SERIAL_NUMBER_NOT_AVAILABLE                                        // No serial number support
+//#define EVENT_TRACE_DISABLE                                                // No event trace
+//#define CYCLE_PROFILING                                                    // Cycle count statistics of the hot paths (MESG_CYCLE_PROFILE_ID)
+//#define SERIAL_SYNC_USE_SPIM                                               // Synchronous serial through SPIM0 EasyDMA blocks instead of SPI0 bytes
 #define COMPLETE_CHIP_SYSTEM_RESET                                         // ANT reset message causes NRF51 hard reset
 #define SYSTEM_SLEEP                                                       // Enable deep sleep command
 #define SERIAL_REPORT_RESET_MESSAGE                                        // Generate startup message
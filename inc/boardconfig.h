@@ -137,6 +137,11 @@ All rights reserved.
 
 #endif
 
+// Channel profiles are stored in the last two flash pages unless the board reserves them
+#if defined(XIAO_NRF52840)
+   #define CHANNEL_PROFILE_FLASH_START       0x000ED000  // application data area below the Adafruit bootloader
+#endif
+
 //Baudrate Capabilities
 //#define BAUD1200_UNSUPPORTED
 //#define BAUD2400_UNSUPPORTED
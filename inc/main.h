@@ -19,6 +19,11 @@ All rights reserved.
  */
 void Main_SetQueuedBurst(void);
 
+/**
+ * @brief Restart the ANT stack with a new channel memory configuration, the previous one is restored if it fails
+ */
+uint32_t Main_ANTReconfigure(const ANT_ENABLE *pstANTEnable);
+
 
 /**
  * @brief Application debug command handler
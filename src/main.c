@@ -25,9 +25,14 @@ All rights reserved.
 #include "app_error.h"
 #include "appconfig.h"
 #include "boardconfig.h"
+#include "channel_profile.h"
 #include "command.h"
+#include "cycle_profile.h"
+#include "dsi_utility.h"
 #include "event_buffering.h"
+#include "event_trace.h"
 #include "global.h"
+#include "ram_arena.h"
 #include "serial.h"
 #include "system.h"
 
@@ -38,14 +43,18 @@ All rights reserved.
 uint32_t ulErrorCode;
 bool bAllowSleep = 0;
 bool bAllowSerialSleep = 0;
-ant_event_t stResponse;
-bool bResponsePending;
+#define COMMAND_RESPONSE_QUEUE_MASK    (COMMAND_RESPONSE_QUEUE_SIZE - 1)
+#define COMMAND_RESPONSE_QUEUE_FULL()  ((uint8_t)(ucResponseHead - ucResponseTail) >= COMMAND_RESPONSE_QUEUE_SIZE)
+ANT_MESSAGE astResponse[COMMAND_RESPONSE_QUEUE_SIZE]; // command responses, sent ahead of buffered events
+uint8_t ucResponseHead; // responses generated
+uint8_t ucResponseTail; // responses handed to the serial output buffer
 ant_event_t stSdEvent;
 volatile bool bStallStackEvents;
 ANT_MESSAGE *pstRxMessage;
 ANT_MESSAGE *pstTxMessage;
 uint8_t aucCapabilities[12]; // require 8, 4 extra padding just in case for future
 nrf_nvic_state_t nrf_nvic_state;
+static nrf_clock_lf_cfg_t clock_source; // kept for restarting the softdevice
 
 extern uint16_t usEventFilterMask;
 
@@ -147,9 +156,11 @@ void RADIO_NOTIFICATION_IRQHandler(void)
 void SD_EVT_IRQHandler(void)
 {
    uint32_t ulEvent;
+   CYCLE_PROFILE_START(ulCycleStart);
 
    while (sd_evt_get(&ulEvent) == NRF_SUCCESS) // read out SOC events
    {
+      System_FlashEventProcess(ulEvent);
    }
 
    while (!bStallStackEvents && sd_ant_event_get(
@@ -157,12 +168,22 @@ void SD_EVT_IRQHandler(void)
       &stSdEvent.stHeader.ucEvent,
       stSdEvent.stMessage.aucMessage) == NRF_SUCCESS)
    {
+      if (System_TimerRequested()) // stamps are only consumed (appended or traced) while the timer runs
+         DSI_PutULong(System_GetTime_32K(), stSdEvent.stHeader.aucTimestamp);
       bEventANTProcessStart = 1; // start ANT event handler to check if there are any ANT events
+#if !defined (EVENT_TRACE_DISABLE)
+      event_trace_record(&stSdEvent);
+#endif // !EVENT_TRACE_DISABLE
       if (!event_buffering_put(&stSdEvent))
       {
          bStallStackEvents = 1;
+#if !defined (EVENT_TRACE_DISABLE)
+         event_trace_stall();
+#endif // !EVENT_TRACE_DISABLE
       }
    }
+
+   CYCLE_PROFILE_STOP(CYCLE_PROFILE_SD_EVT_IRQ, ulCycleStart);
 }
 
 /**
@@ -177,6 +198,16 @@ void UART0_IRQHandler(void)
    Serial_UART0_IRQHandler();
 }
 
+#if defined(SERIAL_USE_UARTE)
+/**
+ * @brief Handler for serial receive idle timer interrupts
+ */
+void TIMER3_IRQHandler(void)
+{
+   Serial_TIMER3_IRQHandler();
+}
+#endif
+
 /**
  * @brief Handler for GPIOTE interrupts
  */
@@ -193,6 +224,49 @@ void Main_SetQueuedBurst(void)
    bEventBurstMessageProcess = 1; // ANT burst message to process
 }
 
+/**
+ * @brief Restart the ANT stack with a new channel memory configuration
+ */
+uint32_t Main_ANTReconfigure(const ANT_ENABLE *pstANTEnable)
+{
+   uint32_t ulANTError;
+   ANT_ENABLE stPrevious = stANTChannelEnable;
+
+   // The ANT stack can only be given its memory once, restart the softdevice. Everything
+   // set up through it is lost as after a reset, app interrupt settings are kept and the
+   // high frequency clock request and DC/DC mode are restored.
+   ulErrorCode = sd_softdevice_disable();
+   APP_ERROR_CHECK(ulErrorCode);
+
+   bStallStackEvents = 0; // the held event belongs to the previous stack
+   ucBurstSequence = 0;
+
+   ulErrorCode = sd_softdevice_enable(&clock_source, softdevice_assert_callback, ANT_LICENSE_KEY);
+   APP_ERROR_CHECK(ulErrorCode);
+
+   // Requests and SoC settings made through the softdevice went with it.
+   Serial_ClockRestore();
+   System_SoftDeviceRestore();
+
+   stANTChannelEnable = *pstANTEnable;
+   ulANTError = sd_ant_enable(&stANTChannelEnable);
+   if (ulANTError != NRF_SUCCESS)
+   {
+      stANTChannelEnable = stPrevious; // known to work
+      if (stANTChannelEnable.usMemoryBlockByteSize) // otherwise the stack was left at its own defaults
+      {
+         ulErrorCode = sd_ant_enable(&stANTChannelEnable);
+         APP_ERROR_CHECK(ulErrorCode);
+      }
+   }
+
+   ulErrorCode = sd_ant_capabilities_get(aucCapabilities); // get num channels supported by stack
+   APP_ERROR_CHECK(ulErrorCode);
+   stANTChannelEnable.ucTotalNumberOfChannels = aucCapabilities[0];
+
+   return ulANTError;
+}
+
 #if defined(XIAO_NRF52840)
 /**
  * @brief Set LEDs on Seeed XIAO nRF52840 (with pin initialization as other methods are overwriting it)
@@ -230,8 +304,6 @@ int main()
    SetLEDs(true, false, false);
    #endif	
 
-   nrf_clock_lf_cfg_t clock_source;
-
    // Initialize nrf_nvic_state to 0
    memset(&nrf_nvic_state, 0, sizeof(nrf_nvic_state));
 
@@ -280,6 +352,10 @@ int main()
    APP_ERROR_CHECK(ulErrorCode);
 #endif // SCALABLE_CHANNELS_DEFAULT
 
+   // Whatever the ANT stack did not take of the channel block is handed to the message queues
+   // (the whole block if it was not enabled with it). Must be set up before they are initialized.
+   ram_arena_init(aucANTChannelBlock, sizeof(aucANTChannelBlock), stANTChannelEnable.usMemoryBlockByteSize);
+
    ulErrorCode = sd_ant_capabilities_get(aucCapabilities); // get num channels supported by stack
    APP_ERROR_CHECK(ulErrorCode);
    stANTChannelEnable.ucTotalNumberOfChannels = aucCapabilities[0];
@@ -292,11 +368,20 @@ int main()
    bEventSetBaudrate = 0;
    ucQueuedTxBurstChannel = 0xFF; // invalid channel number
    ucBurstSequence = 0;
-   bResponsePending = 0;
+   ucResponseHead = 0;
+   ucResponseTail = 0;
    bStallStackEvents = 0;
 
    System_Init();
    event_buffering_init();
+#if !defined (EVENT_TRACE_DISABLE)
+   event_trace_init();
+#endif // !EVENT_TRACE_DISABLE
+#if defined (CYCLE_PROFILING)
+   cycle_profile_init();
+#endif // CYCLE_PROFILING
+   Command_Init();
+   channel_profile_init();
 
    #if defined(XIAO_NRF52840)
    SetLEDs(true, true, false);
@@ -315,6 +400,10 @@ int main()
    System_ResetMesg((ANT_MESSAGE *)pstTxMessage); // send reset message upon system startup
 #endif // !SERIAL_REPORT_RESET_MESSAGE
 
+   Command_ProfileBootApply(&astResponse[ucResponseHead & COMMAND_RESPONSE_QUEUE_MASK]); // configure the channels of the startup profile
+   if (astResponse[ucResponseHead & COMMAND_RESPONSE_QUEUE_MASK].ANT_MESSAGE_ucSize)
+      ucResponseHead++; // queue the response, sent after the startup message
+
    // reset power reset reason after constructing startup message
    ulErrorCode = sd_power_reset_reason_clr(POWER_RESETREAS_OFF_Msk | POWER_RESETREAS_LOCKUP_Msk | POWER_RESETREAS_SREQ_Msk | POWER_RESETREAS_DOG_Msk | POWER_RESETREAS_RESETPIN_Msk); // clear reset reasons
    APP_ERROR_CHECK(ulErrorCode);
@@ -341,16 +430,23 @@ int main()
 
          bAllowSleep = 0;
       }
-      else if (bEventRXSerialMessageProcess && !bResponsePending) // rx serial message to handle
+      else if (bEventRXSerialMessageProcess && !COMMAND_RESPONSE_QUEUE_FULL() && !bEventBurstMessageProcess && (ucQueuedTxBurstChannel == 0xFF)) // rx serial message to handle, in order behind any held burst message
       {
          bEventRXSerialMessageProcess = 0; // clear the RX event flag
-         Command_SerialMessageProcess((ANT_MESSAGE *)pstRxMessage, &stResponse.stMessage); // send to command handler
-         bResponsePending = 1;
+         pstRxMessage = Serial_GetRxMesgPtr(); // oldest queued message
+         CYCLE_PROFILE_START(ulCycleStart);
+         Command_SerialMessageProcess((ANT_MESSAGE *)pstRxMessage, &astResponse[ucResponseHead & COMMAND_RESPONSE_QUEUE_MASK]); // send to command handler
+         CYCLE_PROFILE_STOP(CYCLE_PROFILE_COMMAND, ulCycleStart);
+         if (astResponse[ucResponseHead & COMMAND_RESPONSE_QUEUE_MASK].ANT_MESSAGE_ucSize)
+            ucResponseHead++; // queue the response
          bAllowSleep = 0;
       }
-      else if (bEventANTProcessStart || bEventANTProcess) // protocol event message to handle
+      else if ((bEventANTProcessStart || bEventANTProcess) && !pstTxMessage->ANT_MESSAGE_ucSize && !Serial_TxEventFrameQueueFull()) // protocol event message to handle and output buffer is free
       {
          ant_event_hdr_t stHeader;
+         mc_fifo_span_t stFrame;
+         event_lane_t eLane;
+         uint16_t usRecordSize;
 
          if (!bEventANTProcess)
          {
@@ -358,17 +454,19 @@ int main()
             bEventANTProcess = 1;
          }
 
-         if (event_buffering_get(&stHeader, (ANT_MESSAGE*)pstTxMessage)) // received event, send to event handlers
+         if (event_buffering_claim(&stHeader, &stFrame, &eLane, &usRecordSize)) // received event, send to event handlers
          {
             uint8_t ucEventType = stHeader.ucEvent;
-
-            Serial_ANTEventHandler(ucEventType, pstTxMessage);
+            bool bSend = Serial_ANTEventHandler(ucEventType, stHeader.ucChannel);
 
             if (((uint16_t)(1 << (ucEventType - 1))) & usEventFilterMask)
             {
                // Do not send the message through serial interface
-               pstTxMessage->ANT_MESSAGE_ucSize = 0;
+               bSend = false;
             }
+
+            // Frame is sent straight out of the event buffer, its space is released once it is out.
+            Serial_TxEventFrame(bSend ? &stFrame : NULL, eLane, usRecordSize);
          }
          else // no event
          {
@@ -377,32 +475,32 @@ int main()
 
          bAllowSleep = 0;
       }
-      else if (bEventBurstMessageProcess && !bResponsePending) // we have a burst message to process
+      else if (bEventBurstMessageProcess && !COMMAND_RESPONSE_QUEUE_FULL()) // we have a burst message to process
       {
          bEventBurstMessageProcess = 0; // clear the burst event flag
-         if (Command_BurstMessageProcess((ANT_MESSAGE *)pstRxMessage, &stResponse.stMessage)) // try to process the burst transfer message
+         pstRxMessage = Serial_GetRxMesgPtr(); // the burst message is still the oldest queued one
+         astResponse[ucResponseHead & COMMAND_RESPONSE_QUEUE_MASK].ANT_MESSAGE_ucSize = 0; // init the response
+         if (Command_BurstMessageProcess((ANT_MESSAGE *)pstRxMessage, &astResponse[ucResponseHead & COMMAND_RESPONSE_QUEUE_MASK])) // try to process the burst transfer message
          {
-            ucQueuedTxBurstChannel = ((ANT_MESSAGE *)pstRxMessage)->ANT_MESSAGE_ucChannel & CHANNEL_NUMBER_MASK; // indicate queued burst transfer process with channel number
+            ucQueuedTxBurstChannel = ((ANT_MESSAGE *)pstRxMessage)->ANT_MESSAGE_ucChannel & CHANNEL_NUMBER_MASK; // indicate burst message waiting for staging space with channel number
          }
 
+         if (astResponse[ucResponseHead & COMMAND_RESPONSE_QUEUE_MASK].ANT_MESSAGE_ucSize)
+            ucResponseHead++; // queue the response
+
          bAllowSleep = 0;
-         bResponsePending = 1;
       }
 
-      // Queue any generated response.
-      if (bResponsePending)
+      // Hand queued responses to the output buffer. They bypass the message queue so
+      // command handling does not stall behind buffered events.
+      while ((ucResponseTail != ucResponseHead) && !pstTxMessage->ANT_MESSAGE_ucSize)
       {
-         stResponse.stHeader.ucChannel = stResponse.stMessage.ANT_MESSAGE_ucChannel;
-         stResponse.stHeader.ucEvent = NO_EVENT;
-         if (stResponse.stMessage.ANT_MESSAGE_ucSize == 0 ||
-            event_buffering_put(&stResponse))
-         {
-            bResponsePending = false;
-         }
-         event_buffering_flush();
+         ANT_MESSAGE *pstResponse = &astResponse[ucResponseTail & COMMAND_RESPONSE_QUEUE_MASK];
+
+         memcpy(pstTxMessage->aucMessage, pstResponse->aucMessage, pstResponse->ANT_MESSAGE_ucSize + MESG_SIZE_SIZE + MESG_ID_SIZE);
+         ucResponseTail++;
+         Serial_TxMessage(); // frame it into the tx queue, the output buffer stays occupied if the tx queue is full
 
-         // Need to make sure we run the service to pull the message out of the queue later.
-         bEventANTProcess = 1;
          bAllowSleep = 0;
       }
 
@@ -410,6 +508,9 @@ int main()
       // command responses get first go when the fifo fills up.
       if (bStallStackEvents && event_buffering_put(&stSdEvent))
       {
+#if !defined (EVENT_TRACE_DISABLE)
+         event_trace_resume(&stSdEvent);
+#endif // !EVENT_TRACE_DISABLE
          // Allow interrupt to start pushing more events.
          bStallStackEvents = 0;
          // Make sure to flush any that were already ignored.
@@ -417,14 +518,22 @@ int main()
       }
 
       System_Tick();
-      Serial_TxMessage(); // transmit any pending tx messages, goes to sleep if it can
+      if (event_buffering_tick()) // time threshold of buffered events expired
+      {
+         bEventANTProcess = 1;
+         bAllowSleep = 0;
+      }
+      Serial_TxMessage(); // queue any pending tx message, transmission completes in the background
 
       if (bAllowSleep) // if sleep is allowed
       {
-         if (bAllowSerialSleep)
-            Serial_Sleep(); // serial interface sleep
+         if (!Serial_TxBusy()) // keep serial interface up until the tx queue has drained
+         {
+            if (bAllowSerialSleep)
+               Serial_Sleep(); // serial interface sleep
 
-         System_DeepSleep(); // goto deep sleep/system off if required
+            System_DeepSleep(); // goto deep sleep/system off if required
+         }
 
          (void)sd_app_evt_wait(); // wait for event low power mode
       }